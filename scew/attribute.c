@@ -54,8 +54,15 @@ scew_attribute_create (XML_Char const *name, XML_Char const *value)
 
   if (attribute != NULL)
     {
-      attribute->name = scew_strdup(name);
-      attribute->value = scew_strdup(value);
+      scew_bool created =
+        (scew_attribute_set_name (attribute, name) != NULL)
+        && (scew_attribute_set_value (attribute, value) != NULL);
+
+      if (!created)
+        {
+          scew_attribute_free (attribute);
+          attribute = NULL;
+        }
     }
   else
     {
@@ -77,15 +84,24 @@ scew_attribute_copy (scew_attribute const *attribute)
   if (new_attr != NULL)
     {
       scew_bool copied =
-        (scew_attribute_set_name (new_attr, attribute->name) != NULL)
-        && (scew_attribute_set_value (new_attr, attribute->value) != NULL);
+        (scew_xstr_set_ (&new_attr->name,
+                         attribute->name.data,
+                         attribute->name.len) != NULL)
+        && (scew_xstr_set_ (&new_attr->value,
+                            attribute->value.data,
+                            attribute->value.len) != NULL);
 
       if (!copied)
         {
+          scew_error_set_last_error_ (scew_error_no_memory);
           scew_attribute_free (new_attr);
           new_attr = NULL;
         }
     }
+  else
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+    }
 
   return new_attr;
 }
@@ -93,10 +109,11 @@ scew_attribute_copy (scew_attribute const *attribute)
 void
 scew_attribute_free (scew_attribute *attribute)
 {
-  if (attribute != NULL)
+  /* Attributes of frozen elements are freed with their tree. */
+  if ((attribute != NULL) && scew_attribute_writable_ (attribute))
     {
-      free (attribute->name);
-      free (attribute->value);
+      scew_xstr_free_ (&attribute->name);
+      scew_xstr_free_ (&attribute->value);
       free (attribute);
     }
 }
@@ -110,8 +127,8 @@ scew_attribute_compare (scew_attribute const *a, scew_attribute const *b)
   assert (a != NULL);
   assert (b != NULL);
 
-  return (scew_strcmp (a->name, b->name) == 0)
-    && (scew_strcmp (a->value, b->value) == 0);
+  return scew_xstr_equal_ (&a->name, &b->name)
+    && scew_xstr_equal_ (&a->value, &b->value);
 }
 
 
@@ -122,7 +139,15 @@ scew_attribute_name (scew_attribute const *attribute)
 {
   assert (attribute != NULL);
 
-  return attribute->name;
+  return attribute->name.data;
+}
+
+size_t
+scew_attribute_name_len (scew_attribute const *attribute)
+{
+  assert (attribute != NULL);
+
+  return attribute->name.len;
 }
 
 XML_Char const*
@@ -130,27 +155,37 @@ scew_attribute_value (scew_attribute const *attribute)
 {
   assert (attribute != NULL);
 
-  return attribute->value;
+  return attribute->value.data;
+}
+
+size_t
+scew_attribute_value_len (scew_attribute const *attribute)
+{
+  assert (attribute != NULL);
+
+  return attribute->value.len;
 }
 
 XML_Char const*
 scew_attribute_set_name (scew_attribute *attribute, XML_Char const *name)
 {
-  XML_Char *new_name = NULL;
+  XML_Char const *new_name = NULL;
 
   assert (attribute != NULL);
   assert (name != NULL);
 
-  new_name = scew_strdup (name);
-  if (new_name != NULL)
+  if (!scew_attribute_writable_ (attribute))
     {
-      free (attribute->name);
-      attribute->name = new_name;
+      return NULL;
     }
-  else
+
+  scew_attribute_changing_ (attribute);
+  new_name = scew_xstr_set_ (&attribute->name, name, scew_strlen (name));
+  if (NULL == new_name)
     {
       scew_error_set_last_error_ (scew_error_no_memory);
     }
+  scew_attribute_changed_ (attribute);
 
   return new_name;
 }
@@ -158,25 +193,72 @@ scew_attribute_set_name (scew_attribute *attribute, XML_Char const *name)
 XML_Char const*
 scew_attribute_set_value (scew_attribute *attribute, XML_Char const *value)
 {
-  XML_Char *new_value = NULL;
+  XML_Char const *new_value = NULL;
 
   assert (attribute != NULL);
   assert (value != NULL);
 
-  new_value = scew_strdup (value);
-  if (new_value != NULL)
+  if (!scew_attribute_writable_ (attribute))
     {
-      free (attribute->value);
-      attribute->value = new_value;
+      return NULL;
     }
-  else
+
+  scew_attribute_changing_ (attribute);
+  new_value = scew_xstr_set_ (&attribute->value, value, scew_strlen (value));
+  if (NULL == new_value)
     {
       scew_error_set_last_error_ (scew_error_no_memory);
     }
+  scew_attribute_changed_ (attribute);
 
   return new_value;
 }
 
+XML_Char const*
+scew_attribute_set_value_len (scew_attribute *attribute,
+                              XML_Char const *value,
+                              size_t len)
+{
+  XML_Char const *new_value = NULL;
+
+  assert (attribute != NULL);
+  assert (value != NULL);
+
+  if (!scew_attribute_writable_ (attribute))
+    {
+      return NULL;
+    }
+
+  scew_attribute_changing_ (attribute);
+  new_value = scew_xstr_set_ (&attribute->value, value, len);
+  if (NULL == new_value)
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+    }
+  scew_attribute_changed_ (attribute);
+
+  return new_value;
+}
+
+XML_Char const*
+scew_attribute_set_value_take (scew_attribute *attribute, XML_Char *value)
+{
+  assert (attribute != NULL);
+  assert (value != NULL);
+
+  if (!scew_attribute_writable_ (attribute))
+    {
+      free (value);
+      return NULL;
+    }
+
+  scew_attribute_changing_ (attribute);
+  scew_xstr_take_ (&attribute->value, value, scew_strlen (value));
+  scew_attribute_changed_ (attribute);
+
+  return attribute->value.data;
+}
+
 scew_element*
 scew_attribute_parent (scew_attribute const *attribute)
 {
@@ -131,6 +131,17 @@ extern SCEW_API scew_bool scew_attribute_compare (scew_attribute const *a,
 extern SCEW_API XML_Char const*
 scew_attribute_name (scew_attribute const *attribute);
 
+/**
+ * Returns the length (in characters) of the given @a attribute's
+ * name.
+ *
+ * @pre attribute != NULL
+ *
+ * @ingroup SCEWAttributeAcc
+ */
+extern SCEW_API size_t
+scew_attribute_name_len (scew_attribute const *attribute);
+
 /**
  * Returns the given @a attribute's value.
  *
@@ -141,6 +152,17 @@ scew_attribute_name (scew_attribute const *attribute);
 extern SCEW_API XML_Char const*
 scew_attribute_value (scew_attribute const *attribute);
 
+/**
+ * Returns the length (in characters) of the given @a attribute's
+ * value.
+ *
+ * @pre attribute != NULL
+ *
+ * @ingroup SCEWAttributeAcc
+ */
+extern SCEW_API size_t
+scew_attribute_value_len (scew_attribute const *attribute);
+
 /**
  * Sets a new @a name to the given @a attribute and frees the old
  * one. If an error is found, the old name is not freed.
@@ -171,6 +193,44 @@ scew_attribute_set_name (scew_attribute *attribute, XML_Char const *name);
 extern SCEW_API XML_Char const*
 scew_attribute_set_value (scew_attribute *attribute, XML_Char const *value);
 
+/**
+ * Sets a new @a value to the given @a attribute, copying the first @a
+ * len characters of @a value, and frees the old one. The given @a
+ * value does not need to be null-terminated. If an error is found,
+ * the old value is not freed.
+ *
+ * @pre attribute != NULL
+ * @pre value != NULL
+ *
+ * @return the new @a attribute's value, or NULL if the new value
+ * could not be set.
+ *
+ * @ingroup SCEWAttributeAcc
+ */
+extern SCEW_API XML_Char const*
+scew_attribute_set_value_len (scew_attribute *attribute,
+                              XML_Char const *value,
+                              size_t len);
+
+/**
+ * Sets a new @a value to the given @a attribute and frees the old
+ * one. The attribute takes ownership of the given null-terminated
+ * buffer, which must have been allocated with malloc. Long values
+ * are not copied, but values of less than 16 characters are copied
+ * inside the attribute and @a value is freed right away, so the
+ * caller must not use or free @a value afterwards (use the returned
+ * pointer instead).
+ *
+ * @pre attribute != NULL
+ * @pre value != NULL
+ *
+ * @return the new @a attribute's value.
+ *
+ * @ingroup SCEWAttributeAcc
+ */
+extern SCEW_API XML_Char const*
+scew_attribute_set_value_take (scew_attribute *attribute, XML_Char *value);
+
 
 /**
  * @defgroup SCEWAttributeHier Hierarchy
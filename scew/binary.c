@@ -0,0 +1,854 @@
+/**
+ * @file     binary.c
+ * @brief    binary.h implementation
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 20:30
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+
+#include "binary.h"
+
+#include "xerror.h"
+#include "xhash.h"
+#include "xtree.h"
+
+#include "attribute.h"
+#include "element.h"
+#include "list.h"
+#include "str.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+
+/* Private */
+
+/* Identifies binary documents. */
+#define MAGIC_ _XT("SCEWB")
+
+/* Number of characters of a string literal (without '\0'). */
+#define STR_LEN_(str) ((sizeof (str) / sizeof (XML_Char)) - 1)
+
+enum
+  {
+    FORMAT_VERSION_ = 1,        /* Version of the binary format */
+    BUFFER_SIZE_ = 4096,        /* Characters written or read at once */
+    MIN_NAMES_ = 64,            /* Initial size of the names tables */
+    MAX_NUMBER_ = (sizeof (unsigned long) * 8 + 6) / 7 /* Characters in
+                                                          a number */
+  };
+
+/* An entry of the emitter names table (an open addressing hash
+   table). */
+typedef struct
+{
+  XML_Char const *data;         /* The name (NULL if the slot is free) */
+  size_t len;
+  unsigned long hash;
+  unsigned long index;          /* Reference to the name */
+} name_slot_;
+
+typedef struct
+{
+  scew_writer *writer;
+  XML_Char buffer[BUFFER_SIZE_];
+  size_t used;
+  name_slot_ *names;
+  size_t capacity;              /* Number of slots (a power of two) */
+  unsigned long n_names;
+  scew_bool no_memory;
+} emitter_;
+
+/* A decoded element whose children are still being loaded. */
+typedef struct
+{
+  scew_element *element;
+  unsigned long remaining;
+} frame_;
+
+typedef struct
+{
+  scew_reader *reader;
+  XML_Char buffer[BUFFER_SIZE_ + 1]; /* File readers add a '\0' */
+  size_t used;
+  size_t next;
+  XML_Char *scratch;            /* Last string read */
+  size_t scratch_size;
+  XML_Char **names;
+  unsigned long n_names;
+  unsigned long names_size;
+  frame_ *frames;
+  unsigned long n_frames;
+  unsigned long frames_size;
+  scew_error error;
+} decoder_;
+
+static scew_bool emit_flush_ (emitter_ *emitter);
+static scew_bool emit_chars_ (emitter_ *emitter,
+                              XML_Char const *data,
+                              size_t len);
+static scew_bool emit_number_ (emitter_ *emitter, unsigned long value);
+static scew_bool emit_string_ (emitter_ *emitter,
+                               XML_Char const *data,
+                               size_t len);
+static scew_bool emit_optional_ (emitter_ *emitter, XML_Char const *data);
+static scew_bool emit_name_ (emitter_ *emitter,
+                             XML_Char const *data,
+                             size_t len);
+static scew_bool grow_names_ (emitter_ *emitter);
+static scew_bool emit_element_ (emitter_ *emitter,
+                                scew_element const *element);
+
+static void fail_ (decoder_ *decoder, scew_error error);
+static scew_bool read_char_ (decoder_ *decoder, unsigned long *value);
+static scew_bool read_number_ (decoder_ *decoder, unsigned long *value);
+static scew_bool read_string_ (decoder_ *decoder, unsigned long len);
+static scew_bool read_optional_ (decoder_ *decoder, XML_Char **data);
+static scew_bool read_name_ (decoder_ *decoder, XML_Char const **name);
+static scew_bool read_header_ (decoder_ *decoder, scew_tree *tree);
+static scew_element* read_element_ (decoder_ *decoder,
+                                    unsigned long *n_children);
+static scew_bool read_children_ (decoder_ *decoder, scew_element *root,
+                                 unsigned long n_children);
+static scew_bool push_frame_ (decoder_ *decoder,
+                              scew_element *element,
+                              unsigned long n_children);
+static void free_decoder_ (decoder_ *decoder);
+
+
+
+/* Public */
+
+scew_bool
+scew_binary_print_tree (scew_writer *writer, scew_tree const *tree)
+{
+  static XML_Char const MAGIC[] = MAGIC_;
+
+  emitter_ emitter;
+  scew_element const *root = NULL;
+  scew_bool result = SCEW_TRUE;
+
+  assert (writer != NULL);
+  assert (tree != NULL);
+
+  emitter.writer = writer;
+  emitter.used = 0;
+  emitter.names = NULL;
+  emitter.capacity = 0;
+  emitter.n_names = 0;
+  emitter.no_memory = SCEW_FALSE;
+
+  root = scew_tree_root (tree);
+
+  result = emit_chars_ (&emitter, MAGIC, STR_LEN_ (MAGIC))
+    && emit_number_ (&emitter, FORMAT_VERSION_)
+    && emit_number_ (&emitter, sizeof (XML_Char))
+    && emit_optional_ (&emitter, scew_tree_xml_version (tree))
+    && emit_optional_ (&emitter, scew_tree_xml_encoding (tree))
+    && emit_optional_ (&emitter, scew_tree_xml_preamble (tree))
+    && emit_number_ (&emitter, scew_tree_xml_standalone (tree))
+    && emit_number_ (&emitter, (NULL == root) ? 0 : 1)
+    && ((NULL == root) || emit_element_ (&emitter, root))
+    && emit_flush_ (&emitter);
+
+  free (emitter.names);
+
+  if (!result)
+    {
+      scew_error_set_last_error_ (emitter.no_memory
+                                  ? scew_error_no_memory
+                                  : scew_error_io);
+    }
+
+  return result;
+}
+
+scew_tree*
+scew_binary_load (scew_reader *reader)
+{
+  decoder_ *decoder = NULL;
+  scew_tree *tree = NULL;
+  scew_element *root = NULL;
+  unsigned long n_children = 0;
+  unsigned long has_root = 0;
+  scew_bool result = SCEW_TRUE;
+
+  assert (reader != NULL);
+
+  decoder = calloc (1, sizeof (decoder_));
+  tree = calloc (1, sizeof (scew_tree));
+  if ((NULL == decoder) || (NULL == tree))
+    {
+      free (decoder);
+      free (tree);
+      scew_error_set_last_error_ (scew_error_no_memory);
+      return NULL;
+    }
+
+  decoder->reader = reader;
+  decoder->error = scew_error_none;
+
+  result = read_header_ (decoder, tree) && read_number_ (decoder, &has_root);
+  if (result && (has_root > 1))
+    {
+      fail_ (decoder, scew_error_binary);
+      result = SCEW_FALSE;
+    }
+
+  if (result && (1 == has_root))
+    {
+      root = read_element_ (decoder, &n_children);
+      result = (root != NULL) && read_children_ (decoder, root, n_children);
+      if (result)
+        {
+          scew_tree_set_root_element (tree, root);
+        }
+      else
+        {
+          scew_element_free (root);
+        }
+    }
+
+  if (!result)
+    {
+      scew_error_set_last_error_ (decoder->error);
+      scew_tree_free (tree);
+      tree = NULL;
+    }
+
+  free_decoder_ (decoder);
+
+  return tree;
+}
+
+
+
+/* Private */
+
+/* Emitter */
+
+scew_bool
+emit_flush_ (emitter_ *emitter)
+{
+  size_t used = emitter->used;
+
+  emitter->used = 0;
+
+  return (0 == used)
+    || (scew_writer_write (emitter->writer, emitter->buffer, used) == used);
+}
+
+scew_bool
+emit_chars_ (emitter_ *emitter, XML_Char const *data, size_t len)
+{
+  if ((len > BUFFER_SIZE_ - emitter->used) && !emit_flush_ (emitter))
+    {
+      return SCEW_FALSE;
+    }
+
+  /* Long strings are not worth copying. */
+  if (len >= BUFFER_SIZE_)
+    {
+      return (scew_writer_write (emitter->writer, data, len) == len);
+    }
+
+  scew_memcpy (emitter->buffer + emitter->used, data, len);
+  emitter->used += len;
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+emit_number_ (emitter_ *emitter, unsigned long value)
+{
+  XML_Char number[MAX_NUMBER_];
+  size_t len = 0;
+
+  /* 7 bits per character, the 8th one telling whether more follow. */
+  do
+    {
+      number[len] = (XML_Char) ((value & 0x7F) | ((value > 0x7F) ? 0x80 : 0));
+      value >>= 7;
+      len += 1;
+    }
+  while (value > 0);
+
+  return emit_chars_ (emitter, number, len);
+}
+
+scew_bool
+emit_string_ (emitter_ *emitter, XML_Char const *data, size_t len)
+{
+  return emit_number_ (emitter, len) && emit_chars_ (emitter, data, len);
+}
+
+scew_bool
+emit_optional_ (emitter_ *emitter, XML_Char const *data)
+{
+  size_t len = 0;
+
+  if (NULL == data)
+    {
+      return emit_number_ (emitter, 0);
+    }
+
+  len = scew_strlen (data);
+
+  return emit_number_ (emitter, len + 1) && emit_chars_ (emitter, data, len);
+}
+
+scew_bool
+emit_name_ (emitter_ *emitter, XML_Char const *data, size_t len)
+{
+  name_slot_ *slot = NULL;
+  unsigned long hash = 0;
+  size_t mask = 0;
+  size_t i = 0;
+
+  if (((emitter->n_names + 1) * 2 > emitter->capacity)
+      && !grow_names_ (emitter))
+    {
+      return SCEW_FALSE;
+    }
+
+  hash = scew_hash_string_ (scew_hash_init_ (), data, len);
+  mask = emitter->capacity - 1;
+  for (i = hash & mask; emitter->names[i].data != NULL; i = (i + 1) & mask)
+    {
+      slot = &emitter->names[i];
+      if ((slot->hash == hash) && (slot->len == len)
+          && (scew_memcmp (slot->data, data, len) == 0))
+        {
+          return emit_number_ (emitter, slot->index);
+        }
+    }
+
+  /* New names are stored after a 0 reference, and get the next one. */
+  slot = &emitter->names[i];
+  slot->data = data;
+  slot->len = len;
+  slot->hash = hash;
+  slot->index = ++emitter->n_names;
+
+  return emit_number_ (emitter, 0) && emit_string_ (emitter, data, len);
+}
+
+scew_bool
+grow_names_ (emitter_ *emitter)
+{
+  name_slot_ *names = NULL;
+  size_t capacity = 0;
+  size_t mask = 0;
+  size_t i = 0;
+  size_t j = 0;
+
+  capacity = (0 == emitter->capacity) ? MIN_NAMES_ : emitter->capacity * 2;
+  names = calloc (capacity, sizeof (name_slot_));
+  if (NULL == names)
+    {
+      emitter->no_memory = SCEW_TRUE;
+      return SCEW_FALSE;
+    }
+
+  mask = capacity - 1;
+  for (i = 0; i < emitter->capacity; ++i)
+    {
+      if (emitter->names[i].data != NULL)
+        {
+          for (j = emitter->names[i].hash & mask;
+               names[j].data != NULL;
+               j = (j + 1) & mask)
+            {
+              /* Look for a free slot. */
+            }
+          names[j] = emitter->names[i];
+        }
+    }
+
+  free (emitter->names);
+  emitter->names = names;
+  emitter->capacity = capacity;
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+emit_element_ (emitter_ *emitter, scew_element const *element)
+{
+  scew_attribute const *attribute = NULL;
+  XML_Char const *contents = NULL;
+  scew_list *list = NULL;
+  scew_bool result = SCEW_TRUE;
+
+  result = emit_name_ (emitter, scew_element_name (element),
+                       scew_element_name_len (element))
+    && emit_number_ (emitter, scew_element_attribute_count (element));
+
+  list = scew_element_attributes (element);
+  while (result && (list != NULL))
+    {
+      attribute = scew_list_data (list);
+      result = emit_name_ (emitter, scew_attribute_name (attribute),
+                           scew_attribute_name_len (attribute))
+        && emit_string_ (emitter, scew_attribute_value (attribute),
+                         scew_attribute_value_len (attribute));
+      list = scew_list_next (list);
+    }
+
+  contents = scew_element_contents (element);
+  if (NULL == contents)
+    {
+      result = result && emit_number_ (emitter, 0);
+    }
+  else
+    {
+      result = result
+        && emit_number_ (emitter, scew_element_contents_len (element) + 1)
+        && emit_chars_ (emitter, contents,
+                        scew_element_contents_len (element));
+    }
+
+  result = result && emit_number_ (emitter, scew_element_count (element));
+
+  list = scew_element_children (element);
+  while (result && (list != NULL))
+    {
+      result = emit_element_ (emitter, scew_list_data (list));
+      list = scew_list_next (list);
+    }
+
+  return result;
+}
+
+
+/* Decoder */
+
+void
+fail_ (decoder_ *decoder, scew_error error)
+{
+  /* Keep the first error, which is the real cause. */
+  if (scew_error_none == decoder->error)
+    {
+      decoder->error = error;
+    }
+}
+
+scew_bool
+read_char_ (decoder_ *decoder, unsigned long *value)
+{
+  if (decoder->next == decoder->used)
+    {
+      decoder->used = scew_reader_read (decoder->reader, decoder->buffer,
+                                        BUFFER_SIZE_);
+      decoder->next = 0;
+      if (0 == decoder->used)
+        {
+          fail_ (decoder, scew_reader_error (decoder->reader)
+                 ? scew_error_io : scew_error_binary);
+          return SCEW_FALSE;
+        }
+    }
+
+  *value = (unsigned long) decoder->buffer[decoder->next++];
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+read_number_ (decoder_ *decoder, unsigned long *value)
+{
+  unsigned long byte = 0;
+  unsigned int shift = 0;
+
+  *value = 0;
+  do
+    {
+      if (!read_char_ (decoder, &byte))
+        {
+          return SCEW_FALSE;
+        }
+
+      /* Numbers are made of bytes, whatever the size of XML_Char. */
+      byte &= 0xFF;
+      if ((shift >= sizeof (unsigned long) * 8)
+          || (((byte & 0x7F) << shift) >> shift != (byte & 0x7F)))
+        {
+          /* Too big to be one of our numbers. */
+          fail_ (decoder, scew_error_binary);
+          return SCEW_FALSE;
+        }
+      *value |= (byte & 0x7F) << shift;
+      shift += 7;
+    }
+  while (byte & 0x80);
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+read_string_ (decoder_ *decoder, unsigned long len)
+{
+  XML_Char *scratch = NULL;
+  size_t size = 0;
+  size_t done = 0;
+  size_t count = 0;
+  unsigned long value = 0;
+
+  /* The scratch buffer only grows with the characters actually read,
+     so a bogus length can not make us allocate too much. */
+  while (done < len)
+    {
+      if (decoder->next == decoder->used)
+        {
+          if (!read_char_ (decoder, &value))
+            {
+              return SCEW_FALSE;
+            }
+          decoder->next -= 1;
+        }
+
+      count = decoder->used - decoder->next;
+      count = (count > len - done) ? len - done : count;
+
+      if (done + count + 1 > decoder->scratch_size)
+        {
+          size = decoder->scratch_size * 2;
+          size = (size < done + count + 1) ? done + count + 1 : size;
+          scratch = realloc (decoder->scratch, size * sizeof (XML_Char));
+          if (NULL == scratch)
+            {
+              fail_ (decoder, scew_error_no_memory);
+              return SCEW_FALSE;
+            }
+          decoder->scratch = scratch;
+          decoder->scratch_size = size;
+        }
+
+      scew_memcpy (decoder->scratch + done,
+                   decoder->buffer + decoder->next,
+                   count);
+      decoder->next += count;
+      done += count;
+    }
+
+  if (NULL == decoder->scratch)
+    {
+      decoder->scratch = malloc (BUFFER_SIZE_ * sizeof (XML_Char));
+      if (NULL == decoder->scratch)
+        {
+          fail_ (decoder, scew_error_no_memory);
+          return SCEW_FALSE;
+        }
+      decoder->scratch_size = BUFFER_SIZE_;
+    }
+  decoder->scratch[len] = _XT('\0');
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+read_optional_ (decoder_ *decoder, XML_Char **data)
+{
+  unsigned long len = 0;
+
+  *data = NULL;
+  if (!read_number_ (decoder, &len))
+    {
+      return SCEW_FALSE;
+    }
+
+  /* Unset strings are stored as 0, and the rest as their length plus
+     one. */
+  if (0 == len)
+    {
+      return SCEW_TRUE;
+    }
+
+  if (!read_string_ (decoder, len - 1))
+    {
+      return SCEW_FALSE;
+    }
+
+  *data = scew_strndup (decoder->scratch, len - 1);
+  if (NULL == *data)
+    {
+      fail_ (decoder, scew_error_no_memory);
+    }
+
+  return (*data != NULL);
+}
+
+scew_bool
+read_name_ (decoder_ *decoder, XML_Char const **name)
+{
+  XML_Char **names = NULL;
+  unsigned long reference = 0;
+  unsigned long len = 0;
+  unsigned long size = 0;
+
+  if (!read_number_ (decoder, &reference))
+    {
+      return SCEW_FALSE;
+    }
+
+  if (reference > decoder->n_names)
+    {
+      fail_ (decoder, scew_error_binary);
+      return SCEW_FALSE;
+    }
+
+  if (reference > 0)
+    {
+      *name = decoder->names[reference - 1];
+      return SCEW_TRUE;
+    }
+
+  if (decoder->n_names == decoder->names_size)
+    {
+      size = (0 == decoder->names_size) ? MIN_NAMES_ : decoder->names_size * 2;
+      names = realloc (decoder->names, size * sizeof (XML_Char *));
+      if (NULL == names)
+        {
+          fail_ (decoder, scew_error_no_memory);
+          return SCEW_FALSE;
+        }
+      decoder->names = names;
+      decoder->names_size = size;
+    }
+
+  if (!read_number_ (decoder, &len) || !read_string_ (decoder, len))
+    {
+      return SCEW_FALSE;
+    }
+
+  *name = scew_strndup (decoder->scratch, len);
+  if (NULL == *name)
+    {
+      fail_ (decoder, scew_error_no_memory);
+      return SCEW_FALSE;
+    }
+  decoder->names[decoder->n_names++] = (XML_Char *) *name;
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+read_header_ (decoder_ *decoder, scew_tree *tree)
+{
+  static XML_Char const MAGIC[] = MAGIC_;
+
+  unsigned long value = 0;
+  unsigned int i = 0;
+
+  for (i = 0; i < STR_LEN_ (MAGIC); ++i)
+    {
+      if (!read_char_ (decoder, &value))
+        {
+          return SCEW_FALSE;
+        }
+      if (value != (unsigned long) MAGIC[i])
+        {
+          fail_ (decoder, scew_error_binary);
+          return SCEW_FALSE;
+        }
+    }
+
+  if (!read_number_ (decoder, &value) || (value != FORMAT_VERSION_)
+      || !read_number_ (decoder, &value) || (value != sizeof (XML_Char)))
+    {
+      fail_ (decoder, scew_error_binary);
+      return SCEW_FALSE;
+    }
+
+  if (!read_optional_ (decoder, &tree->version)
+      || !read_optional_ (decoder, &tree->encoding)
+      || !read_optional_ (decoder, &tree->preamble)
+      || !read_number_ (decoder, &value))
+    {
+      return SCEW_FALSE;
+    }
+
+  if (value > scew_tree_standalone_yes)
+    {
+      fail_ (decoder, scew_error_binary);
+      return SCEW_FALSE;
+    }
+  tree->standalone = (scew_tree_standalone) value;
+
+  return SCEW_TRUE;
+}
+
+scew_element*
+read_element_ (decoder_ *decoder, unsigned long *n_children)
+{
+  scew_element *element = NULL;
+  XML_Char const *name = NULL;
+  unsigned long n_attributes = 0;
+  unsigned long len = 0;
+  unsigned long i = 0;
+  scew_bool result = SCEW_TRUE;
+
+  if (!read_name_ (decoder, &name))
+    {
+      return NULL;
+    }
+
+  element = scew_element_create (name);
+  if (NULL == element)
+    {
+      fail_ (decoder, scew_error_no_memory);
+      return NULL;
+    }
+
+  result = read_number_ (decoder, &n_attributes);
+  for (i = 0; result && (i < n_attributes); ++i)
+    {
+      result = read_name_ (decoder, &name)
+        && read_number_ (decoder, &len)
+        && read_string_ (decoder, len);
+      if (result
+          && (NULL == scew_element_add_attribute_pair (element, name,
+                                                       decoder->scratch)))
+        {
+          fail_ (decoder, scew_error_no_memory);
+          result = SCEW_FALSE;
+        }
+    }
+
+  result = result && read_number_ (decoder, &len);
+  if (result && (len > 0))
+    {
+      result = read_string_ (decoder, len - 1);
+      if (result
+          && (NULL == scew_element_set_contents_len (element,
+                                                     decoder->scratch,
+                                                     len - 1)))
+        {
+          fail_ (decoder, scew_error_no_memory);
+          result = SCEW_FALSE;
+        }
+    }
+
+  result = result && read_number_ (decoder, n_children);
+
+  if (!result)
+    {
+      scew_element_free (element);
+      element = NULL;
+    }
+
+  return element;
+}
+
+scew_bool
+read_children_ (decoder_ *decoder, scew_element *root,
+                unsigned long n_children)
+{
+  frame_ *frame = NULL;
+  scew_element *child = NULL;
+
+  /* Elements are loaded without recursion, so deep documents can not
+     exhaust the stack. */
+  if (!push_frame_ (decoder, root, n_children))
+    {
+      return SCEW_FALSE;
+    }
+
+  while (decoder->n_frames > 0)
+    {
+      frame = &decoder->frames[decoder->n_frames - 1];
+      if (0 == frame->remaining)
+        {
+          decoder->n_frames -= 1;
+          continue;
+        }
+      frame->remaining -= 1;
+
+      child = read_element_ (decoder, &n_children);
+      if (NULL == child)
+        {
+          return SCEW_FALSE;
+        }
+      if (NULL == scew_element_add_element (frame->element, child))
+        {
+          scew_element_free (child);
+          fail_ (decoder, scew_error_no_memory);
+          return SCEW_FALSE;
+        }
+      if (!push_frame_ (decoder, child, n_children))
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+push_frame_ (decoder_ *decoder, scew_element *element,
+             unsigned long n_children)
+{
+  frame_ *frames = NULL;
+  unsigned long size = 0;
+
+  if (0 == n_children)
+    {
+      return SCEW_TRUE;
+    }
+
+  if (decoder->n_frames == decoder->frames_size)
+    {
+      size = (0 == decoder->frames_size) ? MIN_NAMES_ : decoder->frames_size * 2;
+      frames = realloc (decoder->frames, size * sizeof (frame_));
+      if (NULL == frames)
+        {
+          fail_ (decoder, scew_error_no_memory);
+          return SCEW_FALSE;
+        }
+      decoder->frames = frames;
+      decoder->frames_size = size;
+    }
+
+  decoder->frames[decoder->n_frames].element = element;
+  decoder->frames[decoder->n_frames].remaining = n_children;
+  decoder->n_frames += 1;
+
+  return SCEW_TRUE;
+}
+
+void
+free_decoder_ (decoder_ *decoder)
+{
+  unsigned long i = 0;
+
+  for (i = 0; i < decoder->n_names; ++i)
+    {
+      free (decoder->names[i]);
+    }
+  free (decoder->names);
+  free (decoder->frames);
+  free (decoder->scratch);
+  free (decoder);
+}
@@ -0,0 +1,108 @@
+/**
+ * @file     binary.h
+ * @brief    SCEW compact binary documents
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 20:30
+ * @ingroup  SCEWBinary
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+/**
+ * @defgroup SCEWBinary Binary documents
+ *
+ * Print and load XML trees in a compact binary encoding, which is
+ * much cheaper to decode than XML text. It is meant to exchange
+ * documents between programs using SCEW, not to be stored for long:
+ * the encoding is not an XML standard and it depends on the size of
+ * XML_Char.
+ *
+ * Binary documents are written to SCEW writers and read from SCEW
+ * readers, as XML text is, so any writer and reader can be used. A
+ * document is made of:
+ *
+ * - A header: the characters "SCEWB", the format version and the
+ *   size of XML_Char.
+ * - The tree properties: XML version, encoding, preamble and
+ *   standalone attribute.
+ * - The root element (if any), followed by its attributes, contents
+ *   and children, recursively, in document order.
+ *
+ * Numbers (lengths and counts) are stored as variable length
+ * integers, 7 bits per character, so small numbers take a single
+ * character. Strings are stored as their length followed by their
+ * characters, which are never escaped. Element and attribute names
+ * are stored only the first time they are found: afterwards, they are
+ * referred to by their position in a table of names.
+ *
+ * @ingroup SCEWIO
+ */
+
+#ifndef BINARY_H_2610182030
+#define BINARY_H_2610182030
+
+#include "export.h"
+
+#include "bool.h"
+#include "reader.h"
+#include "tree.h"
+#include "writer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Prints the given @a tree to the given @a writer as a binary
+ * document.
+ *
+ * @pre writer != NULL
+ * @pre tree != NULL
+ *
+ * @return true if the tree was printed, false otherwise (see
+ * #scew_error_code).
+ *
+ * @ingroup SCEWBinary
+ */
+extern SCEW_API scew_bool scew_binary_print_tree (scew_writer *writer,
+                                                  scew_tree const *tree);
+
+/**
+ * Loads a binary document printed with #scew_binary_print_tree from
+ * the given @a reader. Elements are created directly, without going
+ * through the XML parser, so no parser hook is called.
+ *
+ * @pre reader != NULL
+ *
+ * @return the new tree, or NULL if it could not be loaded. The error
+ * code is set to #scew_error_binary if the document is not valid (or
+ * is truncated), and to #scew_error_io if the reader failed.
+ *
+ * @ingroup SCEWBinary
+ */
+extern SCEW_API scew_tree* scew_binary_load (scew_reader *reader);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* BINARY_H_2610182030 */
@@ -0,0 +1,1559 @@
+/**
+ * @file     diff.c
+ * @brief    diff.h implementation
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 12:10
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "diff.h"
+
+#include "xattribute.h"
+#include "xelement.h"
+#include "xerror.h"
+#include "xhash.h"
+#include "xtree.h"
+
+#include "attribute.h"
+#include "str.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/* Private */
+
+struct scew_diff
+{
+  unsigned int n_edits;         /**< Number of edits */
+  scew_list *edits;             /**< List of edits */
+  scew_list *last_edit;         /**< Pointer to last edit (performance) */
+};
+
+struct scew_diff_edit
+{
+  scew_diff_operation operation; /**< The edit operation */
+  XML_Char *path;               /**< Path of the affected element */
+  unsigned int position;        /**< Position (inserts and moves) */
+  scew_element *element;        /**< Inserted element (inserts) */
+  XML_Char *name;               /**< Attribute name (attribute updates) */
+  XML_Char *value;              /**< New contents or attribute value */
+};
+
+typedef struct
+{
+  scew_diff *diff;              /**< The edit script being created */
+  XML_Char *path;               /**< Path of the current element */
+  size_t path_len;              /**< Number of characters of path */
+  size_t path_size;             /**< Allocated characters of path */
+  scew_bool failed;             /**< Whether an error has been found */
+} diff_state_;
+
+/* Unmatched children. */
+#define NO_MATCH_ ((unsigned int) -1)
+
+/* Maximum number of digits of an unsigned int (plus some margin). */
+enum { MAX_DIGITS_ = 24 };
+
+static XML_Char const *DIFF_ROOT_ = _XT("diff");
+static XML_Char const *ATTR_PATH_ = _XT("path");
+static XML_Char const *ATTR_POSITION_ = _XT("position");
+static XML_Char const *ATTR_NAME_ = _XT("name");
+static XML_Char const *ATTR_VALUE_ = _XT("value");
+
+/* Element names of each operation, in scew_diff_operation order. */
+static XML_Char const *OPERATION_NAMES_[] =
+  {
+    _XT("insert"),
+    _XT("delete"),
+    _XT("move"),
+    _XT("update-text"),
+    _XT("update-attribute")
+  };
+
+static scew_diff* create_diff_ (void);
+static scew_diff_edit* create_edit_ (scew_diff_operation operation,
+                                     XML_Char const *path,
+                                     size_t path_len);
+static void free_edit_ (scew_diff_edit *edit);
+static scew_bool append_edit_ (scew_diff *diff, scew_diff_edit *edit);
+
+static scew_diff_edit* add_edit_ (diff_state_ *state,
+                                  scew_diff_operation operation);
+static void push_segment_ (diff_state_ *state,
+                           scew_element const *element,
+                           unsigned int index);
+
+static void diff_element_ (diff_state_ *state,
+                           scew_element const *a,
+                           scew_element const *b);
+static void diff_attributes_ (diff_state_ *state,
+                              scew_element const *a,
+                              scew_element const *b);
+static void diff_children_ (diff_state_ *state,
+                            scew_element const *a,
+                            scew_element const *b);
+static scew_bool match_children_ (scew_element * const *a_nodes,
+                                  unsigned int n,
+                                  scew_element * const *b_nodes,
+                                  unsigned int m,
+                                  unsigned int *a_match,
+                                  unsigned int *b_match);
+static void mark_stable_ (unsigned int const *b_match,
+                          unsigned int m,
+                          unsigned int *stable,
+                          unsigned int *scratch);
+static scew_bool number_names_ (scew_element * const *nodes,
+                                unsigned int n,
+                                unsigned int *index);
+static unsigned int name_slot_ (unsigned int const *table,
+                                unsigned int size,
+                                scew_element * const *nodes,
+                                scew_element const *node);
+static unsigned int name_index_ (scew_element * const *nodes,
+                                 unsigned int position);
+static unsigned int find_node_ (scew_element * const *nodes,
+                                unsigned int n,
+                                scew_element const *node);
+static scew_bool same_name_ (scew_element const *a, scew_element const *b);
+static scew_bool identical_ (scew_element const *a, scew_element const *b);
+
+static scew_element* resolve_ (scew_tree const *tree, XML_Char const *path);
+static scew_element* child_by_name_ (scew_element const *element,
+                                     XML_Char const *name,
+                                     size_t len,
+                                     unsigned int index);
+static scew_bool apply_edit_ (scew_tree *tree, scew_diff_edit const *edit);
+
+static scew_bool edit_to_element_ (scew_diff_edit const *edit,
+                                   scew_element *root);
+static scew_diff_edit* element_to_edit_ (scew_element const *element);
+
+static size_t format_uint_ (XML_Char *buffer, unsigned int value);
+static XML_Char const* parse_uint_ (XML_Char const *str,
+                                    unsigned int *value);
+
+
+
+/* Public */
+
+scew_diff*
+scew_tree_diff (scew_tree const *a, scew_tree const *b)
+{
+  diff_state_ state;
+  scew_element const *root_a = NULL;
+  scew_element const *root_b = NULL;
+
+  assert (a != NULL);
+  assert (b != NULL);
+
+  state.diff = create_diff_ ();
+  state.path = NULL;
+  state.path_len = 0;
+  state.path_size = 0;
+  state.failed = (NULL == state.diff);
+
+  root_a = a->root;
+  root_b = b->root;
+
+  if ((root_a != NULL) && (root_b != NULL) && same_name_ (root_a, root_b))
+    {
+      push_segment_ (&state, root_a, 0);
+      diff_element_ (&state, root_a, root_b);
+    }
+  else
+    {
+      /* Different roots, replace the whole tree. */
+      if (root_a != NULL)
+        {
+          push_segment_ (&state, root_a, 0);
+          add_edit_ (&state, scew_diff_delete);
+          state.path_len = 0;
+        }
+      if (root_b != NULL)
+        {
+          scew_diff_edit *edit = add_edit_ (&state, scew_diff_insert);
+          if (edit != NULL)
+            {
+              edit->element = scew_element_copy (root_b);
+              state.failed = (NULL == edit->element);
+            }
+        }
+    }
+
+  free (state.path);
+
+  if (state.failed)
+    {
+      scew_diff_free (state.diff);
+      state.diff = NULL;
+    }
+
+  return state.diff;
+}
+
+scew_bool
+scew_tree_patch (scew_tree *tree, scew_diff const *diff)
+{
+  scew_bool applied = SCEW_TRUE;
+  scew_list *list = NULL;
+
+  assert (tree != NULL);
+  assert (diff != NULL);
+
+  if (tree->frozen != NULL)
+    {
+      scew_error_set_last_error_ (scew_error_frozen);
+      return SCEW_FALSE;
+    }
+
+  list = diff->edits;
+  while (applied && (list != NULL))
+    {
+      applied = apply_edit_ (tree, scew_list_data (list));
+      list = scew_list_next (list);
+    }
+
+  return applied;
+}
+
+void
+scew_diff_free (scew_diff *diff)
+{
+  if (diff != NULL)
+    {
+      scew_list *list = diff->edits;
+      while (list != NULL)
+        {
+          free_edit_ (scew_list_data (list));
+          list = scew_list_next (list);
+        }
+      scew_list_free (diff->edits);
+      free (diff);
+    }
+}
+
+unsigned int
+scew_diff_count (scew_diff const *diff)
+{
+  assert (diff != NULL);
+
+  return diff->n_edits;
+}
+
+scew_list*
+scew_diff_edits (scew_diff const *diff)
+{
+  assert (diff != NULL);
+
+  return diff->edits;
+}
+
+
+/* Edits */
+
+scew_diff_operation
+scew_diff_edit_operation (scew_diff_edit const *edit)
+{
+  assert (edit != NULL);
+
+  return edit->operation;
+}
+
+XML_Char const*
+scew_diff_edit_path (scew_diff_edit const *edit)
+{
+  assert (edit != NULL);
+
+  return edit->path;
+}
+
+unsigned int
+scew_diff_edit_position (scew_diff_edit const *edit)
+{
+  assert (edit != NULL);
+
+  return edit->position;
+}
+
+scew_element const*
+scew_diff_edit_element (scew_diff_edit const *edit)
+{
+  assert (edit != NULL);
+
+  return edit->element;
+}
+
+XML_Char const*
+scew_diff_edit_name (scew_diff_edit const *edit)
+{
+  assert (edit != NULL);
+
+  return edit->name;
+}
+
+XML_Char const*
+scew_diff_edit_value (scew_diff_edit const *edit)
+{
+  assert (edit != NULL);
+
+  return edit->value;
+}
+
+
+/* Serialization */
+
+scew_tree*
+scew_diff_tree (scew_diff const *diff)
+{
+  scew_tree *tree = NULL;
+  scew_element *root = NULL;
+  scew_list *list = NULL;
+  scew_bool created = SCEW_FALSE;
+
+  assert (diff != NULL);
+
+  tree = scew_tree_create ();
+  if (tree != NULL)
+    {
+      root = scew_tree_set_root (tree, DIFF_ROOT_);
+    }
+
+  created = (root != NULL);
+  list = diff->edits;
+  while (created && (list != NULL))
+    {
+      created = edit_to_element_ (scew_list_data (list), root);
+      list = scew_list_next (list);
+    }
+
+  if (!created)
+    {
+      scew_tree_free (tree);
+      tree = NULL;
+    }
+
+  return tree;
+}
+
+scew_diff*
+scew_diff_from_tree (scew_tree const *tree)
+{
+  scew_diff *diff = NULL;
+  scew_element const *root = NULL;
+  scew_list *list = NULL;
+  scew_bool created = SCEW_FALSE;
+
+  assert (tree != NULL);
+
+  root = tree->root;
+  if ((NULL == root) || (scew_strcmp (root->name.data, DIFF_ROOT_) != 0))
+    {
+      scew_error_set_last_error_ (scew_error_diff);
+      return NULL;
+    }
+
+  diff = create_diff_ ();
+
+  created = (diff != NULL);
+  list = root->children;
+  while (created && (list != NULL))
+    {
+      scew_diff_edit *edit = element_to_edit_ (scew_list_data (list));
+      created = (edit != NULL) && append_edit_ (diff, edit);
+      if ((edit != NULL) && !created)
+        {
+          free_edit_ (edit);
+        }
+      list = scew_list_next (list);
+    }
+
+  if (!created)
+    {
+      scew_diff_free (diff);
+      diff = NULL;
+    }
+
+  return diff;
+}
+
+
+
+/* Private (edit scripts) */
+
+scew_diff*
+create_diff_ (void)
+{
+  scew_diff *diff = calloc (1, sizeof (scew_diff));
+
+  if (NULL == diff)
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+    }
+
+  return diff;
+}
+
+scew_diff_edit*
+create_edit_ (scew_diff_operation operation,
+              XML_Char const *path,
+              size_t path_len)
+{
+  scew_diff_edit *edit = calloc (1, sizeof (scew_diff_edit));
+
+  if (edit != NULL)
+    {
+      edit->operation = operation;
+      edit->path = scew_strndup (path, path_len);
+      if (NULL == edit->path)
+        {
+          free (edit);
+          edit = NULL;
+        }
+    }
+
+  if (NULL == edit)
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+    }
+
+  return edit;
+}
+
+void
+free_edit_ (scew_diff_edit *edit)
+{
+  if (edit != NULL)
+    {
+      scew_element_free (edit->element);
+      free (edit->path);
+      free (edit->name);
+      free (edit->value);
+      free (edit);
+    }
+}
+
+scew_bool
+append_edit_ (scew_diff *diff, scew_diff_edit *edit)
+{
+  scew_list *item = NULL;
+
+  assert (diff != NULL);
+  assert (edit != NULL);
+
+  item = scew_list_append (diff->last_edit, edit);
+
+  if (item != NULL)
+    {
+      if (NULL == diff->edits)
+        {
+          diff->edits = item;
+        }
+      diff->last_edit = item;
+      diff->n_edits += 1;
+    }
+  else
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+    }
+
+  return (item != NULL);
+}
+
+
+
+/* Private (diff) */
+
+scew_diff_edit*
+add_edit_ (diff_state_ *state, scew_diff_operation operation)
+{
+  scew_diff_edit *edit = NULL;
+
+  assert (state != NULL);
+
+  if (state->failed)
+    {
+      return NULL;
+    }
+
+  edit = create_edit_ (operation,
+                       (NULL == state->path) ? _XT("") : state->path,
+                       state->path_len);
+
+  if ((edit != NULL) && !append_edit_ (state->diff, edit))
+    {
+      free_edit_ (edit);
+      edit = NULL;
+    }
+
+  state->failed = (NULL == edit);
+
+  return edit;
+}
+
+void
+push_segment_ (diff_state_ *state,
+               scew_element const *element,
+               unsigned int index)
+{
+  size_t needed = 0;
+
+  assert (state != NULL);
+  assert (element != NULL);
+
+  if (state->failed)
+    {
+      return;
+    }
+
+  /* "/name[index]" and the null character. */
+  needed = state->path_len + element->name.len + MAX_DIGITS_ + 4;
+  if (needed > state->path_size)
+    {
+      size_t size = 2 * needed;
+      XML_Char *path = realloc (state->path, size * sizeof (XML_Char));
+      if (NULL == path)
+        {
+          scew_error_set_last_error_ (scew_error_no_memory);
+          state->failed = SCEW_TRUE;
+          return;
+        }
+      state->path = path;
+      state->path_size = size;
+    }
+
+  state->path[state->path_len++] = _XT('/');
+  scew_memcpy (&state->path[state->path_len],
+               element->name.data,
+               element->name.len);
+  state->path_len += element->name.len;
+
+  /* The root element has no position. */
+  if (index > 0)
+    {
+      state->path[state->path_len++] = _XT('[');
+      state->path_len += format_uint_ (&state->path[state->path_len], index);
+      state->path[state->path_len++] = _XT(']');
+    }
+
+  state->path[state->path_len] = _XT('\0');
+}
+
+void
+diff_element_ (diff_state_ *state,
+               scew_element const *a,
+               scew_element const *b)
+{
+  assert (state != NULL);
+  assert (a != NULL);
+  assert (b != NULL);
+
+  /* Identical subtrees, nothing to do. */
+  if (identical_ (a, b))
+    {
+      return;
+    }
+
+  if (!scew_xstr_equal_ (&a->contents, &b->contents))
+    {
+      scew_diff_edit *edit = add_edit_ (state, scew_diff_update_text);
+      if ((edit != NULL) && (b->contents.data != NULL))
+        {
+          edit->value = scew_strndup (b->contents.data, b->contents.len);
+          state->failed = (NULL == edit->value);
+        }
+    }
+
+  diff_attributes_ (state, a, b);
+  diff_children_ (state, a, b);
+}
+
+void
+diff_attributes_ (diff_state_ *state,
+                  scew_element const *a,
+                  scew_element const *b)
+{
+  scew_list *list_a = NULL;
+  scew_list *list_b = NULL;
+
+  assert (state != NULL);
+  assert (a != NULL);
+  assert (b != NULL);
+
+  /**
+   * Attributes are compared in order, so the ones that are kept need
+   * to be in the same order in both elements. Walk the attributes of
+   * a that are also in b: while they are in b's order they are just
+   * updated; from the first one out of order they are deleted and
+   * added again (last) with the rest of b's attributes.
+   */
+  list_a = a->attributes;
+  list_b = b->attributes;
+  while (list_a != NULL)
+    {
+      scew_attribute *attr_a = scew_list_data (list_a);
+      scew_attribute *attr_b = NULL;
+      scew_diff_edit *edit = NULL;
+
+      if (list_b != NULL)
+        {
+          attr_b = scew_list_data (list_b);
+        }
+
+      if ((attr_b != NULL) && scew_xstr_equal_ (&attr_a->name, &attr_b->name))
+        {
+          if (!scew_xstr_equal_ (&attr_a->value, &attr_b->value))
+            {
+              edit = add_edit_ (state, scew_diff_update_attribute);
+              if (edit != NULL)
+                {
+                  edit->name = scew_strdup (attr_b->name.data);
+                  edit->value = scew_strndup (attr_b->value.data,
+                                              attr_b->value.len);
+                  state->failed = (NULL == edit->name) || (NULL == edit->value);
+                }
+            }
+          list_b = scew_list_next (list_b);
+        }
+      else
+        {
+          edit = add_edit_ (state, scew_diff_update_attribute);
+          if (edit != NULL)
+            {
+              edit->name = scew_strdup (attr_a->name.data);
+              state->failed = (NULL == edit->name);
+            }
+        }
+
+      list_a = scew_list_next (list_a);
+    }
+
+  /* Add the remaining attributes of b. */
+  while (list_b != NULL)
+    {
+      scew_attribute *attr_b = scew_list_data (list_b);
+      scew_diff_edit *edit = add_edit_ (state, scew_diff_update_attribute);
+      if (edit != NULL)
+        {
+          edit->name = scew_strdup (attr_b->name.data);
+          edit->value = scew_strndup (attr_b->value.data, attr_b->value.len);
+          state->failed = (NULL == edit->name) || (NULL == edit->value);
+        }
+      list_b = scew_list_next (list_b);
+    }
+}
+
+void
+diff_children_ (diff_state_ *state,
+                scew_element const *a,
+                scew_element const *b)
+{
+  unsigned int n = 0;
+  unsigned int m = 0;
+  unsigned int i = 0;
+  unsigned int j = 0;
+  unsigned int n_current = 0;
+  size_t path_len = 0;
+  scew_list *list = NULL;
+
+  /* Children of a (n), children of b (m) and current children (m). */
+  scew_element **nodes = NULL;
+  scew_element **a_nodes = NULL;
+  scew_element **b_nodes = NULL;
+  scew_element **current = NULL;
+
+  /* Matches of a (n), matches of b (m), stable children of b (m),
+     scratch space (4m) and name indexes of a (n). */
+  unsigned int *work = NULL;
+  unsigned int *a_index = NULL;
+  unsigned int *a_match = NULL;
+  unsigned int *b_match = NULL;
+  unsigned int *stable = NULL;
+
+  assert (state != NULL);
+  assert (a != NULL);
+  assert (b != NULL);
+
+  n = a->n_children;
+  m = b->n_children;
+
+  if (state->failed || ((0 == n) && (0 == m)))
+    {
+      return;
+    }
+
+  nodes = malloc ((n + 2 * m) * sizeof (scew_element *));
+  work = malloc ((2 * n + 6 * m) * sizeof (unsigned int));
+  if ((NULL == nodes) || (NULL == work))
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      state->failed = SCEW_TRUE;
+      free (nodes);
+      free (work);
+      return;
+    }
+
+  a_nodes = nodes;
+  b_nodes = nodes + n;
+  current = b_nodes + m;
+  a_match = work;
+  b_match = a_match + n;
+  stable = b_match + m;
+  a_index = stable + 5 * m;
+
+  for (i = 0, list = a->children; list != NULL; list = scew_list_next (list))
+    {
+      a_match[i] = NO_MATCH_;
+      a_nodes[i++] = scew_list_data (list);
+    }
+  for (j = 0, list = b->children; list != NULL; list = scew_list_next (list))
+    {
+      b_match[j] = NO_MATCH_;
+      b_nodes[j++] = scew_list_data (list);
+    }
+
+  if (!match_children_ (a_nodes, n, b_nodes, m, a_match, b_match)
+      || !number_names_ (a_nodes, n, a_index))
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      state->failed = SCEW_TRUE;
+    }
+
+  /**
+   * Diff matched children first, while the positions of this level
+   * are still the ones of a. Identical ones are skipped right away,
+   * so a long list of children with a few changes costs little more
+   * than walking it.
+   */
+  path_len = state->path_len;
+  for (i = 0; (i < n) && !state->failed; ++i)
+    {
+      if ((a_match[i] != NO_MATCH_)
+          && !identical_ (a_nodes[i], b_nodes[a_match[i]]))
+        {
+          push_segment_ (state, a_nodes[i], a_index[i]);
+          diff_element_ (state, a_nodes[i], b_nodes[a_match[i]]);
+          state->path_len = path_len;
+        }
+    }
+
+  /* Delete unmatched children, last ones first, so paths are valid. */
+  for (i = n; i-- > 0;)
+    {
+      if ((NO_MATCH_ == a_match[i]) && !state->failed)
+        {
+          push_segment_ (state, a_nodes[i], a_index[i]);
+          add_edit_ (state, scew_diff_delete);
+          state->path_len = path_len;
+        }
+    }
+
+  /**
+   * The longest sequence of matched children in the same order in
+   * both elements stays where it is. The rest of b's children are
+   * moved (or inserted) right after their predecessor in b, in b's
+   * order, which ends up giving b's order.
+   */
+  mark_stable_ (b_match, m, stable, stable + m);
+
+  for (i = 0; i < n; ++i)
+    {
+      if (a_match[i] != NO_MATCH_)
+        {
+          current[n_current++] = a_nodes[i];
+        }
+    }
+
+  for (j = 0; (j < m) && !state->failed; ++j)
+    {
+      scew_element *node = NULL;
+      scew_diff_edit *edit = NULL;
+      unsigned int position = 0;
+      unsigned int from = 0;
+
+      if ((b_match[j] != NO_MATCH_) && stable[j])
+        {
+          continue;
+        }
+
+      if (b_match[j] != NO_MATCH_)
+        {
+          node = a_nodes[b_match[j]];
+          from = find_node_ (current, n_current, node);
+          push_segment_ (state, node, name_index_ (current, from));
+          n_current -= 1;
+          memmove (&current[from], &current[from + 1],
+                   (n_current - from) * sizeof (scew_element *));
+        }
+      else
+        {
+          node = b_nodes[j];
+        }
+
+      if (j > 0)
+        {
+          scew_element *previous = (NO_MATCH_ == b_match[j - 1])
+            ? b_nodes[j - 1] : a_nodes[b_match[j - 1]];
+          position = find_node_ (current, n_current, previous) + 1;
+        }
+
+      if (NO_MATCH_ == b_match[j])
+        {
+          edit = add_edit_ (state, scew_diff_insert);
+          if (edit != NULL)
+            {
+              edit->position = position;
+              edit->element = scew_element_copy (node);
+              state->failed = (NULL == edit->element);
+            }
+        }
+      else if (position != from)
+        {
+          edit = add_edit_ (state, scew_diff_move);
+          if (edit != NULL)
+            {
+              edit->position = position;
+            }
+        }
+      state->path_len = path_len;
+
+      memmove (&current[position + 1], &current[position],
+               (n_current - position) * sizeof (scew_element *));
+      current[position] = node;
+      n_current += 1;
+    }
+
+  free (nodes);
+  free (work);
+}
+
+scew_bool
+match_children_ (scew_element * const *a_nodes,
+                 unsigned int n,
+                 scew_element * const *b_nodes,
+                 unsigned int m,
+                 unsigned int *a_match,
+                 unsigned int *b_match)
+{
+  unsigned int start = 0;
+  unsigned int end_a = n;
+  unsigned int end_b = m;
+  unsigned int i = 0;
+  unsigned int j = 0;
+
+  /* Identical children at the beginning... */
+  while ((start < n) && (start < m)
+         && identical_ (a_nodes[start], b_nodes[start]))
+    {
+      a_match[start] = start;
+      b_match[start] = start;
+      start += 1;
+    }
+
+  /* ...and at the end. */
+  while ((end_a > start) && (end_b > start)
+         && identical_ (a_nodes[end_a - 1], b_nodes[end_b - 1]))
+    {
+      end_a -= 1;
+      end_b -= 1;
+      a_match[end_a] = end_b;
+      b_match[end_b] = end_a;
+    }
+
+  /* Identical children somewhere else (probably moved). */
+  if ((end_a > start) && (end_b > start))
+    {
+      /* Open addressing hash table of a's children (index + 1). */
+      unsigned int size = 1;
+      unsigned int *table = NULL;
+
+      while (size < 2 * (end_a - start))
+        {
+          size *= 2;
+        }
+
+      table = calloc (size, sizeof (unsigned int));
+      if (NULL == table)
+        {
+          return SCEW_FALSE;
+        }
+
+      for (i = start; i < end_a; ++i)
+        {
+          unsigned int slot = scew_element_hash (a_nodes[i]) & (size - 1);
+          while (table[slot] != 0)
+            {
+              slot = (slot + 1) & (size - 1);
+            }
+          table[slot] = i + 1;
+        }
+
+      for (j = start; j < end_b; ++j)
+        {
+          unsigned long hash = scew_element_hash (b_nodes[j]);
+          unsigned int slot = hash & (size - 1);
+          while (table[slot] != 0)
+            {
+              i = table[slot] - 1;
+              if ((NO_MATCH_ == a_match[i])
+                  && (scew_element_hash (a_nodes[i]) == hash)
+                  && identical_ (a_nodes[i], b_nodes[j]))
+                {
+                  a_match[i] = j;
+                  b_match[j] = i;
+                  break;
+                }
+              slot = (slot + 1) & (size - 1);
+            }
+        }
+
+      free (table);
+    }
+
+  /**
+   * Children with the same name are different versions of each
+   * other. Each child of b left is matched to the first child of a
+   * left with its name, so a's children left are queued by name (in
+   * a's order) first.
+   */
+  if ((end_a > start) && (end_b > start))
+    {
+      unsigned int size = 1;
+      unsigned int *table = NULL;
+      unsigned int *heads = NULL;
+      unsigned int *next = NULL;
+
+      while (size < 2 * (end_a - start))
+        {
+          size *= 2;
+        }
+
+      table = calloc (2 * size + (end_a - start), sizeof (unsigned int));
+      if (NULL == table)
+        {
+          return SCEW_FALSE;
+        }
+      heads = table + size;
+      next = heads + size;
+
+      for (i = end_a; i-- > start;)
+        {
+          if (NO_MATCH_ == a_match[i])
+            {
+              unsigned int slot = name_slot_ (table, size, a_nodes, a_nodes[i]);
+              next[i - start] = (0 == table[slot]) ? NO_MATCH_ : heads[slot];
+              table[slot] = i + 1;
+              heads[slot] = i;
+            }
+        }
+
+      for (j = start; j < end_b; ++j)
+        {
+          if (NO_MATCH_ == b_match[j])
+            {
+              unsigned int slot = name_slot_ (table, size, a_nodes, b_nodes[j]);
+              if ((table[slot] != 0) && (heads[slot] != NO_MATCH_))
+                {
+                  i = heads[slot];
+                  heads[slot] = next[i - start];
+                  a_match[i] = j;
+                  b_match[j] = i;
+                }
+            }
+        }
+
+      free (table);
+    }
+
+  return SCEW_TRUE;
+}
+
+void
+mark_stable_ (unsigned int const *b_match,
+              unsigned int m,
+              unsigned int *stable,
+              unsigned int *scratch)
+{
+  /* Longest increasing subsequence of b's matches (patience sort). */
+  unsigned int *values = scratch;
+  unsigned int *positions = values + m;
+  unsigned int *tails = positions + m;
+  unsigned int *previous = tails + m;
+  unsigned int n_values = 0;
+  unsigned int length = 0;
+  unsigned int i = 0;
+  unsigned int j = 0;
+
+  for (j = 0; j < m; ++j)
+    {
+      stable[j] = SCEW_FALSE;
+      if (b_match[j] != NO_MATCH_)
+        {
+          values[n_values] = b_match[j];
+          positions[n_values] = j;
+          n_values += 1;
+        }
+    }
+
+  for (i = 0; i < n_values; ++i)
+    {
+      unsigned int low = 0;
+      unsigned int high = length;
+      while (low < high)
+        {
+          unsigned int middle = low + (high - low) / 2;
+          if (values[tails[middle]] < values[i])
+            {
+              low = middle + 1;
+            }
+          else
+            {
+              high = middle;
+            }
+        }
+      previous[i] = (low > 0) ? tails[low - 1] : NO_MATCH_;
+      tails[low] = i;
+      if (low == length)
+        {
+          length += 1;
+        }
+    }
+
+  for (i = (length > 0) ? tails[length - 1] : NO_MATCH_;
+       i != NO_MATCH_;
+       i = previous[i])
+    {
+      stable[positions[i]] = SCEW_TRUE;
+    }
+}
+
+scew_bool
+number_names_ (scew_element * const *nodes,
+               unsigned int n,
+               unsigned int *index)
+{
+  /* Last node seen of each name (index + 1). */
+  unsigned int size = 1;
+  unsigned int *table = NULL;
+  unsigned int i = 0;
+
+  while (size < 2 * n)
+    {
+      size *= 2;
+    }
+
+  table = calloc (size, sizeof (unsigned int));
+  if (NULL == table)
+    {
+      return SCEW_FALSE;
+    }
+
+  for (i = 0; i < n; ++i)
+    {
+      unsigned int slot = name_slot_ (table, size, nodes, nodes[i]);
+      index[i] = (0 == table[slot]) ? 1 : index[table[slot] - 1] + 1;
+      table[slot] = i + 1;
+    }
+
+  free (table);
+
+  return SCEW_TRUE;
+}
+
+unsigned int
+name_slot_ (unsigned int const *table,
+            unsigned int size,
+            scew_element * const *nodes,
+            scew_element const *node)
+{
+  unsigned int slot = scew_hash_string_ (scew_hash_init_ (),
+                                         node->name.data,
+                                         node->name.len) & (size - 1);
+
+  while ((table[slot] != 0) && !same_name_ (nodes[table[slot] - 1], node))
+    {
+      slot = (slot + 1) & (size - 1);
+    }
+
+  return slot;
+}
+
+unsigned int
+name_index_ (scew_element * const *nodes, unsigned int position)
+{
+  unsigned int index = 1;
+  unsigned int i = 0;
+
+  for (i = 0; i < position; ++i)
+    {
+      if (same_name_ (nodes[i], nodes[position]))
+        {
+          index += 1;
+        }
+    }
+
+  return index;
+}
+
+unsigned int
+find_node_ (scew_element * const *nodes,
+            unsigned int n,
+            scew_element const *node)
+{
+  unsigned int i = 0;
+
+  while ((i < n) && (nodes[i] != node))
+    {
+      i += 1;
+    }
+
+  assert (i < n);
+
+  return i;
+}
+
+scew_bool
+same_name_ (scew_element const *a, scew_element const *b)
+{
+  return scew_xstr_equal_ (&a->name, &b->name);
+}
+
+scew_bool
+identical_ (scew_element const *a, scew_element const *b)
+{
+  /**
+   * Subtrees with the same name and hash are taken as identical
+   * without walking them, as collisions of 64 bit hashes are very
+   * unlikely. Where unsigned long has 32 bits they are also compared.
+   */
+  return same_name_ (a, b)
+    && (scew_element_hash (a) == scew_element_hash (b))
+#if ULONG_MAX <= 0xffffffffUL
+    && scew_element_compare (a, b, NULL)
+#endif
+    ;
+}
+
+
+
+/* Private (patch) */
+
+scew_element*
+resolve_ (scew_tree const *tree, XML_Char const *path)
+{
+  scew_element *element = NULL;
+  XML_Char const *p = path;
+
+  assert (tree != NULL);
+  assert (path != NULL);
+
+  while (_XT('/') == *p)
+    {
+      XML_Char const *name = ++p;
+      unsigned int index = 1;
+      size_t len = 0;
+
+      while ((*p != _XT('\0')) && (*p != _XT('/')) && (*p != _XT('[')))
+        {
+          p += 1;
+        }
+      len = p - name;
+
+      if (_XT('[') == *p)
+        {
+          p = parse_uint_ (p + 1, &index);
+          if ((NULL == p) || (*p != _XT(']')) || (0 == index))
+            {
+              return NULL;
+            }
+          p += 1;
+        }
+
+      if (NULL == element)
+        {
+          element = tree->root;
+          if ((NULL == element) || (index != 1)
+              || (element->name.len != len)
+              || (scew_memcmp (element->name.data, name, len) != 0))
+            {
+              return NULL;
+            }
+        }
+      else
+        {
+          element = child_by_name_ (element, name, len, index);
+          if (NULL == element)
+            {
+              return NULL;
+            }
+        }
+    }
+
+  return (_XT('\0') == *p) ? element : NULL;
+}
+
+scew_element*
+child_by_name_ (scew_element const *element,
+                XML_Char const *name,
+                size_t len,
+                unsigned int index)
+{
+  scew_list *list = NULL;
+
+  assert (element != NULL);
+  assert (name != NULL);
+
+  list = element->children;
+  while (list != NULL)
+    {
+      scew_element *child = scew_list_data (list);
+      if ((child->name.len == len)
+          && (scew_memcmp (child->name.data, name, len) == 0)
+          && (0 == --index))
+        {
+          return child;
+        }
+      list = scew_list_next (list);
+    }
+
+  return NULL;
+}
+
+scew_bool
+apply_edit_ (scew_tree *tree, scew_diff_edit const *edit)
+{
+  scew_element *element = NULL;
+  scew_element *parent = NULL;
+  scew_element *new_element = NULL;
+  scew_bool applied = SCEW_FALSE;
+  scew_bool document = SCEW_FALSE;
+
+  assert (tree != NULL);
+  assert (edit != NULL);
+
+  document = (_XT('\0') == edit->path[0]);
+  if (!document)
+    {
+      element = resolve_ (tree, edit->path);
+      if (NULL == element)
+        {
+          scew_error_set_last_error_ (scew_error_diff);
+          return SCEW_FALSE;
+        }
+    }
+
+  switch (edit->operation)
+    {
+    case scew_diff_insert:
+      if ((document && (tree->root != NULL))
+          || (!document && (edit->position > element->n_children)))
+        {
+          break;
+        }
+      new_element = scew_element_copy (edit->element);
+      if (NULL == new_element)
+        {
+          return SCEW_FALSE;
+        }
+      if (document)
+        {
+          scew_tree_set_root_element (tree, new_element);
+        }
+      else if (NULL == scew_element_insert_element (element,
+                                                    new_element,
+                                                    edit->position))
+        {
+          scew_element_free (new_element);
+          return SCEW_FALSE;
+        }
+      applied = SCEW_TRUE;
+      break;
+
+    case scew_diff_delete:
+      if (element != NULL)
+        {
+          /* Freeing the root also removes it from the tree. */
+          scew_element_free (element);
+          applied = SCEW_TRUE;
+        }
+      break;
+
+    case scew_diff_move:
+      parent = (NULL == element) ? NULL : element->parent;
+      if ((parent != NULL) && (edit->position < parent->n_children))
+        {
+          scew_element_detach (element);
+          if (NULL == scew_element_insert_element (parent,
+                                                   element,
+                                                   edit->position))
+            {
+              scew_element_free (element);
+              return SCEW_FALSE;
+            }
+          applied = SCEW_TRUE;
+        }
+      break;
+
+    case scew_diff_update_text:
+      if (element != NULL)
+        {
+          if (NULL == edit->value)
+            {
+              scew_element_free_contents (element);
+            }
+          else if (NULL == scew_element_set_contents (element, edit->value))
+            {
+              return SCEW_FALSE;
+            }
+          applied = SCEW_TRUE;
+        }
+      break;
+
+    case scew_diff_update_attribute:
+      if (element != NULL)
+        {
+          if (edit->value != NULL)
+            {
+              if (NULL == scew_element_add_attribute_pair (element,
+                                                           edit->name,
+                                                           edit->value))
+                {
+                  return SCEW_FALSE;
+                }
+              applied = SCEW_TRUE;
+            }
+          else
+            {
+              scew_attribute *attribute =
+                scew_element_attribute_by_name (element, edit->name);
+              if (attribute != NULL)
+                {
+                  scew_element_delete_attribute (element, attribute);
+                  applied = SCEW_TRUE;
+                }
+            }
+        }
+      break;
+    }
+
+  if (!applied)
+    {
+      scew_error_set_last_error_ (scew_error_diff);
+    }
+
+  return applied;
+}
+
+
+
+/* Private (serialization) */
+
+scew_bool
+edit_to_element_ (scew_diff_edit const *edit, scew_element *root)
+{
+  XML_Char buffer[MAX_DIGITS_];
+  scew_element *element = NULL;
+  scew_bool created = SCEW_FALSE;
+
+  assert (edit != NULL);
+  assert (root != NULL);
+
+  element = scew_element_add (root, OPERATION_NAMES_[edit->operation]);
+
+  created = (element != NULL)
+    && (scew_element_add_attribute_pair (element, ATTR_PATH_, edit->path)
+        != NULL);
+
+  if (created && ((scew_diff_insert == edit->operation)
+                  || (scew_diff_move == edit->operation)))
+    {
+      buffer[format_uint_ (buffer, edit->position)] = _XT('\0');
+      created = (scew_element_add_attribute_pair (element,
+                                                  ATTR_POSITION_,
+                                                  buffer) != NULL);
+    }
+
+  if (created && (edit->name != NULL))
+    {
+      created = (scew_element_add_attribute_pair (element,
+                                                  ATTR_NAME_,
+                                                  edit->name) != NULL);
+    }
+
+  if (created && (edit->value != NULL))
+    {
+      created = (scew_diff_update_text == edit->operation)
+        ? (scew_element_set_contents (element, edit->value) != NULL)
+        : (scew_element_add_attribute_pair (element,
+                                            ATTR_VALUE_,
+                                            edit->value) != NULL);
+    }
+
+  if (created && (edit->element != NULL))
+    {
+      scew_element *child = scew_element_copy (edit->element);
+      created = (child != NULL)
+        && (scew_element_add_element (element, child) != NULL);
+      if ((child != NULL) && !created)
+        {
+          scew_element_free (child);
+        }
+    }
+
+  return created;
+}
+
+scew_diff_edit*
+element_to_edit_ (scew_element const *element)
+{
+  scew_diff_edit *edit = NULL;
+  scew_attribute *path = NULL;
+  scew_attribute *position = NULL;
+  scew_attribute *name = NULL;
+  scew_attribute *value = NULL;
+  scew_bool valid = SCEW_FALSE;
+  unsigned int operation = 0;
+  unsigned int n_operations = 0;
+
+  assert (element != NULL);
+
+  n_operations = sizeof (OPERATION_NAMES_) / sizeof (OPERATION_NAMES_[0]);
+  while ((operation < n_operations)
+         && (scew_strcmp (element->name.data,
+                          OPERATION_NAMES_[operation]) != 0))
+    {
+      operation += 1;
+    }
+
+  path = scew_element_attribute_by_name (element, ATTR_PATH_);
+  position = scew_element_attribute_by_name (element, ATTR_POSITION_);
+  name = scew_element_attribute_by_name (element, ATTR_NAME_);
+  value = scew_element_attribute_by_name (element, ATTR_VALUE_);
+
+  valid = (operation < n_operations) && (path != NULL);
+  switch (operation)
+    {
+    case scew_diff_insert:
+      valid = valid && (position != NULL) && (1 == element->n_children);
+      break;
+    case scew_diff_move:
+      valid = valid && (position != NULL);
+      break;
+    case scew_diff_update_attribute:
+      valid = valid && (name != NULL);
+      break;
+    default:
+      break;
+    }
+
+  if (!valid)
+    {
+      scew_error_set_last_error_ (scew_error_diff);
+      return NULL;
+    }
+
+  edit = create_edit_ ((scew_diff_operation) operation,
+                       path->value.data,
+                       path->value.len);
+  if (NULL == edit)
+    {
+      return NULL;
+    }
+
+  if (position != NULL)
+    {
+      XML_Char const *end = parse_uint_ (position->value.data, &edit->position);
+      valid = (end != NULL) && (_XT('\0') == *end);
+    }
+
+  if (valid && (scew_diff_insert == edit->operation))
+    {
+      edit->element = scew_element_copy (scew_list_data (element->children));
+      valid = (edit->element != NULL);
+    }
+  else if (valid && (scew_diff_update_attribute == edit->operation))
+    {
+      edit->name = scew_strdup (name->value.data);
+      edit->value = (NULL == value) ? NULL : scew_strdup (value->value.data);
+      valid = (edit->name != NULL) && ((NULL == value) || (edit->value != NULL));
+    }
+  else if (valid && (scew_diff_update_text == edit->operation)
+           && (element->contents.data != NULL))
+    {
+      edit->value = scew_strndup (element->contents.data,
+                                  element->contents.len);
+      valid = (edit->value != NULL);
+    }
+
+  if (!valid)
+    {
+      free_edit_ (edit);
+      edit = NULL;
+    }
+
+  return edit;
+}
+
+
+
+/* Private (miscellaneous) */
+
+size_t
+format_uint_ (XML_Char *buffer, unsigned int value)
+{
+  XML_Char digits[MAX_DIGITS_];
+  size_t len = 0;
+  size_t i = 0;
+
+  do
+    {
+      digits[len++] = (XML_Char) (_XT('0') + value % 10);
+      value /= 10;
+    }
+  while (value > 0);
+
+  for (i = 0; i < len; ++i)
+    {
+      buffer[i] = digits[len - i - 1];
+    }
+
+  return len;
+}
+
+XML_Char const*
+parse_uint_ (XML_Char const *str, unsigned int *value)
+{
+  XML_Char const *p = str;
+
+  *value = 0;
+  while ((*p >= _XT('0')) && (*p <= _XT('9')))
+    {
+      *value = *value * 10 + (unsigned int) (*p - _XT('0'));
+      p += 1;
+    }
+
+  return (p == str) ? NULL : p;
+}
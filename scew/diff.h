@@ -0,0 +1,308 @@
+/**
+ * @file     diff.h
+ * @brief    SCEW tree differences and patches
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 12:10
+ * @ingroup  SCEWDiff, SCEWDiffEdit, SCEWDiffSerial
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+/**
+ * @defgroup SCEWDiff Differences
+ *
+ * Compute the differences between two XML trees as an edit script
+ * (see #scew_tree_diff), and apply it to a tree (see
+ * #scew_tree_patch). An edit script is a sequence of edits which,
+ * applied in order to the first tree, transform it into the second
+ * one.
+ *
+ * Edits refer to elements with paths in an XPath-like syntax, such
+ * as "/root/child[2]/element[1]", where the root element has no
+ * position and children positions count elements with the same name,
+ * starting at 1. Each path is relative to the tree obtained after
+ * applying all the previous edits of the script.
+ *
+ * Only the root element and its descendants are taken into account,
+ * the XML declaration and preamble are not.
+ */
+
+#ifndef DIFF_H_2610181210
+#define DIFF_H_2610181210
+
+#include "export.h"
+
+#include "element.h"
+#include "list.h"
+#include "tree.h"
+
+#include <expat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * This is the type declaration for edit scripts.
+ *
+ * @ingroup SCEWDiff
+ */
+typedef struct scew_diff scew_diff;
+
+/**
+ * This is the type declaration for the edits of an edit script.
+ *
+ * @ingroup SCEWDiffEdit
+ */
+typedef struct scew_diff_edit scew_diff_edit;
+
+/**
+ * List of possible edit operations.
+ *
+ * @ingroup SCEWDiffEdit
+ */
+typedef enum
+  {
+    scew_diff_insert,           /**< Insert an element (and its children)
+                                   as a child of the element at the
+                                   edit's path, at the edit's position.
+                                   An empty path inserts the root
+                                   element. */
+    scew_diff_delete,           /**< Delete the element at the edit's
+                                   path (and its children). */
+    scew_diff_move,             /**< Move the element at the edit's path
+                                   to the edit's position among its
+                                   siblings (after detaching it). */
+    scew_diff_update_text,      /**< Set the contents of the element at
+                                   the edit's path to the edit's value,
+                                   or free them if the value is NULL. */
+    scew_diff_update_attribute  /**< Set the attribute with the edit's
+                                   name of the element at the edit's
+                                   path to the edit's value, or delete
+                                   it if the value is NULL. New
+                                   attributes are added last. */
+  } scew_diff_operation;
+
+
+/**
+ * Computes a minimal edit script that transforms the tree @a a into
+ * the tree @a b, so #scew_tree_patch (a, script) makes @a a equal to
+ * @a b (as compared by #scew_tree_compare with the default
+ * comparison, apart from the XML declaration and preamble).
+ *
+ * Subtrees with the same name and hash (see #scew_element_hash) are
+ * considered identical and are skipped without walking them. Hashes
+ * have 64 bits where unsigned long is that large, so a collision
+ * (which would hide a change) is very unlikely; elsewhere subtrees
+ * with the same hash are also compared. Children are first matched by
+ * hash and then by name (elements with different names are never
+ * matched), in time linear in the number of children, so the time
+ * needed to diff two large trees which are almost identical is
+ * roughly the time needed to hash them plus the time needed to walk
+ * the changed subtrees and their siblings. Each child that needs to
+ * be moved or inserted also costs time linear in the number of its
+ * siblings.
+ *
+ * @pre a != NULL
+ * @pre b != NULL
+ *
+ * @param a the tree to diff from.
+ * @param b the tree to diff to.
+ *
+ * @return a new edit script (which might be empty if both trees are
+ * equal), or NULL if it could not be created. The edit script does
+ * not depend on the given trees, so they can be freed afterwards.
+ *
+ * @ingroup SCEWDiff
+ */
+extern SCEW_API scew_diff* scew_tree_diff (scew_tree const *a,
+                                           scew_tree const *b);
+
+/**
+ * Applies the given edit script to @a tree. Edits are applied in
+ * order.
+ *
+ * @pre tree != NULL
+ * @pre diff != NULL
+ *
+ * @return true if the whole script was applied, false if an edit
+ * could not be applied (the error code is set to #scew_error_diff if
+ * the edit does not match the tree). Note that in that case, the
+ * previous edits have already been applied.
+ *
+ * @ingroup SCEWDiff
+ */
+extern SCEW_API scew_bool scew_tree_patch (scew_tree *tree,
+                                           scew_diff const *diff);
+
+/**
+ * Frees an edit script and all its edits. If @a diff is NULL, no
+ * operation is performed.
+ *
+ * @ingroup SCEWDiff
+ */
+extern SCEW_API void scew_diff_free (scew_diff *diff);
+
+/**
+ * Returns the number of edits of the given edit script.
+ *
+ * @pre diff != NULL
+ *
+ * @ingroup SCEWDiff
+ */
+extern SCEW_API unsigned int scew_diff_count (scew_diff const *diff);
+
+/**
+ * Returns the list of edits (#scew_diff_edit) of the given edit
+ * script, in the order they need to be applied. This is the internal
+ * list where edits are stored, so no modifications or deletions
+ * should be performed on this list.
+ *
+ * @pre diff != NULL
+ *
+ * @return the list of edits, or NULL if the edit script is empty.
+ *
+ * @ingroup SCEWDiff
+ */
+extern SCEW_API scew_list* scew_diff_edits (scew_diff const *diff);
+
+
+/**
+ * @defgroup SCEWDiffEdit Edits
+ * Access the information of the edits of an edit script.
+ * @ingroup SCEWDiff
+ */
+
+/**
+ * Returns the operation of the given @a edit.
+ *
+ * @pre edit != NULL
+ *
+ * @ingroup SCEWDiffEdit
+ */
+extern SCEW_API scew_diff_operation
+scew_diff_edit_operation (scew_diff_edit const *edit);
+
+/**
+ * Returns the path of the element affected by the given @a edit. For
+ * insertions, this is the path of the new element's parent.
+ *
+ * @pre edit != NULL
+ *
+ * @ingroup SCEWDiffEdit
+ */
+extern SCEW_API XML_Char const* scew_diff_edit_path (scew_diff_edit const *edit);
+
+/**
+ * Returns the position (starting at 0, and counting all children) of
+ * an inserted or moved element.
+ *
+ * @pre edit != NULL
+ *
+ * @return the position for insertions and moves, 0 otherwise.
+ *
+ * @ingroup SCEWDiffEdit
+ */
+extern SCEW_API unsigned int
+scew_diff_edit_position (scew_diff_edit const *edit);
+
+/**
+ * Returns the element (and its children) inserted by the given @a
+ * edit. The element belongs to the edit, a copy of it is inserted by
+ * #scew_tree_patch.
+ *
+ * @pre edit != NULL
+ *
+ * @return the inserted element for insertions, NULL otherwise.
+ *
+ * @ingroup SCEWDiffEdit
+ */
+extern SCEW_API scew_element const*
+scew_diff_edit_element (scew_diff_edit const *edit);
+
+/**
+ * Returns the name of the attribute updated by the given @a edit.
+ *
+ * @pre edit != NULL
+ *
+ * @return the attribute name for attribute updates, NULL otherwise.
+ *
+ * @ingroup SCEWDiffEdit
+ */
+extern SCEW_API XML_Char const* scew_diff_edit_name (scew_diff_edit const *edit);
+
+/**
+ * Returns the new value of the contents or the attribute updated by
+ * the given @a edit.
+ *
+ * @pre edit != NULL
+ *
+ * @return the new contents or attribute value, or NULL if they are to
+ * be removed (or for other operations).
+ *
+ * @ingroup SCEWDiffEdit
+ */
+extern SCEW_API XML_Char const* scew_diff_edit_value (scew_diff_edit const *edit);
+
+
+/**
+ * @defgroup SCEWDiffSerial Serialization
+ * Convert edit scripts to and from XML trees, so they can be printed
+ * and parsed as any other XML document.
+ * @ingroup SCEWDiff
+ */
+
+/**
+ * Creates an XML tree representing the given edit script. The root
+ * element is named "diff" and it has a child for each edit, named
+ * after the operation ("insert", "delete", "move", "update-text" or
+ * "update-attribute"), with "path", "position", "name" and "value"
+ * attributes as needed. The new text of "update-text" edits is stored
+ * as the element contents, and inserted elements as its only child.
+ *
+ * @pre diff != NULL
+ *
+ * @return a new XML tree, or NULL if it could not be created.
+ *
+ * @ingroup SCEWDiffSerial
+ */
+extern SCEW_API scew_tree* scew_diff_tree (scew_diff const *diff);
+
+/**
+ * Creates an edit script from an XML tree created by #scew_diff_tree
+ * (possibly printed and parsed again).
+ *
+ * @pre tree != NULL
+ *
+ * @return a new edit script, or NULL if it could not be created (the
+ * error code is set to #scew_error_diff if the tree is not a valid
+ * edit script).
+ *
+ * @ingroup SCEWDiffSerial
+ */
+extern SCEW_API scew_diff* scew_diff_from_tree (scew_tree const *tree);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* DIFF_H_2610181210 */
@@ -27,6 +27,7 @@
  */
 
 #include "xelement.h"
+#include "xtree.h"
 
 #include "str.h"
 
@@ -65,14 +66,27 @@ scew_element_create (XML_Char const *name)
 void
 scew_element_free (scew_element *element)
 {
-  if (element != NULL)
+  /* Frozen elements are freed with their tree. */
+  if ((element != NULL) && scew_element_writable_ (element))
     {
+      /* Leave the tree first, so its indexes are not updated while
+         the subtree is freed. */
+      scew_element_detach (element);
+      if (element->cache != NULL)
+        {
+          element->cache->indexed = SCEW_FALSE;
+        }
+      if (element->tree != NULL)
+        {
+          element->tree->root = NULL;
+        }
+
       scew_element_delete_all (element);
       scew_element_delete_attribute_all (element);
-      scew_element_detach (element);
 
-      free (element->name);
-      free (element->contents);
+      scew_xstr_free_ (&element->name);
+      scew_xstr_free_ (&element->contents);
+      free (element->cache);
       free (element);
     }
 }
@@ -85,7 +99,15 @@ scew_element_name (scew_element const *element)
 {
   assert (element != NULL);
 
-  return element->name;
+  return element->name.data;
+}
+
+size_t
+scew_element_name_len (scew_element const *element)
+{
+  assert (element != NULL);
+
+  return element->name.len;
 }
 
 XML_Char const*
@@ -93,63 +115,183 @@ scew_element_contents (scew_element const *element)
 {
   assert (element != NULL);
 
-  return element->contents;
+  return element->contents.data;
+}
+
+size_t
+scew_element_contents_len (scew_element const *element)
+{
+  assert (element != NULL);
+
+  return element->contents.len;
+}
+
+unsigned long
+scew_element_epoch (scew_element const *element)
+{
+  assert (element != NULL);
+
+  /* Pending epochs are only a cache, so it is fine to update them (not
+     from concurrent readers, though, see element.h). */
+  return scew_element_epoch_ ((scew_element *) element);
 }
 
 XML_Char const*
 scew_element_set_name (scew_element *element, XML_Char const *name)
 {
-  XML_Char *new_name = NULL;
+  XML_Char const *new_name = NULL;
 
   assert (element != NULL);
   assert (name != NULL);
 
-  new_name = scew_strdup (name);
-  if (new_name != NULL)
+  if (!scew_element_writable_ (element))
     {
-      free (element->name);
-      element->name = new_name;
+      return NULL;
+    }
+
+  new_name = scew_xstr_set_ (&element->name, name, scew_strlen (name));
+  if (NULL == new_name)
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
     }
   else
+    {
+      scew_element_changed_ (element);
+    }
+
+  return new_name;
+}
+
+XML_Char const*
+scew_element_set_name_len (scew_element *element,
+                           XML_Char const *name,
+                           size_t len)
+{
+  XML_Char const *new_name = NULL;
+
+  assert (element != NULL);
+  assert (name != NULL);
+
+  if (!scew_element_writable_ (element))
+    {
+      return NULL;
+    }
+
+  new_name = scew_xstr_set_ (&element->name, name, len);
+  if (NULL == new_name)
     {
       scew_error_set_last_error_ (scew_error_no_memory);
     }
+  else
+    {
+      scew_element_changed_ (element);
+    }
 
   return new_name;
 }
 
+XML_Char const*
+scew_element_set_name_take (scew_element *element, XML_Char *name)
+{
+  assert (element != NULL);
+  assert (name != NULL);
+
+  if (!scew_element_writable_ (element))
+    {
+      free (name);
+      return NULL;
+    }
+
+  scew_xstr_take_ (&element->name, name, scew_strlen (name));
+  scew_element_changed_ (element);
+
+  return element->name.data;
+}
+
 XML_Char const*
 scew_element_set_contents (scew_element *element, XML_Char const *contents)
 {
-  XML_Char *new_contents = NULL;
+  XML_Char const *new_contents = NULL;
 
   assert (element != NULL);
   assert (contents != NULL);
 
-  new_contents = scew_strdup (contents);
-  if (new_contents != NULL)
+  if (!scew_element_writable_ (element))
     {
-      free (element->contents);
-      element->contents = new_contents;
+      return NULL;
     }
-  else
+
+  scew_element_contents_changing_ (element);
+  new_contents = scew_xstr_set_ (&element->contents,
+                                 contents,
+                                 scew_strlen (contents));
+  if (NULL == new_contents)
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+    }
+  scew_element_contents_changed_ (element);
+
+  return new_contents;
+}
+
+XML_Char const*
+scew_element_set_contents_len (scew_element *element,
+                               XML_Char const *contents,
+                               size_t len)
+{
+  XML_Char const *new_contents = NULL;
+
+  assert (element != NULL);
+  assert (contents != NULL);
+
+  if (!scew_element_writable_ (element))
+    {
+      return NULL;
+    }
+
+  scew_element_contents_changing_ (element);
+  new_contents = scew_xstr_set_ (&element->contents, contents, len);
+  if (NULL == new_contents)
     {
       scew_error_set_last_error_ (scew_error_no_memory);
     }
+  scew_element_contents_changed_ (element);
 
   return new_contents;
 }
 
+XML_Char const*
+scew_element_set_contents_take (scew_element *element, XML_Char *contents)
+{
+  assert (element != NULL);
+  assert (contents != NULL);
+
+  if (!scew_element_writable_ (element))
+    {
+      free (contents);
+      return NULL;
+    }
+
+  scew_element_contents_changing_ (element);
+  scew_xstr_take_ (&element->contents, contents, scew_strlen (contents));
+  scew_element_contents_changed_ (element);
+
+  return element->contents.data;
+}
+
 void
 scew_element_free_contents (scew_element *element)
 {
   assert (element != NULL);
 
-  if (element->contents != NULL)
+  if (!scew_element_writable_ (element))
     {
-      free (element->contents);
-      element->contents = NULL;
+      return;
     }
+
+  scew_element_contents_changing_ (element);
+  scew_xstr_free_ (&element->contents);
+  scew_element_contents_changed_ (element);
 }
 
 
@@ -260,6 +402,11 @@ scew_element_add_element (scew_element *element, scew_element *child)
   assert (child != NULL);
   assert (scew_element_parent (child) == NULL);
 
+  if (!scew_element_writable_ (element))
+    {
+      return NULL;
+    }
+
   item = scew_list_append (element->last_child, child);
 
   if (item != NULL)
@@ -273,6 +420,54 @@ scew_element_add_element (scew_element *element, scew_element *child)
 
       element->last_child = item;
       element->n_children += 1;
+
+      scew_element_changed_ (element);
+    }
+  else
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      child = NULL;
+    }
+
+  return child;
+}
+
+scew_element*
+scew_element_insert_element (scew_element *element,
+                             scew_element *child,
+                             unsigned int index)
+{
+  scew_list *item = NULL;
+
+  assert (element != NULL);
+  assert (child != NULL);
+  assert (scew_element_parent (child) == NULL);
+  assert (index <= element->n_children);
+
+  if (!scew_element_writable_ (element))
+    {
+      return NULL;
+    }
+
+  if (index == element->n_children)
+    {
+      return scew_element_add_element (element, child);
+    }
+
+  item = scew_list_insert (scew_list_index (element->children, index), child);
+
+  if (item != NULL)
+    {
+      if (0 == index)
+        {
+          element->children = item;
+        }
+      child->parent = element;
+      child->myself = item;
+
+      element->n_children += 1;
+
+      scew_element_changed_ (element);
     }
   else
     {
@@ -290,6 +485,11 @@ scew_element_delete_all (scew_element *element)
 
   assert (element != NULL);
 
+  if (!scew_element_writable_ (element))
+    {
+      return;
+    }
+
   list = element->children;
   while (list != NULL)
     {
@@ -303,6 +503,8 @@ scew_element_delete_all (scew_element *element)
   element->children = NULL;
   element->last_child = NULL;
   element->n_children = 0;
+
+  scew_element_changed_ (element);
 }
 
 void
@@ -313,6 +515,11 @@ scew_element_delete_all_by_name (scew_element *element, XML_Char const *name)
   assert (element != NULL);
   assert (name != NULL);
 
+  if (!scew_element_writable_ (element))
+    {
+      return;
+    }
+
   child = scew_element_by_name (element, name);
   while (child != NULL)
     {
@@ -347,6 +554,11 @@ scew_element_detach (scew_element *element)
 
   assert (element != NULL);
 
+  if (!scew_element_writable_ (element))
+    {
+      return;
+    }
+
   parent = element->parent;
 
   if (parent != NULL)
@@ -368,5 +580,7 @@ scew_element_detach (scew_element *element)
 
       element->parent = NULL;
       element->myself = NULL;
+
+      scew_element_changed_ (parent);
     }
 }
@@ -33,6 +33,18 @@
  *
  * Element related functions. SCEW provides functions to access and
  * manipulate the elements of an XML tree.
+ *
+ * Functions taking const elements do not modify them, but some of
+ * them fill caches attached to the elements (allocated the first time
+ * one is needed, so elements not using them only pay for a pointer).
+ * Subtree hashes (see #scew_element_hash) are stored atomically, so
+ * hashing and comparing can be done from several threads at once.
+ * Epochs (see #scew_element_epoch) and the name summaries computed by
+ * searches are not: on a tree that is not frozen, these functions
+ * must not be called concurrently with any other function on the same
+ * elements. Frozen trees (see #scew_tree_freeze) have all their
+ * caches computed, so any number of threads can read them. No
+ * function can be called while an element is being modified.
  */
 
 #ifndef ELEMENT_H_0211250048
@@ -44,6 +56,8 @@
 
 #include <expat.h>
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -108,6 +122,24 @@ extern SCEW_API scew_element* scew_element_create (XML_Char const *name);
  */
 extern SCEW_API scew_element* scew_element_copy (scew_element const *element);
 
+/**
+ * Makes the same deep copy as #scew_element_copy, but the children of
+ * the given @a element (and their subtrees) are copied in parallel,
+ * using as many threads as processors are available, and then added
+ * to the new element in order. This is only worth it for large
+ * elements with many children.
+ *
+ * The given element must not be modified while it is being copied.
+ *
+ * @pre element != NULL
+ *
+ * @return a new element, or NULL if the copy failed.
+ *
+ * @ingroup SCEWElementAlloc
+ */
+extern SCEW_API scew_element*
+scew_element_copy_parallel (scew_element const *element);
+
 /**
  * Frees the given @a element recursively. That is, it frees all its
  * children and attributes. If the @a element has a parent, it is also
@@ -172,6 +204,61 @@ scew_element_by_index (scew_element const *element, unsigned int index);
 extern SCEW_API scew_list*
 scew_element_list_by_name (scew_element const *element, XML_Char const *name);
 
+/**
+ * Returns the first descendant (in document order) of the specified
+ * @a element that matches the given @a name. The given @a element
+ * itself is not considered.
+ *
+ * Every element keeps a small summary of the element and attribute
+ * names found in its subtree, so subtrees that can not contain the
+ * given @a name are skipped. Summaries are computed lazily the first
+ * time they are needed and kept until the subtree is modified, so
+ * repeated searches in an unmodified tree are much cheaper than the
+ * first one.
+ *
+ * @pre element != NULL
+ * @pre name != NULL
+ *
+ * @return the first descendant that matches the given @a name, or
+ * NULL if not found.
+ *
+ * @ingroup SCEWElementSearch
+ */
+extern SCEW_API scew_element*
+scew_element_descendant_by_name (scew_element const *element,
+                                 XML_Char const *name);
+
+/**
+ * Tells whether the subtree of the specified @a element (including
+ * the element itself) may contain an element with the given @a
+ * name. The answer is based on the subtree summary (see
+ * #scew_element_descendant_by_name), so if false is returned there is
+ * definitely no such element, but if true is returned there might
+ * not be one either.
+ *
+ * @pre element != NULL
+ * @pre name != NULL
+ *
+ * @ingroup SCEWElementSearch
+ */
+extern SCEW_API scew_bool
+scew_element_may_contain (scew_element const *element, XML_Char const *name);
+
+/**
+ * Tells whether the subtree of the specified @a element (including
+ * the element itself) may contain an element with an attribute with
+ * the given @a name. As with #scew_element_may_contain, false
+ * positives are possible but false negatives are not.
+ *
+ * @pre element != NULL
+ * @pre name != NULL
+ *
+ * @ingroup SCEWElementSearch
+ */
+extern SCEW_API scew_bool
+scew_element_may_contain_attribute (scew_element const *element,
+                                    XML_Char const *name);
+
 
 /**
  * @defgroup SCEWElementCompare Comparison
@@ -214,6 +301,61 @@ extern SCEW_API scew_bool scew_element_compare (scew_element const *a,
                                                 scew_element const *b,
                                                 scew_element_cmp_hook hook);
 
+/**
+ * Performs the same comparison as #scew_element_compare, with the
+ * same result, but the children of the given elements (and their
+ * subtrees) are compared in parallel, using as many threads as
+ * processors are available. This is only worth it for large
+ * elements with many children.
+ *
+ * As @a hook might be called from several threads at the same time,
+ * it must be thread-safe. The given elements must not be modified
+ * while they are being compared.
+ *
+ * @pre a != NULL
+ * @pre b != NULL
+ *
+ * @param a one of the elements to compare.
+ * @param b one of the elements to compare.
+ * @param hook the user defined comparison function. If NULL, the
+ * default comparison is used.
+ *
+ * @return true if both elements are considered equal, false
+ * otherwise.
+ *
+ * @ingroup SCEWElementCompare
+ */
+extern SCEW_API scew_bool
+scew_element_compare_parallel (scew_element const *a,
+                               scew_element const *b,
+                               scew_element_cmp_hook hook);
+
+/**
+ * Returns a hash of the whole subtree rooted at the given @a
+ * element. The hash takes into account the element's name, contents
+ * and attributes (in order) and, recursively, the hashes of all its
+ * children (in order). Therefore, two elements considered equal by
+ * #scew_element_compare (with the default comparison) always have the
+ * same hash.
+ *
+ * The hash is computed the first time it is needed and cached in the
+ * element, and it is automatically invalidated (for the element and
+ * all its ancestors) whenever the subtree is modified. Once hashes are
+ * computed, #scew_element_compare (with the default comparison) uses
+ * them to reject different subtrees without traversing them. Hashes
+ * are cached atomically, so this function can be called from several
+ * threads at once on the same (not modified) elements.
+ *
+ * @pre element != NULL
+ *
+ * @param element the element to obtain the hash of.
+ *
+ * @return the hash of the given element's subtree.
+ *
+ * @ingroup SCEWElementCompare
+ */
+extern SCEW_API unsigned long scew_element_hash (scew_element const *element);
+
 
 /**
  * @defgroup SCEWElementAcc Accessors
@@ -234,6 +376,19 @@ extern SCEW_API scew_bool scew_element_compare (scew_element const *a,
 extern SCEW_API XML_Char const*
 scew_element_name (scew_element const *element);
 
+/**
+ * Returns the length (in characters) of the given @a element's
+ * name. The length is stored with the name, so this function does
+ * not need to traverse it.
+ *
+ * @pre element != NULL
+ *
+ * @return the number of characters of the @a element's name.
+ *
+ * @ingroup SCEWElementAcc
+ */
+extern SCEW_API size_t scew_element_name_len (scew_element const *element);
+
 /**
  * Returns the given @a element's contents. That is, the text between
  * the start and end element tags.
@@ -248,6 +403,46 @@ scew_element_name (scew_element const *element);
 extern SCEW_API XML_Char const*
 scew_element_contents (scew_element const *element);
 
+/**
+ * Returns the length (in characters) of the given @a element's
+ * contents. The length is stored with the contents, so this function
+ * does not need to traverse them.
+ *
+ * @pre element != NULL
+ *
+ * @return the number of characters of the @a element's contents, or
+ * 0 if the element has no contents.
+ *
+ * @ingroup SCEWElementAcc
+ */
+extern SCEW_API size_t
+scew_element_contents_len (scew_element const *element);
+
+/**
+ * Returns the modification epoch of the given @a element. The epoch
+ * changes whenever the element or any of its descendants is modified
+ * (names, contents, attributes or children), so data derived from a
+ * subtree can be cached together with the epoch of its root, and
+ * checked in constant (amortized) time to still be up to date.
+ *
+ * Epochs are only meaningful for the same element: epochs of
+ * different elements are not related in any way.
+ *
+ * Reading the epoch of a modified subtree updates the epochs cached
+ * in it, so this function is not safe for concurrent readers of a
+ * tree that is not frozen (see @ref SCEWElement).
+ *
+ * @pre element != NULL
+ *
+ * @return the current epoch of the given @a element's subtree, which
+ * is never 0 unless there is not enough memory to keep track of it
+ * (and then the subtree must be taken as modified).
+ *
+ * @ingroup SCEWElementAcc
+ */
+extern SCEW_API unsigned long
+scew_element_epoch (scew_element const *element);
+
 /**
  * Sets a new @a name to the given @a element and frees the old
  * one. If the new name can not be set, the old one is not freed.
@@ -263,6 +458,44 @@ scew_element_contents (scew_element const *element);
 extern SCEW_API XML_Char const* scew_element_set_name (scew_element *element,
                                                        XML_Char const *name);
 
+/**
+ * Sets a new @a name to the given @a element, copying the first @a
+ * len characters of @a name, and frees the old one. The given @a name
+ * does not need to be null-terminated. If the new name can not be
+ * set, the old one is not freed.
+ *
+ * @pre element != NULL
+ * @pre name != NULL
+ *
+ * @return the new @a element's name, or NULL if the name can not be
+ * set.
+ *
+ * @ingroup SCEWElementAcc
+ */
+extern SCEW_API XML_Char const*
+scew_element_set_name_len (scew_element *element,
+                           XML_Char const *name,
+                           size_t len);
+
+/**
+ * Sets a new @a name to the given @a element and frees the old
+ * one. The element takes ownership of the given null-terminated
+ * buffer, which must have been allocated with malloc. Long names are
+ * not copied, but names of less than 16 characters are copied inside
+ * the element and @a name is freed right away, so the caller must
+ * not use or free @a name afterwards (use the returned pointer
+ * instead).
+ *
+ * @pre element != NULL
+ * @pre name != NULL
+ *
+ * @return the new @a element's name.
+ *
+ * @ingroup SCEWElementAcc
+ */
+extern SCEW_API XML_Char const*
+scew_element_set_name_take (scew_element *element, XML_Char *name);
+
 /**
  * Sets a new @a contents to the given element and frees the old
  * one. If the new contents can not be set, the old one is not freed.
@@ -277,6 +510,44 @@ extern SCEW_API XML_Char const* scew_element_set_name (scew_element *element,
 extern SCEW_API XML_Char const*
 scew_element_set_contents (scew_element *element, XML_Char const *contents);
 
+/**
+ * Sets a new @a contents to the given @a element, copying the first
+ * @a len characters of @a contents, and frees the old one. The given
+ * @a contents does not need to be null-terminated. If the new
+ * contents can not be set, the old one is not freed.
+ *
+ * @pre element != NULL
+ * @pre contents != NULL
+ *
+ * @return the new @a element's contents, or NULL if the contents can
+ * not be set.
+ *
+ * @ingroup SCEWElementAcc
+ */
+extern SCEW_API XML_Char const*
+scew_element_set_contents_len (scew_element *element,
+                               XML_Char const *contents,
+                               size_t len);
+
+/**
+ * Sets a new @a contents to the given @a element and frees the old
+ * one. The element takes ownership of the given null-terminated
+ * buffer, which must have been allocated with malloc. Long contents
+ * are not copied, but contents of less than 16 characters are copied
+ * inside the element and @a contents is freed right away, so the
+ * caller must not use or free @a contents afterwards (use the
+ * returned pointer instead).
+ *
+ * @pre element != NULL
+ * @pre contents != NULL
+ *
+ * @return the new @a element's contents.
+ *
+ * @ingroup SCEWElementAcc
+ */
+extern SCEW_API XML_Char const*
+scew_element_set_contents_take (scew_element *element, XML_Char *contents);
+
 /**
  * Frees the current contents of the given @a element. If the @a
  * element has no contents, this functions does not have any effect.
@@ -382,6 +653,28 @@ extern SCEW_API scew_element* scew_element_add_pair (scew_element *element,
 extern SCEW_API scew_element* scew_element_add_element (scew_element *element,
                                                         scew_element *child);
 
+/**
+ * Inserts a @a child to the given @a element at the given @a
+ * position, so it becomes the child at that position. If @a index is
+ * the number of children of @a element, this is the same as
+ * #scew_element_add_element. As with #scew_element_add_element, the
+ * element being inserted should be a clean element.
+ *
+ * @pre element != NULL
+ * @pre child != NULL
+ * @pre #scew_element_parent (child) == NULL
+ * @pre index <= #scew_element_count (element)
+ *
+ * @return the element being inserted, or NULL if the element could
+ * not be inserted.
+ *
+ * @ingroup SCEWElementHier
+ */
+extern SCEW_API scew_element*
+scew_element_insert_element (scew_element *element,
+                             scew_element *child,
+                             unsigned int index);
+
 /**
  * Deletes all the children for the given @a element. This function
  * deletes all subchildren recursively. This will automatically free
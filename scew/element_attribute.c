@@ -109,6 +109,11 @@ scew_element_add_attribute (scew_element *element, scew_attribute *attribute)
   assert (element != NULL);
   assert (attribute != NULL);
 
+  if (!scew_element_writable_ (element))
+    {
+      return NULL;
+    }
+
   if (scew_attribute_parent (attribute) == NULL)
     {
       XML_Char const *name = scew_attribute_name (attribute);
@@ -140,6 +145,11 @@ scew_element_add_attribute_pair (scew_element *element,
   assert (name != NULL);
   assert (value != NULL);
 
+  if (!scew_element_writable_ (element))
+    {
+      return NULL;
+    }
+
   /* Try to find an existent attribute. */
   old_attribute = scew_element_attribute_by_name (element, name);
 
@@ -178,10 +188,24 @@ scew_element_delete_attribute (scew_element *element,
   assert (element != NULL);
   assert (attribute != NULL);
 
+  if (!scew_element_writable_ (element))
+    {
+      return;
+    }
+
+  scew_attribute_changing_ (attribute);
+
+  if (scew_list_data (element->last_attribute) == attribute)
+    {
+      element->last_attribute = scew_list_previous (element->last_attribute);
+    }
+
   element->attributes = scew_list_delete (element->attributes, attribute);
   element->n_attributes -= 1;
 
   scew_attribute_free (attribute);
+
+  scew_element_attributes_changed_ (element);
 }
 
 void
@@ -191,12 +215,18 @@ scew_element_delete_attribute_all (scew_element *element)
 
   assert (element != NULL);
 
+  if (!scew_element_writable_ (element))
+    {
+      return;
+    }
+
   /* Free all attributes. */
   list = element->attributes;
   while (list != NULL)
     {
       scew_attribute *aux = scew_list_data (list);
       list = scew_list_next (list);
+      scew_attribute_changing_ (aux);
       scew_attribute_free (aux);
     }
   scew_list_free (element->attributes);
@@ -204,6 +234,8 @@ scew_element_delete_attribute_all (scew_element *element)
   element->attributes = NULL;
   element->last_attribute = NULL;
   element->n_attributes = 0;
+
+  scew_element_attributes_changed_ (element);
 }
 
 void
@@ -280,6 +312,8 @@ add_new_attribute_ (scew_element *element, scew_attribute *attribute)
       element->last_attribute = item;
       element->n_attributes += 1;
 
+      scew_attribute_changed_ (attribute);
+
       /* Update the return value. */
       new_attribute = attribute;
     }
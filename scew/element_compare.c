@@ -29,9 +29,13 @@
 #include "xelement.h"
 
 #include "attribute.h"
-#include "str.h"
+
+#include "xattribute.h"
+#include "xhash.h"
+#include "xpool.h"
 
 #include <assert.h>
+#include <stdlib.h>
 
 
 
@@ -44,6 +48,23 @@ static scew_bool compare_children_ (scew_element const *a,
                                     scew_element_cmp_hook hook);
 static scew_bool compare_attributes_ (scew_element const *a,
                                       scew_element const *b);
+static unsigned long hash_subtree_ (scew_element const *element,
+                                    scew_bool *cached);
+static unsigned long hash_element_ (scew_element const *element,
+                                    scew_bool *cached);
+static scew_bool different_hashes_ (scew_element const *a,
+                                    scew_element const *b,
+                                    scew_element_cmp_hook hook);
+
+/* Data shared by the threads comparing elements' children. */
+typedef struct
+{
+  scew_element_cmp_hook hook;
+  scew_element **a_children;
+  scew_element **b_children;
+} parallel_compare_;
+
+static scew_bool compare_child_ (void *data, unsigned int index);
 
 
 
@@ -61,9 +82,79 @@ scew_element_compare (scew_element const *a,
 
   cmp_hook = (NULL == hook) ? compare_element_ : hook;
 
+  if (different_hashes_ (a, b, cmp_hook))
+    {
+      return SCEW_FALSE;
+    }
+
   return (cmp_hook (a, b) && compare_children_ (a, b, cmp_hook));
 }
 
+scew_bool
+scew_element_compare_parallel (scew_element const *a,
+                               scew_element const *b,
+                               scew_element_cmp_hook hook)
+{
+  parallel_compare_ compare;
+  scew_list *list_a = NULL;
+  scew_list *list_b = NULL;
+  scew_bool equal = SCEW_FALSE;
+  unsigned int i = 0;
+
+  assert (a != NULL);
+  assert (b != NULL);
+
+  compare.hook = (NULL == hook) ? compare_element_ : hook;
+
+  if (different_hashes_ (a, b, compare.hook)
+      || !compare.hook (a, b)
+      || (a->n_children != b->n_children))
+    {
+      return SCEW_FALSE;
+    }
+
+  compare.a_children = NULL;
+  if (a->n_children > 1)
+    {
+      compare.a_children = malloc (2 * a->n_children * sizeof (scew_element *));
+    }
+
+  /* Not worth it (or no memory), just compare sequentially. */
+  if (NULL == compare.a_children)
+    {
+      return compare_children_ (a, b, compare.hook);
+    }
+
+  compare.b_children = compare.a_children + a->n_children;
+
+  list_a = a->children;
+  list_b = b->children;
+  for (i = 0; i < a->n_children; ++i)
+    {
+      compare.a_children[i] = scew_list_data (list_a);
+      compare.b_children[i] = scew_list_data (list_b);
+      list_a = scew_list_next (list_a);
+      list_b = scew_list_next (list_b);
+    }
+
+  /* Stops as soon as a different pair of children is found. */
+  equal = scew_pool_run_ (a->n_children, compare_child_, &compare);
+
+  free (compare.a_children);
+
+  return equal;
+}
+
+unsigned long
+scew_element_hash (scew_element const *element)
+{
+  scew_bool cached = SCEW_FALSE;
+
+  assert (element != NULL);
+
+  return hash_subtree_ (element, &cached);
+}
+
 
 /* Private */
 
@@ -75,8 +166,8 @@ compare_element_ (scew_element const *a, scew_element const *b)
   assert (a != NULL);
   assert (b != NULL);
 
-  equal = (scew_strcmp (a->name, b->name) == 0)
-    && (scew_strcmp (a->contents, b->contents) == 0)
+  equal = scew_xstr_equal_ (&a->name, &b->name)
+    && scew_xstr_equal_ (&a->contents, &b->contents)
     && compare_attributes_ (a, b);
 
   return equal;
@@ -135,3 +226,93 @@ compare_children_ (scew_element const *a,
 
   return equal;
 }
+
+unsigned long
+hash_subtree_ (scew_element const *element, scew_bool *cached)
+{
+  unsigned long hash = 0;
+
+  assert (element != NULL);
+  assert (cached != NULL);
+
+  *cached = scew_element_cached_hash_ (element, &hash);
+  if (!*cached)
+    {
+      /* Hashes are only cached if the ones of all children are too, so
+         modifying a child always invalidates its ancestors' hashes. */
+      hash = hash_element_ (element, cached);
+      *cached = *cached && scew_element_cache_hash_ (element, hash);
+    }
+
+  return hash;
+}
+
+unsigned long
+hash_element_ (scew_element const *element, scew_bool *cached)
+{
+  unsigned long hash = 0;
+  scew_bool child_cached = SCEW_FALSE;
+  scew_list *list = NULL;
+
+  assert (element != NULL);
+  assert (cached != NULL);
+
+  *cached = SCEW_TRUE;
+
+  hash = scew_hash_init_ ();
+  hash = scew_hash_string_ (hash, element->name.data, element->name.len);
+  hash = scew_hash_string_ (hash,
+                            element->contents.data,
+                            element->contents.len);
+
+  hash = scew_hash_word_ (hash, element->n_attributes);
+  list = element->attributes;
+  while (list != NULL)
+    {
+      scew_attribute *attribute = scew_list_data (list);
+      hash = scew_hash_string_ (hash,
+                                attribute->name.data,
+                                attribute->name.len);
+      hash = scew_hash_string_ (hash,
+                                attribute->value.data,
+                                attribute->value.len);
+      list = scew_list_next (list);
+    }
+
+  hash = scew_hash_word_ (hash, element->n_children);
+  list = element->children;
+  while (list != NULL)
+    {
+      scew_element *child = scew_list_data (list);
+      hash = scew_hash_word_ (hash, hash_subtree_ (child, &child_cached));
+      *cached = *cached && child_cached;
+      list = scew_list_next (list);
+    }
+
+  return hash;
+}
+
+scew_bool
+different_hashes_ (scew_element const *a,
+                   scew_element const *b,
+                   scew_element_cmp_hook hook)
+{
+  unsigned long hash_a = 0;
+  unsigned long hash_b = 0;
+
+  /* Structurally different elements have different hashes. */
+  return (compare_element_ == hook)
+    && scew_element_cached_hash_ (a, &hash_a)
+    && scew_element_cached_hash_ (b, &hash_b)
+    && (hash_a != hash_b);
+}
+
+scew_bool
+compare_child_ (void *data, unsigned int index)
+{
+  parallel_compare_ *compare = (parallel_compare_ *) data;
+
+  return scew_element_compare (compare->a_children[index],
+                               compare->b_children[index],
+                               compare->hook);
+}
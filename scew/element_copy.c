@@ -30,16 +30,33 @@
 
 #include "attribute.h"
 
+#include "xerror.h"
+#include "xpool.h"
+
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 
 
 
 /* Private */
 
+/* Data shared by the threads copying an element's children. */
+typedef struct
+{
+  unsigned int n_children;
+  scew_element **children;
+  scew_element **copies;
+} parallel_copy_;
+
+static scew_element* copy_element_ (scew_element const *element);
+static scew_bool copy_child_ (void *data, unsigned int index);
 static scew_bool copy_children_ (scew_element *new_element,
                                  scew_element const *element);
 static scew_bool copy_attributes_ (scew_element *new_element,
                                    scew_element const *element);
+static void copy_caches_ (scew_element *new_element,
+                          scew_element const *element);
 
 
 
@@ -52,18 +69,125 @@ scew_element_copy (scew_element const *element)
 
   assert (element != NULL);
 
+  new_elem = copy_element_ (element);
+
+  if ((new_elem != NULL) && !copy_children_ (new_elem, element))
+    {
+      scew_element_free (new_elem);
+      new_elem = NULL;
+    }
+
+  if (new_elem != NULL)
+    {
+      copy_caches_ (new_elem, element);
+    }
+
+  return new_elem;
+}
+
+scew_element*
+scew_element_copy_parallel (scew_element const *element)
+{
+  parallel_copy_ copy;
+  scew_element *new_elem = NULL;
+  scew_list *list = NULL;
+  scew_bool copied = SCEW_FALSE;
+  unsigned int i = 0;
+
+  assert (element != NULL);
+
+  if (element->n_children < 2)
+    {
+      return scew_element_copy (element);
+    }
+
+  new_elem = copy_element_ (element);
+  if (NULL == new_elem)
+    {
+      return NULL;
+    }
+
+  copy.n_children = element->n_children;
+  copy.children = malloc (copy.n_children * sizeof (scew_element *));
+  copy.copies = calloc (copy.n_children, sizeof (scew_element *));
+
+  copied = (copy.children != NULL) && (copy.copies != NULL);
+  if (copied)
+    {
+      for (i = 0, list = element->children;
+           list != NULL;
+           list = scew_list_next (list))
+        {
+          copy.children[i++] = scew_list_data (list);
+        }
+
+      copied = scew_pool_run_ (copy.n_children, copy_child_, &copy);
+    }
+
+  /* Stitch the copied subtrees back in order. */
+  for (i = 0; copied && (i < copy.n_children); ++i)
+    {
+      copied = (scew_element_add_element (new_elem, copy.copies[i]) != NULL);
+      if (copied)
+        {
+          copy.copies[i] = NULL;
+        }
+    }
+
+  if (!copied)
+    {
+      /* Errors in other threads are not seen by the calling thread. */
+      scew_error_set_last_error_ (scew_error_no_memory);
+
+      for (i = 0; (copy.copies != NULL) && (i < copy.n_children); ++i)
+        {
+          scew_element_free (copy.copies[i]);
+        }
+      scew_element_free (new_elem);
+      new_elem = NULL;
+    }
+  else
+    {
+      copy_caches_ (new_elem, element);
+    }
+
+  free (copy.children);
+  free (copy.copies);
+
+  return new_elem;
+}
+
+
+
+/* Private */
+
+scew_element*
+copy_element_ (scew_element const *element)
+{
+  scew_element *new_elem = NULL;
+
+  assert (element != NULL);
+
   new_elem = calloc (1, sizeof (scew_element));
 
   if (new_elem != NULL)
     {
+      scew_xstr const *contents = &element->contents;
+      scew_xstr const *name = &element->name;
+
       scew_bool copied =
-        ((NULL == element->contents)
-         || (scew_element_set_contents (new_elem, element->contents) != NULL));
+        ((NULL == contents->data)
+         || (scew_xstr_set_ (&new_elem->contents,
+                             contents->data,
+                             contents->len) != NULL))
+        && (scew_xstr_set_ (&new_elem->name, name->data, name->len) != NULL);
+
+      if (!copied)
+        {
+          scew_error_set_last_error_ (scew_error_no_memory);
+        }
 
-      copied = copied
-        && (scew_element_set_name (new_elem, element->name) != NULL)
-        && copy_children_ (new_elem, element)
-        && copy_attributes_ (new_elem, element);
+      copied = copied && copy_attributes_ (new_elem, element);
 
       if (!copied)
         {
@@ -71,13 +195,23 @@ scew_element_copy (scew_element const *element)
           new_elem = NULL;
         }
     }
+  else
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+    }
 
   return new_elem;
 }
 
+scew_bool
+copy_child_ (void *data, unsigned int index)
+{
+  parallel_copy_ *copy = (parallel_copy_ *) data;
 
-
-/* Private */
+  copy->copies[index] = scew_element_copy (copy->children[index]);
+
+  return (copy->copies[index] != NULL);
+}
 
 scew_bool
 copy_children_ (scew_element *new_element, scew_element const *element)
@@ -124,3 +258,48 @@ copy_attributes_ (scew_element *new_element, scew_element const *element)
 
   return copied;
 }
+
+void
+copy_caches_ (scew_element *new_element, scew_element const *element)
+{
+  scew_element_cache_ *cache = scew_element_cache_get_ (element);
+  scew_element_cache_ *new_cache = NULL;
+  scew_element_cache_ *child_cache = NULL;
+  scew_list *item = NULL;
+  unsigned long hash = 0;
+  scew_bool hash_valid = scew_element_cached_hash_ (element, &hash);
+  scew_bool summary_valid = (cache != NULL) && cache->summary_valid;
+
+  /**
+   * The copy is structurally identical, so are its hash and summary,
+   * as long as its children got theirs (adding their caches might
+   * have failed).
+   */
+  for (item = new_element->children;
+       (hash_valid || summary_valid) && (item != NULL);
+       item = scew_list_next (item))
+    {
+      child_cache = scew_element_cache_get_ (scew_list_data (item));
+      hash_valid = hash_valid
+        && (child_cache != NULL) && child_cache->hash_valid;
+      summary_valid = summary_valid
+        && (child_cache != NULL) && child_cache->summary_valid;
+    }
+
+  /* Only elements using hashes or summaries get a cache. */
+  if (hash_valid || summary_valid)
+    {
+      new_cache = scew_element_cache_add_ (new_element);
+    }
+
+  if (new_cache != NULL)
+    {
+      new_cache->hash = hash;
+      new_cache->hash_valid = hash_valid;
+      if (summary_valid)
+        {
+          memcpy (new_cache->summary, cache->summary, SCEW_SUMMARY_BYTES_);
+          new_cache->summary_valid = SCEW_TRUE;
+        }
+    }
+}
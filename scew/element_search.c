@@ -37,6 +37,12 @@
 /* Private */
 
 static scew_bool cmp_name_ (void const *element, void const *name);
+static scew_element const* first_child_ (scew_element const *element,
+                                         scew_element const *root,
+                                         unsigned long key);
+static scew_element const* next_sibling_ (scew_element const *element,
+                                          scew_element const *root,
+                                          unsigned long key);
 
 
 
@@ -99,12 +105,134 @@ scew_element_list_by_name (scew_element const *element, XML_Char const *name)
   return list;
 }
 
+scew_element*
+scew_element_descendant_by_name (scew_element const *element,
+                                 XML_Char const *name)
+{
+  scew_element const *current = NULL;
+  unsigned long key = 0;
+  size_t len = 0;
+
+  assert (element != NULL);
+  assert (name != NULL);
+
+  len = scew_strlen (name);
+  key = scew_element_name_key_ (name, len);
+
+  if (!scew_element_may_contain_ (element, key, SCEW_TRUE))
+    {
+      return NULL;
+    }
+
+  current = first_child_ (element, element, key);
+  while (current != NULL)
+    {
+      if ((current->name.len == len)
+          && (scew_memcmp (current->name.data, name, len) == 0))
+        {
+          return (scew_element *) current;
+        }
+
+      /* Go down if possible, otherwise to the next candidate sibling of
+         the closest ancestor. */
+      if (current->children != NULL)
+        {
+          current = first_child_ (current, element, key);
+        }
+      else
+        {
+          current = next_sibling_ (current, element, key);
+        }
+    }
+
+  return NULL;
+}
+
+scew_bool
+scew_element_may_contain (scew_element const *element, XML_Char const *name)
+{
+  assert (element != NULL);
+  assert (name != NULL);
+
+  return scew_element_may_contain_ (element,
+                                    scew_element_name_key_ (name,
+                                                            scew_strlen (name)),
+                                    SCEW_TRUE);
+}
+
+scew_bool
+scew_element_may_contain_attribute (scew_element const *element,
+                                    XML_Char const *name)
+{
+  size_t len = 0;
+
+  assert (element != NULL);
+  assert (name != NULL);
+
+  len = scew_strlen (name);
+
+  return scew_element_may_contain_ (element,
+                                    scew_element_attribute_key_ (name, len),
+                                    SCEW_TRUE);
+}
+
 
 /* Private */
 
 scew_bool
 cmp_name_ (void const *element, void const *name)
 {
-  return (scew_strcmp (((scew_element *) element)->name,
+  return (scew_strcmp (((scew_element *) element)->name.data,
                        (XML_Char *) name) == 0);
 }
+
+scew_element const*
+first_child_ (scew_element const *element,
+              scew_element const *root,
+              unsigned long key)
+{
+  scew_element const *child = NULL;
+
+  if (NULL == element->children)
+    {
+      return NULL;
+    }
+
+  child = scew_list_data (element->children);
+  if (!scew_element_may_contain_ (child, key, SCEW_TRUE))
+    {
+      /* The next candidate is the same as if the child had no
+         children, which might be outside of the element. */
+      return next_sibling_ (child, root, key);
+    }
+
+  return child;
+}
+
+scew_element const*
+next_sibling_ (scew_element const *element,
+               scew_element const *root,
+               unsigned long key)
+{
+  scew_element const *sibling = NULL;
+  scew_list *item = NULL;
+
+  /* Climb up until we find an ancestor (or the element itself) with a
+     sibling whose subtree may contain the key. */
+  while ((element != NULL) && (element != root))
+    {
+      for (item = scew_list_next (element->myself);
+           item != NULL;
+           item = scew_list_next (item))
+        {
+          sibling = scew_list_data (item);
+          if (scew_element_may_contain_ (sibling, key, SCEW_TRUE))
+            {
+              return sibling;
+            }
+        }
+      element = element->parent;
+    }
+
+  return NULL;
+}
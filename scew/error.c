@@ -52,7 +52,12 @@ scew_error_string (scew_error code)
       _XT("Input/Output error"),
       _XT("Error while calling hook"),
       _XT("Internal Expat parser error"),
-      _XT("Internal SCEW error")
+      _XT("Internal SCEW error"),
+      _XT("Edit script does not apply"),
+      _XT("Invalid query expression"),
+      _XT("Invalid or out of date snapshot"),
+      _XT("Invalid binary document"),
+      _XT("Frozen trees can not be modified")
     };
 
   assert (sizeof(message) / sizeof(message[0]) == scew_error_unknown);
@@ -69,6 +69,11 @@ typedef enum
     scew_error_hook,            /**< Hook returned error. */
     scew_error_expat,           /**< Expat parser error. */
     scew_error_internal,        /**< Internal SCEW error. */
+    scew_error_diff,            /**< Edit script does not apply. */
+    scew_error_query,           /**< Invalid query expression. */
+    scew_error_snapshot,        /**< Invalid or out of date snapshot. */
+    scew_error_binary,          /**< Invalid binary document. */
+    scew_error_frozen,          /**< Frozen trees can not be modified. */
     scew_error_unknown          /**< end of list marker */
   } scew_error;
 
@@ -26,21 +26,11 @@
  * @endif
  **/
 
-#include "list.h"
+#include "xlist.h"
 
 #include <assert.h>
 #include <stdlib.h>
 
-
-/* Private */
-
-struct scew_list
-{
-  void *data;
-  scew_list *prev;
-  scew_list *next;
-};
-
 
 /* Public */
 
@@ -141,6 +131,30 @@ scew_list_prepend (scew_list *list, void *data)
   return item;
 }
 
+scew_list*
+scew_list_insert (scew_list *item, void *data)
+{
+  scew_list *new_item = NULL;
+
+  assert (item != NULL);
+  assert (data != NULL);
+
+  new_item = scew_list_create (data);
+
+  if (new_item != NULL)
+    {
+      new_item->prev = item->prev;
+      new_item->next = item;
+      if (item->prev != NULL)
+        {
+          item->prev->next = new_item;
+        }
+      item->prev = new_item;
+    }
+
+  return new_item;
+}
+
 scew_list*
 scew_list_delete (scew_list *list, void *data)
 {
@@ -170,6 +184,7 @@ scew_list_delete (scew_list *list, void *data)
             {
               list = list->next;
             }
+          free (tmp);
           break;
         }
     }
@@ -174,6 +174,20 @@ extern SCEW_API scew_list* scew_list_append (scew_list *list, void *data);
  */
 extern SCEW_API scew_list* scew_list_prepend (scew_list *list, void *data);
 
+/**
+ * Creates a new list item with the given @a data and inserts it right
+ * before the given @a item, which might be in the middle of a list.
+ *
+ * @pre item != NULL
+ * @pre data != NULL
+ *
+ * @return the item inserted before @a item or NULL if an item could
+ * not be created.
+ *
+ * @ingroup SCEWListMod
+ */
+extern SCEW_API scew_list* scew_list_insert (scew_list *item, void *data);
+
 /**
  * Deletes the first item pointing to @a data from the given @a
  * list. This function will search from the given item list, not from
@@ -30,6 +30,7 @@
 
 #include "xparser.h"
 #include "xerror.h"
+#include "xscan.h"
 
 #include "tree.h"
 #include "str.h"
@@ -157,6 +158,7 @@ scew_parser_reset (scew_parser *parser)
   parser->tree = NULL;
   parser->preamble = NULL;
   parser->stack = NULL;
+  parser->tree_loaded = SCEW_FALSE;
 }
 
 void
@@ -294,7 +296,7 @@ parse_buffer_ (scew_parser *parser,
   scew_bool result = SCEW_TRUE;
   size_t byte_no = size * sizeof (XML_Char);
 
-  if (done || !scew_isempty (buffer))
+  if (done || (scew_scan_lspace_ (buffer, size) < size))
     {
       if (!XML_Parse (parser->parser, (char *) buffer, byte_no, done))
         {
@@ -342,6 +344,7 @@ parse_stream_buffer_ (scew_parser *parser, XML_Char const *buffer, size_t size)
   unsigned int start = 0;
   unsigned int end = 0;
   unsigned int length = 0;
+  unsigned int spaces = 0;
 
   assert(parser != NULL);
   assert(buffer != NULL);
@@ -369,11 +372,9 @@ parse_stream_buffer_ (scew_parser *parser, XML_Char const *buffer, size_t size)
        */
       if (!parser->parsing_started && (parser->stack == NULL))
         {
-          while ((start < size) && scew_isspace (buffer[start]))
-            {
-              start += 1;
-              end += 1;
-            }
+          spaces = scew_scan_lspace_ (buffer + start, size - start);
+          start += spaces;
+          end += spaces;
         }
 
       if ((end == size) || (buffer[end] == _XT('>')))
@@ -389,9 +390,7 @@ parse_stream_buffer_ (scew_parser *parser, XML_Char const *buffer, size_t size)
               return SCEW_FALSE;
             }
 
-          if ((parser->tree != NULL)
-              && (scew_tree_root (parser->tree) != NULL)
-              && (NULL == parser->stack))
+          if (parser->tree_loaded)
             {
               /* Tell Expat we're done. */
               if (!parse_buffer_ (parser, _XT(""), 0, SCEW_TRUE))
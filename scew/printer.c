@@ -29,10 +29,14 @@
 #include "printer.h"
 
 #include "xerror.h"
+#include "xpool.h"
+#include "xscan.h"
 
 #include "str.h"
+#include "writer_buffer.h"
 
 #include <assert.h>
+#include <stdlib.h>
 
 
 /* Private */
@@ -44,25 +48,88 @@
 #define STR_YES_        _XT("yes")
 #define STR_NO_         _XT("no")
 
+/* Number of characters of a string literal (without '\0'). */
+#define STR_LEN_(str)   ((sizeof (str) / sizeof (XML_Char)) - 1)
+
+/* Write a string literal without computing its length at runtime. */
+#define print_literal_(printer, str) print_write_ (printer, str, STR_LEN_ (str))
+
 enum
   {
-    DEFAULT_INDENT_SPACES_ = 3  /**< Default number of indent spaces */
+    DEFAULT_INDENT_SPACES_ = 3, /**< Default number of indent spaces */
+    BUFFER_SIZE_ = 1024,        /**< Characters collected before writing */
+    MAX_PARALLEL_TASKS_ = 256,  /**< Chunks of children printed in parallel */
+    MAX_SPANS_ = 64,            /**< Spans collected before writing */
+    MIN_SPAN_ = 64              /**< Shorter data is copied into the buffer */
   };
 
+/*
+ * Printed data is collected in a buffer and sent to the writer when
+ * the buffer is full or when the outermost public printing function
+ * returns, so writers are called once per buffer instead of once per
+ * tag, name and attribute.
+ *
+ * If the writer supports vectored output, long names, values and
+ * contents are not copied: spans pointing to the tree's own strings
+ * are collected instead, between spans of the buffer, and all of them
+ * are written at once. The tree can not change while it is printed,
+ * so the spans are valid until they are written.
+ */
 struct scew_printer
 {
   scew_bool indented;
   unsigned int indent;
   unsigned int spaces;
   scew_writer *writer;
+  unsigned int nesting;         /**< Public printing calls in progress */
+  size_t used;                  /**< Characters in the buffer */
+  XML_Char buffer[BUFFER_SIZE_];
+  scew_bool measuring;          /**< Only count characters, do not write */
+  size_t measured;              /**< Characters counted while measuring */
+  scew_bool vectored;           /**< Whether spans are collected */
+  size_t n_spans;               /**< Spans collected */
+  scew_writer_span spans[MAX_SPANS_];
 };
 
-static scew_bool print_write_ (scew_printer *printer, XML_Char const *data);
+/*
+ * Data shared by the threads printing an element's children. Children
+ * are split in consecutive chunks, each one printed into its own
+ * memory buffer.
+ */
+typedef struct
+{
+  scew_printer const *printer;
+  unsigned int n_children;
+  scew_element **children;
+  unsigned int n_tasks;
+  XML_Char **buffers;
+  size_t *lengths;
+} parallel_print_;
+
+static scew_bool print_declaration_ (scew_printer *printer,
+                                     scew_tree const *tree);
+static scew_bool print_contents_ (scew_printer *printer,
+                                  scew_element const *element);
+static scew_bool print_children_task_ (void *data, unsigned int index);
+static void measure_begin_ (scew_printer *printer);
+static size_t measure_end_ (scew_printer *printer);
+static void print_begin_ (scew_printer *printer);
+static scew_bool print_end_ (scew_printer *printer, scew_bool result);
+static scew_bool print_flush_ (scew_printer *printer);
+static scew_bool print_write_ (scew_printer *printer,
+                               XML_Char const *data,
+                               size_t len);
+static scew_bool print_span_ (scew_printer *printer,
+                              XML_Char const *data,
+                              size_t len);
+static scew_bool print_string_ (scew_printer *printer, XML_Char const *data);
 static scew_bool print_pi_start_ (scew_printer *printer, XML_Char const *pi);
 static scew_bool print_pi_end_ (scew_printer *printer);
 static scew_bool print_attribute_ (scew_printer *printer,
-                                   XML_Char const* name,
-                                   XML_Char const* value);
+                                   XML_Char const *name,
+                                   size_t name_len,
+                                   XML_Char const *value,
+                                   size_t value_len);
 static scew_bool print_eol_ (scew_printer *printer);
 static scew_bool print_current_indent_ (scew_printer *printer);
 static scew_bool print_next_indent_ (scew_printer *printer);
@@ -73,7 +140,9 @@ static scew_bool print_element_start_ (scew_printer *printer,
 static scew_bool print_element_end_ (scew_printer *printer,
                                      scew_element const *element);
 static scew_bool print_escaped_ (scew_printer *printer,
-                                 XML_Char const *string);
+                                 XML_Char const *string,
+                                 size_t len);
+static scew_bool print_entity_ (scew_printer *printer, XML_Char chr);
 
 
 /* Public */
@@ -141,57 +210,83 @@ scew_bool
 scew_printer_print_tree (scew_printer *printer, scew_tree const *tree)
 {
   scew_bool result = SCEW_TRUE;
-  XML_Char const *version = NULL;
-  XML_Char const *encoding = NULL;
-  XML_Char const *preamble = NULL;
-  scew_tree_standalone standalone = scew_tree_standalone_unknown;
 
   assert (printer != NULL);
   assert (tree != NULL);
 
-  version = scew_tree_xml_version (tree);
-  encoding = scew_tree_xml_encoding (tree);
-  standalone = scew_tree_xml_standalone (tree);
-  preamble = scew_tree_xml_preamble (tree);
+  print_begin_ (printer);
 
-  /* Start XML declaration. */
-  result = print_pi_start_ (printer, STR_XML_);
-  result = result && print_attribute_ (printer, STR_VERSION_, version);
+  result = print_declaration_ (printer, tree);
 
-  if (encoding)
+  /* Print XML document. */
+  result = result && scew_printer_print_element (printer,
+                                                 scew_tree_root (tree));
+
+  result = print_end_ (printer, result);
+
+  if (!result)
     {
-      result = result && print_attribute_ (printer, STR_ENCODING_, encoding);
+      scew_error_set_last_error_ (scew_error_io);
     }
 
+  return result;
+}
+
+scew_bool
+scew_printer_print_tree_parallel (scew_printer *printer,
+                                  scew_tree const *tree)
+{
+  scew_bool result = SCEW_TRUE;
+  scew_bool printed = SCEW_TRUE;
+
+  assert (printer != NULL);
+  assert (tree != NULL);
+
+  print_begin_ (printer);
+
+  result = print_declaration_ (printer, tree);
+
+  /* Print XML document (which sets its own errors). */
   if (result)
     {
-      switch (standalone)
-        {
-        case scew_tree_standalone_unknown:
-          break;
-        case scew_tree_standalone_no:
-          result = print_attribute_ (printer, STR_STANDALONE_, STR_NO_);
-          break;
-        case scew_tree_standalone_yes:
-          result = print_attribute_ (printer, STR_STANDALONE_, STR_YES_);
-          break;
-        };
+      printed = scew_printer_print_element_parallel (printer,
+                                                     scew_tree_root (tree));
+      result = printed;
     }
 
-  /* End XML declaration. */
-  result = result && print_pi_end_ (printer) && print_eol_ (printer);
+  result = print_end_ (printer, result);
 
-  /* XML preamble (DOCTYPE...). */
-  if (preamble != NULL)
+  if (!result && printed)
     {
-      result = result && print_write_ (printer, preamble);
-      result = result && print_eol_ (printer);
+      scew_error_set_last_error_ (scew_error_io);
+    }
+
+  return result;
+}
+
+scew_bool
+scew_printer_print_element (scew_printer *printer, scew_element const *element)
+{
+  scew_bool result = SCEW_TRUE;
+  scew_bool closed = SCEW_TRUE;
+
+  assert (printer != NULL);
+  assert (element != NULL);
+
+  print_begin_ (printer);
+
+  result = print_element_start_ (printer, element, &closed);
+
+  if (!closed)
+    {
+      result = result && print_contents_ (printer, element);
+      result = result && scew_printer_print_element_children (printer,
+                                                              element);
+      result = result && print_element_end_ (printer, element);
       result = result && print_eol_ (printer);
     }
 
-  /* Print XML document. */
-  result = result && scew_printer_print_element (printer,
-                                                 scew_tree_root (tree));
+  result = print_end_ (printer, result);
 
   if (!result)
     {
@@ -202,53 +297,88 @@ scew_printer_print_tree (scew_printer *printer, scew_tree const *tree)
 }
 
 scew_bool
-scew_printer_print_element (scew_printer *printer, scew_element const *element)
+scew_printer_print_element_parallel (scew_printer *printer,
+                                     scew_element const *element)
 {
+  parallel_print_ print;
+  scew_list *list = NULL;
+  scew_bool rendered = SCEW_FALSE;
   scew_bool result = SCEW_TRUE;
   scew_bool closed = SCEW_TRUE;
+  unsigned int i = 0;
 
   assert (printer != NULL);
   assert (element != NULL);
 
-  result = print_element_start_ (printer, element, &closed);
+  print.n_children = scew_element_count (element);
+  if (print.n_children < 2)
+    {
+      return scew_printer_print_element (printer, element);
+    }
 
-  if (!closed)
+  print.printer = printer;
+  print.n_tasks = (print.n_children < MAX_PARALLEL_TASKS_)
+    ? print.n_children : MAX_PARALLEL_TASKS_;
+  print.children = malloc (print.n_children * sizeof (scew_element *));
+  print.buffers = calloc (print.n_tasks, sizeof (XML_Char *));
+  print.lengths = calloc (print.n_tasks, sizeof (size_t));
+
+  /* Children are printed into memory first, the element comes later. */
+  rendered = (print.children != NULL) && (print.buffers != NULL)
+    && (print.lengths != NULL);
+  if (rendered)
+    {
+      for (i = 0, list = scew_element_children (element);
+           list != NULL;
+           list = scew_list_next (list))
+        {
+          print.children[i++] = scew_list_data (list);
+        }
+
+      rendered = scew_pool_run_ (print.n_tasks, print_children_task_, &print);
+    }
+
+  if (rendered)
     {
-      XML_Char const *contents = scew_element_contents (element);
+      print_begin_ (printer);
 
-      if (contents != NULL)
+      result = print_element_start_ (printer, element, &closed);
+      result = result && print_contents_ (printer, element);
+
+      /* Stitch the printed children back in order. */
+      for (i = 0; result && (i < print.n_tasks); ++i)
         {
-          unsigned int children_no = scew_element_count (element);
-
-          /* Only indent contents if we have children elements. */
-          if (children_no > 0)
-            {
-              result = result && print_next_indent_ (printer);
-            }
-
-          /* Only write contents if non zero-length string. */
-          if (scew_strlen (contents) > 0)
-            {
-              result = result && print_escaped_ (printer, contents);
-            }
-
-          if (children_no > 0)
-            {
-              result = result && print_eol_ (printer);
-            }
+          result = print_write_ (printer, print.buffers[i], print.lengths[i]);
         }
 
-      result = result && scew_printer_print_element_children (printer,
-                                                              element);
       result = result && print_element_end_ (printer, element);
       result = result && print_eol_ (printer);
+
+      /* Spans must not point to the printed children once freed. */
+      result = result && print_flush_ (printer);
+
+      result = print_end_ (printer, result);
     }
 
-  if (!result)
+  if (!rendered)
+    {
+      /* Errors in other threads are not seen by the calling thread. */
+      scew_error_set_last_error_ (scew_error_no_memory);
+      result = SCEW_FALSE;
+    }
+  else if (!result)
     {
       scew_error_set_last_error_ (scew_error_io);
     }
 
+  for (i = 0; (print.buffers != NULL) && (i < print.n_tasks); ++i)
+    {
+      free (print.buffers[i]);
+    }
+  free (print.children);
+  free (print.buffers);
+  free (print.lengths);
+
   return result;
 }
 
@@ -265,6 +395,8 @@ scew_printer_print_element_children (scew_printer *printer,
 
   indent = printer->indent;
 
+  print_begin_ (printer);
+
   list = scew_element_children (element);
   while (result && (list != NULL))
     {
@@ -278,6 +410,8 @@ scew_printer_print_element_children (scew_printer *printer,
 
   printer->indent = indent;
 
+  result = print_end_ (printer, result);
+
   if (!result)
     {
       scew_error_set_last_error_ (scew_error_io);
@@ -297,6 +431,8 @@ scew_printer_print_element_attributes (scew_printer *printer,
   assert (printer != NULL);
   assert (element != NULL);
 
+  print_begin_ (printer);
+
   list = scew_element_attributes (element);
   while (result && (list != NULL))
     {
@@ -305,6 +441,8 @@ scew_printer_print_element_attributes (scew_printer *printer,
       list = scew_list_next (list);
     }
 
+  result = print_end_ (printer, result);
+
   if (!result)
     {
       scew_error_set_last_error_ (scew_error_io);
@@ -322,9 +460,15 @@ scew_printer_print_attribute (scew_printer *printer,
   assert (printer != NULL);
   assert (attribute != NULL);
 
+  print_begin_ (printer);
+
   result = print_attribute_ (printer,
                              scew_attribute_name (attribute),
-                             scew_attribute_value (attribute));
+                             scew_attribute_name_len (attribute),
+                             scew_attribute_value (attribute),
+                             scew_attribute_value_len (attribute));
+
+  result = print_end_ (printer, result);
 
   if (!result)
     {
@@ -334,54 +478,375 @@ scew_printer_print_attribute (scew_printer *printer,
   return result;
 }
 
+size_t
+scew_printer_measure_tree (scew_printer *printer, scew_tree const *tree)
+{
+  assert (printer != NULL);
+  assert (tree != NULL);
+
+  measure_begin_ (printer);
+  scew_printer_print_tree (printer, tree);
+
+  return measure_end_ (printer);
+}
+
+size_t
+scew_printer_measure_element (scew_printer *printer,
+                              scew_element const *element)
+{
+  assert (printer != NULL);
+  assert (element != NULL);
+
+  measure_begin_ (printer);
+  scew_printer_print_element (printer, element);
+
+  return measure_end_ (printer);
+}
+
 
 
 /* Private */
 
 scew_bool
-print_write_ (scew_printer *printer, XML_Char const *data)
+print_declaration_ (scew_printer *printer, scew_tree const *tree)
+{
+  scew_bool result = SCEW_TRUE;
+  XML_Char const *version = NULL;
+  XML_Char const *encoding = NULL;
+  XML_Char const *preamble = NULL;
+  scew_tree_standalone standalone = scew_tree_standalone_unknown;
+
+  version = scew_tree_xml_version (tree);
+  encoding = scew_tree_xml_encoding (tree);
+  standalone = scew_tree_xml_standalone (tree);
+  preamble = scew_tree_xml_preamble (tree);
+
+  /* Start XML declaration. */
+  result = print_pi_start_ (printer, STR_XML_);
+  result = result && print_attribute_ (printer,
+                                       STR_VERSION_,
+                                       STR_LEN_ (STR_VERSION_),
+                                       version,
+                                       scew_strlen (version));
+
+  if (encoding)
+    {
+      result = result && print_attribute_ (printer,
+                                           STR_ENCODING_,
+                                           STR_LEN_ (STR_ENCODING_),
+                                           encoding,
+                                           scew_strlen (encoding));
+    }
+
+  if (result)
+    {
+      switch (standalone)
+        {
+        case scew_tree_standalone_unknown:
+          break;
+        case scew_tree_standalone_no:
+          result = print_attribute_ (printer,
+                                     STR_STANDALONE_,
+                                     STR_LEN_ (STR_STANDALONE_),
+                                     STR_NO_,
+                                     STR_LEN_ (STR_NO_));
+          break;
+        case scew_tree_standalone_yes:
+          result = print_attribute_ (printer,
+                                     STR_STANDALONE_,
+                                     STR_LEN_ (STR_STANDALONE_),
+                                     STR_YES_,
+                                     STR_LEN_ (STR_YES_));
+          break;
+        };
+    }
+
+  /* End XML declaration. */
+  result = result && print_pi_end_ (printer) && print_eol_ (printer);
+
+  /* XML preamble (DOCTYPE...). */
+  if (preamble != NULL)
+    {
+      result = result && print_string_ (printer, preamble);
+      result = result && print_eol_ (printer);
+      result = result && print_eol_ (printer);
+    }
+
+  return result;
+}
+
+scew_bool
+print_contents_ (scew_printer *printer, scew_element const *element)
+{
+  scew_bool result = SCEW_TRUE;
+  XML_Char const *contents = scew_element_contents (element);
+
+  if (contents != NULL)
+    {
+      unsigned int children_no = scew_element_count (element);
+      size_t contents_len = scew_element_contents_len (element);
+
+      /* Only indent contents if we have children elements. */
+      if (children_no > 0)
+        {
+          result = print_next_indent_ (printer);
+        }
+
+      /* Only write contents if non zero-length string. */
+      if (contents_len > 0)
+        {
+          result = result && print_escaped_ (printer,
+                                             contents,
+                                             contents_len);
+        }
+
+      if (children_no > 0)
+        {
+          result = result && print_eol_ (printer);
+        }
+    }
+
+  return result;
+}
+
+scew_bool
+print_children_task_ (void *data, unsigned int index)
+{
+  parallel_print_ *print = data;
+  scew_writer *writer = NULL;
+  scew_printer *printer = NULL;
+  scew_bool result = SCEW_FALSE;
+  unsigned int chunk = 0;
+  unsigned int first = 0;
+  unsigned int last = 0;
+  unsigned int i = 0;
+
+  chunk = (print->n_children + print->n_tasks - 1) / print->n_tasks;
+  first = index * chunk;
+  last = (first + chunk < print->n_children) ? first + chunk
+    : print->n_children;
+
+  writer = scew_writer_memory_create ();
+  printer = (writer != NULL) ? scew_printer_create (writer) : NULL;
+
+  if (printer != NULL)
+    {
+      /* Children are one level deeper than their parent. */
+      printer->indented = print->printer->indented;
+      printer->spaces = print->printer->spaces;
+      printer->indent = print->printer->indent + 1;
+
+      print_begin_ (printer);
+
+      result = SCEW_TRUE;
+      for (i = first; result && (i < last); ++i)
+        {
+          result = scew_printer_print_element (printer, print->children[i]);
+        }
+
+      result = print_end_ (printer, result);
+
+      if (result)
+        {
+          print->buffers[index] =
+            scew_writer_memory_steal (writer, &print->lengths[index]);
+          result = (print->buffers[index] != NULL);
+        }
+    }
+
+  scew_printer_free (printer);
+  scew_writer_free (writer);
+
+  return result;
+}
+
+/*
+ * Measuring runs the same printing code, so the result is always
+ * exact, but characters are only counted when written.
+ */
+void
+measure_begin_ (scew_printer *printer)
+{
+  printer->measuring = SCEW_TRUE;
+  printer->measured = 0;
+}
+
+size_t
+measure_end_ (scew_printer *printer)
+{
+  printer->measuring = SCEW_FALSE;
+
+  return printer->measured;
+}
+
+void
+print_begin_ (scew_printer *printer)
+{
+  if (0 == printer->nesting)
+    {
+      printer->vectored = scew_writer_vectored (printer->writer);
+    }
+
+  printer->nesting += 1;
+}
+
+scew_bool
+print_end_ (scew_printer *printer, scew_bool result)
+{
+  printer->nesting -= 1;
+
+  /* Nothing is left behind once the outermost call returns. */
+  if (0 == printer->nesting)
+    {
+      result = result && print_flush_ (printer);
+      printer->used = 0;
+      printer->n_spans = 0;
+    }
+
+  return result;
+}
+
+scew_bool
+print_flush_ (scew_printer *printer)
+{
+  size_t used = printer->used;
+  size_t n_spans = printer->n_spans;
+  size_t char_no = 0;
+  size_t i = 0;
+
+  printer->used = 0;
+  printer->n_spans = 0;
+
+  /* When spans are collected, the buffer is already one of them. */
+  if (n_spans > 0)
+    {
+      for (i = 0; i < n_spans; ++i)
+        {
+          char_no += printer->spans[i].char_no;
+        }
+      return (scew_writer_writev (printer->writer, printer->spans, n_spans)
+              == char_no);
+    }
+
+  return (0 == used)
+    || (scew_writer_write (printer->writer, printer->buffer, used) == used);
+}
+
+scew_bool
+print_write_ (scew_printer *printer, XML_Char const *data, size_t len)
+{
+  if (printer->measuring)
+    {
+      printer->measured += len;
+      return SCEW_TRUE;
+    }
+
+  if (printer->vectored)
+    {
+      return print_span_ (printer, data, len);
+    }
+
+  if ((len > BUFFER_SIZE_ - printer->used) && !print_flush_ (printer))
+    {
+      return SCEW_FALSE;
+    }
+
+  /* Large data does not need to be collected. */
+  if (len >= BUFFER_SIZE_)
+    {
+      return (scew_writer_write (printer->writer, data, len) == len);
+    }
+
+  scew_memcpy (printer->buffer + printer->used, data, len);
+  printer->used += len;
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+print_span_ (scew_printer *printer, XML_Char const *data, size_t len)
 {
-  scew_writer *writer = printer->writer;
+  scew_writer_span *span = NULL;
+  scew_bool copied = (len < MIN_SPAN_);
+
+  if (0 == len)
+    {
+      return SCEW_TRUE;
+    }
+
+  if (((MAX_SPANS_ == printer->n_spans)
+       || (copied && (len > BUFFER_SIZE_ - printer->used)))
+      && !print_flush_ (printer))
+    {
+      return SCEW_FALSE;
+    }
+
+  /* Short data is cheaper to copy than to write on its own. */
+  if (copied)
+    {
+      scew_memcpy (printer->buffer + printer->used, data, len);
+      data = printer->buffer + printer->used;
+      printer->used += len;
+
+      span = (printer->n_spans > 0)
+        ? &printer->spans[printer->n_spans - 1] : NULL;
+      if ((span != NULL) && (span->buffer + span->char_no == data))
+        {
+          span->char_no += len;
+          return SCEW_TRUE;
+        }
+    }
 
-  size_t len = scew_strlen (data);
+  span = &printer->spans[printer->n_spans];
+  span->buffer = data;
+  span->char_no = len;
+  printer->n_spans += 1;
 
-  return (scew_writer_write (writer, data, len) == len);
+  return SCEW_TRUE;
+}
+
+scew_bool
+print_string_ (scew_printer *printer, XML_Char const *data)
+{
+  return print_write_ (printer, data, scew_strlen (data));
 }
 
 scew_bool
 print_pi_start_ (scew_printer *printer, XML_Char const *pi)
 {
-  static XML_Char const *PI_START = _XT("<?");
+  static XML_Char const PI_START[] = _XT("<?");
 
-  return print_write_ (printer, PI_START) && print_write_ (printer, pi);
+  return print_literal_ (printer, PI_START) && print_string_ (printer, pi);
 }
 
 scew_bool
 print_pi_end_ (scew_printer *printer)
 {
-  static XML_Char const *PI_END = _XT("?>");
+  static XML_Char const PI_END[] = _XT("?>");
 
-  return print_write_ (printer, PI_END) && print_eol_ (printer);
+  return print_literal_ (printer, PI_END) && print_eol_ (printer);
 }
 
 scew_bool
 print_attribute_ (scew_printer *printer,
-                  XML_Char const* name,
-                  XML_Char const* value)
+                  XML_Char const *name,
+                  size_t name_len,
+                  XML_Char const *value,
+                  size_t value_len)
 {
   scew_bool result = SCEW_FALSE;
 
-  result = print_write_ (printer, _XT(" "));
-  result = result && print_write_ (printer, name);
-  result = result && print_write_ (printer, _XT("=\""));
+  result = print_literal_ (printer, _XT(" "));
+  result = result && print_write_ (printer, name, name_len);
+  result = result && print_literal_ (printer, _XT("=\""));
 
   /* It is possible that an attribute's value is empty. */
-  if (scew_strlen (value) > 0)
+  if (value_len > 0)
     {
-      result = result && print_escaped_ (printer, value);
+      result = result && print_escaped_ (printer, value, value_len);
     }
 
-  result = result && print_write_ (printer, _XT("\""));
+  result = result && print_literal_ (printer, _XT("\""));
 
   return result;
 }
@@ -395,7 +860,7 @@ print_eol_ (scew_printer *printer)
 
   if (printer->indented)
     {
-      result = print_write_ (printer, _XT("\n"));
+      result = print_literal_ (printer, _XT("\n"));
     }
 
   return result;
@@ -422,11 +887,15 @@ print_indent_ (scew_printer *printer, unsigned int indent)
 
   if (printer->indented)
     {
-      unsigned int i = 0;
-      unsigned int spaces = indent * printer->spaces;
-      for (i = 0; result && (i < spaces); ++i)
+      static XML_Char const SPACES[] = _XT("                                ");
+
+      size_t spaces = indent * printer->spaces;
+      size_t len = 0;
+      while (result && (spaces > 0))
         {
-          result = print_write_ (printer, _XT(" "));
+          len = (spaces < STR_LEN_ (SPACES)) ? spaces : STR_LEN_ (SPACES);
+          result = print_write_ (printer, SPACES, len);
+          spaces -= len;
         }
     }
 
@@ -438,13 +907,12 @@ print_element_start_ (scew_printer *printer,
                       scew_element const *element,
                       scew_bool *closed)
 {
-  static XML_Char const *START = _XT("<");
-  static XML_Char const *END_1 = _XT(">");
-  static XML_Char const *END_2 = _XT("/>");
+  static XML_Char const START[] = _XT("<");
+  static XML_Char const END_1[] = _XT(">");
+  static XML_Char const END_2[] = _XT("/>");
 
   scew_list *list = NULL;
   XML_Char const *name = NULL;
-  XML_Char const *contents = NULL;
   scew_bool result = SCEW_TRUE;
 
   assert (printer != NULL);
@@ -453,23 +921,23 @@ print_element_start_ (scew_printer *printer,
   name = scew_element_name (element);
 
   result = print_current_indent_ (printer);
-  result = result && print_write_ (printer, START);
-  result = result && print_write_ (printer, name);
+  result = result && print_literal_ (printer, START);
+  result = result && print_write_ (printer,
+                                   name,
+                                   scew_element_name_len (element));
   result = result && scew_printer_print_element_attributes (printer, element);
 
-  contents = scew_element_contents (element);
-
   *closed = SCEW_FALSE;
   list = scew_element_children (element);
-  if (((NULL == contents) || (scew_strlen (contents) == 0)) && (NULL == list))
+  if ((0 == scew_element_contents_len (element)) && (NULL == list))
     {
-      result = result && print_write_ (printer, END_2);
+      result = result && print_literal_ (printer, END_2);
       result = result && print_eol_ (printer);
       *closed = SCEW_TRUE;
     }
   else
     {
-      result = result && print_write_ (printer, END_1);
+      result = result && print_literal_ (printer, END_1);
       if (list != NULL)
         {
           result = result && print_eol_ (printer);
@@ -482,8 +950,8 @@ print_element_start_ (scew_printer *printer,
 scew_bool
 print_element_end_ (scew_printer *printer, scew_element const *element)
 {
-  static XML_Char const *START = _XT("</");
-  static XML_Char const *END = _XT(">");
+  static XML_Char const START[] = _XT("</");
+  static XML_Char const END[] = _XT(">");
 
   scew_bool result = SCEW_TRUE;
 
@@ -495,25 +963,67 @@ print_element_end_ (scew_printer *printer, scew_element const *element)
     {
       result = print_current_indent_ (printer);
     }
-  result = result && print_write_ (printer, START);
-  result = result && print_write_ (printer, name);
-  result = result && print_write_ (printer, END);
+  result = result && print_literal_ (printer, START);
+  result = result && print_write_ (printer,
+                                   name,
+                                   scew_element_name_len (element));
+  result = result && print_literal_ (printer, END);
 
   return result;
 }
 
 scew_bool
-print_escaped_ (scew_printer *printer, XML_Char const *string)
+print_escaped_ (scew_printer *printer, XML_Char const *string, size_t len)
 {
   scew_bool result = SCEW_TRUE;
+  size_t span = 0;
+
+  /*
+   * Characters that do not need to be escaped (usually all of them)
+   * are written in spans, directly from the given string.
+   */
+  while (result && (len > 0))
+    {
+      span = scew_scan_escape_ (string, len);
+      result = print_write_ (printer, string, span);
+      if (result && (span < len))
+        {
+          result = print_entity_ (printer, string[span]);
+          span += 1;
+        }
+      string += span;
+      len -= span;
+    }
 
-  /* Get escaped string. */
-  XML_Char *escaped = scew_strescape (string);
+  return result;
+}
 
-  result = print_write_ (printer, escaped);
+scew_bool
+print_entity_ (scew_printer *printer, XML_Char chr)
+{
+  scew_bool result = SCEW_TRUE;
 
-  /* Free escaped string. */
-  free (escaped);
+  switch (chr)
+    {
+    case _XT('<'):
+      result = print_literal_ (printer, _XT("&lt;"));
+      break;
+    case _XT('>'):
+      result = print_literal_ (printer, _XT("&gt;"));
+      break;
+    case _XT('&'):
+      result = print_literal_ (printer, _XT("&amp;"));
+      break;
+    case _XT('\''):
+      result = print_literal_ (printer, _XT("&apos;"));
+      break;
+    case _XT('"'):
+      result = print_literal_ (printer, _XT("&quot;"));
+      break;
+    default:
+      result = print_write_ (printer, &chr, 1);
+      break;
+    }
 
   return result;
 }
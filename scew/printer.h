@@ -180,6 +180,24 @@ extern SCEW_API scew_writer* scew_printer_set_writer (scew_printer *printer,
 extern SCEW_API scew_bool scew_printer_print_tree (scew_printer *printer,
                                                    scew_tree const *tree);
 
+/**
+ * Prints the given SCEW @a tree to the specified @a printer in the
+ * same way #scew_printer_print_tree does (the output is exactly the
+ * same), but the children of the root element are printed in
+ * parallel (see #scew_printer_print_element_parallel).
+ *
+ * @pre printer != NULL
+ * @pre tree != NULL
+ *
+ * @param printer the printer to be used for printing data.
+ * @param tree the SCEW tree to print.
+ *
+ * @ingroup SCEWPrinterOutput
+ */
+extern SCEW_API scew_bool
+scew_printer_print_tree_parallel (scew_printer *printer,
+                                  scew_tree const *tree);
+
 /**
  * Prints the given SCEW @a element to the specified @a printer. This
  * will print the element (with its attributes) and all its children
@@ -197,6 +215,29 @@ extern SCEW_API scew_bool
 scew_printer_print_element (scew_printer *printer,
                             scew_element const *element);
 
+/**
+ * Prints the given SCEW @a element to the specified @a printer in the
+ * same way #scew_printer_print_element does (the output is exactly
+ * the same), but the children of the element (and their subtrees) are
+ * printed in parallel into memory, using as many threads as
+ * processors are available, and then written in order. This is only
+ * worth it for large elements with many children, and needs as much
+ * memory as the printed children.
+ *
+ * The given element must not be modified while it is being printed.
+ *
+ * @pre printer != NULL
+ * @pre element != NULL
+ *
+ * @param printer the printer to be used for printing data.
+ * @param element the SCEW element to print.
+ *
+ * @ingroup SCEWPrinterOutput
+ */
+extern SCEW_API scew_bool
+scew_printer_print_element_parallel (scew_printer *printer,
+                                     scew_element const *element);
+
 /**
  * Prints the given SCEW @a element children to the specified @a
  * printer. This will print the element children recursively.
@@ -249,6 +290,45 @@ extern SCEW_API scew_bool
 scew_printer_print_attribute (scew_printer *printer,
                               scew_attribute const *attribute);
 
+/**
+ * Tells how many characters #scew_printer_print_tree would print for
+ * the given @a tree with the current settings (e.g. indentation) of
+ * the given @a printer, without printing anything. This can be used
+ * to allocate or reserve the exact space needed before printing.
+ *
+ * @pre printer != NULL
+ * @pre tree != NULL
+ *
+ * @param printer the printer whose settings are used.
+ * @param tree the SCEW tree to measure.
+ *
+ * @return the number of characters the tree would be printed with.
+ *
+ * @ingroup SCEWPrinterOutput
+ */
+extern SCEW_API size_t scew_printer_measure_tree (scew_printer *printer,
+                                                  scew_tree const *tree);
+
+/**
+ * Tells how many characters #scew_printer_print_element would print
+ * for the given @a element with the current settings (e.g.
+ * indentation) of the given @a printer, without printing anything.
+ *
+ * @pre printer != NULL
+ * @pre element != NULL
+ *
+ * @param printer the printer whose settings are used.
+ * @param element the SCEW element to measure.
+ *
+ * @return the number of characters the element would be printed
+ * with.
+ *
+ * @ingroup SCEWPrinterOutput
+ */
+extern SCEW_API size_t
+scew_printer_measure_element (scew_printer *printer,
+                              scew_element const *element);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,1004 @@
+/**
+ * @file     query.c
+ * @brief    query.h implementation
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 15:40
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "query.h"
+
+#include "xattribute.h"
+#include "xelement.h"
+#include "xerror.h"
+#include "xtree.h"
+
+#include "str.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/* Private */
+
+enum
+  {
+    MAX_PREDICATES_ = 8         /**< Maximum number of predicates per step */
+  };
+
+typedef enum
+  {
+    predicate_position_,        /**< [n] */
+    predicate_last_,            /**< [last()] */
+    predicate_attribute_,       /**< [@name] or [@name='value'] */
+    predicate_text_             /**< [text()] or [text()='value'] */
+  } predicate_type_;
+
+typedef struct
+{
+  predicate_type_ type;         /**< The predicate type */
+  unsigned int position;        /**< Expected position (positions) */
+  XML_Char const *name;         /**< Attribute name (attributes) */
+  size_t name_len;              /**< Attribute name length */
+  unsigned long key;            /**< Attribute name summary key */
+  XML_Char const *value;        /**< Expected value (NULL if any) */
+  size_t value_len;             /**< Expected value length */
+} predicate_;
+
+typedef struct
+{
+  scew_bool descendant;         /**< Descendant ("//") or child axis */
+  scew_bool self;               /**< Also matches the context ("//text()") */
+  XML_Char const *name;         /**< Name test (NULL for "*") */
+  size_t name_len;              /**< Name test length */
+  unsigned long key;            /**< Name test summary key */
+  unsigned int n_predicates;    /**< Number of predicates */
+  predicate_ *predicates;       /**< Step predicates */
+} step_;
+
+struct scew_query
+{
+  XML_Char *source;             /**< Copy of the expression (names and
+                                   values point into it) */
+  scew_bool absolute;           /**< Whether the path starts with "/" */
+  scew_bool text;               /**< Whether the path ends with "text()" */
+  unsigned int n_steps;         /**< Number of steps */
+  step_ *steps;                 /**< Location steps */
+  predicate_ *predicates;       /**< Storage for all steps' predicates */
+};
+
+/* Parser state. */
+typedef struct
+{
+  XML_Char const *cursor;
+  scew_query *query;
+  unsigned int n_predicates;
+} compiler_;
+
+/* State of a running query. */
+typedef struct
+{
+  scew_query const *query;
+  scew_element *root;           /* The element the query is run on */
+  scew_query_hook hook;
+  void *user_data;
+} run_;
+
+static scew_bool parse_path_ (compiler_ *compiler);
+static scew_bool parse_step_ (compiler_ *compiler, step_ *step);
+static scew_bool parse_predicate_ (compiler_ *compiler,
+                                   predicate_ *predicate);
+static scew_bool parse_literal_ (compiler_ *compiler,
+                                 XML_Char const **value,
+                                 size_t *len);
+static size_t parse_name_ (compiler_ *compiler);
+static scew_bool is_delimiter_ (XML_Char c);
+static scew_bool skip_ (compiler_ *compiler, XML_Char const *token);
+static void skip_spaces_ (compiler_ *compiler);
+
+static scew_element* parent_ (run_ const *run, scew_element *element);
+static scew_element* first_child_ (run_ const *run, scew_element *context);
+static scew_element* next_sibling_ (run_ const *run, scew_element *element);
+static scew_element* previous_sibling_ (run_ const *run,
+                                        scew_element *element);
+
+static scew_bool forward_ (run_ const *run,
+                           unsigned int index,
+                           scew_element *context);
+static scew_bool children_ (run_ const *run,
+                            unsigned int index,
+                            scew_element *context);
+static scew_bool descendants_ (run_ const *run,
+                               unsigned int index,
+                               scew_element *anchor);
+static scew_bool backward_ (run_ const *run,
+                            unsigned int index,
+                            scew_element *element,
+                            unsigned int first,
+                            scew_element *anchor);
+static scew_bool report_ (run_ const *run, scew_element *element);
+
+static scew_bool matches_ (run_ const *run,
+                           step_ const *step,
+                           scew_element *element,
+                           unsigned int n_predicates);
+static scew_bool matches_name_ (step_ const *step, scew_element *element);
+static scew_bool matches_value_ (predicate_ const *predicate,
+                                 scew_element *element);
+static scew_bool is_last_ (run_ const *run,
+                           step_ const *step,
+                           scew_element *element,
+                           unsigned int n_predicates);
+static scew_bool may_contain_ (step_ const *step, scew_element const *element);
+
+static scew_bool first_hook_ (scew_element *element, void *user_data);
+static scew_bool count_hook_ (scew_element *element, void *user_data);
+
+
+
+/* Public */
+
+scew_query*
+scew_query_compile (XML_Char const *expression)
+{
+  compiler_ compiler;
+  scew_query *query = NULL;
+  XML_Char const *c = NULL;
+  unsigned int max_steps = 1;
+  unsigned int max_predicates = 0;
+
+  assert (expression != NULL);
+
+  /* Each step starts with a '/' (except the first one) and each
+     predicate with a '[', so this is enough to hold them all. */
+  for (c = expression; *c != _XT('\0'); ++c)
+    {
+      if (_XT('/') == *c)
+        {
+          max_steps += 1;
+        }
+      else if (_XT('[') == *c)
+        {
+          max_predicates += 1;
+        }
+    }
+
+  query = calloc (1, sizeof (scew_query));
+  if (NULL == query)
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      return NULL;
+    }
+
+  query->source = scew_strdup (expression);
+  query->steps = calloc (max_steps, sizeof (step_));
+  if (max_predicates > 0)
+    {
+      query->predicates = calloc (max_predicates, sizeof (predicate_));
+    }
+
+  if ((NULL == query->source)
+      || (NULL == query->steps)
+      || ((max_predicates > 0) && (NULL == query->predicates)))
+    {
+      scew_query_free (query);
+      scew_error_set_last_error_ (scew_error_no_memory);
+      return NULL;
+    }
+
+  compiler.cursor = query->source;
+  compiler.query = query;
+  compiler.n_predicates = 0;
+
+  if (!parse_path_ (&compiler))
+    {
+      scew_query_free (query);
+      scew_error_set_last_error_ (scew_error_query);
+      return NULL;
+    }
+
+  return query;
+}
+
+void
+scew_query_free (scew_query *query)
+{
+  if (query != NULL)
+    {
+      free (query->source);
+      free (query->steps);
+      free (query->predicates);
+      free (query);
+    }
+}
+
+scew_bool
+scew_query_run (scew_query const *query,
+                scew_element *element,
+                scew_query_hook hook,
+                void *user_data)
+{
+  run_ run;
+
+  assert (query != NULL);
+  assert (element != NULL);
+  assert (hook != NULL);
+
+  run.query = query;
+  run.root = element;
+  run.hook = hook;
+  run.user_data = user_data;
+
+  /* Absolute paths start from a virtual document (NULL) whose only
+     child is the given element. */
+  return forward_ (&run, 0, query->absolute ? NULL : element);
+}
+
+scew_bool
+scew_query_run_tree (scew_query const *query,
+                     scew_tree const *tree,
+                     scew_query_hook hook,
+                     void *user_data)
+{
+  run_ run;
+  step_ const *last = NULL;
+  scew_element * const *elements = NULL;
+  unsigned int count = 0;
+  unsigned int i = 0;
+
+  assert (query != NULL);
+  assert (tree != NULL);
+  assert (hook != NULL);
+
+  if (NULL == tree->root)
+    {
+      return SCEW_TRUE;
+    }
+
+  run.query = query;
+  run.root = tree->root;
+  run.hook = hook;
+  run.user_data = user_data;
+
+  /* The candidates of "//.../name" queries are all the elements with
+     that name, which are already known in document order. */
+  if ((query->n_steps > 0) && query->absolute && query->steps[0].descendant)
+    {
+      last = &query->steps[query->n_steps - 1];
+      if ((last->name != NULL)
+          && scew_tree_names_lookup_ (tree, last->name, last->name_len,
+                                      &elements, &count))
+        {
+          for (i = 0; i < count; ++i)
+            {
+              if (backward_ (&run, query->n_steps - 1, elements[i], 0, NULL)
+                  && !report_ (&run, elements[i]))
+                {
+                  return SCEW_FALSE;
+                }
+            }
+          return SCEW_TRUE;
+        }
+    }
+
+  return scew_query_run (query, tree->root, hook, user_data);
+}
+
+scew_element*
+scew_query_first (scew_query const *query, scew_element *element)
+{
+  scew_element *first = NULL;
+
+  assert (query != NULL);
+  assert (element != NULL);
+
+  scew_query_run (query, element, first_hook_, &first);
+
+  return first;
+}
+
+unsigned int
+scew_query_count (scew_query const *query, scew_element *element)
+{
+  unsigned int count = 0;
+
+  assert (query != NULL);
+  assert (element != NULL);
+
+  scew_query_run (query, element, count_hook_, &count);
+
+  return count;
+}
+
+
+
+/* Private (compiler) */
+
+scew_bool
+parse_path_ (compiler_ *compiler)
+{
+  scew_query *query = compiler->query;
+  scew_bool descendant = SCEW_FALSE;
+  step_ *step = NULL;
+
+  skip_spaces_ (compiler);
+
+  query->absolute = (_XT('/') == *compiler->cursor);
+
+  while (!query->text)
+    {
+      if (query->absolute || (query->n_steps > 0))
+        {
+          if (!skip_ (compiler, _XT("/")))
+            {
+              break;
+            }
+          descendant = skip_ (compiler, _XT("/"));
+        }
+
+      if (skip_ (compiler, _XT("text()")))
+        {
+          query->text = SCEW_TRUE;
+          if (descendant)
+            {
+              /* "//text()" is the text of the context and all its
+                 descendants. */
+              step = &query->steps[query->n_steps++];
+              step->descendant = SCEW_TRUE;
+              step->self = SCEW_TRUE;
+            }
+        }
+      else
+        {
+          step = &query->steps[query->n_steps++];
+          step->descendant = descendant;
+          if (!parse_step_ (compiler, step))
+            {
+              return SCEW_FALSE;
+            }
+        }
+    }
+
+  skip_spaces_ (compiler);
+
+  return (_XT('\0') == *compiler->cursor)
+    && ((query->n_steps > 0) || query->text);
+}
+
+scew_bool
+parse_step_ (compiler_ *compiler, step_ *step)
+{
+  predicate_ *predicate = NULL;
+
+  if (!skip_ (compiler, _XT("*")))
+    {
+      step->name = compiler->cursor;
+      step->name_len = parse_name_ (compiler);
+      if (0 == step->name_len)
+        {
+          return SCEW_FALSE;
+        }
+      step->key = scew_element_name_key_ (step->name, step->name_len);
+    }
+
+  step->predicates = &compiler->query->predicates[compiler->n_predicates];
+
+  while (skip_ (compiler, _XT("[")))
+    {
+      if (step->n_predicates == MAX_PREDICATES_)
+        {
+          return SCEW_FALSE;
+        }
+
+      predicate = &step->predicates[step->n_predicates];
+      if (!parse_predicate_ (compiler, predicate))
+        {
+          return SCEW_FALSE;
+        }
+      step->n_predicates += 1;
+      compiler->n_predicates += 1;
+    }
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+parse_predicate_ (compiler_ *compiler, predicate_ *predicate)
+{
+  XML_Char const *c = NULL;
+
+  skip_spaces_ (compiler);
+
+  c = compiler->cursor;
+  if ((*c >= _XT('0')) && (*c <= _XT('9')))
+    {
+      predicate->type = predicate_position_;
+      while ((*c >= _XT('0')) && (*c <= _XT('9')))
+        {
+          predicate->position = predicate->position * 10 + (*c - _XT('0'));
+          c += 1;
+        }
+      compiler->cursor = c;
+      if (0 == predicate->position)
+        {
+          return SCEW_FALSE;
+        }
+    }
+  else if (skip_ (compiler, _XT("last()")))
+    {
+      predicate->type = predicate_last_;
+    }
+  else
+    {
+      if (skip_ (compiler, _XT("@")))
+        {
+          predicate->type = predicate_attribute_;
+          predicate->name = compiler->cursor;
+          predicate->name_len = parse_name_ (compiler);
+          if (0 == predicate->name_len)
+            {
+              return SCEW_FALSE;
+            }
+          predicate->key = scew_element_attribute_key_ (predicate->name,
+                                                        predicate->name_len);
+        }
+      else if (skip_ (compiler, _XT("text()")))
+        {
+          predicate->type = predicate_text_;
+        }
+      else
+        {
+          return SCEW_FALSE;
+        }
+
+      skip_spaces_ (compiler);
+      if (skip_ (compiler, _XT("="))
+          && !parse_literal_ (compiler, &predicate->value,
+                              &predicate->value_len))
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  skip_spaces_ (compiler);
+
+  return skip_ (compiler, _XT("]"));
+}
+
+scew_bool
+parse_literal_ (compiler_ *compiler, XML_Char const **value, size_t *len)
+{
+  XML_Char const *c = NULL;
+  XML_Char quote = 0;
+
+  skip_spaces_ (compiler);
+
+  quote = *compiler->cursor;
+  if ((quote != _XT('\'')) && (quote != _XT('"')))
+    {
+      return SCEW_FALSE;
+    }
+
+  c = compiler->cursor + 1;
+  *value = c;
+  while ((*c != quote) && (*c != _XT('\0')))
+    {
+      c += 1;
+    }
+  if (*c != quote)
+    {
+      return SCEW_FALSE;
+    }
+
+  *len = c - *value;
+  compiler->cursor = c + 1;
+
+  return SCEW_TRUE;
+}
+
+size_t
+parse_name_ (compiler_ *compiler)
+{
+  XML_Char const *start = compiler->cursor;
+  XML_Char const *c = start;
+
+  while ((*c != _XT('\0')) && !scew_isspace (*c) && !is_delimiter_ (*c))
+    {
+      c += 1;
+    }
+  compiler->cursor = c;
+
+  return c - start;
+}
+
+scew_bool
+is_delimiter_ (XML_Char c)
+{
+  switch (c)
+    {
+    case _XT('/'):
+    case _XT('['):
+    case _XT(']'):
+    case _XT('@'):
+    case _XT('='):
+    case _XT('('):
+    case _XT(')'):
+    case _XT('*'):
+    case _XT('\''):
+    case _XT('"'):
+      return SCEW_TRUE;
+    default:
+      return SCEW_FALSE;
+    }
+}
+
+scew_bool
+skip_ (compiler_ *compiler, XML_Char const *token)
+{
+  XML_Char const *c = compiler->cursor;
+
+  while ((*token != _XT('\0')) && (*c == *token))
+    {
+      c += 1;
+      token += 1;
+    }
+  if (*token != _XT('\0'))
+    {
+      return SCEW_FALSE;
+    }
+  compiler->cursor = c;
+
+  return SCEW_TRUE;
+}
+
+void
+skip_spaces_ (compiler_ *compiler)
+{
+  while (scew_isspace (*compiler->cursor))
+    {
+      compiler->cursor += 1;
+    }
+}
+
+
+
+/* Private (navigation) */
+
+/*
+ * For absolute paths, the root element is the only child of a virtual
+ * document (NULL), even if the element has a parent.
+ */
+
+scew_element*
+parent_ (run_ const *run, scew_element *element)
+{
+  return (run->query->absolute && (element == run->root))
+    ? NULL
+    : element->parent;
+}
+
+scew_element*
+first_child_ (run_ const *run, scew_element *context)
+{
+  if (NULL == context)
+    {
+      return run->root;
+    }
+
+  return (NULL == context->children)
+    ? NULL
+    : scew_list_data (context->children);
+}
+
+scew_element*
+next_sibling_ (run_ const *run, scew_element *element)
+{
+  scew_list *next = NULL;
+
+  if ((NULL == element->myself)
+      || (run->query->absolute && (element == run->root)))
+    {
+      return NULL;
+    }
+
+  next = scew_list_next (element->myself);
+
+  return (NULL == next) ? NULL : scew_list_data (next);
+}
+
+scew_element*
+previous_sibling_ (run_ const *run, scew_element *element)
+{
+  scew_list *previous = NULL;
+
+  if ((NULL == element->myself)
+      || (run->query->absolute && (element == run->root)))
+    {
+      return NULL;
+    }
+
+  previous = scew_list_previous (element->myself);
+
+  return (NULL == previous) ? NULL : scew_list_data (previous);
+}
+
+
+
+/* Private (evaluation) */
+
+/*
+ * Leading child steps are evaluated forward, from the context to its
+ * children. From the first descendant step on, each element below the
+ * current context is visited once in document order and matched
+ * against the remaining steps backward, from the element to its
+ * ancestors. This reports every match once and in document order,
+ * without needing to store intermediate results.
+ */
+
+scew_bool
+forward_ (run_ const *run, unsigned int index, scew_element *context)
+{
+  scew_query const *query = run->query;
+
+  if (index == query->n_steps)
+    {
+      return report_ (run, context);
+    }
+  else if (query->steps[index].descendant)
+    {
+      return descendants_ (run, index, context);
+    }
+  else
+    {
+      return children_ (run, index, context);
+    }
+}
+
+scew_bool
+children_ (run_ const *run, unsigned int index, scew_element *context)
+{
+  step_ const *step = &run->query->steps[index];
+  predicate_ const *predicate = NULL;
+  unsigned int count[MAX_PREDICATES_];
+  scew_element *child = NULL;
+  scew_bool matches = SCEW_FALSE;
+  unsigned int i = 0;
+
+  for (i = 0; i < step->n_predicates; ++i)
+    {
+      count[i] = 0;
+    }
+
+  for (child = first_child_ (run, context);
+       child != NULL;
+       child = next_sibling_ (run, child))
+    {
+      matches = matches_name_ (step, child);
+      for (i = 0; matches && (i < step->n_predicates); ++i)
+        {
+          /* count[i] is the number of children that passed the
+             previous predicates, which gives positions in a single
+             pass. */
+          predicate = &step->predicates[i];
+          switch (predicate->type)
+            {
+            case predicate_position_:
+              count[i] += 1;
+              matches = (count[i] == predicate->position);
+              break;
+            case predicate_last_:
+              matches = is_last_ (run, step, child, i);
+              break;
+            default:
+              matches = matches_value_ (predicate, child);
+              break;
+            }
+        }
+
+      if (matches && !forward_ (run, index + 1, child))
+        {
+          return SCEW_FALSE;
+        }
+
+      /* No other child can be at the requested position. */
+      if ((step->n_predicates > 0)
+          && (predicate_position_ == step->predicates[0].type)
+          && (count[0] == step->predicates[0].position))
+        {
+          break;
+        }
+    }
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+descendants_ (run_ const *run, unsigned int index, scew_element *anchor)
+{
+  unsigned int last = run->query->n_steps - 1;
+  scew_element *element = NULL;
+  scew_element *next = NULL;
+  scew_bool descend = SCEW_FALSE;
+
+  if (run->query->steps[index].self && (anchor != NULL))
+    {
+      /* Only "//text()" steps (always the last one) match the
+         context. */
+      if (!report_ (run, anchor))
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  element = first_child_ (run, anchor);
+  while (element != NULL)
+    {
+      /* Matches are always reported from the subtree they are in, so
+         subtrees that can not contain the last step are skipped. */
+      descend = may_contain_ (&run->query->steps[last], element);
+      if (descend
+          && backward_ (run, last, element, index, anchor)
+          && !report_ (run, element))
+        {
+          return SCEW_FALSE;
+        }
+
+      /* Pre-order traversal, without going above the anchor. */
+      next = descend ? first_child_ (run, element) : NULL;
+      while ((NULL == next) && (element != NULL))
+        {
+          next = next_sibling_ (run, element);
+          if (NULL == next)
+            {
+              element = parent_ (run, element);
+              if (element == anchor)
+                {
+                  element = NULL;
+                }
+            }
+        }
+      element = next;
+    }
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+backward_ (run_ const *run,
+           unsigned int index,
+           scew_element *element,
+           unsigned int first,
+           scew_element *anchor)
+{
+  step_ const *step = &run->query->steps[index];
+  scew_element *ancestor = NULL;
+
+  if (!matches_ (run, step, element, step->n_predicates))
+    {
+      return SCEW_FALSE;
+    }
+
+  /* The first descendant step matches anything below the anchor. */
+  if (index == first)
+    {
+      return SCEW_TRUE;
+    }
+
+  ancestor = step->self ? element : parent_ (run, element);
+  if (!step->descendant)
+    {
+      return (ancestor != anchor)
+        && backward_ (run, index - 1, ancestor, first, anchor);
+    }
+
+  for (; ancestor != anchor; ancestor = parent_ (run, ancestor))
+    {
+      if (backward_ (run, index - 1, ancestor, first, anchor))
+        {
+          return SCEW_TRUE;
+        }
+    }
+
+  return SCEW_FALSE;
+}
+
+scew_bool
+report_ (run_ const *run, scew_element *element)
+{
+  if ((NULL == element)
+      || (run->query->text && (NULL == element->contents.data)))
+    {
+      return SCEW_TRUE;
+    }
+
+  return run->hook (element, run->user_data);
+}
+
+scew_bool
+matches_ (run_ const *run,
+          step_ const *step,
+          scew_element *element,
+          unsigned int n_predicates)
+{
+  predicate_ const *predicate = NULL;
+  scew_element *sibling = NULL;
+  unsigned int position = 0;
+  unsigned int i = 0;
+
+  if (!matches_name_ (step, element))
+    {
+      return SCEW_FALSE;
+    }
+
+  for (i = 0; i < n_predicates; ++i)
+    {
+      predicate = &step->predicates[i];
+      switch (predicate->type)
+        {
+        case predicate_position_:
+          /* Count the previous siblings that pass the previous
+             predicates. */
+          position = 1;
+          for (sibling = previous_sibling_ (run, element);
+               (sibling != NULL) && (position <= predicate->position);
+               sibling = previous_sibling_ (run, sibling))
+            {
+              if (matches_ (run, step, sibling, i))
+                {
+                  position += 1;
+                }
+            }
+          if (position != predicate->position)
+            {
+              return SCEW_FALSE;
+            }
+          break;
+        case predicate_last_:
+          if (!is_last_ (run, step, element, i))
+            {
+              return SCEW_FALSE;
+            }
+          break;
+        default:
+          if (!matches_value_ (predicate, element))
+            {
+              return SCEW_FALSE;
+            }
+          break;
+        }
+    }
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+matches_name_ (step_ const *step, scew_element *element)
+{
+  return (NULL == step->name)
+    || ((element->name.len == step->name_len)
+        && (scew_memcmp (element->name.data, step->name, step->name_len) == 0));
+}
+
+scew_bool
+matches_value_ (predicate_ const *predicate, scew_element *element)
+{
+  scew_xstr const *value = NULL;
+  scew_attribute const *attribute = NULL;
+  scew_list *item = NULL;
+
+  if (predicate_text_ == predicate->type)
+    {
+      value = &element->contents;
+    }
+  else
+    {
+      for (item = element->attributes;
+           (item != NULL) && (NULL == value);
+           item = scew_list_next (item))
+        {
+          attribute = scew_list_data (item);
+          if ((attribute->name.len == predicate->name_len)
+              && (scew_memcmp (attribute->name.data, predicate->name,
+                               predicate->name_len) == 0))
+            {
+              value = &attribute->value;
+            }
+        }
+    }
+
+  if ((NULL == value) || (NULL == value->data))
+    {
+      return SCEW_FALSE;
+    }
+
+  return (NULL == predicate->value)
+    || ((value->len == predicate->value_len)
+        && (scew_memcmp (value->data, predicate->value,
+                         predicate->value_len) == 0));
+}
+
+scew_bool
+is_last_ (run_ const *run,
+          step_ const *step,
+          scew_element *element,
+          unsigned int n_predicates)
+{
+  scew_element *sibling = NULL;
+
+  for (sibling = next_sibling_ (run, element);
+       sibling != NULL;
+       sibling = next_sibling_ (run, sibling))
+    {
+      if (matches_ (run, step, sibling, n_predicates))
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+may_contain_ (step_ const *step, scew_element const *element)
+{
+  unsigned int i = 0;
+
+  /* Summaries are only used if they are already computed, so running
+     a query does not modify the tree. */
+  if ((step->name != NULL)
+      && !scew_element_may_contain_ (element, step->key, SCEW_FALSE))
+    {
+      return SCEW_FALSE;
+    }
+
+  for (i = 0; i < step->n_predicates; ++i)
+    {
+      if ((predicate_attribute_ == step->predicates[i].type)
+          && !scew_element_may_contain_ (element,
+                                         step->predicates[i].key,
+                                         SCEW_FALSE))
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+first_hook_ (scew_element *element, void *user_data)
+{
+  *((scew_element **) user_data) = element;
+
+  return SCEW_FALSE;
+}
+
+scew_bool
+count_hook_ (scew_element *element, void *user_data)
+{
+  *((unsigned int *) user_data) += 1;
+
+  return SCEW_TRUE;
+}
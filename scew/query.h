@@ -0,0 +1,198 @@
+/**
+ * @file     query.h
+ * @brief    SCEW XPath-like element queries
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 15:40
+ * @ingroup  SCEWQuery
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+/**
+ * @defgroup SCEWQuery Queries
+ *
+ * Search elements with a subset of XPath. Query expressions are
+ * compiled once (see #scew_query_compile) and can then be run as
+ * many times as needed, on any element (see #scew_query_run). Running
+ * a query does not allocate any memory.
+ *
+ * The supported subset is made of location paths with:
+ *
+ * - Child ("/") and descendant ("//") axes. A path starting with
+ *   "/" or "//" is absolute, and the element the query is run on is
+ *   considered the root element of the document. Otherwise, the path
+ *   is relative to the element the query is run on.
+ * - Name tests ("name" or "prefix:name") and the "*" wildcard.
+ * - Predicates, which can be combined: positions ("[2]" or
+ *   "[last()]"), attribute existence ("[@id]"), attribute equality
+ *   ("[@id='value']") and contents equality ("[text()='value']").
+ * - A final "text()" step, which selects elements with contents.
+ *
+ * For example, "/config//server[@enabled='yes'][1]/name/text()".
+ *
+ * Positions count siblings, as in XPath, and matches are always
+ * reported once and in document order.
+ */
+
+#ifndef QUERY_H_2610181540
+#define QUERY_H_2610181540
+
+#include "export.h"
+
+#include "bool.h"
+#include "element.h"
+#include "tree.h"
+
+#include <expat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * This is the type declaration for compiled queries.
+ *
+ * @ingroup SCEWQuery
+ */
+typedef struct scew_query scew_query;
+
+/**
+ * Query hooks are called for each element matched by a query (see
+ * #scew_query_run). For queries ending with "text()", the element's
+ * contents can be obtained with #scew_element_contents.
+ *
+ * The hook must not modify the tree the query is being run on.
+ *
+ * @return true to continue searching, false to stop.
+ *
+ * @ingroup SCEWQuery
+ */
+typedef scew_bool (*scew_query_hook) (scew_element *element, void *user_data);
+
+
+/**
+ * Compiles the given query @a expression.
+ *
+ * @pre expression != NULL
+ *
+ * @return a new compiled query, or NULL if it could not be created
+ * (the error code is set to #scew_error_query if the expression is
+ * not valid).
+ *
+ * @ingroup SCEWQuery
+ */
+extern SCEW_API scew_query* scew_query_compile (XML_Char const *expression);
+
+/**
+ * Frees a compiled query. If @a query is NULL, no operation is
+ * performed.
+ *
+ * @ingroup SCEWQuery
+ */
+extern SCEW_API void scew_query_free (scew_query *query);
+
+/**
+ * Runs the given compiled @a query on @a element, calling @a hook for
+ * each matching element, in document order. A compiled query is not
+ * modified when run, so it can be run from several threads at the
+ * same time.
+ *
+ * Queries with descendant steps skip the subtrees whose name
+ * summaries (see #scew_element_descendant_by_name) show they can not
+ * contain any match. Summaries are only used if they are already
+ * computed, as running a query never modifies the tree.
+ *
+ * @pre query != NULL
+ * @pre element != NULL
+ * @pre hook != NULL
+ *
+ * @param query the compiled query to run.
+ * @param element the element to run the query on.
+ * @param hook the function called for each match.
+ * @param user_data user specific data passed to @a hook.
+ *
+ * @return true if all the matches were reported, false if @a hook
+ * stopped the query.
+ *
+ * @ingroup SCEWQuery
+ */
+extern SCEW_API scew_bool scew_query_run (scew_query const *query,
+                                          scew_element *element,
+                                          scew_query_hook hook,
+                                          void *user_data);
+
+/**
+ * Runs the given compiled @a query on the root element of the given
+ * @a tree, as #scew_query_run does.
+ *
+ * If the names index of the tree is enabled and up to date (see
+ * #scew_tree_index_names), absolute queries that start with "//" and
+ * end with a name test (e.g. "//item" or "//list//item[@id]") only
+ * visit the elements with that name, instead of the whole tree. The
+ * index is never rebuilt here.
+ *
+ * @pre query != NULL
+ * @pre tree != NULL
+ * @pre hook != NULL
+ *
+ * @return true if all the matches were reported, false if @a hook
+ * stopped the query.
+ *
+ * @ingroup SCEWQuery
+ */
+extern SCEW_API scew_bool scew_query_run_tree (scew_query const *query,
+                                               scew_tree const *tree,
+                                               scew_query_hook hook,
+                                               void *user_data);
+
+/**
+ * Runs the given compiled @a query on @a element and returns the
+ * first match.
+ *
+ * @pre query != NULL
+ * @pre element != NULL
+ *
+ * @return the first matching element, or NULL if there are no
+ * matches.
+ *
+ * @ingroup SCEWQuery
+ */
+extern SCEW_API scew_element* scew_query_first (scew_query const *query,
+                                                scew_element *element);
+
+/**
+ * Runs the given compiled @a query on @a element and returns the
+ * number of matches.
+ *
+ * @pre query != NULL
+ * @pre element != NULL
+ *
+ * @ingroup SCEWQuery
+ */
+extern SCEW_API unsigned int scew_query_count (scew_query const *query,
+                                               scew_element *element);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* QUERY_H_2610181540 */
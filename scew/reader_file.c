@@ -26,14 +26,37 @@
  * @endif
  **/
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+/* posix_fadvise needs POSIX.1-2001. */
+#if defined (HAVE_POSIX_FADVISE) && !defined (_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 600
+#endif /* HAVE_POSIX_FADVISE && !_XOPEN_SOURCE */
+
 #include "reader_file.h"
 
 #include "str.h"
 
 #include <assert.h>
+#include <errno.h>
+#include <string.h>
 
 #include <stdlib.h>
 
+#ifdef _MSC_VER
+#include <io.h>
+#define read _read
+#define close _close
+#else
+#include <unistd.h>
+#endif /* _MSC_VER */
+
+#ifdef HAVE_POSIX_FADVISE
+#include <fcntl.h>
+#endif /* HAVE_POSIX_FADVISE */
+
 
 /* Private */
 
@@ -60,6 +83,40 @@ static scew_reader_hooks const file_hooks_ =
     file_free_
   };
 
+enum
+  {
+    FD_BUFFER_SIZE_ = 65536     /**< Bytes read at once */
+  };
+
+typedef struct
+{
+  int fd;
+  scew_bool closed;
+  scew_bool end;
+  scew_bool error;
+  size_t start;                 /* First pending byte in buffer */
+  size_t used;                  /* Bytes read into buffer */
+  char buffer[FD_BUFFER_SIZE_];
+} scew_reader_fd;
+
+static size_t fd_read_ (scew_reader *reader,
+                        XML_Char *buffer,
+                        size_t char_no);
+static scew_bool fd_end_ (scew_reader *reader);
+static scew_bool fd_error_ (scew_reader *reader);
+static scew_bool fd_close_ (scew_reader *reader);
+static void fd_free_ (scew_reader *reader);
+static void fd_fill_ (scew_reader_fd *fd_reader);
+
+static scew_reader_hooks const fd_hooks_ =
+  {
+    fd_read_,
+    fd_end_,
+    fd_error_,
+    fd_close_,
+    fd_free_
+  };
+
 
 /* Public */
 
@@ -111,6 +168,42 @@ scew_reader_fp_create (FILE *file)
   return reader;
 }
 
+scew_reader*
+scew_reader_fd_create (int fd)
+{
+  scew_reader *reader = NULL;
+  scew_reader_fd *fd_reader = NULL;
+
+  assert (fd >= 0);
+
+  fd_reader = malloc (sizeof (scew_reader_fd));
+
+  if (fd_reader != NULL)
+    {
+      fd_reader->fd = fd;
+      fd_reader->closed = SCEW_FALSE;
+      fd_reader->end = SCEW_FALSE;
+      fd_reader->error = SCEW_FALSE;
+      fd_reader->start = 0;
+      fd_reader->used = 0;
+
+#ifdef HAVE_POSIX_FADVISE
+      /* Only hints: they fail on pipes, which is fine. */
+      posix_fadvise (fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+      posix_fadvise (fd, 0, 0, POSIX_FADV_NOREUSE);
+#endif /* HAVE_POSIX_FADVISE */
+
+      /* Create reader */
+      reader = scew_reader_create (&fd_hooks_, fd_reader);
+      if (NULL == reader)
+        {
+          free (fd_reader);
+        }
+    }
+
+  return reader;
+}
+
 
 /* Private */
 
@@ -204,3 +297,136 @@ file_free_ (scew_reader *reader)
   fp_reader = scew_reader_data (reader);
   free (fp_reader);
 }
+
+size_t
+fd_read_ (scew_reader *reader, XML_Char *buffer, size_t char_no)
+{
+  size_t read_no = 0;
+  scew_reader_fd *fd_reader = NULL;
+
+  assert (reader != NULL);
+  assert (buffer != NULL);
+
+  fd_reader = scew_reader_data (reader);
+
+  if (!fd_reader->closed)
+    {
+      if (fd_reader->used - fd_reader->start < sizeof (XML_Char))
+        {
+          fd_fill_ (fd_reader);
+        }
+
+      read_no = (fd_reader->used - fd_reader->start) / sizeof (XML_Char);
+      if (read_no > char_no)
+        {
+          read_no = char_no;
+        }
+
+      memcpy (buffer, fd_reader->buffer + fd_reader->start,
+              read_no * sizeof (XML_Char));
+      fd_reader->start += read_no * sizeof (XML_Char);
+    }
+
+  buffer[read_no] = _XT('\0');
+
+  return read_no;
+}
+
+scew_bool
+fd_end_ (scew_reader *reader)
+{
+  scew_reader_fd *fd_reader = NULL;
+
+  assert (reader != NULL);
+
+  fd_reader = scew_reader_data (reader);
+
+  /* Bytes of an incomplete last character are never returned. */
+  return fd_reader->closed
+    || (fd_reader->end
+        && (fd_reader->used - fd_reader->start < sizeof (XML_Char)));
+}
+
+scew_bool
+fd_error_ (scew_reader *reader)
+{
+  scew_reader_fd *fd_reader = NULL;
+
+  assert (reader != NULL);
+
+  fd_reader = scew_reader_data (reader);
+
+  return fd_reader->error;
+}
+
+scew_bool
+fd_close_ (scew_reader *reader)
+{
+  scew_reader_fd *fd_reader = NULL;
+
+  assert (reader != NULL);
+
+  fd_reader = scew_reader_data (reader);
+
+  /* Do not close already closed file or standard input. */
+  if (fd_reader->closed || (0 == fd_reader->fd))
+    {
+      fd_reader->closed = SCEW_TRUE;
+    }
+  else
+    {
+      /* Set closed flag if we are actually able to close it. */
+      fd_reader->closed = (0 == close (fd_reader->fd));
+    }
+
+  return fd_reader->closed;
+}
+
+void
+fd_free_ (scew_reader *reader)
+{
+  scew_reader_fd *fd_reader = NULL;
+
+  assert (reader != NULL);
+
+  /* Close the file before freeing the reader. */
+  fd_close_ (reader);
+
+  fd_reader = scew_reader_data (reader);
+  free (fd_reader);
+}
+
+void
+fd_fill_ (scew_reader_fd *fd_reader)
+{
+  long read_no = 0;
+  size_t left = fd_reader->used - fd_reader->start;
+
+  /* Keep the bytes of an incomplete character (if any). */
+  memmove (fd_reader->buffer, fd_reader->buffer + fd_reader->start, left);
+  fd_reader->start = 0;
+  fd_reader->used = left;
+
+  /*
+   * Ask for whole blocks, but return as soon as there is a character
+   * available, so streamed input (pipes, terminals) is not delayed.
+   */
+  while (!fd_reader->end && !fd_reader->error
+         && (fd_reader->used < sizeof (XML_Char)))
+    {
+      read_no = read (fd_reader->fd, fd_reader->buffer + fd_reader->used,
+                      FD_BUFFER_SIZE_ - fd_reader->used);
+      if (read_no > 0)
+        {
+          fd_reader->used += read_no;
+        }
+      else if (0 == read_no)
+        {
+          fd_reader->end = SCEW_TRUE;
+        }
+      else if (errno != EINTR)
+        {
+          fd_reader->error = SCEW_TRUE;
+        }
+    }
+}
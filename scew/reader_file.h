@@ -89,6 +89,33 @@ extern SCEW_API scew_reader* scew_reader_file_create (char const *file_name);
  */
 extern SCEW_API scew_reader* scew_reader_fp_create (FILE *file);
 
+/**
+ * Creates a new SCEW reader for the given file descriptor, which
+ * might be a regular file, a pipe, a socket or the standard input
+ * (0). Data is read in large blocks directly with the operating
+ * system, without going through stdio, and the system is told that
+ * the file will be read sequentially and only once. Characters are
+ * read as they would be stored in memory, so no conversion is done
+ * for wide characters.
+ *
+ * Reads return as soon as some data is available, so streamed input
+ * is processed while it arrives.
+ *
+ * The file descriptor is closed when the reader is closed or freed,
+ * unless it is the standard input.
+ *
+ * @pre fd >= 0
+ *
+ * @param fd the file descriptor where the new SCEW reader should read
+ * data from.
+ *
+ * @return a new SCEW reader for the given file descriptor or NULL if
+ * the reader could not be created.
+ *
+ * @ingroup SCEWReaderFile
+ */
+extern SCEW_API scew_reader* scew_reader_fd_create (int fd);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
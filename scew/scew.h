@@ -32,12 +32,15 @@
 #include "export.h"
 
 #include "attribute.h"
+#include "binary.h"
 #include "bool.h"
+#include "diff.h"
 #include "element.h"
 #include "error.h"
 #include "list.h"
 #include "parser.h"
 #include "printer.h"
+#include "query.h"
 #include "reader.h"
 #include "reader_buffer.h"
 #include "reader_file.h"
@@ -45,6 +48,7 @@
 #include "tree.h"
 #include "writer.h"
 #include "writer_buffer.h"
+#include "writer_buffered.h"
 #include "writer_file.h"
 
 /* Automatically include the correct library on Windows. */
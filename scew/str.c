@@ -29,6 +29,7 @@
 #include "str.h"
 
 #include "xerror.h"
+#include "xscan.h"
 #include "str.h"
 
 #include <assert.h>
@@ -57,6 +58,8 @@ enum
     QUOT_SIZE_ = 6              /**< Size of &quot; */
   };
 
+static XML_Char const* entity_ (XML_Char chr, size_t *len);
+
 
 /* Public */
 
@@ -110,6 +113,23 @@ scew_strdup (XML_Char const *src)
   return out;
 }
 
+XML_Char*
+scew_strndup (XML_Char const *src, size_t len)
+{
+  XML_Char *out = NULL;
+
+  assert (src != NULL);
+
+  out = malloc ((len + 1) * sizeof (XML_Char));
+  if (out != NULL)
+    {
+      scew_memcpy (out, src, len);
+      out[len] = _XT('\0');
+    }
+
+  return out;
+}
+
 void
 scew_strtrim (XML_Char *src)
 {
@@ -119,16 +139,9 @@ scew_strtrim (XML_Char *src)
 
   assert (src != NULL);
 
-  end = scew_strlen (src);
-
-  /* Strip trailing whitespace. */
-  while ((end > 0) && scew_isspace (src[end - 1]))
-    {
-      src[--end] = _XT('\0');
-    }
-
-  /* Strip leading whitespace. */
-  start = scew_strspn (src, _XT(" \n\r\t\v"));
+  /* Strip trailing and leading whitespace. */
+  end = scew_scan_rspace_ (src, scew_strlen (src));
+  start = scew_scan_lspace_ (src, end);
   total = end - start;
   scew_memmove (src, &src[start], total);
   src[total] = _XT('\0');
@@ -137,93 +150,121 @@ scew_strtrim (XML_Char *src)
 scew_bool
 scew_isempty (XML_Char const *src)
 {
-  scew_bool empty = SCEW_TRUE;
-  XML_Char *p = (XML_Char *) src;
+  size_t len = 0;
 
   assert (src != NULL);
 
-  while (empty && (*p != _XT('\0')))
+  /* Most strings are not empty, which the first character tells. */
+  if ((*src != _XT('\0')) && !scew_isspace (*src))
     {
-      empty = (scew_isspace (*p) != 0);
-      p += 1;
+      return SCEW_FALSE;
     }
 
-  return empty;
+  len = scew_strlen (src);
+
+  return (scew_scan_lspace_ (src, len) == len);
 }
 
 XML_Char*
 scew_strescape (XML_Char const *src)
 {
-  XML_Char *p = (XML_Char *) src;
+  XML_Char const *p = src;
+  XML_Char const *entity = NULL;
   XML_Char *escaped = NULL;
-  unsigned int len = 0;
+  size_t src_len = 0;
+  size_t left = 0;
+  size_t span = 0;
+  size_t entity_len = 0;
+  size_t len = 0;
 
   assert (src != NULL);
 
   /* We first need to calculate the size of the new escaped string. */
-  while (*p != _XT('\0'))
+  src_len = scew_strlen (src);
+  len = src_len;
+  left = src_len;
+  while (left > 0)
     {
-      switch (*p)
+      span = scew_scan_escape_ (p, left);
+      if (span < left)
         {
-        case CHR_LT_:
-          len += LT_SIZE_;
-          break;
-        case CHR_GT_:
-          len += GT_SIZE_;
-          break;
-        case CHR_AMP_:
-          len += AMP_SIZE_;
-          break;
-        case CHR_APOS_:
-          len += APOS_SIZE_;
-          break;
-        case CHR_QUOT_:
-          len += QUOT_SIZE_;
-          break;
-        default:
-          len += 1;
-          break;
+          entity_ (p[span], &entity_len);
+          len += entity_len - 1;
+          span += 1;
         }
-      p += 1;
+      p += span;
+      left -= span;
     }
 
   /* Allocate new string (if necessary). */
   escaped = calloc (len + 1, sizeof (XML_Char));
+  if (NULL == escaped)
+    {
+      return NULL;
+    }
 
-  /* Append characters to new string, escaping the needed ones. */
-  p = (XML_Char *) src;
+  /*
+   * Append characters to new string, escaping the needed ones. Spans
+   * of characters that do not need to be escaped are copied at once.
+   */
+  p = src;
+  left = src_len;
   len = 0;
-  while (*p != _XT('\0'))
+  while (left > 0)
     {
-      switch (*p)
+      span = scew_scan_escape_ (p, left);
+      scew_memcpy (&escaped[len], p, span);
+      len += span;
+      if (span < left)
         {
-        case CHR_LT_:
-          scew_memcpy (&escaped[len], XML_LT_, LT_SIZE_);
-          len += LT_SIZE_;
-          break;
-        case CHR_GT_:
-          scew_memcpy (&escaped[len], XML_GT_, GT_SIZE_);
-          len += GT_SIZE_;
-          break;
-        case CHR_AMP_:
-          scew_memcpy (&escaped[len], XML_AMP_, AMP_SIZE_);
-          len += AMP_SIZE_;
-          break;
-        case CHR_APOS_:
-          scew_memcpy (&escaped[len], XML_APOS_, APOS_SIZE_);
-          len += APOS_SIZE_;
-          break;
-        case CHR_QUOT_:
-          scew_memcpy (&escaped[len], XML_QUOT_, QUOT_SIZE_);
-          len += QUOT_SIZE_;
-          break;
-        default:
-          escaped[len] = *p;
-          len += 1;
-          break;
+          entity = entity_ (p[span], &entity_len);
+          scew_memcpy (&escaped[len], entity, entity_len);
+          len += entity_len;
+          span += 1;
         }
-      p += 1;
+      p += span;
+      left -= span;
     }
 
   return escaped;
 }
+
+
+
+/* Private */
+
+XML_Char const*
+entity_ (XML_Char chr, size_t *len)
+{
+  XML_Char const *entity = NULL;
+
+  switch (chr)
+    {
+    case CHR_LT_:
+      entity = XML_LT_;
+      *len = LT_SIZE_;
+      break;
+    case CHR_GT_:
+      entity = XML_GT_;
+      *len = GT_SIZE_;
+      break;
+    case CHR_AMP_:
+      entity = XML_AMP_;
+      *len = AMP_SIZE_;
+      break;
+    case CHR_APOS_:
+      entity = XML_APOS_;
+      *len = APOS_SIZE_;
+      break;
+    case CHR_QUOT_:
+      entity = XML_QUOT_;
+      *len = QUOT_SIZE_;
+      break;
+    default:
+      /* Not reached: only escapable characters are given. */
+      *len = 0;
+      break;
+    }
+
+  return entity;
+}
@@ -68,6 +68,12 @@
  */
 #define scew_memmove(dst, src, n) memmove (dst, src, sizeof (XML_Char) * (n))
 
+/**
+ * Compare the number of given characters from @a s1 and @a s2. See
+ * standard @a memcmp documentation.
+ */
+#define scew_memcmp(s1, s2, n)  memcmp (s1, s2, sizeof (XML_Char) * (n))
+
 #ifdef XML_UNICODE_WCHAR_T
 
 #include <wchar.h>
@@ -263,6 +269,23 @@ extern SCEW_API int scew_strcmp (XML_Char const *a, XML_Char const *b);
  */
 extern SCEW_API XML_Char* scew_strdup (XML_Char const *src);
 
+/**
+ * Creates a new null-terminated copy of the first @a len characters
+ * of the given string. The given string does not need to be
+ * null-terminated.
+ *
+ * @pre src != NULL
+ *
+ * @param src the characters to be duplicated.
+ * @param len the number of characters to copy.
+ *
+ * @return the duplicated string, or NULL if it could not be
+ * allocated.
+ *
+ * @ingroup SCEWString
+ */
+extern SCEW_API XML_Char* scew_strndup (XML_Char const *src, size_t len);
+
 /**
  * Trims off extra spaces from the beginning and end of a string. The
  * trimming is done in place.
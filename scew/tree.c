@@ -26,8 +26,9 @@
  * @endif
  */
 
-#include "tree.h"
+#include "xtree.h"
 
+#include "xelement.h"
 #include "xerror.h"
 
 #include "element.h"
@@ -38,15 +39,6 @@
 
 /* Private */
 
-struct scew_tree
-{
-  XML_Char *version;
-  XML_Char *encoding;
-  XML_Char *preamble;
-  scew_tree_standalone standalone;
-  scew_element *root;
-};
-
 static scew_bool compare_tree_ (scew_tree const *a, scew_tree const *b);
 
 static XML_Char const *DEFAULT_XML_VERSION_ = (XML_Char *) _XT("1.0");
@@ -91,7 +83,12 @@ scew_tree_copy (scew_tree const *tree)
       new_tree->encoding = scew_strdup (tree->encoding);
       new_tree->preamble = scew_strdup (tree->preamble);
       new_tree->standalone = tree->standalone;
-      new_tree->root = scew_element_copy (tree->root);
+      new_tree->root = (NULL == tree->root)
+        ? NULL : scew_element_copy (tree->root);
+      if (new_tree->root != NULL)
+        {
+          new_tree->root->tree = new_tree;
+        }
 
       copied =
         ((tree->version == NULL) || (new_tree->version != NULL))
@@ -117,7 +114,22 @@ scew_tree_free (scew_tree *tree)
       free (tree->version);
       free (tree->encoding);
       free (tree->preamble);
-      scew_element_free (tree->root);
+      scew_tree_unindex_names (tree);
+      scew_tree_unindex_attributes_ (tree);
+      scew_tree_unindex_text (tree);
+      scew_tree_unindex_order (tree);
+      if (tree->snapshot != NULL)
+        {
+          scew_tree_close_snapshot_ (tree);
+        }
+      else if (tree->frozen != NULL)
+        {
+          free (tree->frozen);
+        }
+      else
+        {
+          scew_element_free (tree->root);
+        }
       free (tree);
     }
 }
@@ -222,6 +234,12 @@ scew_tree_set_root (scew_tree *tree, XML_Char const *name)
   if (root != NULL)
     {
       new_root = scew_tree_set_root_element (tree, root);
+
+      /* Delete element if it can not be set as root */
+      if (NULL == new_root)
+        {
+          scew_element_free (root);
+        }
     }
   else
     {
@@ -237,7 +255,21 @@ scew_tree_set_root_element (scew_tree *tree, scew_element *root)
   assert (tree != NULL);
   assert (root != NULL);
 
+  if (tree->frozen != NULL)
+    {
+      scew_error_set_last_error_ (scew_error_frozen);
+      return NULL;
+    }
+
+  /* A freed root leaves the tree, so the old root is still valid. */
+  if (tree->root != NULL)
+    {
+      tree->root->tree = NULL;
+    }
+
   tree->root = root;
+  root->tree = tree;
+  scew_tree_changed_ (tree);
 
   return root;
 }
@@ -3,7 +3,8 @@
  * @brief    SCEW tree handling routines
  * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
  * @date     Thu Feb 20, 2003 23:32
- * @ingroup  SCEWTree, SCEWTreeAlloc, SCEWTreeProp, SCEWTreeContent
+ * @ingroup  SCEWTree, SCEWTreeAlloc, SCEWTreeProp, SCEWTreeContent,
+ *           SCEWTreeIndex, SCEWTreeFreeze
  *
  * @if copyright
  *
@@ -305,6 +306,7 @@ extern SCEW_API scew_element* scew_tree_root (scew_tree const *tree);
  * overwritten, possibly causing a memory leak, as the old root
  * element is *not* automatically freed. So, if you plan to set a new
  * root element, remember to free the old one first.
+ * Freeing the root element of a tree also removes it from the tree.
  *
  * @pre tree != NULL
  * @pre name != NULL
@@ -326,6 +328,7 @@ extern SCEW_API scew_element* scew_tree_set_root (scew_tree *tree,
  * be overwritten, possibly causing a memory leak, as the old root
  * element is *not* automatically freed. So, if you plan to set a new
  * root element, remember to free the old one first.
+ * Freeing the root element of a tree also removes it from the tree.
  *
  * @pre tree != NULL
  * @pre root != NULL
@@ -377,6 +380,406 @@ extern SCEW_API XML_Char const* scew_tree_xml_preamble (scew_tree const *tree);
 extern SCEW_API void scew_tree_set_xml_preamble (scew_tree *tree,
                                                  XML_Char const *preamble);
 
+
+/**
+ * @defgroup SCEWTreeIndex Indexes
+ * Optional indexes to find elements without traversing the whole
+ * tree. Indexes are kept up to date automatically: any modification
+ * of the tree marks them as out of date, and they are rebuilt the
+ * next time they are used.
+ * @ingroup SCEWTree
+ */
+
+/**
+ * Enables the element names index of the given @a tree and builds
+ * it. The index maps each element name to all the elements in the
+ * tree with that name, in document order. Once enabled, it is used
+ * by #scew_tree_elements_by_name and by queries (see
+ * #scew_query_run).
+ *
+ * @pre tree != NULL
+ *
+ * @return true if the index could be built, false otherwise (no
+ * memory available).
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API scew_bool scew_tree_index_names (scew_tree *tree);
+
+/**
+ * Disables the element names index of the given @a tree, freeing all
+ * its memory. If the index was not enabled, no operation is
+ * performed.
+ *
+ * @pre tree != NULL
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API void scew_tree_unindex_names (scew_tree *tree);
+
+/**
+ * Returns all the elements of the given @a tree with the given @a
+ * name, in document order. The index is rebuilt first if the tree has
+ * been modified since it was last used.
+ *
+ * The returned array belongs to the index and is only valid until
+ * the tree is modified or the index is disabled.
+ *
+ * @pre tree != NULL
+ * @pre name != NULL
+ * @pre count != NULL
+ *
+ * @param tree the tree to search elements in.
+ * @param name the name of the elements to find.
+ * @param count where the number of elements found is stored.
+ *
+ * @return the array of elements found, or NULL if there are none,
+ * the names index is not enabled (see #scew_tree_index_names) or it
+ * could not be rebuilt (no memory available).
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API scew_element* const*
+scew_tree_elements_by_name (scew_tree *tree,
+                            XML_Char const *name,
+                            unsigned int *count);
+
+/**
+ * Enables an index of the values of the attributes with the given @a
+ * name (e.g. "id") in the given @a tree, and builds it. Unlike other
+ * indexes, attribute indexes are updated in place, without being
+ * rebuilt, when attributes are added (#scew_element_add_attribute,
+ * #scew_element_add_attribute_pair), modified
+ * (#scew_attribute_set_value, #scew_attribute_set_name) or deleted
+ * (#scew_element_delete_attribute). If the index is already enabled,
+ * it is only rebuilt if it is out of date.
+ *
+ * @pre tree != NULL
+ * @pre name != NULL
+ *
+ * @return true if the index could be built, false otherwise (no
+ * memory available).
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API scew_bool scew_tree_index_attribute (scew_tree *tree,
+                                                     XML_Char const *name);
+
+/**
+ * Disables the index of the attributes with the given @a name of the
+ * given @a tree, freeing all its memory. If the index was not
+ * enabled, no operation is performed.
+ *
+ * @pre tree != NULL
+ * @pre name != NULL
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API void scew_tree_unindex_attribute (scew_tree *tree,
+                                                  XML_Char const *name);
+
+/**
+ * Finds the element of the given @a tree that has an attribute with
+ * the given @a name and @a value, in constant time. The index is
+ * rebuilt first if elements have been added, removed or renamed since
+ * it was last used. If several elements have the same value, any of
+ * them is returned.
+ *
+ * @pre tree != NULL
+ * @pre name != NULL
+ * @pre value != NULL
+ *
+ * @return the element found, or NULL if there is none, the attribute
+ * is not indexed (see #scew_tree_index_attribute) or the index could
+ * not be rebuilt (no memory available).
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API scew_element*
+scew_tree_element_by_attribute (scew_tree *tree,
+                                XML_Char const *name,
+                                XML_Char const *value);
+
+/**
+ * Enables the contents index of the given @a tree and builds it. The
+ * contents of each element are split into tokens (runs of characters
+ * separated by spaces or punctuation), and the index maps each token
+ * to all the elements whose contents have it. Like attribute indexes,
+ * the contents index is updated in place when the contents of an
+ * element are set (#scew_element_set_contents) or freed
+ * (#scew_element_free_contents), and only rebuilt if elements are
+ * added, removed or renamed.
+ *
+ * @pre tree != NULL
+ *
+ * @return true if the index could be built, false otherwise (no
+ * memory available).
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API scew_bool scew_tree_index_text (scew_tree *tree);
+
+/**
+ * Disables the contents index of the given @a tree, freeing all its
+ * memory. If the index was not enabled, no operation is performed.
+ *
+ * @pre tree != NULL
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API void scew_tree_unindex_text (scew_tree *tree);
+
+/**
+ * Returns all the elements of the given @a tree whose contents have
+ * the given @a token (case-sensitive). Elements are returned in
+ * document order, except the ones whose contents have been set since
+ * the index was last built, which come last. The index is rebuilt
+ * first if it is out of date.
+ *
+ * The returned array belongs to the index and is only valid until
+ * the tree is modified or the index is disabled.
+ *
+ * @pre tree != NULL
+ * @pre token != NULL
+ * @pre count != NULL
+ *
+ * @param tree the tree to search elements in.
+ * @param token the token to find (with no spaces or punctuation).
+ * @param count where the number of elements found is stored.
+ *
+ * @return the array of elements found, or NULL if there are none,
+ * the contents index is not enabled (see #scew_tree_index_text) or it
+ * could not be rebuilt (no memory available).
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API scew_element* const*
+scew_tree_elements_by_token (scew_tree *tree,
+                             XML_Char const *token,
+                             unsigned int *count);
+
+/**
+ * Enables the document order index of the given @a tree and builds
+ * it in a single traversal. Each element is numbered with its
+ * pre-order rank and the rank of the last element of its subtree, so
+ * the subtree of an element is the interval between both
+ * ranks. Once enabled, ancestry and document order tests
+ * (#scew_tree_is_ancestor, #scew_tree_compare_order) take constant
+ * time, and subtrees are contiguous ranges of the elements in
+ * document order (#scew_tree_subtree_elements).
+ *
+ * @pre tree != NULL
+ *
+ * @return true if the index could be built, false otherwise (no
+ * memory available).
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API scew_bool scew_tree_index_order (scew_tree *tree);
+
+/**
+ * Disables the document order index of the given @a tree, freeing
+ * all its memory. If the index was not enabled, no operation is
+ * performed.
+ *
+ * @pre tree != NULL
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API void scew_tree_unindex_order (scew_tree *tree);
+
+/**
+ * Tells whether @a ancestor is a proper ancestor of @a element, both
+ * being elements of the given @a tree. If the document order index is
+ * enabled (see #scew_tree_index_order) this takes constant time
+ * (after rebuilding the index if it is out of date), otherwise the
+ * parents of @a element are walked.
+ *
+ * @pre tree != NULL
+ * @pre ancestor != NULL
+ * @pre element != NULL
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API scew_bool scew_tree_is_ancestor (scew_tree *tree,
+                                                 scew_element const *ancestor,
+                                                 scew_element const *element);
+
+/**
+ * Compares the position in document order of the given elements of
+ * @a tree. As with #scew_tree_is_ancestor, this takes constant time
+ * if the document order index is enabled, otherwise both elements'
+ * parents are walked up to their closest common ancestor.
+ *
+ * @pre tree != NULL
+ * @pre a != NULL
+ * @pre b != NULL
+ *
+ * @return a negative number if @a a comes before @a b (e.g. it is
+ * its ancestor), 0 if they are the same element or a positive number
+ * if @a a comes after @a b.
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API int scew_tree_compare_order (scew_tree *tree,
+                                             scew_element const *a,
+                                             scew_element const *b);
+
+/**
+ * Sorts the given array of @a count elements of @a tree in document
+ * order, for example to merge the results of several searches. See
+ * #scew_tree_compare_order.
+ *
+ * @pre tree != NULL
+ * @pre elements != NULL || count == 0
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API void scew_tree_sort_elements (scew_tree *tree,
+                                              scew_element **elements,
+                                              unsigned int count);
+
+/**
+ * Returns the subtree of the given @a element of @a tree (the
+ * element itself followed by all its descendants) as a range of the
+ * elements of the tree in document order. The index is rebuilt first
+ * if the tree has been modified since it was last used.
+ *
+ * The returned array belongs to the index and is only valid until
+ * the tree is modified or the index is disabled.
+ *
+ * @pre tree != NULL
+ * @pre element != NULL
+ * @pre count != NULL
+ *
+ * @return the elements of the subtree, or NULL if the document order
+ * index is not enabled (see #scew_tree_index_order) or it could not
+ * be rebuilt (no memory available).
+ *
+ * @ingroup SCEWTreeIndex
+ */
+extern SCEW_API scew_element* const*
+scew_tree_subtree_elements (scew_tree *tree,
+                            scew_element const *element,
+                            unsigned int *count);
+
+
+/**
+ * @defgroup SCEWTreeFreeze Frozen trees
+ * Compact read-only trees.
+ * @ingroup SCEWTree
+ */
+
+/**
+ * Freezes the given @a tree, making it read-only. All the elements
+ * of the tree are moved into a single memory block, in document
+ * order: elements first (in pre-order) and their caches, then their
+ * children and attributes lists (each list in a contiguous range),
+ * the attributes and finally all the strings that do not fit inline
+ * packed together. The original elements are freed.
+ *
+ * Frozen trees are read with the same functions as any other tree,
+ * but traversals are much more cache-friendly, as there is a single
+ * allocation instead of several per element. This also saves the
+ * memory of the allocator overhead and of the unused space of strings
+ * (about a tenth of a tree with all its caches computed, which
+ * frozen trees always have), but frozen elements and attributes
+ * keep the same structures as the others, so readers can be given
+ * pointers to them: freezing is meant for locality and concurrent
+ * reads, not for compactness. Hashes (#scew_element_hash), names
+ * summaries (#scew_element_may_contain), epochs (#scew_element_epoch)
+ * and enabled indexes are computed while freezing, so reading a
+ * frozen tree never modifies it and it can be safely read from any
+ * number of threads at the same time.
+ *
+ * Frozen trees can not be modified in any way: their elements,
+ * attributes and root element can not be changed or freed (the whole
+ * tree is freed with #scew_tree_free). Functions trying to do so
+ * (including #scew_tree_patch) do nothing and fail with
+ * #scew_error_frozen, and strings given to the "take" setters are
+ * freed. A mutable copy can be obtained with #scew_tree_copy.
+ * Pointers to the elements and attributes of the tree obtained before
+ * freezing it are not valid any more. Freezing an empty or already
+ * frozen tree does nothing.
+ *
+ * @pre tree != NULL
+ *
+ * @return true if the tree is frozen, false otherwise (no memory
+ * available), in which case the tree is left untouched.
+ *
+ * @ingroup SCEWTreeFreeze
+ */
+extern SCEW_API scew_bool scew_tree_freeze (scew_tree *tree);
+
+/**
+ * Tells whether the given @a tree is frozen (see #scew_tree_freeze).
+ *
+ * @pre tree != NULL
+ *
+ * @ingroup SCEWTreeFreeze
+ */
+extern SCEW_API scew_bool scew_tree_is_frozen (scew_tree const *tree);
+
+/**
+ * Saves a snapshot of the given @a tree in the given file. A snapshot
+ * is the binary image of the frozen tree (see #scew_tree_freeze),
+ * with all its pointers replaced by offsets, so it can be opened
+ * again with #scew_tree_open_snapshot without parsing anything.
+ *
+ * If @a source_name is not NULL, the size and modification time of
+ * that file (usually the XML document the tree was loaded from) are
+ * stored in the snapshot, so out of date snapshots can be detected
+ * when opening them.
+ *
+ * Snapshots are not portable: they can only be opened by the same
+ * SCEW build on the same kind of machine that saved them.
+ *
+ * @pre tree != NULL
+ * @pre file_name != NULL
+ *
+ * @param tree the tree to save (frozen or not).
+ * @param file_name the name of the snapshot file to create.
+ * @param source_name the name of the source file of the tree, or NULL.
+ *
+ * @return true if the snapshot was saved, false otherwise (see
+ * #scew_error_code).
+ *
+ * @ingroup SCEWTreeFreeze
+ */
+extern SCEW_API scew_bool scew_tree_save_snapshot (scew_tree const *tree,
+                                                   char const *file_name,
+                                                   char const *source_name);
+
+/**
+ * Opens a snapshot saved with #scew_tree_save_snapshot as a frozen
+ * tree. The snapshot is mapped into memory (where available) and
+ * used in place: its offsets are turned back into pointers, but no
+ * element is allocated and nothing is parsed. The snapshot is
+ * released when the tree is freed.
+ *
+ * Snapshot files are not trusted: every offset is checked to point to
+ * the object and region it belongs to, and every string to be
+ * null-terminated within its storage, so a corrupted snapshot is
+ * rejected instead of being used.
+ *
+ * If @a source_name is not NULL, the snapshot is only opened if it
+ * was saved with the same source file and that file has not changed
+ * since (same size and modification time).
+ *
+ * @pre file_name != NULL
+ *
+ * @param file_name the name of the snapshot file to open.
+ * @param source_name the name of the source file of the tree, or NULL.
+ *
+ * @return the frozen tree, or NULL if the snapshot could not be read
+ * (#scew_error_io), it is invalid or out of date
+ * (#scew_error_snapshot), or there is no memory available.
+ *
+ * @ingroup SCEWTreeFreeze
+ */
+extern SCEW_API scew_tree* scew_tree_open_snapshot (char const *file_name,
+                                                    char const *source_name);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,281 @@
+/**
+ * @file     tree_freeze.c
+ * @brief    tree.h implementation (frozen trees)
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 19:05
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "xtree.h"
+
+#include "xattribute.h"
+#include "xelement.h"
+#include "xerror.h"
+#include "xlist.h"
+#include "xstr.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+
+/* Private */
+
+/* Next free slots of each kind in the frozen block. */
+typedef struct
+{
+  scew_element *elements;
+  scew_element_cache_ *caches;
+  scew_list *items;
+  scew_attribute *attributes;
+  XML_Char *pool;
+} freezer_;
+
+static void measure_ (scew_element const *element,
+                      scew_frozen_layout_ *layout);
+static scew_element* freeze_element_ (freezer_ *freezer,
+                                      scew_element const *element,
+                                      scew_element *parent,
+                                      scew_list *myself);
+static scew_list* link_items_ (freezer_ *freezer, unsigned int count);
+
+
+
+/* Public */
+
+scew_bool
+scew_tree_freeze (scew_tree *tree)
+{
+  scew_frozen_layout_ layout;
+  void *block = NULL;
+
+  assert (tree != NULL);
+
+  if ((NULL == tree->root) || (tree->frozen != NULL))
+    {
+      return SCEW_TRUE;
+    }
+
+  block = scew_tree_freeze_block_ (tree->root, &layout);
+  if (NULL == block)
+    {
+      return SCEW_FALSE;
+    }
+
+  /* The old root leaves the tree before being freed. */
+  tree->root->tree = NULL;
+  scew_element_free (tree->root);
+
+  tree->root = block;
+  tree->frozen = block;
+  tree->root->tree = tree;
+
+  scew_tree_reindex_ (tree);
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+scew_tree_is_frozen (scew_tree const *tree)
+{
+  assert (tree != NULL);
+
+  return (tree->frozen != NULL);
+}
+
+
+
+/* Protected */
+
+void*
+scew_tree_freeze_block_ (scew_element *root, scew_frozen_layout_ *layout)
+{
+  freezer_ freezer;
+  scew_element_cache_ *cache = NULL;
+  void *block = NULL;
+
+  assert (root != NULL);
+  assert (layout != NULL);
+
+  /* Compute all the caches, so they are copied and frozen trees are
+     never modified when read. They are only valid at the root if
+     they are valid in the whole subtree. */
+  scew_element_hash (root);
+  scew_element_may_contain_ (root, 0, SCEW_TRUE);
+  scew_element_epoch_ (root);
+
+  cache = scew_element_cache_get_ (root);
+  if ((NULL == cache) || !cache->hash_valid || !cache->summary_valid
+      || cache->epoch_pending)
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      return NULL;
+    }
+
+  layout->n_elements = 0;
+  layout->n_items = 0;
+  layout->n_attributes = 0;
+  layout->n_chars = 0;
+  measure_ (root, layout);
+
+  block = calloc (1, scew_tree_frozen_size_ (layout));
+  if (NULL == block)
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      return NULL;
+    }
+
+  freezer.elements = block;
+  freezer.caches =
+    (scew_element_cache_ *) (freezer.elements + layout->n_elements);
+  freezer.items = (scew_list *) (freezer.caches + layout->n_elements);
+  freezer.attributes = (scew_attribute *) (freezer.items + layout->n_items);
+  freezer.pool = (XML_Char *) (freezer.attributes + layout->n_attributes);
+
+  freeze_element_ (&freezer, root, NULL, NULL);
+
+  return block;
+}
+
+size_t
+scew_tree_frozen_size_ (scew_frozen_layout_ const *layout)
+{
+  assert (layout != NULL);
+
+  /* Structures are stored first, as they have the strictest alignment,
+     and strings last. */
+  return layout->n_elements * sizeof (scew_element)
+    + layout->n_elements * sizeof (scew_element_cache_)
+    + layout->n_items * sizeof (scew_list)
+    + layout->n_attributes * sizeof (scew_attribute)
+    + layout->n_chars * sizeof (XML_Char);
+}
+
+
+
+/* Private */
+
+void
+measure_ (scew_element const *element, scew_frozen_layout_ *layout)
+{
+  scew_attribute const *attribute = NULL;
+  scew_list *item = NULL;
+
+  layout->n_elements += 1;
+  layout->n_items += element->n_attributes + element->n_children;
+  layout->n_attributes += element->n_attributes;
+  layout->n_chars += scew_xstr_pack_size_ (&element->name)
+    + scew_xstr_pack_size_ (&element->contents);
+
+  for (item = element->attributes; item != NULL; item = item->next)
+    {
+      attribute = item->data;
+      layout->n_chars += scew_xstr_pack_size_ (&attribute->name)
+        + scew_xstr_pack_size_ (&attribute->value);
+    }
+
+  for (item = element->children; item != NULL; item = item->next)
+    {
+      measure_ (item->data, layout);
+    }
+}
+
+scew_element*
+freeze_element_ (freezer_ *freezer,
+                 scew_element const *element,
+                 scew_element *parent,
+                 scew_list *myself)
+{
+  scew_element *frozen = freezer->elements++;
+  scew_attribute *attribute = NULL;
+  scew_list *items = NULL;
+  scew_list *item = NULL;
+  unsigned int i = 0;
+
+  freezer->pool = scew_xstr_pack_ (&frozen->name, &element->name,
+                                   freezer->pool);
+  freezer->pool = scew_xstr_pack_ (&frozen->contents, &element->contents,
+                                   freezer->pool);
+
+  frozen->parent = parent;
+  frozen->myself = myself;
+
+  /* Indexes are built again for the frozen tree. */
+  frozen->cache = freezer->caches++;
+  *frozen->cache = *element->cache;
+  frozen->cache->indexed = SCEW_FALSE;
+  frozen->cache->frozen = SCEW_TRUE;
+
+  /* Attributes... */
+  items = link_items_ (freezer, element->n_attributes);
+  for (i = 0, item = element->attributes; item != NULL; ++i, item = item->next)
+    {
+      attribute = freezer->attributes++;
+      freezer->pool =
+        scew_xstr_pack_ (&attribute->name,
+                         &((scew_attribute *) item->data)->name,
+                         freezer->pool);
+      freezer->pool =
+        scew_xstr_pack_ (&attribute->value,
+                         &((scew_attribute *) item->data)->value,
+                         freezer->pool);
+      attribute->parent = frozen;
+      items[i].data = attribute;
+    }
+  frozen->n_attributes = element->n_attributes;
+  frozen->attributes = items;
+  frozen->last_attribute = (NULL == items) ? NULL : &items[i - 1];
+
+  /* ... and children, each one followed by its own subtree. */
+  items = link_items_ (freezer, element->n_children);
+  for (i = 0, item = element->children; item != NULL; ++i, item = item->next)
+    {
+      items[i].data = freeze_element_ (freezer, item->data, frozen, &items[i]);
+    }
+  frozen->n_children = element->n_children;
+  frozen->children = items;
+  frozen->last_child = (NULL == items) ? NULL : &items[i - 1];
+
+  return frozen;
+}
+
+scew_list*
+link_items_ (freezer_ *freezer, unsigned int count)
+{
+  scew_list *items = freezer->items;
+  unsigned int i = 0;
+
+  if (0 == count)
+    {
+      return NULL;
+    }
+
+  for (i = 0; i < count; ++i)
+    {
+      items[i].prev = (i > 0) ? &items[i - 1] : NULL;
+      items[i].next = (i + 1 < count) ? &items[i + 1] : NULL;
+    }
+  freezer->items += count;
+
+  return items;
+}
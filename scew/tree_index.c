@@ -0,0 +1,1677 @@
+/**
+ * @file     tree_index.c
+ * @brief    tree.h implementation (indexes)
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 16:30
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "xtree.h"
+
+#include "xattribute.h"
+#include "xelement.h"
+#include "xerror.h"
+#include "xhash.h"
+
+#include "str.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/* Private */
+
+enum
+  {
+    MIN_NAMES_ = 16,            /**< Initial size of the names table */
+    MIN_VALUES_ = 16,           /**< Initial size of the values tables */
+    MIN_TOKENS_ = 64,           /**< Initial size of the tokens table */
+    MIN_POSTINGS_ = 4,          /**< Initial size of the elements of a token */
+    MIN_ORDER_ = 64             /**< Initial size of the document order array */
+  };
+
+/* Tells whether the given character separates contents tokens. */
+#define IS_DELIMITER_(c) (scew_isspace (c) || scew_ispunct (c))
+
+/* All the elements with the same name. */
+typedef struct
+{
+  XML_Char const *name;         /**< Name (owned by the first element) */
+  size_t len;                   /**< Name length */
+  unsigned long hash;           /**< Name hash */
+  unsigned int offset;          /**< First element in the elements array */
+  unsigned int count;           /**< Number of elements */
+} name_entry_;
+
+/*
+ * The elements are stored in a single array, grouped by name and in
+ * document order within each group. Names are looked up in an open
+ * addressing hash table.
+ *
+ * Building the index marks all the elements of the tree as indexed,
+ * and modifying an element clears the mark of the element and its
+ * ancestors. So, the index is up to date as long as the root element
+ * is still marked.
+ */
+struct scew_name_index_
+{
+  scew_bool valid;              /**< Whether the index has been built */
+  scew_element *root;           /**< Root element when it was built */
+  unsigned int n_names;         /**< Number of different names */
+  unsigned int size;            /**< Size of the names table (power of 2) */
+  name_entry_ *names;           /**< Names table */
+  unsigned int n_elements;      /**< Number of elements */
+  scew_element **elements;      /**< Elements grouped by name */
+};
+
+/* An attribute with the indexed name. */
+typedef struct
+{
+  scew_attribute const *attribute; /**< The attribute (NULL if none) */
+  scew_bool deleted;            /**< Whether the attribute was removed */
+  unsigned long hash;           /**< Value hash */
+} value_entry_;
+
+/*
+ * Attributes are looked up by value in an open addressing hash
+ * table. As attributes are added and removed in place, removed
+ * entries are marked as deleted (so probing goes on) until the table
+ * is resized.
+ */
+struct scew_attribute_index_
+{
+  scew_attribute_index_ *next;  /**< Next attribute index of the tree */
+  XML_Char *name;               /**< Indexed attribute name */
+  size_t len;                   /**< Indexed attribute name length */
+  scew_bool valid;              /**< Whether the index has been built */
+  scew_element *root;           /**< Root element when it was built */
+  unsigned int n_values;        /**< Number of attributes */
+  unsigned int n_used;          /**< Number of used or deleted entries */
+  unsigned int size;            /**< Size of the values table (power of 2) */
+  value_entry_ *values;         /**< Values table */
+};
+
+/*
+ * All the elements whose contents have the same token (postings),
+ * sorted by their contents sequence number. Removed elements are
+ * found with a binary search and their postings cleared (set to
+ * NULL). Cleared postings are compacted in batches: when the elements
+ * are requested, or when at least half the postings are cleared and
+ * more room is needed.
+ */
+typedef struct
+{
+  XML_Char *token;              /**< The token (NULL if empty slot) */
+  size_t len;                   /**< Token length */
+  unsigned long hash;           /**< Token hash */
+  unsigned int count;           /**< Number of elements */
+  unsigned int used;            /**< Number of postings (with cleared ones) */
+  unsigned int capacity;        /**< Size of the postings arrays */
+  scew_element **elements;      /**< Elements with the token (or NULL) */
+  unsigned int *seqs;           /**< Sequence numbers of the elements */
+} token_entry_;
+
+/*
+ * Tokens are looked up in an open addressing hash table. Tokens are
+ * never removed from the table until it is rebuilt, they just end up
+ * with no elements. Each element is stored once per token, even if
+ * the token appears several times in its contents.
+ *
+ * Every time the contents of an element are indexed, the element gets
+ * the next sequence number (in document order when the index is
+ * built), so postings are always appended in sequence order.
+ */
+struct scew_text_index_
+{
+  scew_bool valid;              /**< Whether the index has been built */
+  scew_element *root;           /**< Root element when it was built */
+  unsigned int next_seq;        /**< Next contents sequence number */
+  unsigned int n_tokens;        /**< Number of different tokens */
+  unsigned int size;            /**< Size of the tokens table (power of 2) */
+  token_entry_ *tokens;         /**< Tokens table */
+};
+
+/*
+ * The elements are stored in document order, and each element keeps
+ * its position in the array (its pre-order rank) and the position of
+ * the last element of its subtree.
+ */
+struct scew_order_index_
+{
+  scew_bool valid;              /**< Whether the index has been built */
+  scew_element *root;           /**< Root element when it was built */
+  unsigned int n_elements;      /**< Number of elements */
+  unsigned int size;            /**< Size of the elements array */
+  scew_element **elements;      /**< Elements in document order */
+};
+
+static scew_bool is_up_to_date_ (scew_tree const *tree,
+                                 scew_bool valid,
+                                 scew_element const *root);
+static void prepare_build_ (scew_tree *tree);
+
+static scew_bool names_up_to_date_ (scew_tree const *tree);
+static scew_bool build_names_ (scew_tree *tree);
+static void clear_names_ (scew_name_index_ *index);
+static name_entry_* find_name_ (scew_name_index_ const *index,
+                                XML_Char const *name,
+                                size_t len,
+                                unsigned long hash);
+static name_entry_* add_name_ (scew_name_index_ *index,
+                               scew_element const *element);
+static scew_bool grow_names_ (scew_name_index_ *index);
+
+static scew_attribute_index_* find_index_ (scew_tree const *tree,
+                                           XML_Char const *name,
+                                           size_t len);
+static scew_bool build_values_ (scew_tree *tree,
+                                scew_attribute_index_ *index);
+static void clear_values_ (scew_attribute_index_ *index);
+static scew_bool add_value_ (scew_attribute_index_ *index,
+                             scew_attribute const *attribute);
+static void remove_value_ (scew_attribute_index_ *index,
+                           scew_attribute const *attribute);
+static scew_element* find_value_ (scew_attribute_index_ const *index,
+                                  XML_Char const *value,
+                                  size_t len);
+static scew_bool resize_values_ (scew_attribute_index_ *index);
+
+static scew_bool text_up_to_date_ (scew_tree const *tree);
+static scew_bool build_text_ (scew_tree *tree);
+static void clear_text_ (scew_text_index_ *index);
+static scew_bool add_tokens_ (scew_text_index_ *index,
+                              scew_element *element);
+static void remove_tokens_ (scew_text_index_ *index,
+                            scew_element const *element);
+static XML_Char const* next_token_ (XML_Char const *text,
+                                    XML_Char const *end,
+                                    size_t *len);
+static token_entry_* find_token_ (scew_text_index_ const *index,
+                                  XML_Char const *token,
+                                  size_t len,
+                                  unsigned long hash);
+static token_entry_* add_token_ (scew_text_index_ *index,
+                                 XML_Char const *token,
+                                 size_t len,
+                                 unsigned long hash);
+static scew_bool grow_tokens_ (scew_text_index_ *index);
+static scew_bool grow_postings_ (token_entry_ *entry);
+static void compact_postings_ (token_entry_ *entry);
+static unsigned int find_posting_ (token_entry_ const *entry,
+                                   unsigned int seq);
+
+static scew_bool order_up_to_date_ (scew_tree *tree);
+static scew_bool build_order_ (scew_tree *tree);
+static void clear_order_ (scew_order_index_ *index);
+static int compare_ranks_ (void const *a, void const *b);
+static int compare_parents_ (void const *a, void const *b);
+static unsigned int depth_ (scew_element const *element);
+
+static scew_element* next_element_ (scew_element *element,
+                                    scew_element const *root);
+
+
+
+/* Public */
+
+scew_bool
+scew_tree_index_names (scew_tree *tree)
+{
+  assert (tree != NULL);
+
+  if (NULL == tree->names)
+    {
+      tree->names = calloc (1, sizeof (scew_name_index_));
+      if (NULL == tree->names)
+        {
+          scew_error_set_last_error_ (scew_error_no_memory);
+          return SCEW_FALSE;
+        }
+    }
+
+  if (!names_up_to_date_ (tree) && !build_names_ (tree))
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      return SCEW_FALSE;
+    }
+
+  return SCEW_TRUE;
+}
+
+void
+scew_tree_unindex_names (scew_tree *tree)
+{
+  assert (tree != NULL);
+
+  if (tree->names != NULL)
+    {
+      clear_names_ (tree->names);
+      free (tree->names);
+      tree->names = NULL;
+    }
+}
+
+scew_element* const*
+scew_tree_elements_by_name (scew_tree *tree,
+                            XML_Char const *name,
+                            unsigned int *count)
+{
+  scew_element * const *elements = NULL;
+
+  assert (tree != NULL);
+  assert (name != NULL);
+  assert (count != NULL);
+
+  *count = 0;
+
+  if ((tree->names != NULL) && scew_tree_index_names (tree))
+    {
+      scew_tree_names_lookup_ (tree, name, scew_strlen (name),
+                               &elements, count);
+    }
+
+  return elements;
+}
+
+scew_bool
+scew_tree_index_attribute (scew_tree *tree, XML_Char const *name)
+{
+  scew_attribute_index_ *index = NULL;
+  size_t len = 0;
+
+  assert (tree != NULL);
+  assert (name != NULL);
+
+  len = scew_strlen (name);
+  index = find_index_ (tree, name, len);
+  if (NULL == index)
+    {
+      index = calloc (1, sizeof (scew_attribute_index_));
+      if (index != NULL)
+        {
+          index->name = scew_strdup (name);
+          index->len = len;
+        }
+      if ((NULL == index) || (NULL == index->name))
+        {
+          free (index);
+          scew_error_set_last_error_ (scew_error_no_memory);
+          return SCEW_FALSE;
+        }
+      index->next = tree->attributes;
+      tree->attributes = index;
+    }
+
+  if (!is_up_to_date_ (tree, index->valid, index->root)
+      && !build_values_ (tree, index))
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      return SCEW_FALSE;
+    }
+
+  return SCEW_TRUE;
+}
+
+void
+scew_tree_unindex_attribute (scew_tree *tree, XML_Char const *name)
+{
+  scew_attribute_index_ **link = NULL;
+  scew_attribute_index_ *index = NULL;
+
+  assert (tree != NULL);
+  assert (name != NULL);
+
+  index = find_index_ (tree, name, scew_strlen (name));
+  if (index != NULL)
+    {
+      for (link = &tree->attributes; *link != index; link = &(*link)->next)
+        {
+        }
+      *link = index->next;
+
+      clear_values_ (index);
+      free (index->name);
+      free (index);
+    }
+}
+
+scew_element*
+scew_tree_element_by_attribute (scew_tree *tree,
+                                XML_Char const *name,
+                                XML_Char const *value)
+{
+  scew_attribute_index_ *index = NULL;
+
+  assert (tree != NULL);
+  assert (name != NULL);
+  assert (value != NULL);
+
+  index = find_index_ (tree, name, scew_strlen (name));
+  if ((NULL == index) || !scew_tree_index_attribute (tree, name))
+    {
+      return NULL;
+    }
+
+  return find_value_ (index, value, scew_strlen (value));
+}
+
+scew_bool
+scew_tree_index_text (scew_tree *tree)
+{
+  assert (tree != NULL);
+
+  if (NULL == tree->text)
+    {
+      tree->text = calloc (1, sizeof (scew_text_index_));
+      if (NULL == tree->text)
+        {
+          scew_error_set_last_error_ (scew_error_no_memory);
+          return SCEW_FALSE;
+        }
+    }
+
+  if (!text_up_to_date_ (tree) && !build_text_ (tree))
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      return SCEW_FALSE;
+    }
+
+  return SCEW_TRUE;
+}
+
+void
+scew_tree_unindex_text (scew_tree *tree)
+{
+  assert (tree != NULL);
+
+  if (tree->text != NULL)
+    {
+      clear_text_ (tree->text);
+      free (tree->text);
+      tree->text = NULL;
+    }
+}
+
+scew_element* const*
+scew_tree_elements_by_token (scew_tree *tree,
+                             XML_Char const *token,
+                             unsigned int *count)
+{
+  token_entry_ *entry = NULL;
+  size_t len = 0;
+
+  assert (tree != NULL);
+  assert (token != NULL);
+  assert (count != NULL);
+
+  *count = 0;
+
+  if ((NULL == tree->text)
+      || !scew_tree_index_text (tree)
+      || (0 == tree->text->n_tokens))
+    {
+      return NULL;
+    }
+
+  len = scew_strlen (token);
+  entry = find_token_ (tree->text, token, len,
+                       scew_hash_string_ (scew_hash_init_ (), token, len));
+  if ((NULL == entry->token) || (0 == entry->count))
+    {
+      return NULL;
+    }
+
+  if (entry->count < entry->used)
+    {
+      compact_postings_ (entry);
+    }
+
+  *count = entry->count;
+
+  return entry->elements;
+}
+
+scew_bool
+scew_tree_index_order (scew_tree *tree)
+{
+  assert (tree != NULL);
+
+  if (NULL == tree->order)
+    {
+      tree->order = calloc (1, sizeof (scew_order_index_));
+      if (NULL == tree->order)
+        {
+          scew_error_set_last_error_ (scew_error_no_memory);
+          return SCEW_FALSE;
+        }
+    }
+
+  if (!is_up_to_date_ (tree, tree->order->valid, tree->order->root)
+      && !build_order_ (tree))
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      return SCEW_FALSE;
+    }
+
+  return SCEW_TRUE;
+}
+
+void
+scew_tree_unindex_order (scew_tree *tree)
+{
+  assert (tree != NULL);
+
+  if (tree->order != NULL)
+    {
+      clear_order_ (tree->order);
+      free (tree->order);
+      tree->order = NULL;
+    }
+}
+
+scew_bool
+scew_tree_is_ancestor (scew_tree *tree,
+                       scew_element const *ancestor,
+                       scew_element const *element)
+{
+  assert (tree != NULL);
+  assert (ancestor != NULL);
+  assert (element != NULL);
+
+  if (order_up_to_date_ (tree))
+    {
+      return (ancestor->cache->order_pre < element->cache->order_pre)
+        && (element->cache->order_pre <= ancestor->cache->order_post);
+    }
+
+  for (element = element->parent; element != NULL; element = element->parent)
+    {
+      if (element == ancestor)
+        {
+          return SCEW_TRUE;
+        }
+    }
+
+  return SCEW_FALSE;
+}
+
+int
+scew_tree_compare_order (scew_tree *tree,
+                         scew_element const *a,
+                         scew_element const *b)
+{
+  assert (tree != NULL);
+  assert (a != NULL);
+  assert (b != NULL);
+
+  return order_up_to_date_ (tree)
+    ? compare_ranks_ (&a, &b)
+    : compare_parents_ (&a, &b);
+}
+
+void
+scew_tree_sort_elements (scew_tree *tree,
+                         scew_element **elements,
+                         unsigned int count)
+{
+  assert (tree != NULL);
+  assert ((elements != NULL) || (0 == count));
+
+  if (count > 1)
+    {
+      qsort (elements, count, sizeof (scew_element *),
+             order_up_to_date_ (tree) ? compare_ranks_ : compare_parents_);
+    }
+}
+
+scew_element* const*
+scew_tree_subtree_elements (scew_tree *tree,
+                            scew_element const *element,
+                            unsigned int *count)
+{
+  assert (tree != NULL);
+  assert (element != NULL);
+  assert (count != NULL);
+
+  *count = 0;
+
+  if (!order_up_to_date_ (tree))
+    {
+      return NULL;
+    }
+
+  *count = element->cache->order_post - element->cache->order_pre + 1;
+
+  return &tree->order->elements[element->cache->order_pre];
+}
+
+
+
+/* Protected */
+
+void
+scew_tree_changed_ (scew_tree *tree)
+{
+  scew_attribute_index_ *index = NULL;
+
+  assert (tree != NULL);
+
+  if (tree->names != NULL)
+    {
+      tree->names->valid = SCEW_FALSE;
+    }
+
+  if (tree->text != NULL)
+    {
+      tree->text->valid = SCEW_FALSE;
+    }
+
+  if (tree->order != NULL)
+    {
+      tree->order->valid = SCEW_FALSE;
+    }
+
+  for (index = tree->attributes; index != NULL; index = index->next)
+    {
+      index->valid = SCEW_FALSE;
+    }
+}
+
+void
+scew_tree_attribute_added_ (scew_tree *tree, scew_attribute const *attribute)
+{
+  scew_attribute_index_ *index = NULL;
+
+  assert (tree != NULL);
+  assert (attribute != NULL);
+
+  index = find_index_ (tree, attribute->name.data, attribute->name.len);
+  if ((index != NULL)
+      && is_up_to_date_ (tree, index->valid, index->root)
+      && !add_value_ (index, attribute))
+    {
+      /* It will be rebuilt next time. */
+      index->valid = SCEW_FALSE;
+    }
+}
+
+void
+scew_tree_attribute_removed_ (scew_tree *tree,
+                              scew_attribute const *attribute)
+{
+  scew_attribute_index_ *index = NULL;
+
+  assert (tree != NULL);
+  assert (attribute != NULL);
+
+  index = find_index_ (tree, attribute->name.data, attribute->name.len);
+  if ((index != NULL) && is_up_to_date_ (tree, index->valid, index->root))
+    {
+      remove_value_ (index, attribute);
+    }
+}
+
+void
+scew_tree_contents_added_ (scew_tree *tree, scew_element *element)
+{
+  assert (tree != NULL);
+  assert (element != NULL);
+
+  if (text_up_to_date_ (tree) && !add_tokens_ (tree->text, element))
+    {
+      /* It will be rebuilt next time. */
+      tree->text->valid = SCEW_FALSE;
+    }
+}
+
+void
+scew_tree_contents_removed_ (scew_tree *tree, scew_element const *element)
+{
+  assert (tree != NULL);
+  assert (element != NULL);
+
+  if (text_up_to_date_ (tree))
+    {
+      remove_tokens_ (tree->text, element);
+    }
+}
+
+void
+scew_tree_reindex_ (scew_tree *tree)
+{
+  scew_attribute_index_ *index = NULL;
+
+  assert (tree != NULL);
+
+  scew_tree_changed_ (tree);
+
+  if (tree->names != NULL)
+    {
+      scew_tree_index_names (tree);
+    }
+
+  for (index = tree->attributes; index != NULL; index = index->next)
+    {
+      scew_tree_index_attribute (tree, index->name);
+    }
+
+  if (tree->text != NULL)
+    {
+      scew_tree_index_text (tree);
+    }
+
+  if (tree->order != NULL)
+    {
+      scew_tree_index_order (tree);
+    }
+}
+
+void
+scew_tree_unindex_attributes_ (scew_tree *tree)
+{
+  scew_attribute_index_ *index = NULL;
+
+  assert (tree != NULL);
+
+  while (tree->attributes != NULL)
+    {
+      index = tree->attributes;
+      tree->attributes = index->next;
+
+      clear_values_ (index);
+      free (index->name);
+      free (index);
+    }
+}
+
+scew_bool
+scew_tree_names_lookup_ (scew_tree const *tree,
+                         XML_Char const *name,
+                         size_t len,
+                         scew_element * const **elements,
+                         unsigned int *count)
+{
+  scew_name_index_ const *index = tree->names;
+  name_entry_ const *entry = NULL;
+
+  assert (tree != NULL);
+  assert (name != NULL);
+  assert (elements != NULL);
+  assert (count != NULL);
+
+  *elements = NULL;
+  *count = 0;
+
+  if (!names_up_to_date_ (tree))
+    {
+      return SCEW_FALSE;
+    }
+
+  if (index->n_names > 0)
+    {
+      entry = find_name_ (index, name, len,
+                          scew_hash_string_ (scew_hash_init_ (), name, len));
+      if (entry->name != NULL)
+        {
+          *elements = &index->elements[entry->offset];
+          *count = entry->count;
+        }
+    }
+
+  return SCEW_TRUE;
+}
+
+
+
+/* Private */
+
+scew_bool
+is_up_to_date_ (scew_tree const *tree,
+                scew_bool valid,
+                scew_element const *root)
+{
+  return valid
+    && (root == tree->root)
+    && ((NULL == root) || scew_element_indexed_ (root));
+}
+
+void
+prepare_build_ (scew_tree *tree)
+{
+  /* Building an index marks all the elements again, which would make
+     other out of date indexes look up to date. */
+  if ((tree->root != NULL) && !scew_element_indexed_ (tree->root))
+    {
+      scew_tree_changed_ (tree);
+    }
+}
+
+
+
+/* Private (names) */
+
+scew_bool
+names_up_to_date_ (scew_tree const *tree)
+{
+  return (tree->names != NULL)
+    && is_up_to_date_ (tree, tree->names->valid, tree->names->root);
+}
+
+scew_bool
+build_names_ (scew_tree *tree)
+{
+  scew_name_index_ *index = tree->names;
+  scew_element *root = tree->root;
+  scew_element *element = NULL;
+  name_entry_ *entry = NULL;
+  unsigned int offset = 0;
+  unsigned int i = 0;
+
+  prepare_build_ (tree);
+  clear_names_ (index);
+
+  /* Count elements per name... */
+  for (element = root;
+       element != NULL;
+       element = next_element_ (element, root))
+    {
+      entry = add_name_ (index, element);
+      if ((NULL == entry) || (NULL == scew_element_set_indexed_ (element)))
+        {
+          clear_names_ (index);
+          return SCEW_FALSE;
+        }
+      entry->count += 1;
+      index->n_elements += 1;
+    }
+
+  if (index->n_elements > 0)
+    {
+      index->elements = malloc (index->n_elements * sizeof (scew_element *));
+      if (NULL == index->elements)
+        {
+          clear_names_ (index);
+          return SCEW_FALSE;
+        }
+    }
+
+  /* ... reserve their place in the elements array... */
+  for (i = 0; i < index->size; ++i)
+    {
+      entry = &index->names[i];
+      if (entry->name != NULL)
+        {
+          entry->offset = offset;
+          offset += entry->count;
+          entry->count = 0;
+        }
+    }
+
+  /* ... and store them, in document order. */
+  for (element = root;
+       element != NULL;
+       element = next_element_ (element, root))
+    {
+      entry = find_name_ (index, element->name.data, element->name.len,
+                          scew_hash_string_ (scew_hash_init_ (),
+                                             element->name.data,
+                                             element->name.len));
+      index->elements[entry->offset + entry->count] = element;
+      entry->count += 1;
+    }
+
+  index->valid = SCEW_TRUE;
+  index->root = root;
+
+  return SCEW_TRUE;
+}
+
+void
+clear_names_ (scew_name_index_ *index)
+{
+  free (index->names);
+  free (index->elements);
+  index->valid = SCEW_FALSE;
+  index->root = NULL;
+  index->n_names = 0;
+  index->size = 0;
+  index->names = NULL;
+  index->n_elements = 0;
+  index->elements = NULL;
+}
+
+name_entry_*
+find_name_ (scew_name_index_ const *index,
+            XML_Char const *name,
+            size_t len,
+            unsigned long hash)
+{
+  unsigned int mask = index->size - 1;
+  unsigned int i = hash & mask;
+  name_entry_ *entry = &index->names[i];
+
+  /* Linear probing, there is always at least one empty slot. */
+  while ((entry->name != NULL)
+         && ((entry->hash != hash)
+             || (entry->len != len)
+             || (scew_memcmp (entry->name, name, len) != 0)))
+    {
+      i = (i + 1) & mask;
+      entry = &index->names[i];
+    }
+
+  return entry;
+}
+
+name_entry_*
+add_name_ (scew_name_index_ *index, scew_element const *element)
+{
+  name_entry_ *entry = NULL;
+  unsigned long hash = scew_hash_string_ (scew_hash_init_ (),
+                                          element->name.data,
+                                          element->name.len);
+
+  /* Keep the table at most half full. */
+  if ((2 * (index->n_names + 1) > index->size) && !grow_names_ (index))
+    {
+      return NULL;
+    }
+
+  entry = find_name_ (index, element->name.data, element->name.len, hash);
+  if (NULL == entry->name)
+    {
+      entry->name = element->name.data;
+      entry->len = element->name.len;
+      entry->hash = hash;
+      index->n_names += 1;
+    }
+
+  return entry;
+}
+
+scew_bool
+grow_names_ (scew_name_index_ *index)
+{
+  name_entry_ *old_names = index->names;
+  unsigned int old_size = index->size;
+  unsigned int i = 0;
+
+  index->size = (0 == old_size) ? MIN_NAMES_ : 2 * old_size;
+  index->names = calloc (index->size, sizeof (name_entry_));
+  if (NULL == index->names)
+    {
+      index->names = old_names;
+      index->size = old_size;
+      return SCEW_FALSE;
+    }
+
+  for (i = 0; i < old_size; ++i)
+    {
+      if (old_names[i].name != NULL)
+        {
+          *find_name_ (index, old_names[i].name, old_names[i].len,
+                       old_names[i].hash) = old_names[i];
+        }
+    }
+  free (old_names);
+
+  return SCEW_TRUE;
+}
+
+
+
+/* Private (attribute values) */
+
+scew_attribute_index_*
+find_index_ (scew_tree const *tree, XML_Char const *name, size_t len)
+{
+  scew_attribute_index_ *index = NULL;
+
+  for (index = tree->attributes; index != NULL; index = index->next)
+    {
+      if ((index->len == len) && (scew_memcmp (index->name, name, len) == 0))
+        {
+          return index;
+        }
+    }
+
+  return NULL;
+}
+
+scew_bool
+build_values_ (scew_tree *tree, scew_attribute_index_ *index)
+{
+  scew_element *root = tree->root;
+  scew_element *element = NULL;
+  scew_attribute const *attribute = NULL;
+  scew_list *item = NULL;
+
+  prepare_build_ (tree);
+  clear_values_ (index);
+
+  for (element = root;
+       element != NULL;
+       element = next_element_ (element, root))
+    {
+      if (NULL == scew_element_set_indexed_ (element))
+        {
+          clear_values_ (index);
+          return SCEW_FALSE;
+        }
+
+      for (item = element->attributes;
+           item != NULL;
+           item = scew_list_next (item))
+        {
+          attribute = scew_list_data (item);
+          if ((attribute->name.len == index->len)
+              && (scew_memcmp (attribute->name.data, index->name,
+                               index->len) == 0)
+              && !add_value_ (index, attribute))
+            {
+              clear_values_ (index);
+              return SCEW_FALSE;
+            }
+        }
+    }
+
+  index->valid = SCEW_TRUE;
+  index->root = root;
+
+  return SCEW_TRUE;
+}
+
+void
+clear_values_ (scew_attribute_index_ *index)
+{
+  free (index->values);
+  index->valid = SCEW_FALSE;
+  index->root = NULL;
+  index->n_values = 0;
+  index->n_used = 0;
+  index->size = 0;
+  index->values = NULL;
+}
+
+scew_bool
+add_value_ (scew_attribute_index_ *index, scew_attribute const *attribute)
+{
+  value_entry_ *entry = NULL;
+  unsigned long hash = scew_hash_string_ (scew_hash_init_ (),
+                                          attribute->value.data,
+                                          attribute->value.len);
+  unsigned int mask = 0;
+  unsigned int i = 0;
+
+  /* Keep the table (including deleted entries) at most half full. */
+  if ((2 * (index->n_used + 1) > index->size) && !resize_values_ (index))
+    {
+      return SCEW_FALSE;
+    }
+
+  mask = index->size - 1;
+  i = hash & mask;
+  while (index->values[i].attribute != NULL)
+    {
+      i = (i + 1) & mask;
+    }
+
+  entry = &index->values[i];
+  if (!entry->deleted)
+    {
+      index->n_used += 1;
+    }
+  entry->attribute = attribute;
+  entry->deleted = SCEW_FALSE;
+  entry->hash = hash;
+  index->n_values += 1;
+
+  return SCEW_TRUE;
+}
+
+void
+remove_value_ (scew_attribute_index_ *index, scew_attribute const *attribute)
+{
+  value_entry_ *entry = NULL;
+  unsigned long hash = 0;
+  unsigned int mask = index->size - 1;
+  unsigned int i = 0;
+
+  if (0 == index->size)
+    {
+      return;
+    }
+
+  hash = scew_hash_string_ (scew_hash_init_ (),
+                            attribute->value.data,
+                            attribute->value.len);
+  i = hash & mask;
+  entry = &index->values[i];
+  while ((entry->attribute != NULL) || entry->deleted)
+    {
+      if (entry->attribute == attribute)
+        {
+          entry->attribute = NULL;
+          entry->deleted = SCEW_TRUE;
+          index->n_values -= 1;
+          return;
+        }
+      i = (i + 1) & mask;
+      entry = &index->values[i];
+    }
+}
+
+scew_element*
+find_value_ (scew_attribute_index_ const *index,
+             XML_Char const *value,
+             size_t len)
+{
+  value_entry_ const *entry = NULL;
+  scew_attribute const *attribute = NULL;
+  unsigned long hash = 0;
+  unsigned int mask = index->size - 1;
+  unsigned int i = 0;
+
+  if (0 == index->n_values)
+    {
+      return NULL;
+    }
+
+  hash = scew_hash_string_ (scew_hash_init_ (), value, len);
+  i = hash & mask;
+  entry = &index->values[i];
+  while ((entry->attribute != NULL) || entry->deleted)
+    {
+      attribute = entry->attribute;
+      if ((attribute != NULL)
+          && (entry->hash == hash)
+          && (attribute->value.len == len)
+          && (scew_memcmp (attribute->value.data, value, len) == 0))
+        {
+          return attribute->parent;
+        }
+      i = (i + 1) & mask;
+      entry = &index->values[i];
+    }
+
+  return NULL;
+}
+
+scew_bool
+resize_values_ (scew_attribute_index_ *index)
+{
+  value_entry_ *old_values = index->values;
+  unsigned int old_size = index->size;
+  unsigned int size = MIN_VALUES_;
+  unsigned int i = 0;
+  unsigned int j = 0;
+
+  /* Deleted entries are dropped, so the table might not grow. */
+  while (size < 4 * (index->n_values + 1))
+    {
+      size *= 2;
+    }
+
+  index->values = calloc (size, sizeof (value_entry_));
+  if (NULL == index->values)
+    {
+      index->values = old_values;
+      return SCEW_FALSE;
+    }
+  index->size = size;
+  index->n_used = index->n_values;
+
+  for (i = 0; i < old_size; ++i)
+    {
+      if (old_values[i].attribute != NULL)
+        {
+          j = old_values[i].hash & (size - 1);
+          while (index->values[j].attribute != NULL)
+            {
+              j = (j + 1) & (size - 1);
+            }
+          index->values[j] = old_values[i];
+        }
+    }
+  free (old_values);
+
+  return SCEW_TRUE;
+}
+
+
+
+/* Private (contents) */
+
+scew_bool
+text_up_to_date_ (scew_tree const *tree)
+{
+  return (tree->text != NULL)
+    && is_up_to_date_ (tree, tree->text->valid, tree->text->root);
+}
+
+scew_bool
+build_text_ (scew_tree *tree)
+{
+  scew_text_index_ *index = tree->text;
+  scew_element *root = tree->root;
+  scew_element *element = NULL;
+
+  prepare_build_ (tree);
+  clear_text_ (index);
+
+  for (element = root;
+       element != NULL;
+       element = next_element_ (element, root))
+    {
+      /* Elements get their cache (for their sequence number) first. */
+      if ((NULL == scew_element_set_indexed_ (element))
+          || !add_tokens_ (index, element))
+        {
+          clear_text_ (index);
+          return SCEW_FALSE;
+        }
+    }
+
+  index->valid = SCEW_TRUE;
+  index->root = root;
+
+  return SCEW_TRUE;
+}
+
+void
+clear_text_ (scew_text_index_ *index)
+{
+  unsigned int i = 0;
+
+  for (i = 0; i < index->size; ++i)
+    {
+      free (index->tokens[i].token);
+      free (index->tokens[i].elements);
+      free (index->tokens[i].seqs);
+    }
+  free (index->tokens);
+  index->valid = SCEW_FALSE;
+  index->root = NULL;
+  index->next_seq = 0;
+  index->n_tokens = 0;
+  index->size = 0;
+  index->tokens = NULL;
+}
+
+scew_bool
+add_tokens_ (scew_text_index_ *index, scew_element *element)
+{
+  XML_Char const *end = element->contents.data + element->contents.len;
+  XML_Char const *token = element->contents.data;
+  token_entry_ *entry = NULL;
+  unsigned long hash = 0;
+  size_t len = 0;
+
+  /* Running out of sequence numbers just rebuilds the index. */
+  if (UINT_MAX == index->next_seq)
+    {
+      return SCEW_FALSE;
+    }
+  element->cache->text_seq = index->next_seq;
+  index->next_seq += 1;
+
+  if (NULL == token)
+    {
+      return SCEW_TRUE;
+    }
+
+  while ((token = next_token_ (token, end, &len)) != NULL)
+    {
+      hash = scew_hash_string_ (scew_hash_init_ (), token, len);
+      entry = add_token_ (index, token, len, hash);
+      if (NULL == entry)
+        {
+          return SCEW_FALSE;
+        }
+
+      /* The element is the last one added if the token is repeated. */
+      if ((0 == entry->used) || (entry->elements[entry->used - 1] != element))
+        {
+          if ((entry->used == entry->capacity) && !grow_postings_ (entry))
+            {
+              return SCEW_FALSE;
+            }
+          entry->elements[entry->used] = element;
+          entry->seqs[entry->used] = element->cache->text_seq;
+          entry->used += 1;
+          entry->count += 1;
+        }
+
+      token += len;
+    }
+
+  return SCEW_TRUE;
+}
+
+void
+remove_tokens_ (scew_text_index_ *index, scew_element const *element)
+{
+  XML_Char const *end = element->contents.data + element->contents.len;
+  XML_Char const *token = element->contents.data;
+  token_entry_ *entry = NULL;
+  unsigned int i = 0;
+  size_t len = 0;
+
+  if ((NULL == token) || (0 == index->n_tokens))
+    {
+      return;
+    }
+
+  while ((token = next_token_ (token, end, &len)) != NULL)
+    {
+      entry = find_token_ (index, token, len,
+                           scew_hash_string_ (scew_hash_init_ (), token, len));
+      if (entry->token != NULL)
+        {
+          /* Repeated tokens find their posting already cleared. */
+          i = find_posting_ (entry, element->cache->text_seq);
+          if ((i < entry->used) && (entry->elements[i] == element))
+            {
+              entry->elements[i] = NULL;
+              entry->count -= 1;
+            }
+        }
+      token += len;
+    }
+}
+
+XML_Char const*
+next_token_ (XML_Char const *text, XML_Char const *end, size_t *len)
+{
+  XML_Char const *token = NULL;
+
+  while ((text < end) && IS_DELIMITER_ (*text))
+    {
+      text += 1;
+    }
+
+  if (text == end)
+    {
+      return NULL;
+    }
+
+  token = text;
+  while ((text < end) && !IS_DELIMITER_ (*text))
+    {
+      text += 1;
+    }
+  *len = text - token;
+
+  return token;
+}
+
+token_entry_*
+find_token_ (scew_text_index_ const *index,
+             XML_Char const *token,
+             size_t len,
+             unsigned long hash)
+{
+  unsigned int mask = index->size - 1;
+  unsigned int i = hash & mask;
+  token_entry_ *entry = &index->tokens[i];
+
+  /* Linear probing, there is always at least one empty slot. */
+  while ((entry->token != NULL)
+         && ((entry->hash != hash)
+             || (entry->len != len)
+             || (scew_memcmp (entry->token, token, len) != 0)))
+    {
+      i = (i + 1) & mask;
+      entry = &index->tokens[i];
+    }
+
+  return entry;
+}
+
+token_entry_*
+add_token_ (scew_text_index_ *index,
+            XML_Char const *token,
+            size_t len,
+            unsigned long hash)
+{
+  token_entry_ *entry = NULL;
+
+  /* Keep the table at most half full. */
+  if ((2 * (index->n_tokens + 1) > index->size) && !grow_tokens_ (index))
+    {
+      return NULL;
+    }
+
+  entry = find_token_ (index, token, len, hash);
+  if (NULL == entry->token)
+    {
+      entry->token = scew_strndup (token, len);
+      if (NULL == entry->token)
+        {
+          return NULL;
+        }
+      entry->len = len;
+      entry->hash = hash;
+      index->n_tokens += 1;
+    }
+
+  return entry;
+}
+
+scew_bool
+grow_tokens_ (scew_text_index_ *index)
+{
+  token_entry_ *old_tokens = index->tokens;
+  unsigned int old_size = index->size;
+  unsigned int i = 0;
+
+  index->size = (0 == old_size) ? MIN_TOKENS_ : 2 * old_size;
+  index->tokens = calloc (index->size, sizeof (token_entry_));
+  if (NULL == index->tokens)
+    {
+      index->tokens = old_tokens;
+      index->size = old_size;
+      return SCEW_FALSE;
+    }
+
+  for (i = 0; i < old_size; ++i)
+    {
+      if (old_tokens[i].token != NULL)
+        {
+          *find_token_ (index, old_tokens[i].token, old_tokens[i].len,
+                        old_tokens[i].hash) = old_tokens[i];
+        }
+    }
+  free (old_tokens);
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+grow_postings_ (token_entry_ *entry)
+{
+  scew_element **elements = NULL;
+  unsigned int *seqs = NULL;
+  unsigned int capacity = 0;
+
+  /* Mostly cleared postings are compacted instead, which is amortized
+     by the removals that cleared them. */
+  if ((entry->used > 0) && (2 * entry->count <= entry->used))
+    {
+      compact_postings_ (entry);
+      return SCEW_TRUE;
+    }
+
+  capacity = (0 == entry->capacity) ? MIN_POSTINGS_ : 2 * entry->capacity;
+  elements = realloc (entry->elements, capacity * sizeof (scew_element *));
+  if (NULL == elements)
+    {
+      return SCEW_FALSE;
+    }
+  entry->elements = elements;
+
+  seqs = realloc (entry->seqs, capacity * sizeof (unsigned int));
+  if (NULL == seqs)
+    {
+      return SCEW_FALSE;
+    }
+  entry->seqs = seqs;
+  entry->capacity = capacity;
+
+  return SCEW_TRUE;
+}
+
+void
+compact_postings_ (token_entry_ *entry)
+{
+  unsigned int i = 0;
+  unsigned int used = 0;
+
+  for (i = 0; i < entry->used; ++i)
+    {
+      if (entry->elements[i] != NULL)
+        {
+          entry->elements[used] = entry->elements[i];
+          entry->seqs[used] = entry->seqs[i];
+          used += 1;
+        }
+    }
+  entry->used = used;
+}
+
+unsigned int
+find_posting_ (token_entry_ const *entry, unsigned int seq)
+{
+  unsigned int low = 0;
+  unsigned int high = entry->used;
+  unsigned int middle = 0;
+
+  /* First posting with a sequence number not lower than seq. */
+  while (low < high)
+    {
+      middle = low + (high - low) / 2;
+      if (entry->seqs[middle] < seq)
+        {
+          low = middle + 1;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+
+  return low;
+}
+
+
+
+/* Private (document order) */
+
+scew_bool
+order_up_to_date_ (scew_tree *tree)
+{
+  /* An enabled index is rebuilt if needed. */
+  return (tree->order != NULL) && scew_tree_index_order (tree);
+}
+
+scew_bool
+build_order_ (scew_tree *tree)
+{
+  scew_order_index_ *index = tree->order;
+  scew_element_cache_ *cache = NULL;
+  scew_element *root = tree->root;
+  scew_element *element = root;
+  scew_element **elements = NULL;
+  scew_list *next = NULL;
+  unsigned int size = 0;
+
+  prepare_build_ (tree);
+  clear_order_ (index);
+
+  while (element != NULL)
+    {
+      if (index->n_elements == index->size)
+        {
+          size = (0 == index->size) ? MIN_ORDER_ : 2 * index->size;
+          elements = realloc (index->elements, size * sizeof (scew_element *));
+          if (NULL == elements)
+            {
+              clear_order_ (index);
+              return SCEW_FALSE;
+            }
+          index->elements = elements;
+          index->size = size;
+        }
+
+      cache = scew_element_set_indexed_ (element);
+      if (NULL == cache)
+        {
+          clear_order_ (index);
+          return SCEW_FALSE;
+        }
+
+      cache->order_pre = index->n_elements;
+      index->elements[index->n_elements] = element;
+      index->n_elements += 1;
+
+      if (element->children != NULL)
+        {
+          element = scew_list_data (element->children);
+          continue;
+        }
+
+      /* The subtrees we leave end with the current element. */
+      next = NULL;
+      while ((NULL == next) && (element != NULL))
+        {
+          element->cache->order_post = index->n_elements - 1;
+          if (element == root)
+            {
+              element = NULL;
+            }
+          else
+            {
+              next = scew_list_next (element->myself);
+              element = (NULL == next)
+                ? element->parent
+                : (scew_element *) scew_list_data (next);
+            }
+        }
+    }
+
+  index->valid = SCEW_TRUE;
+  index->root = root;
+
+  return SCEW_TRUE;
+}
+
+void
+clear_order_ (scew_order_index_ *index)
+{
+  free (index->elements);
+  index->valid = SCEW_FALSE;
+  index->root = NULL;
+  index->n_elements = 0;
+  index->size = 0;
+  index->elements = NULL;
+}
+
+int
+compare_ranks_ (void const *a, void const *b)
+{
+  scew_element const *element_a = *(scew_element * const *) a;
+  scew_element const *element_b = *(scew_element * const *) b;
+
+  return (element_a->cache->order_pre > element_b->cache->order_pre)
+    - (element_a->cache->order_pre < element_b->cache->order_pre);
+}
+
+int
+compare_parents_ (void const *a, void const *b)
+{
+  scew_element const *element_a = *(scew_element * const *) a;
+  scew_element const *element_b = *(scew_element * const *) b;
+  unsigned int depth_a = depth_ (element_a);
+  unsigned int depth_b = depth_ (element_b);
+  int ancestry = (depth_a > depth_b) - (depth_a < depth_b);
+  scew_list *item = NULL;
+
+  /* Bring both elements to the same depth... */
+  for (; depth_a > depth_b; --depth_a)
+    {
+      element_a = element_a->parent;
+    }
+  for (; depth_b > depth_a; --depth_b)
+    {
+      element_b = element_b->parent;
+    }
+
+  /* ... where ancestors come first... */
+  if (element_a == element_b)
+    {
+      return ancestry;
+    }
+
+  /* ... and then up to the children of their closest common
+     ancestor. */
+  while (element_a->parent != element_b->parent)
+    {
+      element_a = element_a->parent;
+      element_b = element_b->parent;
+    }
+
+  for (item = element_a->myself; item != NULL; item = scew_list_next (item))
+    {
+      if (scew_list_data (item) == element_b)
+        {
+          return -1;
+        }
+    }
+
+  return 1;
+}
+
+unsigned int
+depth_ (scew_element const *element)
+{
+  unsigned int depth = 0;
+
+  for (element = element->parent; element != NULL; element = element->parent)
+    {
+      depth += 1;
+    }
+
+  return depth;
+}
+
+
+
+
+/* Private (traversal) */
+
+scew_element*
+next_element_ (scew_element *element, scew_element const *root)
+{
+  scew_list *next = NULL;
+
+  /* Pre-order traversal, without going above the root. */
+  if (element->children != NULL)
+    {
+      return scew_list_data (element->children);
+    }
+
+  while (element != root)
+    {
+      next = scew_list_next (element->myself);
+      if (next != NULL)
+        {
+          return scew_list_data (next);
+        }
+      element = element->parent;
+    }
+
+  return NULL;
+}
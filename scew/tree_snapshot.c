@@ -0,0 +1,905 @@
+/**
+ * @file     tree_snapshot.c
+ * @brief    tree.h implementation (tree snapshots)
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 20:10
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "xtree.h"
+
+#include "xattribute.h"
+#include "xelement.h"
+#include "xerror.h"
+#include "xlist.h"
+#include "xstr.h"
+
+#include "str.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+#define MAP_SNAPSHOTS
+#endif /* HAVE_MMAP && HAVE_SYS_MMAN_H */
+
+#if defined (HAVE_SYS_STAT_H) || defined (_MSC_VER)
+#define STAT_SOURCES
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif /* HAVE_SYS_STAT_H || _MSC_VER */
+
+#ifdef MAP_SNAPSHOTS
+#include <fcntl.h>
+#include <sys/mman.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+#endif /* MAP_SNAPSHOTS */
+
+
+
+/* Private */
+
+/* Identifies snapshot files (and their format version). */
+#define MAGIC_ "SCEWSNP2"
+
+/* Tells whether the snapshot was saved with the same byte order. */
+#define BYTE_ORDER_ 0x01020304UL
+
+/* The frozen block starts at a multiple of this after the header. */
+#define ALIGNMENT_ 16
+
+/* Tree properties stored after the frozen block. */
+enum
+  {
+    VERSION_,
+    ENCODING_,
+    PREAMBLE_,
+    N_PROPERTIES_
+  };
+
+/* Types whose sizes must match the ones of the saving build. */
+enum
+  {
+    POINTER_SIZE_,
+    CHAR_SIZE_,
+    ELEMENT_SIZE_,
+    LIST_SIZE_,
+    ATTRIBUTE_SIZE_,
+    CACHE_SIZE_,
+    N_SIZES_
+  };
+
+/*
+ * Snapshot file header. It is followed by the frozen block of the
+ * tree, with its pointers stored as offsets from the beginning of the
+ * block plus one (0 being NULL), and the tree properties.
+ */
+typedef struct
+{
+  char magic[sizeof (MAGIC_)];
+  unsigned long byte_order;
+  unsigned long sizes[N_SIZES_];
+  unsigned int has_source;
+  unsigned long source_size;
+  long source_mtime;
+  scew_frozen_layout_ layout;
+  size_t properties[N_PROPERTIES_]; /* Length plus one (0 if NULL) */
+  scew_tree_standalone standalone;
+} header_;
+
+/* Size of the header, padded so the frozen block is aligned. */
+#define HEADER_SIZE_                                                    \
+  (((sizeof (header_) + ALIGNMENT_ - 1) / ALIGNMENT_) * ALIGNMENT_)
+
+/*
+ * Turns the offsets of a snapshot block back into pointers. Snapshot
+ * files are not trusted, so the block is walked in the same order it
+ * was frozen (see tree_freeze.c) and every offset must point exactly
+ * where the freezer would have put the object. Cursors point to the
+ * next list item, attribute and pool character to be used.
+ */
+typedef struct
+{
+  char *block;                  /* The frozen block */
+  size_t size;                  /* Size of the block in bytes */
+  scew_element *elements;       /* Elements region */
+  scew_element_cache_ *caches;  /* Caches region (one per element) */
+  unsigned int n_elements;      /* Number of elements */
+  unsigned int n_children;      /* Number of children list items seen */
+  scew_list *items;             /* Next list item */
+  scew_list *items_end;
+  scew_attribute *attributes;   /* Next attribute */
+  scew_attribute *attributes_end;
+  XML_Char *pool;               /* Next pool character */
+  XML_Char *pool_end;
+  scew_bool valid;              /* Whether all offsets were in the block */
+} decoder_;
+
+static void fill_header_ (header_ *header, scew_tree const *tree);
+static scew_bool check_header_ (header_ const *header, size_t size);
+static scew_bool add_size_ (size_t *total, size_t count, size_t size);
+static scew_bool stat_source_ (char const *source_name,
+                               unsigned long *size,
+                               long *mtime);
+static scew_bool write_snapshot_ (FILE *out,
+                                  header_ const *header,
+                                  void const *block,
+                                  scew_tree const *tree);
+static void encode_block_ (char *block, scew_frozen_layout_ const *layout);
+static void* encode_ (char *block, void *pointer);
+static scew_bool decode_block_ (char *block,
+                                scew_frozen_layout_ const *layout);
+static scew_bool decode_element_ (decoder_ *decoder, unsigned int index);
+static scew_bool decode_items_ (decoder_ *decoder,
+                                scew_list **first,
+                                scew_list **last,
+                                unsigned int count);
+static scew_bool decode_string_ (decoder_ *decoder, scew_xstr *str);
+static void* decode_ (decoder_ *decoder, void *pointer);
+static scew_bool element_index_ (decoder_ const *decoder,
+                                 scew_element const *element,
+                                 unsigned int *index);
+static scew_tree* create_tree_ (char *base, header_ const *header);
+static XML_Char* property_ (XML_Char const *chars, size_t stored);
+static char* map_ (char const *file_name, size_t *size);
+static void unmap_ (char *base, size_t size);
+
+
+
+/* Public */
+
+scew_bool
+scew_tree_save_snapshot (scew_tree const *tree,
+                         char const *file_name,
+                         char const *source_name)
+{
+  header_ header;
+  void *block = NULL;
+  FILE *out = NULL;
+  scew_bool result = SCEW_FALSE;
+
+  assert (tree != NULL);
+  assert (file_name != NULL);
+
+  fill_header_ (&header, tree);
+
+  if (source_name != NULL)
+    {
+      header.has_source = 1;
+      if (!stat_source_ (source_name, &header.source_size,
+                         &header.source_mtime))
+        {
+          scew_error_set_last_error_ (scew_error_io);
+          return SCEW_FALSE;
+        }
+    }
+
+  if (tree->root != NULL)
+    {
+      block = scew_tree_freeze_block_ (tree->root, &header.layout);
+      if (NULL == block)
+        {
+          return SCEW_FALSE;
+        }
+
+      encode_block_ (block, &header.layout);
+    }
+
+  out = fopen (file_name, "wb");
+  if (out != NULL)
+    {
+      result = write_snapshot_ (out, &header, block, tree);
+      result = (fclose (out) == 0) && result;
+    }
+
+  if (!result)
+    {
+      scew_error_set_last_error_ (scew_error_io);
+    }
+
+  free (block);
+
+  return result;
+}
+
+scew_tree*
+scew_tree_open_snapshot (char const *file_name, char const *source_name)
+{
+  header_ const *header = NULL;
+  scew_tree *tree = NULL;
+  unsigned long source_size = 0;
+  long source_mtime = 0;
+  size_t size = 0;
+  char *base = NULL;
+
+  assert (file_name != NULL);
+
+  base = map_ (file_name, &size);
+  if (NULL == base)
+    {
+      scew_error_set_last_error_ (scew_error_io);
+      return NULL;
+    }
+
+  header = (header_ const *) base;
+  if (!check_header_ (header, size)
+      || ((source_name != NULL)
+          && (!header->has_source
+              || !stat_source_ (source_name, &source_size, &source_mtime)
+              || (source_size != header->source_size)
+              || (source_mtime != header->source_mtime))))
+    {
+      scew_error_set_last_error_ (scew_error_snapshot);
+      unmap_ (base, size);
+      return NULL;
+    }
+
+  if (!decode_block_ (base + HEADER_SIZE_, &header->layout))
+    {
+      scew_error_set_last_error_ (scew_error_snapshot);
+      unmap_ (base, size);
+      return NULL;
+    }
+
+  tree = create_tree_ (base, header);
+  if (NULL == tree)
+    {
+      scew_error_set_last_error_ (scew_error_no_memory);
+      unmap_ (base, size);
+      return NULL;
+    }
+  tree->snapshot = base;
+  tree->snapshot_size = size;
+
+  return tree;
+}
+
+
+
+/* Protected */
+
+void
+scew_tree_close_snapshot_ (scew_tree *tree)
+{
+  assert (tree != NULL);
+
+  unmap_ (tree->snapshot, tree->snapshot_size);
+  tree->snapshot = NULL;
+  tree->snapshot_size = 0;
+  tree->frozen = NULL;
+  tree->root = NULL;
+}
+
+
+
+/* Private */
+
+void
+fill_header_ (header_ *header, scew_tree const *tree)
+{
+  XML_Char const *properties[N_PROPERTIES_];
+  unsigned int i = 0;
+
+  memset (header, 0, sizeof (header_));
+  memcpy (header->magic, MAGIC_, sizeof (MAGIC_));
+  header->byte_order = BYTE_ORDER_;
+  header->sizes[POINTER_SIZE_] = sizeof (void *);
+  header->sizes[CHAR_SIZE_] = sizeof (XML_Char);
+  header->sizes[ELEMENT_SIZE_] = sizeof (scew_element);
+  header->sizes[LIST_SIZE_] = sizeof (scew_list);
+  header->sizes[ATTRIBUTE_SIZE_] = sizeof (scew_attribute);
+  header->sizes[CACHE_SIZE_] = sizeof (scew_element_cache_);
+
+  if (NULL == tree)
+    {
+      return;
+    }
+
+  header->standalone = tree->standalone;
+
+  properties[VERSION_] = tree->version;
+  properties[ENCODING_] = tree->encoding;
+  properties[PREAMBLE_] = tree->preamble;
+  for (i = 0; i < N_PROPERTIES_; ++i)
+    {
+      header->properties[i] =
+        (NULL == properties[i]) ? 0 : scew_strlen (properties[i]) + 1;
+    }
+}
+
+scew_bool
+check_header_ (header_ const *header, size_t size)
+{
+  header_ expected;
+  size_t total = 0;
+  unsigned int i = 0;
+
+  if (size < HEADER_SIZE_)
+    {
+      return SCEW_FALSE;
+    }
+
+  /* The snapshot must have been saved by a build like this one. */
+  fill_header_ (&expected, NULL);
+  if ((memcmp (header->magic, expected.magic, sizeof (MAGIC_)) != 0)
+      || (header->byte_order != expected.byte_order)
+      || (memcmp (header->sizes, expected.sizes, sizeof (expected.sizes)) != 0))
+    {
+      return SCEW_FALSE;
+    }
+
+  /* An empty tree has no elements at all. */
+  if ((0 == header->layout.n_elements)
+      && ((header->layout.n_items > 0) || (header->layout.n_attributes > 0)
+          || (header->layout.n_chars > 0)))
+    {
+      return SCEW_FALSE;
+    }
+
+  /* Sizes come from the file, so they might overflow. */
+  total = HEADER_SIZE_;
+  if (!add_size_ (&total, header->layout.n_elements, sizeof (scew_element))
+      || !add_size_ (&total, header->layout.n_elements,
+                     sizeof (scew_element_cache_))
+      || !add_size_ (&total, header->layout.n_items, sizeof (scew_list))
+      || !add_size_ (&total, header->layout.n_attributes,
+                     sizeof (scew_attribute))
+      || !add_size_ (&total, header->layout.n_chars, sizeof (XML_Char)))
+    {
+      return SCEW_FALSE;
+    }
+  for (i = 0; i < N_PROPERTIES_; ++i)
+    {
+      if ((header->properties[i] > 0)
+          && !add_size_ (&total, header->properties[i] - 1,
+                         sizeof (XML_Char)))
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  return (total == size);
+}
+
+scew_bool
+add_size_ (size_t *total, size_t count, size_t size)
+{
+  if (count > ((size_t) -1 - *total) / size)
+    {
+      return SCEW_FALSE;
+    }
+
+  *total += count * size;
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+stat_source_ (char const *source_name, unsigned long *size, long *mtime)
+{
+#ifdef STAT_SOURCES
+  struct stat info;
+
+  if (stat (source_name, &info) != 0)
+    {
+      return SCEW_FALSE;
+    }
+
+  *size = (unsigned long) info.st_size;
+  *mtime = (long) info.st_mtime;
+
+  return SCEW_TRUE;
+#else
+  /* There is no way to tell whether the source has changed. */
+  return SCEW_FALSE;
+#endif /* STAT_SOURCES */
+}
+
+scew_bool
+write_snapshot_ (FILE *out,
+                 header_ const *header,
+                 void const *block,
+                 scew_tree const *tree)
+{
+  static char const padding[ALIGNMENT_] = { 0 };
+  XML_Char const *properties[N_PROPERTIES_];
+  size_t size = 0;
+  unsigned int i = 0;
+
+  if ((fwrite (header, sizeof (header_), 1, out) != 1)
+      || (fwrite (padding, 1, HEADER_SIZE_ - sizeof (header_), out)
+          != HEADER_SIZE_ - sizeof (header_)))
+    {
+      return SCEW_FALSE;
+    }
+
+  size = scew_tree_frozen_size_ (&header->layout);
+  if ((size > 0) && (fwrite (block, size, 1, out) != 1))
+    {
+      return SCEW_FALSE;
+    }
+
+  properties[VERSION_] = tree->version;
+  properties[ENCODING_] = tree->encoding;
+  properties[PREAMBLE_] = tree->preamble;
+  for (i = 0; i < N_PROPERTIES_; ++i)
+    {
+      size = (header->properties[i] > 0) ? header->properties[i] - 1 : 0;
+      if ((size > 0)
+          && (fwrite (properties[i], sizeof (XML_Char), size, out) != size))
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  return SCEW_TRUE;
+}
+
+void
+encode_block_ (char *block, scew_frozen_layout_ const *layout)
+{
+  scew_element *elements = (scew_element *) block;
+  scew_element_cache_ *caches =
+    (scew_element_cache_ *) (elements + layout->n_elements);
+  scew_list *items = (scew_list *) (caches + layout->n_elements);
+  scew_attribute *attributes = (scew_attribute *) (items + layout->n_items);
+  scew_element *element = NULL;
+  scew_attribute *attribute = NULL;
+  scew_list *item = NULL;
+  unsigned int i = 0;
+
+  for (i = 0; i < layout->n_elements; ++i)
+    {
+      element = &elements[i];
+      element->name.data = encode_ (block, element->name.data);
+      element->contents.data = encode_ (block, element->contents.data);
+      element->parent = encode_ (block, element->parent);
+      element->myself = encode_ (block, element->myself);
+      element->children = encode_ (block, element->children);
+      element->last_child = encode_ (block, element->last_child);
+      element->attributes = encode_ (block, element->attributes);
+      element->last_attribute = encode_ (block, element->last_attribute);
+      element->cache = encode_ (block, element->cache);
+    }
+
+  for (i = 0; i < layout->n_items; ++i)
+    {
+      item = &items[i];
+      item->data = encode_ (block, item->data);
+      item->prev = encode_ (block, item->prev);
+      item->next = encode_ (block, item->next);
+    }
+
+  for (i = 0; i < layout->n_attributes; ++i)
+    {
+      attribute = &attributes[i];
+      attribute->name.data = encode_ (block, attribute->name.data);
+      attribute->value.data = encode_ (block, attribute->value.data);
+      attribute->parent = encode_ (block, attribute->parent);
+    }
+}
+
+void*
+encode_ (char *block, void *pointer)
+{
+  return (NULL == pointer) ? NULL : (void *) ((char *) pointer - block + 1);
+}
+
+scew_bool
+decode_block_ (char *block, scew_frozen_layout_ const *layout)
+{
+  decoder_ decoder;
+  unsigned int i = 0;
+
+  decoder.block = block;
+  decoder.size = scew_tree_frozen_size_ (layout);
+  decoder.elements = (scew_element *) block;
+  decoder.n_elements = layout->n_elements;
+  decoder.n_children = 0;
+  decoder.caches =
+    (scew_element_cache_ *) (decoder.elements + layout->n_elements);
+  decoder.items = (scew_list *) (decoder.caches + layout->n_elements);
+  decoder.items_end = decoder.items + layout->n_items;
+  decoder.attributes = (scew_attribute *) decoder.items_end;
+  decoder.attributes_end = decoder.attributes + layout->n_attributes;
+  decoder.pool = (XML_Char *) decoder.attributes_end;
+  decoder.pool_end = decoder.pool + layout->n_chars;
+  decoder.valid = SCEW_TRUE;
+
+  for (i = 0; i < layout->n_elements; ++i)
+    {
+      if (!decode_element_ (&decoder, i))
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  /* Every object must have been used, and every element but the root
+     must be the child of another one. */
+  return decoder.valid
+    && (decoder.items == decoder.items_end)
+    && (decoder.attributes == decoder.attributes_end)
+    && (decoder.pool == decoder.pool_end)
+    && ((0 == layout->n_elements)
+        || (decoder.n_children == layout->n_elements - 1));
+}
+
+scew_bool
+decode_element_ (decoder_ *decoder, unsigned int index)
+{
+  scew_element *element = &decoder->elements[index];
+  scew_element *parent = NULL;
+  scew_attribute *attribute = NULL;
+  scew_list *items = NULL;
+  scew_list *myself = NULL;
+  unsigned int other = 0;
+  unsigned int i = 0;
+
+  if (!decode_string_ (decoder, &element->name)
+      || !decode_string_ (decoder, &element->contents))
+    {
+      return SCEW_FALSE;
+    }
+
+  /* Parents come before their children, so their lists of children
+     have already been decoded and the element must be in one of
+     them. */
+  parent = element->parent = decode_ (decoder, element->parent);
+  myself = element->myself = decode_ (decoder, element->myself);
+  element->cache = decode_ (decoder, element->cache);
+  if (!decoder->valid || (element->cache != &decoder->caches[index]))
+    {
+      return SCEW_FALSE;
+    }
+  else if (0 == index)
+    {
+      if ((parent != NULL) || (myself != NULL))
+        {
+          return SCEW_FALSE;
+        }
+    }
+  else if ((NULL == parent) || (NULL == myself)
+           || !element_index_ (decoder, parent, &other) || (other >= index)
+           || (0 == parent->n_children)
+           || ((char *) myself < (char *) parent->children)
+           || ((char *) myself > (char *) parent->last_child)
+           || ((((char *) myself - (char *) parent->children)
+                % sizeof (scew_list)) != 0)
+           || (myself->data != element))
+    {
+      return SCEW_FALSE;
+    }
+
+  /* Attributes... */
+  if (!decode_items_ (decoder, &element->attributes,
+                      &element->last_attribute, element->n_attributes))
+    {
+      return SCEW_FALSE;
+    }
+  items = element->attributes;
+  for (i = 0; i < element->n_attributes; ++i)
+    {
+      attribute = decoder->attributes++;
+      items[i].data = decode_ (decoder, items[i].data);
+      if ((items[i].data != attribute)
+          || (attribute == decoder->attributes_end)
+          || !decode_string_ (decoder, &attribute->name)
+          || !decode_string_ (decoder, &attribute->value))
+        {
+          return SCEW_FALSE;
+        }
+
+      attribute->parent = decode_ (decoder, attribute->parent);
+      if (attribute->parent != element)
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  /* ... and children, which come after the element. */
+  if (!decode_items_ (decoder, &element->children,
+                      &element->last_child, element->n_children))
+    {
+      return SCEW_FALSE;
+    }
+  items = element->children;
+  for (i = 0; i < element->n_children; ++i)
+    {
+      items[i].data = decode_ (decoder, items[i].data);
+      if (!decoder->valid
+          || (NULL == items[i].data)
+          || !element_index_ (decoder, items[i].data, &other)
+          || (other <= index))
+        {
+          return SCEW_FALSE;
+        }
+    }
+  decoder->n_children += element->n_children;
+
+  /* Snapshots are not linked to any tree nor to its indexes, and can
+     not be modified. */
+  element->tree = NULL;
+  element->cache->indexed = SCEW_FALSE;
+  element->cache->frozen = SCEW_TRUE;
+  element->cache->epoch_pending = SCEW_FALSE;
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+decode_items_ (decoder_ *decoder,
+               scew_list **first,
+               scew_list **last,
+               unsigned int count)
+{
+  scew_list *items = decoder->items;
+  scew_list *item = NULL;
+  unsigned int i = 0;
+
+  *first = decode_ (decoder, *first);
+  *last = decode_ (decoder, *last);
+  if (!decoder->valid)
+    {
+      return SCEW_FALSE;
+    }
+  else if (0 == count)
+    {
+      return (NULL == *first) && (NULL == *last);
+    }
+
+  /* Lists are stored one after the other, with their items in order. */
+  if ((count > (size_t) (decoder->items_end - items))
+      || (*first != items) || (*last != &items[count - 1]))
+    {
+      return SCEW_FALSE;
+    }
+
+  for (i = 0; i < count; ++i)
+    {
+      item = &items[i];
+      item->prev = decode_ (decoder, item->prev);
+      item->next = decode_ (decoder, item->next);
+      if ((item->prev != ((i > 0) ? &items[i - 1] : NULL))
+          || (item->next != ((i + 1 < count) ? &items[i + 1] : NULL)))
+        {
+          return SCEW_FALSE;
+        }
+    }
+  decoder->items += count;
+
+  return SCEW_TRUE;
+}
+
+scew_bool
+decode_string_ (decoder_ *decoder, scew_xstr *str)
+{
+  size_t available = decoder->pool_end - decoder->pool;
+
+  str->data = decode_ (decoder, str->data);
+  if (!decoder->valid)
+    {
+      return SCEW_FALSE;
+    }
+  else if (NULL == str->data)
+    {
+      return (0 == str->len);
+    }
+
+  /* Short strings are stored inline... */
+  if (str->data == str->buf)
+    {
+      return (str->len < SCEW_XSTR_INLINE_)
+        && (_XT('\0') == str->buf[str->len]);
+    }
+
+  /* ... and the rest in the pool, one after the other. */
+  if ((str->data != decoder->pool) || (str->len >= available)
+      || (str->data[str->len] != _XT('\0')))
+    {
+      return SCEW_FALSE;
+    }
+  decoder->pool += str->len + 1;
+
+  return SCEW_TRUE;
+}
+
+void*
+decode_ (decoder_ *decoder, void *pointer)
+{
+  size_t offset = (size_t) pointer;
+
+  if (0 == offset)
+    {
+      return NULL;
+    }
+
+  /* Never trust an offset pointing outside the block. */
+  if (offset > decoder->size)
+    {
+      decoder->valid = SCEW_FALSE;
+      return NULL;
+    }
+
+  return decoder->block + offset - 1;
+}
+
+scew_bool
+element_index_ (decoder_ const *decoder,
+                scew_element const *element,
+                unsigned int *index)
+{
+  size_t offset = (char const *) element - (char const *) decoder->elements;
+
+  /* Element pointers are already inside the block, but they must also
+     point to the beginning of an element. */
+  if (((char const *) element < (char const *) decoder->elements)
+      || (offset >= decoder->n_elements * sizeof (scew_element))
+      || ((offset % sizeof (scew_element)) != 0))
+    {
+      return SCEW_FALSE;
+    }
+
+  *index = offset / sizeof (scew_element);
+
+  return SCEW_TRUE;
+}
+
+scew_tree*
+create_tree_ (char *base, header_ const *header)
+{
+  XML_Char const *chars = NULL;
+  scew_tree *tree = NULL;
+
+  tree = calloc (1, sizeof (scew_tree));
+  if (NULL == tree)
+    {
+      return NULL;
+    }
+
+  chars = (XML_Char const *) (base + HEADER_SIZE_
+                              + scew_tree_frozen_size_ (&header->layout));
+
+  tree->version = property_ (chars, header->properties[VERSION_]);
+  chars += (header->properties[VERSION_] > 0)
+    ? header->properties[VERSION_] - 1 : 0;
+  tree->encoding = property_ (chars, header->properties[ENCODING_]);
+  chars += (header->properties[ENCODING_] > 0)
+    ? header->properties[ENCODING_] - 1 : 0;
+  tree->preamble = property_ (chars, header->properties[PREAMBLE_]);
+
+  if (((header->properties[VERSION_] > 0) && (NULL == tree->version))
+      || ((header->properties[ENCODING_] > 0) && (NULL == tree->encoding))
+      || ((header->properties[PREAMBLE_] > 0) && (NULL == tree->preamble)))
+    {
+      scew_tree_free (tree);
+      return NULL;
+    }
+
+  tree->standalone = header->standalone;
+
+  if (header->layout.n_elements > 0)
+    {
+      tree->root = (scew_element *) (base + HEADER_SIZE_);
+      tree->root->tree = tree;
+      tree->frozen = tree->root;
+    }
+
+  return tree;
+}
+
+XML_Char*
+property_ (XML_Char const *chars, size_t stored)
+{
+  return (0 == stored) ? NULL : scew_strndup (chars, stored - 1);
+}
+
+#ifdef MAP_SNAPSHOTS
+
+char*
+map_ (char const *file_name, size_t *size)
+{
+  struct stat info;
+  void *base = NULL;
+  int fd = -1;
+
+  fd = open (file_name, O_RDONLY);
+  if (fd < 0)
+    {
+      return NULL;
+    }
+
+  if ((fstat (fd, &info) != 0) || (0 == info.st_size))
+    {
+      close (fd);
+      return NULL;
+    }
+
+  /* A private mapping, so pointers can be relocated in place without
+     touching the file. */
+  base = mmap (NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (MAP_FAILED == base)
+    {
+      return NULL;
+    }
+
+  *size = info.st_size;
+
+  return base;
+}
+
+void
+unmap_ (char *base, size_t size)
+{
+  munmap (base, size);
+}
+
+#else /* MAP_SNAPSHOTS */
+
+char*
+map_ (char const *file_name, size_t *size)
+{
+  FILE *in = NULL;
+  char *base = NULL;
+  long length = 0;
+
+  in = fopen (file_name, "rb");
+  if (NULL == in)
+    {
+      return NULL;
+    }
+
+  if ((fseek (in, 0, SEEK_END) == 0) && ((length = ftell (in)) > 0)
+      && (fseek (in, 0, SEEK_SET) == 0))
+    {
+      /* malloc alignment is enough for the frozen block. */
+      base = malloc (length);
+      if ((base != NULL) && (fread (base, length, 1, in) != 1))
+        {
+          free (base);
+          base = NULL;
+        }
+    }
+  fclose (in);
+
+  *size = length;
+
+  return base;
+}
+
+void
+unmap_ (char *base, size_t size)
+{
+  free (base);
+}
+
+#endif /* MAP_SNAPSHOTS */
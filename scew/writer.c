@@ -36,6 +36,7 @@
 struct scew_writer
 {
   scew_writer_hooks const *hooks;
+  scew_writer_writev_hook writev; /* Optional vectored output */
   void *data;
 };
 
@@ -60,6 +61,14 @@ scew_writer_create (scew_writer_hooks const *hooks, void *data)
   return writer;
 }
 
+void
+scew_writer_set_writev (scew_writer *writer, scew_writer_writev_hook writev)
+{
+  assert (writer != NULL);
+
+  writer->writev = writev;
+}
+
 void*
 scew_writer_data (scew_writer *writer)
 {
@@ -78,6 +87,46 @@ scew_writer_write (scew_writer *writer, XML_Char const *buffer, size_t char_no)
   return writer->hooks->write (writer, buffer, char_no);
 }
 
+size_t
+scew_writer_writev (scew_writer *writer,
+                    scew_writer_span const *spans,
+                    size_t span_no)
+{
+  size_t written = 0;
+  size_t char_no = 0;
+  size_t i = 0;
+
+  assert (writer != NULL);
+  assert (writer->hooks != NULL);
+  assert (spans != NULL);
+
+  if (writer->writev != NULL)
+    {
+      return writer->writev (writer, spans, span_no);
+    }
+
+  /* Writers without vectored output get one write per span. */
+  for (i = 0; i < span_no; ++i)
+    {
+      char_no = scew_writer_write (writer, spans[i].buffer, spans[i].char_no);
+      written += char_no;
+      if (char_no < spans[i].char_no)
+        {
+          break;
+        }
+    }
+
+  return written;
+}
+
+scew_bool
+scew_writer_vectored (scew_writer *writer)
+{
+  assert (writer != NULL);
+
+  return (writer->writev != NULL);
+}
+
 scew_bool
 scew_writer_end (scew_writer *writer)
 {
@@ -68,6 +68,18 @@ extern "C" {
  */
 typedef struct scew_writer scew_writer;
 
+/**
+ * A piece of data to be written with #scew_writer_writev. Spans only
+ * point to the data, they do not own it.
+ *
+ * @ingroup SCEWWriter
+ */
+typedef struct
+{
+  XML_Char const *buffer;       /**< The characters to write */
+  size_t char_no;               /**< Number of characters to write */
+} scew_writer_span;
+
 /**
  * This is the set of functions that are implemented by all SCEW
  * writers. They must not be used directly, but through the common
@@ -103,6 +115,20 @@ typedef struct
   void (*free) (scew_writer *);
 } scew_writer_hooks;
 
+/**
+ * This is the optional function implemented by SCEW writers that
+ * support vectored output (see #scew_writer_set_writev). It is not
+ * part of #scew_writer_hooks, so hook tables built by existing
+ * programs are still valid.
+ *
+ * @see scew_writer_writev
+ *
+ * @ingroup SCEWWriter
+ */
+typedef size_t (*scew_writer_writev_hook) (scew_writer *,
+                                           scew_writer_span const *,
+                                           size_t);
+
 
 /**
  * Creates a new SCEW writer with the given #scew_writer_hooks
@@ -128,6 +154,23 @@ typedef struct
 extern SCEW_API scew_writer*
 scew_writer_create (scew_writer_hooks const *hooks, void *data);
 
+/**
+ * Sets the optional vectored output function of the given @a
+ * writer. This function should be called internally, right after
+ * #scew_writer_create, when implementing a SCEW writer that can send
+ * several pieces of data at once. Writers without it write spans one
+ * by one (see #scew_writer_writev).
+ *
+ * @pre writer != NULL
+ *
+ * @param writer the writer to set the vectored output function for.
+ * @param writev the vectored output function, or NULL to remove it.
+ *
+ * @ingroup SCEWWriter
+ */
+extern SCEW_API void scew_writer_set_writev (scew_writer *writer,
+                                             scew_writer_writev_hook writev);
+
 /**
  * Returns the reference to the internal data structure being used by
  * the given @a writer.
@@ -168,6 +211,45 @@ extern SCEW_API size_t scew_writer_write (scew_writer *writer,
                                           XML_Char const *buffer,
                                           size_t char_no);
 
+/**
+ * Writes the data of all the given @a spans, in order, to the
+ * specified @a writer. Writers with a vectored output function (see
+ * #scew_writer_set_writev) send all the spans at once (e.g. with a
+ * single writev(2) call for file descriptors), without copying them.
+ * Otherwise, this function will call #scew_writer_write for each
+ * span.
+ *
+ * @pre writer != NULL
+ * @pre spans != NULL
+ *
+ * @param writer the writer where to send the data.
+ * @param spans the pieces of data to write.
+ * @param span_no the number of spans.
+ *
+ * @return the number of characters successfully written.
+ *
+ * @ingroup SCEWWriter
+ */
+extern SCEW_API size_t scew_writer_writev (scew_writer *writer,
+                                           scew_writer_span const *spans,
+                                           size_t span_no);
+
+/**
+ * Tells whether the given @a writer has a vectored output function
+ * (see #scew_writer_set_writev), that is, whether #scew_writer_writev
+ * sends all the spans at once.
+ *
+ * @pre writer != NULL
+ *
+ * @param writer the writer to check.
+ *
+ * @return true if the writer supports vectored output, false
+ * otherwise.
+ *
+ * @ingroup SCEWWriter
+ */
+extern SCEW_API scew_bool scew_writer_vectored (scew_writer *writer);
+
 /**
  * Tells whether the given @a writer has reached its end. That is, no
  * more data can be written to the .
@@ -32,6 +32,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 
 /* Private */
@@ -60,6 +61,38 @@ static scew_writer_hooks const buffer_hooks_ =
     buffer_free_
   };
 
+enum
+  {
+    MEMORY_INITIAL_SIZE_ = 256  /**< Characters allocated on first write */
+  };
+
+typedef struct
+{
+  XML_Char *buffer;
+  size_t size;                  /* Allocated characters */
+  size_t current;               /* Written characters */
+  scew_bool closed;
+  scew_bool error;
+} scew_writer_memory;
+
+static size_t memory_write_ (scew_writer *writer,
+                             XML_Char const *buffer,
+                             size_t char_no);
+static scew_bool memory_end_ (scew_writer *writer);
+static scew_bool memory_error_ (scew_writer *writer);
+static scew_bool memory_close_ (scew_writer *writer);
+static void memory_free_ (scew_writer *writer);
+static scew_bool memory_grow_ (scew_writer_memory *mem_writer, size_t size);
+
+static scew_writer_hooks const memory_hooks_ =
+  {
+    memory_write_,
+    memory_end_,
+    memory_error_,
+    memory_close_,
+    memory_free_
+  };
+
 
 
 /* Public */
@@ -92,6 +125,65 @@ scew_writer_buffer_create (XML_Char *buffer, size_t size)
   return writer;
 }
 
+scew_writer*
+scew_writer_memory_create (void)
+{
+  scew_writer *writer = NULL;
+  scew_writer_memory *mem_writer = NULL;
+
+  mem_writer = calloc (1, sizeof (scew_writer_memory));
+
+  if (mem_writer != NULL)
+    {
+      /* Memory is only allocated when something is written. */
+      mem_writer->buffer = NULL;
+      mem_writer->size = 0;
+      mem_writer->current = 0;
+      mem_writer->closed = SCEW_FALSE;
+      mem_writer->error = SCEW_FALSE;
+
+      /* Create writer */
+      writer = scew_writer_create (&memory_hooks_, mem_writer);
+      if (NULL == writer)
+        {
+          free (mem_writer);
+        }
+    }
+
+  return writer;
+}
+
+XML_Char*
+scew_writer_memory_steal (scew_writer *writer, size_t *len)
+{
+  XML_Char *buffer = NULL;
+  scew_writer_memory *mem_writer = NULL;
+
+  assert (writer != NULL);
+
+  mem_writer = scew_writer_data (writer);
+
+  /* Nothing written yet, but callers always get a string. */
+  if ((NULL == mem_writer->buffer) && !memory_grow_ (mem_writer, 1))
+    {
+      return NULL;
+    }
+
+  buffer = mem_writer->buffer;
+  buffer[mem_writer->current] = _XT('\0');
+  if (len != NULL)
+    {
+      *len = mem_writer->current;
+    }
+
+  /* The writer starts again with an empty buffer. */
+  mem_writer->buffer = NULL;
+  mem_writer->size = 0;
+  mem_writer->current = 0;
+
+  return buffer;
+}
+
 
 /* Private */
 
@@ -166,3 +258,117 @@ buffer_free_ (scew_writer *writer)
 
   free (buf_writer);
 }
+
+size_t
+memory_write_ (scew_writer *writer, XML_Char const *buffer, size_t char_no)
+{
+  size_t needed = 0;
+  scew_writer_memory *mem_writer = NULL;
+
+  assert (writer != NULL);
+  assert (buffer != NULL);
+
+  mem_writer = scew_writer_data (writer);
+
+  if (mem_writer->closed)
+    {
+      return 0;
+    }
+
+  /* Always leave one space for the final null character. */
+  needed = mem_writer->current + char_no + 1;
+  if ((needed > mem_writer->size) && !memory_grow_ (mem_writer, needed))
+    {
+      mem_writer->error = SCEW_TRUE;
+      return 0;
+    }
+
+  scew_memcpy (mem_writer->buffer + mem_writer->current, buffer, char_no);
+  mem_writer->current += char_no;
+
+  return char_no;
+}
+
+scew_bool
+memory_end_ (scew_writer *writer)
+{
+  scew_writer_memory *mem_writer = NULL;
+
+  assert (writer != NULL);
+
+  mem_writer = scew_writer_data (writer);
+
+  return mem_writer->closed;
+}
+
+scew_bool
+memory_error_ (scew_writer *writer)
+{
+  scew_writer_memory *mem_writer = NULL;
+
+  assert (writer != NULL);
+
+  mem_writer = scew_writer_data (writer);
+
+  return mem_writer->error;
+}
+
+scew_bool
+memory_close_ (scew_writer *writer)
+{
+  scew_writer_memory *mem_writer = NULL;
+
+  assert (writer != NULL);
+
+  mem_writer = scew_writer_data (writer);
+
+  /* Written data is kept until it is stolen or the writer freed. */
+  mem_writer->closed = SCEW_TRUE;
+
+  return SCEW_TRUE;
+}
+
+void
+memory_free_ (scew_writer *writer)
+{
+  scew_writer_memory *mem_writer = NULL;
+
+  assert (writer != NULL);
+
+  mem_writer = scew_writer_data (writer);
+
+  free (mem_writer->buffer);
+  free (mem_writer);
+}
+
+scew_bool
+memory_grow_ (scew_writer_memory *mem_writer, size_t size)
+{
+  XML_Char *buffer = NULL;
+  size_t new_size = mem_writer->size;
+
+  /* Grow geometrically, so appending is amortized constant time. */
+  if (new_size < MEMORY_INITIAL_SIZE_)
+    {
+      new_size = MEMORY_INITIAL_SIZE_;
+    }
+  while ((new_size < size) && (new_size <= (size_t) -1 / 2))
+    {
+      new_size *= 2;
+    }
+  if ((new_size < size) || (new_size > (size_t) -1 / sizeof (XML_Char)))
+    {
+      return SCEW_FALSE;
+    }
+
+  buffer = realloc (mem_writer->buffer, new_size * sizeof (XML_Char));
+  if (NULL == buffer)
+    {
+      return SCEW_FALSE;
+    }
+
+  mem_writer->buffer = buffer;
+  mem_writer->size = new_size;
+
+  return SCEW_TRUE;
+}
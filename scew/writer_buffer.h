@@ -66,6 +66,44 @@ extern "C" {
 extern SCEW_API scew_writer* scew_writer_buffer_create (XML_Char *buffer,
                                                         size_t size);
 
+/**
+ * Creates a new SCEW writer that stores data in a memory buffer owned
+ * by the writer. The buffer grows as needed (doubling its size), so
+ * there is no need to know in advance how much data will be written
+ * and appending data takes amortized constant time. Use
+ * #scew_writer_memory_steal to get the written data.
+ *
+ * Written data is kept after the writer is closed, but it is freed
+ * together with the writer unless it has been stolen before.
+ *
+ * @return a new SCEW memory writer or NULL if the writer could not be
+ * created.
+ *
+ * @ingroup SCEWWriterMemory
+ */
+extern SCEW_API scew_writer* scew_writer_memory_create (void);
+
+/**
+ * Takes the data written so far by the given memory @a writer (see
+ * #scew_writer_memory_create) without copying it. The returned buffer
+ * is null-terminated and the caller becomes its owner, so it must be
+ * freed with free. The buffer might be bigger than needed. After this
+ * call, the writer starts again with an empty buffer.
+ *
+ * @pre writer != NULL
+ *
+ * @param writer the memory writer to take the data from.
+ * @param len where to store the number of written characters
+ * (without the null character). It might be NULL.
+ *
+ * @return the written data, or NULL if nothing was written and memory
+ * for an empty string could not be allocated.
+ *
+ * @ingroup SCEWWriterMemory
+ */
+extern SCEW_API XML_Char* scew_writer_memory_steal (scew_writer *writer,
+                                                    size_t *len);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
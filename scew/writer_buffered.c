@@ -0,0 +1,211 @@
+/**
+ * @file     writer_buffered.c
+ * @brief    writer_buffered.h implementation
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 20:50
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "writer_buffered.h"
+
+#include "str.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+/* Private */
+
+typedef struct
+{
+  scew_writer *writer;
+  XML_Char *buffer;
+  size_t size;
+  size_t used;
+  scew_bool error;
+} scew_writer_buffered;
+
+static size_t buffered_write_ (scew_writer *writer,
+                               XML_Char const *buffer,
+                               size_t char_no);
+static scew_bool buffered_end_ (scew_writer *writer);
+static scew_bool buffered_error_ (scew_writer *writer);
+static scew_bool buffered_close_ (scew_writer *writer);
+static void buffered_free_ (scew_writer *writer);
+
+static scew_writer_hooks const buffered_hooks_ =
+  {
+    buffered_write_,
+    buffered_end_,
+    buffered_error_,
+    buffered_close_,
+    buffered_free_
+  };
+
+
+
+/* Public */
+
+scew_writer*
+scew_writer_buffered_create (scew_writer *writer, size_t size)
+{
+  scew_writer *new_writer = NULL;
+  scew_writer_buffered *buf_writer = NULL;
+
+  assert (writer != NULL);
+  assert (size > 0);
+
+  buf_writer = calloc (1, sizeof (scew_writer_buffered));
+
+  if (buf_writer != NULL)
+    {
+      buf_writer->writer = writer;
+      buf_writer->buffer = malloc (size * sizeof (XML_Char));
+      buf_writer->size = size;
+      buf_writer->used = 0;
+      buf_writer->error = SCEW_FALSE;
+
+      /* Create writer */
+      if (buf_writer->buffer != NULL)
+        {
+          new_writer = scew_writer_create (&buffered_hooks_, buf_writer);
+        }
+
+      if (NULL == new_writer)
+        {
+          free (buf_writer->buffer);
+          free (buf_writer);
+        }
+    }
+
+  return new_writer;
+}
+
+scew_bool
+scew_writer_buffered_flush (scew_writer *writer)
+{
+  scew_writer_buffered *buf_writer = NULL;
+  size_t used = 0;
+
+  assert (writer != NULL);
+
+  buf_writer = scew_writer_data (writer);
+
+  used = buf_writer->used;
+  buf_writer->used = 0;
+  if ((used > 0) && !buf_writer->error
+      && (scew_writer_write (buf_writer->writer, buf_writer->buffer, used)
+          != used))
+    {
+      buf_writer->error = SCEW_TRUE;
+    }
+
+  return !buf_writer->error;
+}
+
+
+
+/* Private */
+
+size_t
+buffered_write_ (scew_writer *writer, XML_Char const *buffer, size_t char_no)
+{
+  scew_writer_buffered *buf_writer = NULL;
+
+  assert (writer != NULL);
+  assert (buffer != NULL);
+
+  buf_writer = scew_writer_data (writer);
+
+  if ((char_no > buf_writer->size - buf_writer->used)
+      && !scew_writer_buffered_flush (writer))
+    {
+      return 0;
+    }
+
+  /* Large data does not need to be collected. */
+  if (char_no >= buf_writer->size)
+    {
+      return scew_writer_write (buf_writer->writer, buffer, char_no);
+    }
+
+  scew_memcpy (buf_writer->buffer + buf_writer->used, buffer, char_no);
+  buf_writer->used += char_no;
+
+  return char_no;
+}
+
+scew_bool
+buffered_end_ (scew_writer *writer)
+{
+  scew_writer_buffered *buf_writer = NULL;
+
+  assert (writer != NULL);
+
+  buf_writer = scew_writer_data (writer);
+
+  return scew_writer_end (buf_writer->writer);
+}
+
+scew_bool
+buffered_error_ (scew_writer *writer)
+{
+  scew_writer_buffered *buf_writer = NULL;
+
+  assert (writer != NULL);
+
+  buf_writer = scew_writer_data (writer);
+
+  return buf_writer->error || scew_writer_error (buf_writer->writer);
+}
+
+scew_bool
+buffered_close_ (scew_writer *writer)
+{
+  scew_writer_buffered *buf_writer = NULL;
+  scew_bool flushed = SCEW_FALSE;
+
+  assert (writer != NULL);
+
+  buf_writer = scew_writer_data (writer);
+
+  flushed = scew_writer_buffered_flush (writer);
+
+  return scew_writer_close (buf_writer->writer) && flushed;
+}
+
+void
+buffered_free_ (scew_writer *writer)
+{
+  scew_writer_buffered *buf_writer = NULL;
+
+  assert (writer != NULL);
+
+  buf_writer = scew_writer_data (writer);
+
+  /* Do not lose anything written but not closed. */
+  scew_writer_buffered_flush (writer);
+
+  free (buf_writer->buffer);
+  free (buf_writer);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file     writer_buffered.h
+ * @brief    SCEW buffered writers
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 20:50
+ * @ingroup  SCEWWriterBuffered
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+/**
+ * @defgroup SCEWWriterBuffered Buffered
+ * Batch small writes into large ones.
+ * @ingroup SCEWWriter
+ */
+
+#ifndef WRITER_BUFFERED_H_2610182050
+#define WRITER_BUFFERED_H_2610182050
+
+#include "export.h"
+
+#include "writer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * Creates a new SCEW writer that collects the data written to it in a
+ * buffer of the given @a size, and only writes it to the given @a
+ * writer when the buffer is full (or flushed). Data as large as the
+ * buffer is written straight away. This saves a lot of calls to
+ * writers for which each write is expensive (system calls, hooks...).
+ *
+ * Closing the new writer flushes its buffer and closes @a writer,
+ * but freeing it does not free @a writer, which must outlive it.
+ *
+ * @pre writer != NULL
+ * @pre size > 0
+ *
+ * @param writer the writer to send the data to.
+ * @param size the number of characters to collect before writing.
+ *
+ * @return a new SCEW writer or NULL if the writer could not be
+ * created.
+ *
+ * @ingroup SCEWWriterBuffered
+ */
+extern SCEW_API scew_writer* scew_writer_buffered_create (scew_writer *writer,
+                                                          size_t size);
+
+/**
+ * Writes all the data collected by the given buffered @a writer (see
+ * #scew_writer_buffered_create) to its destination writer.
+ *
+ * @pre writer != NULL
+ *
+ * @param writer a buffered writer.
+ *
+ * @return true if all the data was written, false otherwise.
+ *
+ * @ingroup SCEWWriterBuffered
+ */
+extern SCEW_API scew_bool scew_writer_buffered_flush (scew_writer *writer);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* WRITER_BUFFERED_H_2610182050 */
@@ -26,11 +26,38 @@
  * @endif
  */
 
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+/* fallocate is a GNU extension. */
+#if defined (HAVE_FALLOCATE) && !defined (_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif /* HAVE_FALLOCATE && !_GNU_SOURCE */
+
 #include "writer_file.h"
 
 #include "str.h"
 
 #include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <io.h>
+#define write _write
+#define close _close
+#else
+#include <unistd.h>
+#endif /* _MSC_VER */
+
+#ifdef HAVE_FALLOCATE
+#include <fcntl.h>
+#endif /* HAVE_FALLOCATE */
+
+#ifdef HAVE_WRITEV
+#include <sys/uio.h>
+#endif /* HAVE_WRITEV */
 
 
 /* Private */
@@ -64,6 +91,50 @@ static scew_writer_hooks const file_hooks_ =
     file_free_
   };
 
+enum
+  {
+    FD_BUFFER_SIZE_ = 65536,    /**< Bytes collected before writing */
+    FD_IOV_NO_ = 64             /**< Spans sent by a single writev call */
+  };
+
+typedef struct
+{
+  int fd;
+  scew_bool closed;
+  scew_bool error;
+  size_t used;
+  char buffer[FD_BUFFER_SIZE_];
+} scew_writer_fd;
+
+static size_t fd_write_ (scew_writer *writer,
+                         XML_Char const *buffer,
+                         size_t char_no);
+static scew_bool fd_end_ (scew_writer *writer);
+static scew_bool fd_error_ (scew_writer *writer);
+static scew_bool fd_close_ (scew_writer *writer);
+static void fd_free_ (scew_writer *writer);
+static scew_bool fd_flush_ (scew_writer_fd *fd_writer);
+static scew_bool fd_write_all_ (scew_writer_fd *fd_writer,
+                                char const *data,
+                                size_t size);
+#ifdef HAVE_WRITEV
+static size_t fd_writev_ (scew_writer *writer,
+                          scew_writer_span const *spans,
+                          size_t span_no);
+static scew_bool fd_writev_all_ (scew_writer_fd *fd_writer,
+                                 struct iovec *iov,
+                                 int iov_no);
+#endif /* HAVE_WRITEV */
+
+static scew_writer_hooks const fd_hooks_ =
+  {
+    fd_write_,
+    fd_end_,
+    fd_error_,
+    fd_close_,
+    fd_free_
+  };
+
 
 /* Public */
 
@@ -115,13 +186,76 @@ scew_writer_fp_create (FILE *file)
   return writer;
 }
 
+scew_writer*
+scew_writer_fd_create (int fd)
+{
+  scew_writer *writer = NULL;
+  scew_writer_fd *fd_writer = NULL;
+
+  assert (fd >= 0);
+
+  fd_writer = malloc (sizeof (scew_writer_fd));
+
+  if (fd_writer != NULL)
+    {
+      fd_writer->fd = fd;
+      fd_writer->closed = SCEW_FALSE;
+      fd_writer->error = SCEW_FALSE;
+      fd_writer->used = 0;
+
+      /* Create writer */
+      writer = scew_writer_create (&fd_hooks_, fd_writer);
+      if (NULL == writer)
+        {
+          free (fd_writer);
+        }
+#ifdef HAVE_WRITEV
+      else
+        {
+          scew_writer_set_writev (writer, fd_writev_);
+        }
+#endif /* HAVE_WRITEV */
+    }
+
+  return writer;
+}
+
+scew_bool
+scew_writer_fd_preallocate (scew_writer *writer, size_t char_no)
+{
+#ifdef HAVE_FALLOCATE
+  scew_writer_fd *fd_writer = NULL;
+  off_t offset = 0;
+
+  assert (writer != NULL);
+
+  fd_writer = scew_writer_data (writer);
+
+  /* Pipes and sockets can not be preallocated. */
+  offset = lseek (fd_writer->fd, 0, SEEK_CUR);
+  if (offset < 0)
+    {
+      return SCEW_FALSE;
+    }
+
+  /* Reserve the space without changing the file size, so nothing is
+     left behind if less data is written. */
+  return (fallocate (fd_writer->fd, FALLOC_FL_KEEP_SIZE,
+                     offset + fd_writer->used,
+                     char_no * sizeof (XML_Char)) == 0);
+#else
+  assert (writer != NULL);
+
+  return SCEW_FALSE;
+#endif /* HAVE_FALLOCATE */
+}
+
 
 /* Private */
 
 size_t
 file_write_ (scew_writer *writer, XML_Char const *buffer, size_t char_no)
 {
-  XML_Char c = 0;
   size_t written_no = 0;
   scew_writer_fp *fp_writer = NULL;
 
@@ -130,14 +264,22 @@ file_write_ (scew_writer *writer, XML_Char const *buffer, size_t char_no)
 
   fp_writer = scew_writer_data (writer);
 
-  while ((c != SCEW_EOF) && (written_no < char_no))
-    {
-      c = scew_fputc (buffer[written_no], fp_writer->file);
-      if (c != SCEW_EOF)
-        {
-          written_no += 1;
-        }
-    }
+#ifdef XML_UNICODE_WCHAR_T
+  {
+    /* Wide characters need to be converted one by one. */
+    XML_Char c = 0;
+    while ((c != SCEW_EOF) && (written_no < char_no))
+      {
+        c = scew_fputc (buffer[written_no], fp_writer->file);
+        if (c != SCEW_EOF)
+          {
+            written_no += 1;
+          }
+      }
+  }
+#else
+  written_no = fwrite (buffer, sizeof (XML_Char), char_no, fp_writer->file);
+#endif /* XML_UNICODE_WCHAR_T */
 
   return written_no;
 }
@@ -219,3 +361,233 @@ file_free_ (scew_writer *writer)
   fp_writer = scew_writer_data (writer);
   free (fp_writer);
 }
+
+size_t
+fd_write_ (scew_writer *writer, XML_Char const *buffer, size_t char_no)
+{
+  scew_writer_fd *fd_writer = NULL;
+  size_t size = char_no * sizeof (XML_Char);
+
+  assert (writer != NULL);
+  assert (buffer != NULL);
+
+  fd_writer = scew_writer_data (writer);
+
+  if (fd_writer->closed || fd_writer->error)
+    {
+      return 0;
+    }
+
+  if ((size > FD_BUFFER_SIZE_ - fd_writer->used) && !fd_flush_ (fd_writer))
+    {
+      return 0;
+    }
+
+  /* Large data does not need to be collected. */
+  if (size >= FD_BUFFER_SIZE_)
+    {
+      return fd_write_all_ (fd_writer, (char const *) buffer, size)
+        ? char_no : 0;
+    }
+
+  memcpy (fd_writer->buffer + fd_writer->used, buffer, size);
+  fd_writer->used += size;
+
+  return char_no;
+}
+
+scew_bool
+fd_end_ (scew_writer *writer)
+{
+  scew_writer_fd *fd_writer = NULL;
+
+  assert (writer != NULL);
+
+  fd_writer = scew_writer_data (writer);
+
+  return fd_writer->closed;
+}
+
+scew_bool
+fd_error_ (scew_writer *writer)
+{
+  scew_writer_fd *fd_writer = NULL;
+
+  assert (writer != NULL);
+
+  fd_writer = scew_writer_data (writer);
+
+  return fd_writer->error;
+}
+
+scew_bool
+fd_close_ (scew_writer *writer)
+{
+  scew_bool flushed = SCEW_FALSE;
+  scew_writer_fd *fd_writer = NULL;
+
+  assert (writer != NULL);
+
+  fd_writer = scew_writer_data (writer);
+
+  if (fd_writer->closed)
+    {
+      return SCEW_TRUE;
+    }
+
+  flushed = fd_flush_ (fd_writer);
+
+  /* Do not close standard output and standard error. */
+  if ((1 == fd_writer->fd) || (2 == fd_writer->fd))
+    {
+      fd_writer->closed = SCEW_TRUE;
+    }
+  else
+    {
+      fd_writer->closed = (0 == close (fd_writer->fd));
+    }
+
+  return flushed && fd_writer->closed;
+}
+
+void
+fd_free_ (scew_writer *writer)
+{
+  scew_writer_fd *fd_writer = NULL;
+
+  assert (writer != NULL);
+
+  /* Close the file before freeing the writer. */
+  fd_close_ (writer);
+
+  fd_writer = scew_writer_data (writer);
+  free (fd_writer);
+}
+
+scew_bool
+fd_flush_ (scew_writer_fd *fd_writer)
+{
+  size_t used = fd_writer->used;
+
+  fd_writer->used = 0;
+
+  return (0 == used)
+    || fd_write_all_ (fd_writer, fd_writer->buffer, used);
+}
+
+scew_bool
+fd_write_all_ (scew_writer_fd *fd_writer, char const *data, size_t size)
+{
+  long written = 0;
+
+  while (!fd_writer->error && (size > 0))
+    {
+      written = write (fd_writer->fd, data, size);
+      if (written > 0)
+        {
+          data += written;
+          size -= written;
+        }
+      else if ((written < 0) && (EINTR == errno))
+        {
+          /* Interrupted before writing anything, try again. */
+        }
+      else
+        {
+          fd_writer->error = SCEW_TRUE;
+        }
+    }
+
+  return !fd_writer->error;
+}
+
+#ifdef HAVE_WRITEV
+size_t
+fd_writev_ (scew_writer *writer,
+            scew_writer_span const *spans,
+            size_t span_no)
+{
+  struct iovec iov[FD_IOV_NO_];
+  scew_writer_fd *fd_writer = NULL;
+  size_t char_no = 0;
+  size_t i = 0;
+  int iov_no = 0;
+
+  assert (writer != NULL);
+  assert (spans != NULL);
+
+  fd_writer = scew_writer_data (writer);
+
+  if (fd_writer->closed || fd_writer->error)
+    {
+      return 0;
+    }
+
+  /* Collected data goes first, in the same call as the spans. */
+  if (fd_writer->used > 0)
+    {
+      iov[iov_no].iov_base = fd_writer->buffer;
+      iov[iov_no].iov_len = fd_writer->used;
+      iov_no += 1;
+      fd_writer->used = 0;
+    }
+
+  for (i = 0; i < span_no; ++i)
+    {
+      if (FD_IOV_NO_ == iov_no)
+        {
+          if (!fd_writev_all_ (fd_writer, iov, iov_no))
+            {
+              return 0;
+            }
+          iov_no = 0;
+        }
+
+      if (spans[i].char_no > 0)
+        {
+          iov[iov_no].iov_base = (void *) spans[i].buffer;
+          iov[iov_no].iov_len = spans[i].char_no * sizeof (XML_Char);
+          iov_no += 1;
+          char_no += spans[i].char_no;
+        }
+    }
+
+  return fd_writev_all_ (fd_writer, iov, iov_no) ? char_no : 0;
+}
+
+scew_bool
+fd_writev_all_ (scew_writer_fd *fd_writer, struct iovec *iov, int iov_no)
+{
+  long written = 0;
+
+  while (!fd_writer->error && (iov_no > 0))
+    {
+      written = writev (fd_writer->fd, iov, iov_no);
+      if (written > 0)
+        {
+          /* Skip whole spans written and go on with the rest. */
+          while ((iov_no > 0) && ((size_t) written >= iov->iov_len))
+            {
+              written -= iov->iov_len;
+              iov += 1;
+              iov_no -= 1;
+            }
+          if (iov_no > 0)
+            {
+              iov->iov_base = (char *) iov->iov_base + written;
+              iov->iov_len -= written;
+            }
+        }
+      else if ((written < 0) && (EINTR == errno))
+        {
+          /* Interrupted before writing anything, try again. */
+        }
+      else
+        {
+          fd_writer->error = SCEW_TRUE;
+        }
+    }
+
+  return !fd_writer->error;
+}
+#endif /* HAVE_WRITEV */
@@ -90,6 +90,53 @@ extern SCEW_API scew_writer* scew_writer_file_create (char const *file_name);
  */
 extern SCEW_API scew_writer* scew_writer_fp_create (FILE *file);
 
+/**
+ * Creates a new SCEW writer for the given file descriptor, which
+ * might be a regular file, a pipe or a socket. Data is collected in a
+ * large buffer and written with as few system calls as possible,
+ * without going through stdio. Characters are written as they are
+ * stored in memory, so no conversion is done for wide characters.
+ *
+ * Where writev(2) is available, the writer supports vectored output
+ * (#scew_writer_writev): spans are sent directly from their own
+ * memory, together with any collected data, without being copied.
+ *
+ * The file descriptor is closed when the writer is closed or freed,
+ * unless it is the standard output or the standard error.
+ *
+ * @pre fd >= 0
+ *
+ * @param fd the file descriptor where the new SCEW writer will write
+ * to.
+ *
+ * @return a new SCEW writer for the given file descriptor or NULL if
+ * the writer could not be created.
+ *
+ * @ingroup SCEWWriterFile
+ */
+extern SCEW_API scew_writer* scew_writer_fd_create (int fd);
+
+/**
+ * Reserves disk space for the next @a char_no characters to be
+ * written by the given file descriptor @a writer (see
+ * #scew_writer_fd_create), so the file does not need to grow (and
+ * fragment) while it is being written. The file size is not changed.
+ * This is only an optimization: data can be written whether space is
+ * reserved or not.
+ *
+ * @pre writer != NULL
+ *
+ * @param writer a file descriptor writer.
+ * @param char_no the number of characters to reserve space for.
+ *
+ * @return true if the space was reserved, false if it could not be
+ * reserved or the platform or file does not support it.
+ *
+ * @ingroup SCEWWriterFile
+ */
+extern SCEW_API scew_bool scew_writer_fd_preallocate (scew_writer *writer,
+                                                      size_t char_no);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -28,12 +28,24 @@
 
 #include "xattribute.h"
 
+#include "xelement.h"
+#include "xtree.h"
+
 #include <assert.h>
 
 
 
 /* Protected */
 
+scew_bool
+scew_attribute_writable_ (scew_attribute const *attribute)
+{
+  assert (attribute != NULL);
+
+  return (NULL == attribute->parent)
+    || scew_element_writable_ (attribute->parent);
+}
+
 void
 scew_attribute_set_parent_ (scew_attribute *attribute,
                             scew_element const *parent)
@@ -42,3 +54,42 @@ scew_attribute_set_parent_ (scew_attribute *attribute,
 
   attribute->parent = (scew_element *) parent;
 }
+
+void
+scew_attribute_changing_ (scew_attribute const *attribute)
+{
+  scew_tree *tree = NULL;
+
+  assert (attribute != NULL);
+  assert ((NULL == attribute->parent)
+          || (NULL == attribute->parent->cache)
+          || !attribute->parent->cache->frozen);
+
+  if (attribute->parent != NULL)
+    {
+      tree = scew_element_tree_ (attribute->parent);
+      if (tree != NULL)
+        {
+          scew_tree_attribute_removed_ (tree, attribute);
+        }
+    }
+}
+
+void
+scew_attribute_changed_ (scew_attribute const *attribute)
+{
+  scew_tree *tree = NULL;
+
+  assert (attribute != NULL);
+
+  if (attribute->parent != NULL)
+    {
+      scew_element_attributes_changed_ (attribute->parent);
+
+      tree = scew_element_tree_ (attribute->parent);
+      if (tree != NULL)
+        {
+          scew_tree_attribute_added_ (tree, attribute);
+        }
+    }
+}
@@ -33,20 +33,31 @@
 #include "export.h"
 
 #include "attribute.h"
+#include "xstr.h"
 
 
 /* Types */
 
 struct scew_attribute
 {
-  XML_Char *name;               /**< The attribute's name */
-  XML_Char *value;              /**< The attribute's value */
+  scew_xstr name;               /**< The attribute's name */
+  scew_xstr value;              /**< The attribute's value */
   scew_element *parent;         /**< The XML element parent (if any) */
 };
 
 
 /* Functions */
 
+/**
+ * Tells whether the given @a attribute can be modified, that is,
+ * whether it does not belong to an element of a frozen tree (see
+ * #scew_element_writable_).
+ *
+ * @pre attribute != NULL
+ */
+extern SCEW_LOCAL scew_bool
+scew_attribute_writable_ (scew_attribute const *attribute);
+
 /**
  * Sets a new @a parent to the given @a attribute, NULL is also
  * allowed. Note that the element should be first detached from its
@@ -57,4 +68,25 @@ struct scew_attribute
 extern SCEW_LOCAL void scew_attribute_set_parent_ (scew_attribute *attribute,
                                                    scew_element const *parent);
 
+/**
+ * Notifies that the name or value of the given @a attribute is about
+ * to be modified, or that the attribute is about to be removed from
+ * its element. This removes the attribute from the tree attribute
+ * indexes, if any.
+ *
+ * @pre attribute != NULL
+ */
+extern SCEW_LOCAL void scew_attribute_changing_ (scew_attribute const *attribute);
+
+/**
+ * Notifies that the name or value of the given @a attribute has been
+ * modified, or that the attribute has been added to an element. This
+ * adds the attribute to the tree attribute indexes, if any, and
+ * invalidates the data cached in its element (see
+ * #scew_element_attributes_changed_).
+ *
+ * @pre attribute != NULL
+ */
+extern SCEW_LOCAL void scew_attribute_changed_ (scew_attribute const *attribute);
+
 #endif /* XATTRIBUTE_H_0908242344 */
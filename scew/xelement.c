@@ -0,0 +1,515 @@
+/**
+ * @file     xelement.c
+ * @brief    xelement.h implementation
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 11:30
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "xelement.h"
+
+#include "xattribute.h"
+#include "xerror.h"
+#include "xhash.h"
+#include "xtree.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif /* _MSC_VER */
+
+
+
+/* Private */
+
+static scew_bool epoch_pending_ (scew_element const *element);
+static void modified_ (scew_element *element);
+static scew_element_cache_* summarize_ (scew_element *element);
+static void add_key_ (unsigned char *summary, unsigned long key);
+
+
+
+/* Protected */
+
+scew_bool
+scew_element_writable_ (scew_element const *element)
+{
+  scew_element_cache_ *cache = NULL;
+
+  assert (element != NULL);
+
+  /* Frozen elements always have a cache. */
+  cache = scew_element_cache_get_ (element);
+  if ((cache != NULL) && cache->frozen)
+    {
+      scew_error_set_last_error_ (scew_error_frozen);
+      return SCEW_FALSE;
+    }
+
+  return SCEW_TRUE;
+}
+
+scew_element_cache_*
+scew_element_cache_get_ (scew_element const *element)
+{
+  scew_element_cache_ *cache = NULL;
+
+  assert (element != NULL);
+
+#if defined (__GNUC__)
+  cache = __atomic_load_n (&element->cache, __ATOMIC_ACQUIRE);
+#elif defined (_MSC_VER)
+  cache = *(scew_element_cache_ * const volatile *) &element->cache;
+  MemoryBarrier ();
+#else
+  cache = element->cache;
+#endif /* __GNUC__ */
+
+  return cache;
+}
+
+scew_element_cache_*
+scew_element_cache_add_ (scew_element const *element)
+{
+  scew_element *owner = (scew_element *) element;
+  scew_element_cache_ *cache = NULL;
+  scew_element_cache_ *stored = NULL;
+
+  assert (element != NULL);
+
+  cache = scew_element_cache_get_ (element);
+  if (cache != NULL)
+    {
+      return cache;
+    }
+
+  cache = calloc (1, sizeof (scew_element_cache_));
+  if (NULL == cache)
+    {
+      return NULL;
+    }
+  cache->epoch_pending = SCEW_TRUE;
+
+  /* Another thread might have added a cache in the meantime. */
+#if defined (__GNUC__)
+  if (!__atomic_compare_exchange_n (&owner->cache, &stored, cache, SCEW_FALSE,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+      free (cache);
+      cache = stored;
+    }
+#elif defined (_MSC_VER)
+  stored = InterlockedCompareExchangePointer ((PVOID volatile *) &owner->cache,
+                                              cache, NULL);
+  if (stored != NULL)
+    {
+      free (cache);
+      cache = stored;
+    }
+#else
+  owner->cache = cache;
+#endif /* __GNUC__ */
+
+  return cache;
+}
+
+scew_element_cache_*
+scew_element_set_indexed_ (scew_element *element)
+{
+  scew_element_cache_ *cache = NULL;
+
+  assert (element != NULL);
+
+  cache = scew_element_cache_add_ (element);
+  if (cache != NULL)
+    {
+      cache->indexed = SCEW_TRUE;
+    }
+
+  return cache;
+}
+
+scew_bool
+scew_element_indexed_ (scew_element const *element)
+{
+  scew_element_cache_ *cache = NULL;
+
+  assert (element != NULL);
+
+  cache = scew_element_cache_get_ (element);
+
+  return (cache != NULL) && cache->indexed;
+}
+
+void
+scew_element_changed_ (scew_element *element)
+{
+  scew_element *current = element;
+  scew_element_cache_ *cache = NULL;
+
+  assert (element != NULL);
+  assert ((NULL == element->cache) || !element->cache->frozen);
+
+  /* Elements without a cache have nothing valid, nor their ancestors. */
+  while ((element != NULL)
+         && ((cache = scew_element_cache_get_ (element)) != NULL)
+         && (cache->hash_valid || cache->summary_valid || cache->indexed))
+    {
+      cache->hash_valid = SCEW_FALSE;
+      cache->summary_valid = SCEW_FALSE;
+      cache->indexed = SCEW_FALSE;
+      element = element->parent;
+    }
+
+  modified_ (current);
+}
+
+void
+scew_element_attributes_changed_ (scew_element *element)
+{
+  scew_element *current = element;
+  scew_element_cache_ *cache = NULL;
+
+  assert (element != NULL);
+  assert ((NULL == element->cache) || !element->cache->frozen);
+
+  while ((element != NULL)
+         && ((cache = scew_element_cache_get_ (element)) != NULL)
+         && (cache->hash_valid || cache->summary_valid))
+    {
+      cache->hash_valid = SCEW_FALSE;
+      cache->summary_valid = SCEW_FALSE;
+      element = element->parent;
+    }
+
+  modified_ (current);
+}
+
+void
+scew_element_contents_changing_ (scew_element const *element)
+{
+  scew_tree *tree = NULL;
+
+  assert (element != NULL);
+  assert ((NULL == element->cache) || !element->cache->frozen);
+
+  tree = scew_element_tree_ (element);
+  if (tree != NULL)
+    {
+      scew_tree_contents_removed_ (tree, element);
+    }
+}
+
+void
+scew_element_contents_changed_ (scew_element *element)
+{
+  scew_element *ancestor = element;
+  scew_element_cache_ *cache = NULL;
+  scew_tree *tree = NULL;
+
+  assert (element != NULL);
+
+  while ((ancestor != NULL)
+         && ((cache = scew_element_cache_get_ (ancestor)) != NULL)
+         && cache->hash_valid)
+    {
+      cache->hash_valid = SCEW_FALSE;
+      ancestor = ancestor->parent;
+    }
+
+  modified_ (element);
+
+  tree = scew_element_tree_ (element);
+  if (tree != NULL)
+    {
+      scew_tree_contents_added_ (tree, element);
+    }
+}
+
+scew_tree*
+scew_element_tree_ (scew_element const *element)
+{
+  assert (element != NULL);
+
+  /* Unmarked ancestors mean the indexes are out of date. */
+  while ((element != NULL) && scew_element_indexed_ (element))
+    {
+      if (element->tree != NULL)
+        {
+          return element->tree;
+        }
+      element = element->parent;
+    }
+
+  return NULL;
+}
+
+unsigned long
+scew_element_name_key_ (XML_Char const *name, size_t len)
+{
+  assert (name != NULL);
+
+  return scew_hash_string_ (scew_hash_init_ (), name, len);
+}
+
+unsigned long
+scew_element_attribute_key_ (XML_Char const *name, size_t len)
+{
+  assert (name != NULL);
+
+  /* Attribute names use a different seed than element names. */
+  return scew_hash_string_ (scew_hash_word_ (scew_hash_init_ (), '@'),
+                            name, len);
+}
+
+scew_bool
+scew_element_cached_hash_ (scew_element const *element, unsigned long *hash)
+{
+  scew_element_cache_ *cache = NULL;
+  scew_bool valid = SCEW_FALSE;
+
+  assert (element != NULL);
+  assert (hash != NULL);
+
+  cache = scew_element_cache_get_ (element);
+  if (NULL == cache)
+    {
+      return SCEW_FALSE;
+    }
+
+#if defined (__GNUC__)
+  valid = __atomic_load_n (&cache->hash_valid, __ATOMIC_ACQUIRE);
+  *hash = __atomic_load_n (&cache->hash, __ATOMIC_RELAXED);
+#elif defined (_MSC_VER)
+  valid = *(scew_bool const volatile *) &cache->hash_valid;
+  MemoryBarrier ();
+  *hash = *(unsigned long const volatile *) &cache->hash;
+#else
+  valid = cache->hash_valid;
+  *hash = cache->hash;
+#endif /* __GNUC__ */
+
+  return valid;
+}
+
+scew_bool
+scew_element_cache_hash_ (scew_element const *element, unsigned long hash)
+{
+  scew_element_cache_ *cache = NULL;
+
+  assert (element != NULL);
+
+  cache = scew_element_cache_add_ (element);
+  if (NULL == cache)
+    {
+      return SCEW_FALSE;
+    }
+
+#if defined (__GNUC__)
+  __atomic_store_n (&cache->hash, hash, __ATOMIC_RELAXED);
+  __atomic_store_n (&cache->hash_valid, SCEW_TRUE, __ATOMIC_RELEASE);
+#elif defined (_MSC_VER)
+  *(unsigned long volatile *) &cache->hash = hash;
+  MemoryBarrier ();
+  *(scew_bool volatile *) &cache->hash_valid = SCEW_TRUE;
+#else
+  cache->hash = hash;
+  cache->hash_valid = SCEW_TRUE;
+#endif /* __GNUC__ */
+
+  return SCEW_TRUE;
+}
+
+unsigned long
+scew_element_epoch_ (scew_element *element)
+{
+  scew_element_cache_ *cache = NULL;
+  scew_element *child = NULL;
+  scew_list *item = NULL;
+  scew_bool settled = SCEW_TRUE;
+
+  assert (element != NULL);
+
+  cache = scew_element_cache_add_ (element);
+  if (NULL == cache)
+    {
+      return 0;
+    }
+
+  if (cache->epoch_pending)
+    {
+      cache->epoch += 1;
+
+      for (item = element->children;
+           item != NULL;
+           item = scew_list_next (item))
+        {
+          child = scew_list_data (item);
+          if (epoch_pending_ (child))
+            {
+              scew_element_epoch_ (child);
+              settled = settled && !epoch_pending_ (child);
+            }
+        }
+
+      /* Flagged descendants must keep their ancestors flagged. */
+      cache->epoch_pending = !settled;
+    }
+
+  return cache->epoch;
+}
+
+scew_bool
+scew_element_may_contain_ (scew_element const *element,
+                           unsigned long key,
+                           scew_bool compute)
+{
+  unsigned char probe[SCEW_SUMMARY_BYTES_];
+  scew_element_cache_ *cache = NULL;
+  unsigned int i = 0;
+
+  assert (element != NULL);
+
+  cache = scew_element_cache_get_ (element);
+  if ((NULL == cache) || !cache->summary_valid)
+    {
+      if (!compute)
+        {
+          return SCEW_TRUE;
+        }
+      /* Summaries are a cache, so they can be computed on const
+         elements (or not at all if there is not enough memory). */
+      cache = summarize_ ((scew_element *) element);
+      if (NULL == cache)
+        {
+          return SCEW_TRUE;
+        }
+    }
+
+  memset (probe, 0, sizeof (probe));
+  add_key_ (probe, key);
+  for (i = 0; i < SCEW_SUMMARY_BYTES_; ++i)
+    {
+      if ((cache->summary[i] & probe[i]) != probe[i])
+        {
+          return SCEW_FALSE;
+        }
+    }
+
+  return SCEW_TRUE;
+}
+
+
+
+/* Private */
+
+scew_bool
+epoch_pending_ (scew_element const *element)
+{
+  scew_element_cache_ *cache = scew_element_cache_get_ (element);
+
+  /* Elements without a cache have never had their epoch read. */
+  return (NULL == cache) || cache->epoch_pending;
+}
+
+void
+modified_ (scew_element *element)
+{
+  while ((element != NULL) && !epoch_pending_ (element))
+    {
+      element->cache->epoch_pending = SCEW_TRUE;
+      element = element->parent;
+    }
+}
+
+scew_element_cache_*
+summarize_ (scew_element *element)
+{
+  scew_attribute const *attribute = NULL;
+  scew_element_cache_ *cache = NULL;
+  scew_element_cache_ *child_cache = NULL;
+  scew_element *child = NULL;
+  scew_list *item = NULL;
+  unsigned int i = 0;
+
+  cache = scew_element_cache_add_ (element);
+  if (NULL == cache)
+    {
+      return NULL;
+    }
+
+  memset (cache->summary, 0, SCEW_SUMMARY_BYTES_);
+
+  add_key_ (cache->summary,
+            scew_element_name_key_ (element->name.data, element->name.len));
+
+  for (item = element->attributes; item != NULL; item = scew_list_next (item))
+    {
+      attribute = scew_list_data (item);
+      add_key_ (cache->summary,
+                scew_element_attribute_key_ (attribute->name.data,
+                                             attribute->name.len));
+    }
+
+  /* Summaries are only valid if the ones of all children are too. */
+  for (item = element->children; item != NULL; item = scew_list_next (item))
+    {
+      child = scew_list_data (item);
+      child_cache = scew_element_cache_get_ (child);
+      if ((NULL == child_cache) || !child_cache->summary_valid)
+        {
+          child_cache = summarize_ (child);
+          if (NULL == child_cache)
+            {
+              return NULL;
+            }
+        }
+      for (i = 0; i < SCEW_SUMMARY_BYTES_; ++i)
+        {
+          cache->summary[i] |= child_cache->summary[i];
+        }
+    }
+
+  cache->summary_valid = SCEW_TRUE;
+
+  return cache;
+}
+
+void
+add_key_ (unsigned char *summary, unsigned long key)
+{
+  static unsigned int const BITS = SCEW_SUMMARY_BYTES_ * 8;
+
+  unsigned int bit = 0;
+
+  /* Two bits per key, from different parts of the hash. */
+  bit = key % BITS;
+  summary[bit / 8] |= 1 << (bit % 8);
+
+  bit = (key / BITS) % BITS;
+  summary[bit / 8] |= 1 << (bit % 8);
+}
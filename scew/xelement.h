@@ -29,31 +29,295 @@
 #ifndef XELEMENT_H_0908270147
 #define XELEMENT_H_0908270147
 
+#include "export.h"
+
 #include "element.h"
+#include "tree.h"
 
 #include "list.h"
+#include "xstr.h"
 
 #include <expat.h>
 
 
 /* Types */
 
+enum
+  {
+    SCEW_SUMMARY_BYTES_ = 32    /**< Size of element summaries */
+  };
+
+/*
+ * Data cached in an element by the features that need it: subtree
+ * hashes, epochs, names summaries, tree indexes and frozen trees. It
+ * is only allocated when one of them is first used on the element
+ * (see #scew_element_cache_add_), so elements that never use them
+ * only pay for a pointer. Fields are sorted by alignment, like the
+ * ones of elements, as frozen trees also store caches as they are.
+ */
+typedef struct
+{
+  unsigned long hash;           /**< Cached structural hash */
+  unsigned long epoch;          /**< Modification epoch of the subtree */
+
+  unsigned int order_pre;       /**< Pre-order rank in the tree */
+  unsigned int order_post;      /**< Pre-order rank of the last element of
+                                   the subtree */
+  unsigned int text_seq;        /**< Sequence number of the contents in the
+                                   contents index */
+
+  unsigned char summary[SCEW_SUMMARY_BYTES_]; /**< Bloom filter of the
+                                   element and attribute names in the
+                                   subtree */
+
+  scew_bool hash_valid;         /**< Whether the cached hash is up to date */
+  scew_bool epoch_pending;      /**< Whether the subtree has been modified
+                                   since the epoch was last read */
+  scew_bool summary_valid;      /**< Whether the summary is up to date */
+  scew_bool indexed;            /**< Whether the tree indexes are up to
+                                   date with the element */
+  scew_bool frozen;             /**< Whether the element belongs to a
+                                   frozen tree (see #scew_tree_freeze) */
+} scew_element_cache_;
+
+/*
+ * Fields are sorted by alignment, so there is no padding between
+ * them: frozen trees (see tree_freeze.c) store elements as they are.
+ */
 struct scew_element
 {
-  XML_Char *name;               /**< The element's name */
-  XML_Char *contents;           /**< The element's text contents */
+  scew_xstr name;               /**< The element's name */
+  scew_xstr contents;           /**< The element's text contents */
 
   scew_element *parent;         /**< The parent of the element (if any) */
   scew_list *myself;            /**< Pointer to parent's children list
                                    (performance) */
 
-  unsigned int n_children;      /**< Number of children (if any) */
   scew_list *children;          /**< List of children elements */
   scew_list *last_child;        /**< Pointer to last child (performance) */
 
-  unsigned int n_attributes;    /**< Number of attributes (if any) */
   scew_list *attributes;        /**< List of attributes */
   scew_list *last_attribute;    /**< Pointer to last attribute (performance) */
+
+  scew_tree *tree;              /**< The tree this is the root of (if any) */
+  scew_element_cache_ *cache;   /**< Data of optional features (if any) */
+
+  unsigned int n_children;      /**< Number of children (if any) */
+  unsigned int n_attributes;    /**< Number of attributes (if any) */
 };
 
+
+/* Functions */
+
+/**
+ * Tells whether the given @a element can be modified, that is,
+ * whether it does not belong to a frozen tree. Otherwise it sets the
+ * #scew_error_frozen error. Public functions modifying elements check
+ * this before touching anything, as frozen elements live in a single
+ * block owned by their tree.
+ *
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL scew_bool
+scew_element_writable_ (scew_element const *element);
+
+/**
+ * Returns the cache of the given @a element (see
+ * #scew_element_cache_), or NULL if it has none yet.
+ *
+ * Caches are added by functions taking const elements, which might
+ * be called from several threads at once, so the pointer is read with
+ * the appropriate memory ordering (see #scew_element_cache_add_).
+ *
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL scew_element_cache_*
+scew_element_cache_get_ (scew_element const *element);
+
+/**
+ * Returns the cache of the given @a element, allocating it if the
+ * element has none yet. Being a cache, it can be added to const
+ * elements. A new cache is published atomically: if several threads
+ * add one at the same time, all of them get the one stored first and
+ * the others are freed.
+ *
+ * A new cache has nothing valid and a pending epoch, as elements
+ * without a cache are considered modified (see #scew_element_epoch_).
+ *
+ * @pre element != NULL
+ *
+ * @return the element's cache, or NULL if there is not enough memory
+ * (no error is set, as caches are optional).
+ */
+extern SCEW_LOCAL scew_element_cache_*
+scew_element_cache_add_ (scew_element const *element);
+
+/**
+ * Marks the given @a element as indexed (see #scew_element_tree_),
+ * adding a cache to it if needed.
+ *
+ * @pre element != NULL
+ *
+ * @return the element's cache, or NULL if there is not enough memory.
+ */
+extern SCEW_LOCAL scew_element_cache_*
+scew_element_set_indexed_ (scew_element *element);
+
+/**
+ * Tells whether the given @a element is marked as indexed (see
+ * #scew_element_tree_).
+ *
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL scew_bool
+scew_element_indexed_ (scew_element const *element);
+
+/**
+ * Notifies that the given @a element has been modified (its name,
+ * attributes or list of children). This invalidates the
+ * data cached in the element and all its ancestors, so it must be
+ * called by any function that modifies an element.
+ *
+ * Invalidation stops at the first ancestor that is already invalid,
+ * as its own ancestors are then known to be invalid too. Tree indexes
+ * are only up to date while their root element is marked as indexed.
+ *
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL void scew_element_changed_ (scew_element *element);
+
+/**
+ * Notifies that the attributes of the given @a element have been
+ * modified. This is the same as #scew_element_changed_, except that
+ * tree indexes are not invalidated, as attribute indexes are updated
+ * in place (see #scew_attribute_changed_) and the other indexes do
+ * not depend on attributes.
+ *
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL void scew_element_attributes_changed_ (scew_element *element);
+
+/**
+ * Notifies that the contents of the given @a element are about to be
+ * modified, so they are removed from the contents index of its tree
+ * (if any).
+ *
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL void
+scew_element_contents_changing_ (scew_element const *element);
+
+/**
+ * Notifies that the contents of the given @a element have been
+ * modified. This invalidates the hash of the element and its
+ * ancestors (names summaries and most tree indexes do not depend on
+ * contents), and adds the new contents to the contents index of its
+ * tree (if any).
+ *
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL void scew_element_contents_changed_ (scew_element *element);
+
+/**
+ * Tells whether the given @a element has a cached hash (see
+ * #scew_element_hash) and, if so, stores it in @a hash.
+ *
+ * Hashes are cached by functions taking const elements, which might
+ * be called from several threads at once. The cached hash is stored
+ * before the flag that makes it valid, and the flag is read before
+ * the hash, with the appropriate memory ordering, so a valid flag is
+ * never seen together with a stale hash.
+ *
+ * @pre element != NULL
+ * @pre hash != NULL
+ */
+extern SCEW_LOCAL scew_bool
+scew_element_cached_hash_ (scew_element const *element, unsigned long *hash);
+
+/**
+ * Caches the given @a hash in the given @a element (see
+ * #scew_element_cached_hash_). Being a cache, it can be stored in
+ * const elements.
+ *
+ * @pre element != NULL
+ *
+ * @return whether the hash has been cached, which might not be
+ * possible if the element has no cache and there is not enough
+ * memory to add it.
+ */
+extern SCEW_LOCAL scew_bool
+scew_element_cache_hash_ (scew_element const *element, unsigned long hash);
+
+/**
+ * Returns the modification epoch of the given @a element (see
+ * #scew_element_epoch), bringing up to date the epochs of the element
+ * and all its modified descendants.
+ *
+ * Modifications only flag the element and its ancestors as pending,
+ * stopping at the first ancestor already flagged (as its own
+ * ancestors are then flagged too). Reading an epoch increments it if
+ * it is pending and clears the flags of the element and its flagged
+ * descendants. So, modifications take constant amortized time and
+ * epochs change exactly when their subtree has been modified since
+ * they were last read.
+ *
+ * Elements without a cache are flagged, so reading an epoch adds a
+ * cache to the element and to all its descendants without one. The
+ * first epoch of an element is 1. If a cache can not be allocated,
+ * the elements above it stay flagged, so their epochs change on
+ * every read, and 0 is returned if the element itself has no cache.
+ *
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL unsigned long scew_element_epoch_ (scew_element *element);
+
+/**
+ * Returns the tree whose indexes are up to date with the given @a
+ * element, that is, the tree the element belongs to if it has
+ * up to date indexes.
+ *
+ * @pre element != NULL
+ *
+ * @return the tree, or NULL if the element is not indexed.
+ */
+extern SCEW_LOCAL scew_tree* scew_element_tree_ (scew_element const *element);
+
+/**
+ * Returns the summary key of the element name made of the first @a
+ * len characters of @a name (see #scew_element_may_contain_).
+ *
+ * @pre name != NULL
+ */
+extern SCEW_LOCAL unsigned long scew_element_name_key_ (XML_Char const *name,
+                                                        size_t len);
+
+/**
+ * Returns the summary key of the attribute name made of the first @a
+ * len characters of @a name (see #scew_element_may_contain_).
+ *
+ * @pre name != NULL
+ */
+extern SCEW_LOCAL unsigned long
+scew_element_attribute_key_ (XML_Char const *name, size_t len);
+
+/**
+ * Tells whether the subtree of the given @a element (including the
+ * element itself) may contain the element or attribute name of the
+ * given summary @a key. The summary of a subtree is a small Bloom
+ * filter of all its names, so false positives are possible but false
+ * negatives are not.
+ *
+ * Summaries are computed lazily and cached in the elements until
+ * they are modified. If @a compute is false, summaries are never
+ * computed (nor cached), so this can be called from several threads
+ * at the same time, but true is returned if the summary is not up to
+ * date.
+ *
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL scew_bool
+scew_element_may_contain_ (scew_element const *element,
+                           unsigned long key,
+                           scew_bool compute);
+
 #endif /* XELEMENT_H_0908270147 */
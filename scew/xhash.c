@@ -0,0 +1,87 @@
+/**
+ * @file     xhash.c
+ * @brief    xhash.h implementation
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 11:30
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "xhash.h"
+
+#include <limits.h>
+
+
+
+/* Private */
+
+/* FNV-1a parameters, 64-bit if possible. */
+#if ULONG_MAX > 0xffffffffUL
+#define HASH_OFFSET_ 0xcbf29ce484222325UL
+#define HASH_PRIME_ 0x100000001b3UL
+#else
+#define HASH_OFFSET_ 0x811c9dc5UL
+#define HASH_PRIME_ 0x01000193UL
+#endif
+
+
+
+/* Protected */
+
+unsigned long
+scew_hash_init_ (void)
+{
+  return HASH_OFFSET_;
+}
+
+unsigned long
+scew_hash_word_ (unsigned long hash, unsigned long value)
+{
+  unsigned int i = 0;
+
+  for (i = 0; i < sizeof (unsigned long); ++i)
+    {
+      hash = (hash ^ (value & 0xffUL)) * HASH_PRIME_;
+      value >>= CHAR_BIT;
+    }
+
+  return hash;
+}
+
+unsigned long
+scew_hash_string_ (unsigned long hash, XML_Char const *data, size_t len)
+{
+  size_t i = 0;
+
+  if (NULL == data)
+    {
+      return scew_hash_word_ (hash, 0);
+    }
+
+  hash = scew_hash_word_ (hash, (unsigned long) len + 1);
+  for (i = 0; i < len; ++i)
+    {
+      hash = (hash ^ (unsigned long) data[i]) * HASH_PRIME_;
+    }
+
+  return hash;
+}
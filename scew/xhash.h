@@ -0,0 +1,67 @@
+/**
+ * @file     xhash.h
+ * @brief    SCEW private hashing functions
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 11:30
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#ifndef XHASH_H_2610181130
+#define XHASH_H_2610181130
+
+#include "export.h"
+
+#include <expat.h>
+
+#include <stddef.h>
+
+
+/* Functions */
+
+/**
+ * Returns the initial value for hashes computed with #scew_hash_word_
+ * and #scew_hash_string_. It depends on the size of unsigned long in
+ * the current platform.
+ */
+extern SCEW_LOCAL unsigned long scew_hash_init_ (void);
+
+/**
+ * Mixes the given @a value into @a hash, byte by byte.
+ *
+ * @return the new hash.
+ */
+extern SCEW_LOCAL unsigned long scew_hash_word_ (unsigned long hash,
+                                                 unsigned long value);
+
+/**
+ * Mixes the first @a len characters of @a data into @a hash. The
+ * length itself is also mixed, so consecutive strings do not
+ * collide. A NULL @a data is hashed differently than an empty string.
+ *
+ * @return the new hash.
+ */
+extern SCEW_LOCAL unsigned long scew_hash_string_ (unsigned long hash,
+                                                   XML_Char const *data,
+                                                   size_t len);
+
+#endif /* XHASH_H_2610181130 */
@@ -0,0 +1,49 @@
+/**
+ * @file     xlist.h
+ * @brief    SCEW private list definition
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 19:05
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#ifndef XLIST_H_2610181905
+#define XLIST_H_2610181905
+
+#include "list.h"
+
+
+/* Types */
+
+/**
+ * Doubly linked list item. Items are usually allocated one by one, but
+ * the items of frozen trees are allocated in a single block with the
+ * rest of the tree (see #scew_tree_freeze).
+ */
+struct scew_list
+{
+  void *data;                   /**< The item's data */
+  scew_list *prev;              /**< Previous item (if any) */
+  scew_list *next;              /**< Next item (if any) */
+};
+
+#endif /* XLIST_H_2610181905 */
@@ -27,10 +27,12 @@
  */
 
 #include "xparser.h"
+#include "xelement.h"
 
 #include "str.h"
 
 #include "xerror.h"
+#include "xscan.h"
 
 #include <assert.h>
 
@@ -269,7 +271,7 @@ expat_end_handler_ (void *data, XML_Char const *elem)
 {
   scew_parser *parser = (scew_parser *) data;
   scew_element *current = NULL;
-  XML_Char const *contents = NULL;
+  scew_xstr *contents = NULL;
 
   if (NULL == parser)
     {
@@ -279,36 +281,26 @@ expat_end_handler_ (void *data, XML_Char const *elem)
   current = parser_stack_pop_ (parser);
 
   /* Trim element contents if necessary. */
-  contents = scew_element_contents (current);
-  if (parser->ignore_whitespaces && (contents != NULL))
+  contents = &current->contents;
+  if (parser->ignore_whitespaces && (contents->data != NULL))
     {
-      /* We use the internal const pointer for performance reasons. */
-      scew_strtrim ((XML_Char *) contents);
-      if (scew_strlen (contents) == 0)
+      /* Trimming updates the stored contents length as well. */
+      scew_xstr_trim_ (contents);
+      scew_element_changed_ (current);
+      if (0 == contents->len)
         {
           scew_element_free_contents (current);
         }
     }
 
   /* Trim the whitespace in mixed nodes if necessary */
-  if(parser->ignore_insignificant_whitespaces && (contents != NULL) && scew_element_count(current) > 1) 
-   {
-      int isEmpty = 1;
-      int i;
-      for(i =0;i < scew_strlen(contents); i++)
-       {
-         char c = contents[i];
-         if(!scew_isspace(c))
-           {
-             isEmpty = 0;
-             break;
-           }
-       }
-
-      if(isEmpty)
-        {
-          scew_element_free_contents (current);
-        }
+  if (parser->ignore_insignificant_whitespaces
+      && (contents->data != NULL)
+      && (scew_element_count (current) > 1)
+      && (scew_scan_lspace_ (contents->data, contents->len)
+          == contents->len))
+    {
+      scew_element_free_contents (current);
     }
 
   /* Call loaded element hook. */
@@ -354,6 +346,7 @@ expat_end_handler_ (void *data, XML_Char const *elem)
         }
 
       scew_tree_set_root_element (parser->tree, current);
+      parser->tree_loaded = SCEW_TRUE;
 
       /* Call loaded tree hook. */
       if (parser->tree_hook.hook != NULL)
@@ -373,10 +366,7 @@ expat_char_handler_ (void *data, XML_Char const *str, int len)
 {
   scew_parser *parser = (scew_parser *) data;
   scew_element *current = NULL;
-  XML_Char const *contents = NULL;
-  XML_Char *new_contents = NULL;
-  unsigned int total_old = 0;
-  unsigned int total = 0;
+  XML_Char const *new_contents = NULL;
 
   if (NULL == parser)
     {
@@ -390,34 +380,25 @@ expat_char_handler_ (void *data, XML_Char const *str, int len)
    */
   current = parser->stack->element;
 
-  /* Get size of current contents. */
-  contents = scew_element_contents (current);
-  if (contents != NULL)
-    {
-      total_old = scew_strlen (contents);
-    }
-
   /**
-   * Calculate new size and allocate enough space (+ 1 for
-   * null-terminated string).
+   * Expat might split element contents in several chunks. The first
+   * one is copied straight from Expat's buffer (which is not
+   * null-terminated) and the next ones are appended in place.
    */
-  total = (total_old + len + 1) * sizeof (XML_Char);
-  new_contents = calloc (total, 1);
-
-  /* Copy old contents (if any) and concatenate new one. */
-  if (contents != NULL)
+  if (NULL == scew_element_contents (current))
     {
-      scew_strcpy (new_contents, contents);
+      new_contents = scew_element_set_contents_len (current, str, len);
+    }
+  else
+    {
+      new_contents = scew_xstr_append_ (&current->contents, str, len);
+      scew_element_changed_ (current);
     }
-  scew_strncat (new_contents, str, len);
-
-  scew_element_set_contents (current, new_contents);
 
-  /**
-   * new_contents is duplicated inside scew_element_set_contents so it
-   * is safe to free it here.
-   */
-  free (new_contents);
+  if (NULL == new_contents)
+    {
+      stop_expat_parsing_ (parser, scew_error_no_memory);
+    }
 }
 
 
@@ -59,6 +59,9 @@ struct scew_parser
   scew_bool parsing_started;    /**< Whether we started parsing any
                                    non-space character before a tree
                                    starts (used in streams) */
+  scew_bool tree_loaded;        /**< Whether the current tree has been
+                                   completely loaded (used in streams,
+                                   as the tree hook might free it) */
   load_hook element_hook;       /**< Hook for loaded elements */
   load_hook tree_hook;          /**< Hook for loaded trees */
 };
@@ -0,0 +1,388 @@
+/**
+ * @file     xpool.c
+ * @brief    xpool.h implementation
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 14:20
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "xpool.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+/* Define a single threading macro common for all platforms */
+#ifndef _MT
+#ifndef HAVE_LIBPTHREAD
+#define SINGLE_THREADED
+#endif /* HAVE_LIBPTHREAD */
+#endif /* _MT */
+
+
+
+/* Private */
+
+/* Run tasks in the calling thread. */
+static scew_bool run_sequential_ (unsigned int n_tasks,
+                                  scew_pool_task_ task,
+                                  void *data);
+
+#ifdef SINGLE_THREADED
+
+/* Single-threaded version */
+
+scew_bool
+scew_pool_run_ (unsigned int n_tasks, scew_pool_task_ task, void *data)
+{
+  assert (task != NULL);
+
+  return run_sequential_ (n_tasks, task, data);
+}
+
+#else /* SINGLE_THREADED */
+
+
+/* Multi-threaded versions */
+
+#ifdef _MSC_VER
+
+#define WIN32_LEAN_AND_MEAN
+
+#include <windows.h>
+#include <process.h>
+
+typedef CRITICAL_SECTION mutex_;
+typedef HANDLE thread_;
+
+#define mutex_init_(m) InitializeCriticalSection (m)
+#define mutex_destroy_(m) DeleteCriticalSection (m)
+#define mutex_lock_(m) EnterCriticalSection (m)
+#define mutex_unlock_(m) LeaveCriticalSection (m)
+
+#else /* _MSC_VER */
+
+#include <pthread.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif /* HAVE_UNISTD_H */
+
+typedef pthread_mutex_t mutex_;
+typedef pthread_t thread_;
+
+#define mutex_init_(m) pthread_mutex_init (m, NULL)
+#define mutex_destroy_(m) pthread_mutex_destroy (m)
+#define mutex_lock_(m) pthread_mutex_lock (m)
+#define mutex_unlock_(m) pthread_mutex_unlock (m)
+
+#endif /* _MSC_VER */
+
+/* Upper limit of threads, no matter how many processors there are. */
+enum { MAX_WORKERS_ = 64 };
+
+/* Pending tasks of a worker (from next to end - 1). */
+typedef struct
+{
+  mutex_ mutex;
+  unsigned int next;
+  unsigned int end;
+} queue_;
+
+typedef struct
+{
+  scew_pool_task_ task;
+  void *data;
+  unsigned int n_workers;
+  queue_ queues[MAX_WORKERS_];
+
+  mutex_ mutex;                 /* Protects failed */
+  scew_bool failed;
+} pool_;
+
+/* Worker thread arguments. */
+typedef struct
+{
+  pool_ *pool;
+  unsigned int id;
+} worker_;
+
+static unsigned int n_processors_ (void);
+static scew_bool start_thread_ (thread_ *thread, worker_ *worker);
+static void join_thread_ (thread_ thread);
+static void run_worker_ (pool_ *pool, unsigned int id);
+static scew_bool take_task_ (pool_ *pool,
+                             unsigned int id,
+                             unsigned int *index);
+static scew_bool steal_task_ (pool_ *pool,
+                              unsigned int id,
+                              unsigned int *index);
+
+scew_bool
+scew_pool_run_ (unsigned int n_tasks, scew_pool_task_ task, void *data)
+{
+  pool_ pool;
+  thread_ threads[MAX_WORKERS_];
+  worker_ workers[MAX_WORKERS_];
+  scew_bool started[MAX_WORKERS_];
+  unsigned int i = 0;
+
+  assert (task != NULL);
+
+  pool.n_workers = n_processors_ ();
+  if (pool.n_workers > n_tasks)
+    {
+      pool.n_workers = n_tasks;
+    }
+
+  if (pool.n_workers < 2)
+    {
+      return run_sequential_ (n_tasks, task, data);
+    }
+
+  pool.task = task;
+  pool.data = data;
+  pool.failed = SCEW_FALSE;
+  mutex_init_ (&pool.mutex);
+
+  /* Consecutive blocks of tasks for each worker. */
+  for (i = 0; i < pool.n_workers; ++i)
+    {
+      mutex_init_ (&pool.queues[i].mutex);
+      pool.queues[i].next = (unsigned int)
+        (((unsigned long) n_tasks * i) / pool.n_workers);
+      pool.queues[i].end = (unsigned int)
+        (((unsigned long) n_tasks * (i + 1)) / pool.n_workers);
+    }
+
+  /**
+   * The calling thread is worker 0. If a thread can not be started,
+   * its tasks will be stolen by the others.
+   */
+  for (i = 1; i < pool.n_workers; ++i)
+    {
+      workers[i].pool = &pool;
+      workers[i].id = i;
+      started[i] = start_thread_ (&threads[i], &workers[i]);
+    }
+
+  run_worker_ (&pool, 0);
+
+  for (i = 1; i < pool.n_workers; ++i)
+    {
+      if (started[i])
+        {
+          join_thread_ (threads[i]);
+        }
+    }
+
+  for (i = 0; i < pool.n_workers; ++i)
+    {
+      mutex_destroy_ (&pool.queues[i].mutex);
+    }
+  mutex_destroy_ (&pool.mutex);
+
+  return !pool.failed;
+}
+
+#ifdef _MSC_VER
+
+/* Visual C++ multi-thread version */
+
+static unsigned __stdcall
+thread_main_ (void *arg)
+{
+  worker_ *worker = (worker_ *) arg;
+
+  run_worker_ (worker->pool, worker->id);
+
+  return 0;
+}
+
+unsigned int
+n_processors_ (void)
+{
+  SYSTEM_INFO info;
+
+  GetSystemInfo (&info);
+
+  return (info.dwNumberOfProcessors > MAX_WORKERS_)
+    ? MAX_WORKERS_ : (unsigned int) info.dwNumberOfProcessors;
+}
+
+scew_bool
+start_thread_ (thread_ *thread, worker_ *worker)
+{
+  *thread = (HANDLE) _beginthreadex (NULL, 0, thread_main_, worker, 0, NULL);
+
+  return (*thread != 0);
+}
+
+void
+join_thread_ (thread_ thread)
+{
+  WaitForSingleObject (thread, INFINITE);
+  CloseHandle (thread);
+}
+
+#else /* _MSC_VER */
+
+/* pthread multi-threaded version */
+
+static void*
+thread_main_ (void *arg)
+{
+  worker_ *worker = (worker_ *) arg;
+
+  run_worker_ (worker->pool, worker->id);
+
+  return NULL;
+}
+
+unsigned int
+n_processors_ (void)
+{
+  long n = 1;
+
+#ifdef _SC_NPROCESSORS_ONLN
+  n = sysconf (_SC_NPROCESSORS_ONLN);
+#endif /* _SC_NPROCESSORS_ONLN */
+
+  if (n < 1)
+    {
+      n = 1;
+    }
+
+  return (n > MAX_WORKERS_) ? MAX_WORKERS_ : (unsigned int) n;
+}
+
+scew_bool
+start_thread_ (thread_ *thread, worker_ *worker)
+{
+  return (pthread_create (thread, NULL, thread_main_, worker) == 0);
+}
+
+void
+join_thread_ (thread_ thread)
+{
+  pthread_join (thread, NULL);
+}
+
+#endif /* _MSC_VER */
+
+void
+run_worker_ (pool_ *pool, unsigned int id)
+{
+  unsigned int index = 0;
+  scew_bool failed = SCEW_FALSE;
+
+  while (!failed
+         && (take_task_ (pool, id, &index) || steal_task_ (pool, id, &index)))
+    {
+      if (!pool->task (pool->data, index))
+        {
+          mutex_lock_ (&pool->mutex);
+          pool->failed = SCEW_TRUE;
+          mutex_unlock_ (&pool->mutex);
+        }
+
+      mutex_lock_ (&pool->mutex);
+      failed = pool->failed;
+      mutex_unlock_ (&pool->mutex);
+    }
+}
+
+scew_bool
+take_task_ (pool_ *pool, unsigned int id, unsigned int *index)
+{
+  queue_ *queue = &pool->queues[id];
+  scew_bool taken = SCEW_FALSE;
+
+  mutex_lock_ (&queue->mutex);
+  if (queue->next < queue->end)
+    {
+      *index = queue->next++;
+      taken = SCEW_TRUE;
+    }
+  mutex_unlock_ (&queue->mutex);
+
+  return taken;
+}
+
+scew_bool
+steal_task_ (pool_ *pool, unsigned int id, unsigned int *index)
+{
+  unsigned int i = 0;
+
+  for (i = 1; i < pool->n_workers; ++i)
+    {
+      queue_ *victim = &pool->queues[(id + i) % pool->n_workers];
+      unsigned int start = 0;
+      unsigned int end = 0;
+
+      /* Steal the second half of the victim's pending tasks. */
+      mutex_lock_ (&victim->mutex);
+      if (victim->next < victim->end)
+        {
+          end = victim->end;
+          start = end - (end - victim->next + 1) / 2;
+          victim->end = start;
+        }
+      mutex_unlock_ (&victim->mutex);
+
+      if (start < end)
+        {
+          queue_ *queue = &pool->queues[id];
+
+          mutex_lock_ (&queue->mutex);
+          queue->next = start + 1;
+          queue->end = end;
+          mutex_unlock_ (&queue->mutex);
+
+          *index = start;
+
+          return SCEW_TRUE;
+        }
+    }
+
+  return SCEW_FALSE;
+}
+
+#endif /* SINGLE_THREADED */
+
+scew_bool
+run_sequential_ (unsigned int n_tasks, scew_pool_task_ task, void *data)
+{
+  scew_bool succeeded = SCEW_TRUE;
+  unsigned int i = 0;
+
+  for (i = 0; succeeded && (i < n_tasks); ++i)
+    {
+      succeeded = task (data, i);
+    }
+
+  return succeeded;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file     xpool.h
+ * @brief    SCEW private thread pool
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 14:20
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#ifndef XPOOL_H_2610181420
+#define XPOOL_H_2610181420
+
+#include "export.h"
+
+#include "bool.h"
+
+
+/* Types */
+
+/**
+ * Tasks run by #scew_pool_run_. A task receives the user @a data
+ * given to #scew_pool_run_ and the @a index of the task to run.
+ *
+ * @return true if the task succeeded, false otherwise (which stops
+ * running new tasks).
+ */
+typedef scew_bool (*scew_pool_task_) (void *data, unsigned int index);
+
+
+/* Functions */
+
+/**
+ * Runs tasks 0 to @a n_tasks - 1 in parallel, using as many threads
+ * as processors are available (the calling thread included), and
+ * waits for all of them to finish. Tasks are initially split in
+ * consecutive blocks, one per thread, and idle threads steal half of
+ * the pending tasks of busy threads.
+ *
+ * If any task fails, no new tasks are started. Tasks might be run in
+ * any order and, when there is no thread support, they are simply run
+ * in order in the calling thread.
+ *
+ * @pre task != NULL
+ *
+ * @return true if all the tasks succeeded, false otherwise.
+ */
+extern SCEW_LOCAL scew_bool scew_pool_run_ (unsigned int n_tasks,
+                                            scew_pool_task_ task,
+                                            void *data);
+
+#endif /* XPOOL_H_2610181420 */
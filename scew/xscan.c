@@ -0,0 +1,592 @@
+/**
+ * @file     xscan.c
+ * @brief    xscan.h implementation
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 21:30
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "xscan.h"
+
+#include "str.h"
+
+#include <assert.h>
+
+#ifdef _MSC_VER
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif /* _MSC_VER */
+
+/* Vector instructions are only used for single byte characters. */
+#ifndef XML_UNICODE_WCHAR_T
+#if (defined (__GNUC__) || defined (__clang__))                 \
+  && (defined (__x86_64__) || defined (__i386__))
+#define SCAN_SSE2_
+#define SCAN_AVX2_
+#define SCAN_SSE2_ATTR_ __attribute__ ((target ("sse2")))
+#define SCAN_AVX2_ATTR_ __attribute__ ((target ("avx2")))
+#include <immintrin.h>
+#elif defined (_MSC_VER) && defined (_M_X64)
+#define SCAN_SSE2_
+#define SCAN_SSE2_ATTR_
+#include <emmintrin.h>
+#include <intrin.h>
+#elif defined (__ARM_NEON) || defined (__aarch64__)
+#define SCAN_NEON_
+#include <arm_neon.h>
+#endif
+#endif /* XML_UNICODE_WCHAR_T */
+
+
+
+/* Private */
+
+/*
+ * All characters to be escaped ('"', '&', '\'', '<' and '>') are
+ * between '"' and '>', so a single comparison and a bit mask tell
+ * whether a character needs to be escaped.
+ */
+#define ESCAPE_FIRST_ _XT('"')
+#define ESCAPE_BIT_(c) (1UL << ((c) - ESCAPE_FIRST_))
+#define ESCAPE_MASK_                                    \
+  (ESCAPE_BIT_ (_XT('"')) | ESCAPE_BIT_ (_XT('&'))      \
+   | ESCAPE_BIT_ (_XT('\'')) | ESCAPE_BIT_ (_XT('<'))   \
+   | ESCAPE_BIT_ (_XT('>')))
+
+/* Tells whether the given character needs to be escaped. */
+#define NEEDS_ESCAPE_(c)                                        \
+  ((((unsigned long) (c) - ESCAPE_FIRST_) < 32)                \
+   && ((ESCAPE_MASK_ >> ((unsigned long) (c) - ESCAPE_FIRST_)) & 1))
+
+#ifdef XML_UNICODE_WCHAR_T
+#define IS_SPACE_(c) scew_isspace (c)
+#else
+/* '\t', '\n', '\v', '\f' and '\r' are consecutive. */
+#define IS_SPACE_(c)                                            \
+  ((' ' == (c)) || ((unsigned char) ((c) - '\t') <= '\r' - '\t'))
+#endif /* XML_UNICODE_WCHAR_T */
+
+typedef size_t (*scan_fn_) (XML_Char const *data, size_t len);
+
+typedef struct
+{
+  scan_fn_ escape;
+  scan_fn_ lspace;
+  scan_fn_ rspace;
+} scan_kernels_;
+
+static scan_kernels_ const* kernels_ (void);
+static scan_kernels_ const* select_kernels_ (void);
+
+static size_t scalar_escape_ (XML_Char const *data, size_t len);
+static size_t scalar_lspace_ (XML_Char const *data, size_t len);
+static size_t scalar_rspace_ (XML_Char const *data, size_t len);
+
+static scan_kernels_ const scalar_kernels_ =
+  {
+    scalar_escape_,
+    scalar_lspace_,
+    scalar_rspace_
+  };
+
+#ifdef SCAN_SSE2_
+static unsigned int first_bit_ (unsigned int mask);
+static unsigned int last_bit_ (unsigned int mask);
+
+static __m128i sse2_escape_bytes_ (__m128i v) SCAN_SSE2_ATTR_;
+static __m128i sse2_space_bytes_ (__m128i v) SCAN_SSE2_ATTR_;
+static size_t sse2_escape_ (XML_Char const *data, size_t len) SCAN_SSE2_ATTR_;
+static size_t sse2_lspace_ (XML_Char const *data, size_t len) SCAN_SSE2_ATTR_;
+static size_t sse2_rspace_ (XML_Char const *data, size_t len) SCAN_SSE2_ATTR_;
+
+static scan_kernels_ const sse2_kernels_ =
+  {
+    sse2_escape_,
+    sse2_lspace_,
+    sse2_rspace_
+  };
+#endif /* SCAN_SSE2_ */
+
+#ifdef SCAN_AVX2_
+static __m256i avx2_escape_bytes_ (__m256i v) SCAN_AVX2_ATTR_;
+static __m256i avx2_space_bytes_ (__m256i v) SCAN_AVX2_ATTR_;
+static size_t avx2_escape_ (XML_Char const *data, size_t len) SCAN_AVX2_ATTR_;
+static size_t avx2_lspace_ (XML_Char const *data, size_t len) SCAN_AVX2_ATTR_;
+static size_t avx2_rspace_ (XML_Char const *data, size_t len) SCAN_AVX2_ATTR_;
+
+static scan_kernels_ const avx2_kernels_ =
+  {
+    avx2_escape_,
+    avx2_lspace_,
+    avx2_rspace_
+  };
+#endif /* SCAN_AVX2_ */
+
+#ifdef SCAN_NEON_
+static scew_bool neon_any_ (uint8x16_t mask);
+static uint8x16_t neon_escape_bytes_ (uint8x16_t v);
+static uint8x16_t neon_space_bytes_ (uint8x16_t v);
+static size_t neon_escape_ (XML_Char const *data, size_t len);
+static size_t neon_lspace_ (XML_Char const *data, size_t len);
+static size_t neon_rspace_ (XML_Char const *data, size_t len);
+
+static scan_kernels_ const neon_kernels_ =
+  {
+    neon_escape_,
+    neon_lspace_,
+    neon_rspace_
+  };
+#endif /* SCAN_NEON_ */
+
+
+
+/* Protected */
+
+size_t
+scew_scan_escape_ (XML_Char const *data, size_t len)
+{
+  assert ((data != NULL) || (0 == len));
+
+  return kernels_ ()->escape (data, len);
+}
+
+size_t
+scew_scan_lspace_ (XML_Char const *data, size_t len)
+{
+  assert ((data != NULL) || (0 == len));
+
+  return kernels_ ()->lspace (data, len);
+}
+
+size_t
+scew_scan_rspace_ (XML_Char const *data, size_t len)
+{
+  assert ((data != NULL) || (0 == len));
+
+  return kernels_ ()->rspace (data, len);
+}
+
+
+
+/* Private */
+
+scan_kernels_ const*
+kernels_ (void)
+{
+  /*
+   * Kernels are selected the first time they are needed. Threads
+   * (e.g. from the parallel printer) might race here, so the pointer
+   * is published atomically. They would all select the same kernels.
+   */
+  static scan_kernels_ const *kernels = NULL;
+  scan_kernels_ const *selected = NULL;
+
+#if defined (__GNUC__)
+  selected = __atomic_load_n (&kernels, __ATOMIC_ACQUIRE);
+#elif defined (_MSC_VER)
+  selected = *(scan_kernels_ const * volatile *) &kernels;
+  MemoryBarrier ();
+#else
+  selected = kernels;
+#endif /* __GNUC__ */
+
+  if (NULL == selected)
+    {
+      selected = select_kernels_ ();
+
+#if defined (__GNUC__)
+      __atomic_store_n (&kernels, selected, __ATOMIC_RELEASE);
+#elif defined (_MSC_VER)
+      MemoryBarrier ();
+      *(scan_kernels_ const * volatile *) &kernels = selected;
+#else
+      kernels = selected;
+#endif /* __GNUC__ */
+    }
+
+  return selected;
+}
+
+scan_kernels_ const*
+select_kernels_ (void)
+{
+  scan_kernels_ const *kernels = &scalar_kernels_;
+
+#if defined (SCAN_AVX2_)
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    {
+      kernels = &avx2_kernels_;
+    }
+  else if (__builtin_cpu_supports ("sse2"))
+    {
+      kernels = &sse2_kernels_;
+    }
+#elif defined (SCAN_SSE2_)
+  /* SSE2 is always available in x86-64. */
+  kernels = &sse2_kernels_;
+#elif defined (SCAN_NEON_)
+  /* NEON is always available where it is enabled at compile time. */
+  kernels = &neon_kernels_;
+#endif
+
+  return kernels;
+}
+
+/* Scalar kernels (also used for the tail of vector kernels) */
+
+size_t
+scalar_escape_ (XML_Char const *data, size_t len)
+{
+  size_t i = 0;
+
+  while ((i < len) && !NEEDS_ESCAPE_ (data[i]))
+    {
+      i += 1;
+    }
+
+  return i;
+}
+
+size_t
+scalar_lspace_ (XML_Char const *data, size_t len)
+{
+  size_t i = 0;
+
+  while ((i < len) && IS_SPACE_ (data[i]))
+    {
+      i += 1;
+    }
+
+  return i;
+}
+
+size_t
+scalar_rspace_ (XML_Char const *data, size_t len)
+{
+  while ((len > 0) && IS_SPACE_ (data[len - 1]))
+    {
+      len -= 1;
+    }
+
+  return len;
+}
+
+#ifdef SCAN_SSE2_
+
+/* SSE2 kernels (16 characters at a time) */
+
+#ifdef _MSC_VER
+unsigned int
+first_bit_ (unsigned int mask)
+{
+  unsigned long bit = 0;
+
+  _BitScanForward (&bit, mask);
+
+  return bit;
+}
+
+unsigned int
+last_bit_ (unsigned int mask)
+{
+  unsigned long bit = 0;
+
+  _BitScanReverse (&bit, mask);
+
+  return bit;
+}
+#else
+unsigned int
+first_bit_ (unsigned int mask)
+{
+  return __builtin_ctz (mask);
+}
+
+unsigned int
+last_bit_ (unsigned int mask)
+{
+  return 31 - __builtin_clz (mask);
+}
+#endif /* _MSC_VER */
+
+__m128i
+sse2_escape_bytes_ (__m128i v)
+{
+  __m128i bytes = _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('<'));
+
+  bytes = _mm_or_si128 (bytes, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('>')));
+  bytes = _mm_or_si128 (bytes, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('&')));
+  bytes = _mm_or_si128 (bytes, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('\'')));
+  bytes = _mm_or_si128 (bytes, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('"')));
+
+  return bytes;
+}
+
+__m128i
+sse2_space_bytes_ (__m128i v)
+{
+  /* Only '\t' to '\r' become 0 to 4 (unsigned minimum keeps them). */
+  __m128i control = _mm_sub_epi8 (v, _mm_set1_epi8 ('\t'));
+  __m128i limit = _mm_min_epu8 (control, _mm_set1_epi8 ('\r' - '\t'));
+
+  return _mm_or_si128 (_mm_cmpeq_epi8 (limit, control),
+                       _mm_cmpeq_epi8 (v, _mm_set1_epi8 (' ')));
+}
+
+size_t
+sse2_escape_ (XML_Char const *data, size_t len)
+{
+  size_t i = 0;
+  unsigned int mask = 0;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      __m128i v = _mm_loadu_si128 ((__m128i const *) (data + i));
+      mask = _mm_movemask_epi8 (sse2_escape_bytes_ (v));
+      if (mask != 0)
+        {
+          return i + first_bit_ (mask);
+        }
+    }
+
+  return i + scalar_escape_ (data + i, len - i);
+}
+
+size_t
+sse2_lspace_ (XML_Char const *data, size_t len)
+{
+  size_t i = 0;
+  unsigned int mask = 0;
+
+  for (i = 0; i + 16 <= len; i += 16)
+    {
+      __m128i v = _mm_loadu_si128 ((__m128i const *) (data + i));
+      mask = _mm_movemask_epi8 (sse2_space_bytes_ (v)) ^ 0xFFFF;
+      if (mask != 0)
+        {
+          return i + first_bit_ (mask);
+        }
+    }
+
+  return i + scalar_lspace_ (data + i, len - i);
+}
+
+size_t
+sse2_rspace_ (XML_Char const *data, size_t len)
+{
+  unsigned int mask = 0;
+
+  for (; len >= 16; len -= 16)
+    {
+      __m128i v = _mm_loadu_si128 ((__m128i const *) (data + len - 16));
+      mask = _mm_movemask_epi8 (sse2_space_bytes_ (v)) ^ 0xFFFF;
+      if (mask != 0)
+        {
+          return len - 16 + last_bit_ (mask) + 1;
+        }
+    }
+
+  return scalar_rspace_ (data, len);
+}
+
+#endif /* SCAN_SSE2_ */
+
+#ifdef SCAN_AVX2_
+
+/* AVX2 kernels (32 characters at a time) */
+
+__m256i
+avx2_escape_bytes_ (__m256i v)
+{
+  __m256i bytes = _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('<'));
+
+  bytes = _mm256_or_si256 (bytes,
+                           _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('>')));
+  bytes = _mm256_or_si256 (bytes,
+                           _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('&')));
+  bytes = _mm256_or_si256 (bytes,
+                           _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('\'')));
+  bytes = _mm256_or_si256 (bytes,
+                           _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 ('"')));
+
+  return bytes;
+}
+
+__m256i
+avx2_space_bytes_ (__m256i v)
+{
+  /* Only '\t' to '\r' become 0 to 4 (unsigned minimum keeps them). */
+  __m256i control = _mm256_sub_epi8 (v, _mm256_set1_epi8 ('\t'));
+  __m256i limit = _mm256_min_epu8 (control, _mm256_set1_epi8 ('\r' - '\t'));
+
+  return _mm256_or_si256 (_mm256_cmpeq_epi8 (limit, control),
+                          _mm256_cmpeq_epi8 (v, _mm256_set1_epi8 (' ')));
+}
+
+size_t
+avx2_escape_ (XML_Char const *data, size_t len)
+{
+  size_t i = 0;
+  unsigned int mask = 0;
+
+  for (i = 0; i + 32 <= len; i += 32)
+    {
+      __m256i v = _mm256_loadu_si256 ((__m256i const *) (data + i));
+      mask = _mm256_movemask_epi8 (avx2_escape_bytes_ (v));
+      if (mask != 0)
+        {
+          return i + first_bit_ (mask);
+        }
+    }
+
+  return i + scalar_escape_ (data + i, len - i);
+}
+
+size_t
+avx2_lspace_ (XML_Char const *data, size_t len)
+{
+  size_t i = 0;
+  unsigned int mask = 0;
+
+  for (i = 0; i + 32 <= len; i += 32)
+    {
+      __m256i v = _mm256_loadu_si256 ((__m256i const *) (data + i));
+      mask = ~(unsigned int) _mm256_movemask_epi8 (avx2_space_bytes_ (v));
+      if (mask != 0)
+        {
+          return i + first_bit_ (mask);
+        }
+    }
+
+  return i + scalar_lspace_ (data + i, len - i);
+}
+
+size_t
+avx2_rspace_ (XML_Char const *data, size_t len)
+{
+  unsigned int mask = 0;
+
+  for (; len >= 32; len -= 32)
+    {
+      __m256i v = _mm256_loadu_si256 ((__m256i const *) (data + len - 32));
+      mask = ~(unsigned int) _mm256_movemask_epi8 (avx2_space_bytes_ (v));
+      if (mask != 0)
+        {
+          return len - 32 + last_bit_ (mask) + 1;
+        }
+    }
+
+  return scalar_rspace_ (data, len);
+}
+
+#endif /* SCAN_AVX2_ */
+
+#ifdef SCAN_NEON_
+
+/*
+ * NEON kernels (16 characters at a time). NEON has no cheap way to
+ * get the position of a byte, so only blocks are checked and the
+ * scalar kernels find the exact position within the matching block.
+ */
+
+scew_bool
+neon_any_ (uint8x16_t mask)
+{
+#ifdef __aarch64__
+  return (vmaxvq_u8 (mask) != 0);
+#else
+  uint8x8_t half = vorr_u8 (vget_low_u8 (mask), vget_high_u8 (mask));
+  return (vget_lane_u64 (vreinterpret_u64_u8 (half), 0) != 0);
+#endif /* __aarch64__ */
+}
+
+uint8x16_t
+neon_escape_bytes_ (uint8x16_t v)
+{
+  uint8x16_t bytes = vceqq_u8 (v, vdupq_n_u8 ('<'));
+
+  bytes = vorrq_u8 (bytes, vceqq_u8 (v, vdupq_n_u8 ('>')));
+  bytes = vorrq_u8 (bytes, vceqq_u8 (v, vdupq_n_u8 ('&')));
+  bytes = vorrq_u8 (bytes, vceqq_u8 (v, vdupq_n_u8 ('\'')));
+  bytes = vorrq_u8 (bytes, vceqq_u8 (v, vdupq_n_u8 ('"')));
+
+  return bytes;
+}
+
+uint8x16_t
+neon_space_bytes_ (uint8x16_t v)
+{
+  uint8x16_t control = vsubq_u8 (v, vdupq_n_u8 ('\t'));
+
+  return vorrq_u8 (vcleq_u8 (control, vdupq_n_u8 ('\r' - '\t')),
+                   vceqq_u8 (v, vdupq_n_u8 (' ')));
+}
+
+size_t
+neon_escape_ (XML_Char const *data, size_t len)
+{
+  size_t i = 0;
+
+  while ((i + 16 <= len)
+         && !neon_any_ (neon_escape_bytes_ (vld1q_u8 ((uint8_t const *)
+                                                       data + i))))
+    {
+      i += 16;
+    }
+
+  return i + scalar_escape_ (data + i, len - i);
+}
+
+size_t
+neon_lspace_ (XML_Char const *data, size_t len)
+{
+  size_t i = 0;
+
+  while ((i + 16 <= len)
+         && !neon_any_ (vmvnq_u8 (neon_space_bytes_
+                                  (vld1q_u8 ((uint8_t const *) data + i)))))
+    {
+      i += 16;
+    }
+
+  return i + scalar_lspace_ (data + i, len - i);
+}
+
+size_t
+neon_rspace_ (XML_Char const *data, size_t len)
+{
+  size_t end = len;
+
+  while ((end >= 16)
+         && !neon_any_ (vmvnq_u8 (neon_space_bytes_
+                                  (vld1q_u8 ((uint8_t const *)
+                                             data + end - 16)))))
+    {
+      end -= 16;
+    }
+
+  return scalar_rspace_ (data, end);
+}
+
+#endif /* SCAN_NEON_ */
@@ -0,0 +1,80 @@
+/**
+ * @file     xscan.h
+ * @brief    SCEW private vectorized string scanning
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 21:30
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#ifndef XSCAN_H_2610182130
+#define XSCAN_H_2610182130
+
+#include "export.h"
+
+#include <expat.h>
+
+#include <stddef.h>
+
+
+/* Functions */
+
+/*
+ * These routines look for specific characters in long strings, which
+ * is done on both parsing and printing. They use SIMD instructions
+ * (SSE2, AVX2 or NEON), chosen at runtime depending on what the CPU
+ * supports, falling back to a character by character scan otherwise
+ * (and always for wide characters).
+ *
+ * Whitespace is ' ', '\t', '\n', '\v', '\f' and '\r' (the "C" locale
+ * isspace), or whatever iswspace says for wide characters.
+ */
+
+/**
+ * Returns the position of the first character in the first @a len
+ * characters of @a data that needs to be escaped in XML contents or
+ * attribute values ('<', '>', '&', '\'' or '"'), or @a len if there
+ * is none.
+ *
+ * @pre data != NULL || len == 0
+ */
+extern SCEW_LOCAL size_t scew_scan_escape_ (XML_Char const *data, size_t len);
+
+/**
+ * Returns the number of whitespace characters at the beginning of the
+ * first @a len characters of @a data (@a len if all of them are
+ * whitespace).
+ *
+ * @pre data != NULL || len == 0
+ */
+extern SCEW_LOCAL size_t scew_scan_lspace_ (XML_Char const *data, size_t len);
+
+/**
+ * Returns the number of characters left in the first @a len
+ * characters of @a data after removing the trailing whitespace (0 if
+ * all of them are whitespace).
+ *
+ * @pre data != NULL || len == 0
+ */
+extern SCEW_LOCAL size_t scew_scan_rspace_ (XML_Char const *data, size_t len);
+
+#endif /* XSCAN_H_2610182130 */
@@ -0,0 +1,258 @@
+/**
+ * @file     xstr.c
+ * @brief    xstr.h implementation
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 10:12
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "xstr.h"
+
+#include "str.h"
+#include "xscan.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+
+/* Private */
+
+/* Tells whether the characters of the given string are stored inline. */
+#define IS_INLINE_(str) ((str)->data == (str)->buf)
+
+/* Tells whether the given number of characters can be stored inline. */
+#define FITS_INLINE_(len) ((len) < SCEW_XSTR_INLINE_)
+
+static void release_ (scew_xstr *str);
+
+
+
+/* Protected */
+
+XML_Char const*
+scew_xstr_set_ (scew_xstr *str, XML_Char const *src, size_t len)
+{
+  XML_Char *data = NULL;
+
+  assert (str != NULL);
+  assert (src != NULL);
+
+  if (FITS_INLINE_ (len))
+    {
+      /* src might point to our own characters, so copy them first. */
+      scew_memmove (str->buf, src, len);
+      release_ (str);
+      data = str->buf;
+    }
+  else
+    {
+      data = scew_strndup (src, len);
+      if (NULL == data)
+        {
+          return NULL;
+        }
+      release_ (str);
+    }
+
+  str->data = data;
+  str->len = len;
+  str->data[len] = _XT('\0');
+
+  return data;
+}
+
+XML_Char const*
+scew_xstr_take_ (scew_xstr *str, XML_Char *data, size_t len)
+{
+  assert (str != NULL);
+  assert (data != NULL);
+
+  if (str->data == data)
+    {
+      /* We already own the given characters. */
+      str->len = len;
+    }
+  else if (FITS_INLINE_ (len))
+    {
+      /* Short strings are cheaper to keep inline. */
+      scew_xstr_set_ (str, data, len);
+      free (data);
+    }
+  else
+    {
+      release_ (str);
+      str->data = data;
+      str->len = len;
+    }
+
+  return str->data;
+}
+
+XML_Char const*
+scew_xstr_append_ (scew_xstr *str, XML_Char const *src, size_t len)
+{
+  XML_Char *data = NULL;
+  size_t total = 0;
+
+  assert (str != NULL);
+  assert (src != NULL);
+
+  if (NULL == str->data)
+    {
+      return scew_xstr_set_ (str, src, len);
+    }
+
+  total = str->len + len;
+  if (IS_INLINE_ (str) && FITS_INLINE_ (total))
+    {
+      data = str->buf;
+    }
+  else if (IS_INLINE_ (str))
+    {
+      /* Move inline characters to the heap. */
+      data = malloc ((total + 1) * sizeof (XML_Char));
+      if (data != NULL)
+        {
+          scew_memcpy (data, str->buf, str->len);
+        }
+    }
+  else
+    {
+      /* Heap strings (even short ones, e.g. after trimming) stay there. */
+      data = realloc (str->data, (total + 1) * sizeof (XML_Char));
+    }
+
+  if (data != NULL)
+    {
+      scew_memcpy (data + str->len, src, len);
+      str->data = data;
+      str->len = total;
+      str->data[total] = _XT('\0');
+    }
+
+  return data;
+}
+
+void
+scew_xstr_free_ (scew_xstr *str)
+{
+  assert (str != NULL);
+
+  release_ (str);
+  str->data = NULL;
+  str->len = 0;
+}
+
+scew_bool
+scew_xstr_equal_ (scew_xstr const *a, scew_xstr const *b)
+{
+  assert (a != NULL);
+  assert (b != NULL);
+
+  if ((NULL == a->data) || (NULL == b->data))
+    {
+      return (a->data == b->data);
+    }
+
+  return (a->len == b->len) && (scew_memcmp (a->data, b->data, a->len) == 0);
+}
+
+void
+scew_xstr_trim_ (scew_xstr *str)
+{
+  size_t start = 0;
+  size_t end = 0;
+
+  assert (str != NULL);
+
+  if (NULL == str->data)
+    {
+      return;
+    }
+
+  /* Strip trailing and leading whitespace. */
+  end = scew_scan_rspace_ (str->data, str->len);
+  start = scew_scan_lspace_ (str->data, end);
+
+  str->len = end - start;
+  if (start > 0)
+    {
+      scew_memmove (str->data, &str->data[start], str->len);
+    }
+  str->data[str->len] = _XT('\0');
+}
+
+size_t
+scew_xstr_pack_size_ (scew_xstr const *str)
+{
+  assert (str != NULL);
+
+  return ((NULL == str->data) || FITS_INLINE_ (str->len)) ? 0 : str->len + 1;
+}
+
+XML_Char*
+scew_xstr_pack_ (scew_xstr *str, scew_xstr const *src, XML_Char *pool)
+{
+  XML_Char *data = NULL;
+
+  assert (str != NULL);
+  assert (src != NULL);
+
+  if (NULL == src->data)
+    {
+      str->data = NULL;
+      str->len = 0;
+      return pool;
+    }
+
+  if (FITS_INLINE_ (src->len))
+    {
+      data = str->buf;
+    }
+  else
+    {
+      data = pool;
+      pool += src->len + 1;
+    }
+
+  scew_memcpy (data, src->data, src->len);
+  data[src->len] = _XT('\0');
+  str->data = data;
+  str->len = src->len;
+
+  return pool;
+}
+
+
+
+/* Private */
+
+void
+release_ (scew_xstr *str)
+{
+  if (!IS_INLINE_ (str))
+    {
+      free (str->data);
+    }
+}
@@ -0,0 +1,165 @@
+/**
+ * @file     xstr.h
+ * @brief    SCEW private length-aware string type
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 10:12
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#ifndef XSTR_H_2610181012
+#define XSTR_H_2610181012
+
+#include "export.h"
+
+#include "bool.h"
+
+#include <expat.h>
+
+#include <stddef.h>
+
+
+/* Types */
+
+enum
+  {
+    SCEW_XSTR_INLINE_ = 16      /**< Characters (with '\0') stored inline */
+  };
+
+/**
+ * Strings stored in elements and attributes (names, contents and
+ * values) keep their length next to the characters, so it does not
+ * need to be recomputed every time the string is printed or
+ * compared. The characters are always null-terminated.
+ *
+ * Most names and values are short, so strings of less than
+ * #SCEW_XSTR_INLINE_ characters are stored inside the structure
+ * itself instead of being allocated separately. @a data always points
+ * to the characters, wherever they are, so readers do not need to
+ * care about it. As @a data might point to @a buf, these structures
+ * must not be copied or moved around.
+ */
+typedef struct
+{
+  XML_Char *data;               /**< The characters (NULL if not set) */
+  size_t len;                   /**< Number of characters (without '\0') */
+  XML_Char buf[SCEW_XSTR_INLINE_]; /**< Inline storage for short strings */
+} scew_xstr;
+
+
+/* Functions */
+
+/**
+ * Copies the first @a len characters of @a src into the given @a
+ * str, freeing its old characters. @a src does not need to be
+ * null-terminated. If the new string can not be allocated the old one
+ * is kept.
+ *
+ * @pre str != NULL
+ * @pre src != NULL
+ *
+ * @return the new characters, or NULL if they could not be allocated.
+ */
+extern SCEW_LOCAL XML_Char const* scew_xstr_set_ (scew_xstr *str,
+                                                  XML_Char const *src,
+                                                  size_t len);
+
+/**
+ * Makes the given @a str adopt the null-terminated @a data buffer of
+ * @a len characters, freeing its old characters. @a data must have
+ * been allocated with malloc and it is owned by @a str afterwards
+ * (short strings are moved inline and @a data is freed).
+ *
+ * @pre str != NULL
+ * @pre data != NULL
+ *
+ * @return the new characters.
+ */
+extern SCEW_LOCAL XML_Char const* scew_xstr_take_ (scew_xstr *str,
+                                                   XML_Char *data,
+                                                   size_t len);
+
+/**
+ * Appends the first @a len characters of @a src to the given @a
+ * str. If @a str is unset this is the same as #scew_xstr_set_. If the
+ * string can not be grown the old one is kept.
+ *
+ * @pre str != NULL
+ * @pre src != NULL
+ *
+ * @return the new characters, or NULL if they could not be allocated.
+ */
+extern SCEW_LOCAL XML_Char const* scew_xstr_append_ (scew_xstr *str,
+                                                     XML_Char const *src,
+                                                     size_t len);
+
+/**
+ * Frees the characters of the given @a str and leaves it unset.
+ *
+ * @pre str != NULL
+ */
+extern SCEW_LOCAL void scew_xstr_free_ (scew_xstr *str);
+
+/**
+ * Tells whether the two given strings are equal. Two unset strings
+ * are considered equal, but an unset string is never equal to a set
+ * one (even if empty).
+ *
+ * @pre a != NULL
+ * @pre b != NULL
+ */
+extern SCEW_LOCAL scew_bool scew_xstr_equal_ (scew_xstr const *a,
+                                              scew_xstr const *b);
+
+/**
+ * Trims off spaces from the beginning and end of the given @a str in
+ * place, updating its length. Unset strings are left untouched.
+ *
+ * @pre str != NULL
+ */
+extern SCEW_LOCAL void scew_xstr_trim_ (scew_xstr *str);
+
+/**
+ * Returns the number of characters (with '\0') the given @a str needs
+ * from a pool to be packed with #scew_xstr_pack_ (0 if it is unset or
+ * short enough to be stored inline).
+ *
+ * @pre str != NULL
+ */
+extern SCEW_LOCAL size_t scew_xstr_pack_size_ (scew_xstr const *str);
+
+/**
+ * Copies the given @a src into the unset @a str, storing its
+ * characters inline or, if they do not fit, at the beginning of the
+ * given @a pool. Characters stored in a pool are not owned by @a str,
+ * so it must not be modified or freed afterwards.
+ *
+ * @pre str != NULL
+ * @pre src != NULL
+ *
+ * @return the first character of the pool not used by @a str.
+ */
+extern SCEW_LOCAL XML_Char* scew_xstr_pack_ (scew_xstr *str,
+                                             scew_xstr const *src,
+                                             XML_Char *pool);
+
+#endif /* XSTR_H_2610181012 */
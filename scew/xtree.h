@@ -0,0 +1,214 @@
+/**
+ * @file     xtree.h
+ * @brief    SCEW private tree definition
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 12:05
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#ifndef XTREE_H_2610181205
+#define XTREE_H_2610181205
+
+#include "export.h"
+
+#include "attribute.h"
+#include "tree.h"
+
+#include <expat.h>
+
+#include <stddef.h>
+
+
+/* Types */
+
+/** Element names index (see tree_index.c). */
+typedef struct scew_name_index_ scew_name_index_;
+
+/** Attribute values index (see tree_index.c). */
+typedef struct scew_attribute_index_ scew_attribute_index_;
+
+/** Contents tokens index (see tree_index.c). */
+typedef struct scew_text_index_ scew_text_index_;
+
+/** Document order index (see tree_index.c). */
+typedef struct scew_order_index_ scew_order_index_;
+
+/**
+ * Number of objects of each kind in the block of a frozen tree (see
+ * tree_freeze.c). The block holds, in this order, the elements (in
+ * pre-order, so the root comes first), their caches (in the same
+ * order), the children and attributes list items, the attributes and
+ * the strings pool.
+ */
+typedef struct
+{
+  unsigned int n_elements;      /**< Number of elements */
+  unsigned int n_items;         /**< Number of list items */
+  unsigned int n_attributes;    /**< Number of attributes */
+  size_t n_chars;               /**< Number of characters in the pool */
+} scew_frozen_layout_;
+
+struct scew_tree
+{
+  XML_Char *version;            /**< XML version */
+  XML_Char *encoding;           /**< Document encoding */
+  XML_Char *preamble;           /**< Text between declaration and root */
+  scew_tree_standalone standalone; /**< Standalone attribute */
+  scew_element *root;           /**< The root element (if any) */
+  scew_name_index_ *names;      /**< Element names index (if enabled) */
+  scew_attribute_index_ *attributes; /**< Attribute values indexes */
+  scew_text_index_ *text;       /**< Contents tokens index (if enabled) */
+  scew_order_index_ *order;     /**< Document order index (if enabled) */
+  void *frozen;                 /**< Block with all the elements of a
+                                   frozen tree (if frozen) */
+  void *snapshot;               /**< Snapshot the frozen block belongs to
+                                   (if opened from a snapshot) */
+  size_t snapshot_size;         /**< Size of the snapshot */
+};
+
+
+/* Functions */
+
+/**
+ * Notifies that the root element of the given @a tree has been
+ * replaced, so its indexes are out of date. Modifications of the
+ * elements of the tree are noticed through their indexed flag (see
+ * #scew_element_changed_).
+ *
+ * @pre tree != NULL
+ */
+extern SCEW_LOCAL void scew_tree_changed_ (scew_tree *tree);
+
+/**
+ * Adds the given @a attribute to the up to date attribute indexes of
+ * the given @a tree with the same name. If an index can not be
+ * updated, it is left out of date.
+ *
+ * @pre tree != NULL
+ * @pre attribute != NULL
+ */
+extern SCEW_LOCAL void
+scew_tree_attribute_added_ (scew_tree *tree, scew_attribute const *attribute);
+
+/**
+ * Removes the given @a attribute from the up to date attribute indexes
+ * of the given @a tree with the same name.
+ *
+ * @pre tree != NULL
+ * @pre attribute != NULL
+ */
+extern SCEW_LOCAL void
+scew_tree_attribute_removed_ (scew_tree *tree,
+                              scew_attribute const *attribute);
+
+/**
+ * Adds the tokens of the contents of the given @a element to the
+ * contents index of the given @a tree, if it is up to date. If the
+ * index can not be updated, it is left out of date.
+ *
+ * @pre tree != NULL
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL void scew_tree_contents_added_ (scew_tree *tree,
+                                                  scew_element *element);
+
+/**
+ * Removes the tokens of the contents of the given @a element from the
+ * contents index of the given @a tree, if it is up to date.
+ *
+ * @pre tree != NULL
+ * @pre element != NULL
+ */
+extern SCEW_LOCAL void
+scew_tree_contents_removed_ (scew_tree *tree, scew_element const *element);
+
+/**
+ * Builds the frozen block of the subtree of the given @a root (see
+ * #scew_tree_freeze), storing the number of objects of each kind in
+ * @a layout. The subtree is not modified, except for its cached data
+ * (hashes, summaries and epochs), which is computed first.
+ *
+ * @pre root != NULL
+ * @pre layout != NULL
+ *
+ * @return the new block (to be freed with free), whose first element
+ * is the copy of @a root, or NULL if there is no memory available.
+ */
+extern SCEW_LOCAL void* scew_tree_freeze_block_ (scew_element *root,
+                                                 scew_frozen_layout_ *layout);
+
+/**
+ * Returns the size in bytes of a frozen block with the given @a
+ * layout.
+ *
+ * @pre layout != NULL
+ */
+extern SCEW_LOCAL size_t
+scew_tree_frozen_size_ (scew_frozen_layout_ const *layout);
+
+/**
+ * Releases the snapshot the given @a tree was opened from (see
+ * #scew_tree_open_snapshot), including its frozen block.
+ *
+ * @pre tree != NULL
+ */
+extern SCEW_LOCAL void scew_tree_close_snapshot_ (scew_tree *tree);
+
+/**
+ * Rebuilds all the enabled indexes of the given @a tree. Indexes that
+ * can not be rebuilt are left out of date.
+ *
+ * @pre tree != NULL
+ */
+extern SCEW_LOCAL void scew_tree_reindex_ (scew_tree *tree);
+
+/**
+ * Disables all the attribute indexes of the given @a tree.
+ *
+ * @pre tree != NULL
+ */
+extern SCEW_LOCAL void scew_tree_unindex_attributes_ (scew_tree *tree);
+
+/**
+ * Looks up the elements of the given @a tree whose name is the first
+ * @a len characters of @a name, as #scew_tree_elements_by_name
+ * does. Unlike it, this function never rebuilds the index, so it can
+ * be called from several threads at the same time.
+ *
+ * @pre tree != NULL
+ * @pre name != NULL
+ * @pre elements != NULL
+ * @pre count != NULL
+ *
+ * @return true if the names index is enabled and up to date, in which
+ * case the elements found (in document order) and their number are
+ * stored in @a elements and @a count, false otherwise.
+ */
+extern SCEW_LOCAL scew_bool
+scew_tree_names_lookup_ (scew_tree const *tree,
+                         XML_Char const *name,
+                         size_t len,
+                         scew_element * const **elements,
+                         unsigned int *count);
+
+#endif /* XTREE_H_2610181205 */
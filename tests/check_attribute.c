@@ -84,6 +84,25 @@ START_TEST (test_accessors)
   CHECK_STR (scew_attribute_value (attribute), VALUE_AUX,
              "Attribute value do not match");
 
+  /* Lengths */
+  CHECK_U_INT (scew_attribute_name_len (attribute), scew_strlen (NAME_AUX),
+               "Attribute name length do not match");
+  CHECK_U_INT (scew_attribute_value_len (attribute), scew_strlen (VALUE_AUX),
+               "Attribute value length do not match");
+
+  /* Length-based and ownership-transfer setters */
+  CHECK_STR (scew_attribute_set_value_len (attribute, VALUE, 5), _XT("value"),
+             "New attribute value do not match (span)");
+  CHECK_U_INT (scew_attribute_value_len (attribute), 5,
+               "Attribute value length do not match (span)");
+
+  scew_attribute_set_value_take (attribute, scew_strdup (VALUE));
+
+  CHECK_STR (scew_attribute_value (attribute), VALUE,
+             "Attribute value do not match (take)");
+  CHECK_U_INT (scew_attribute_value_len (attribute), scew_strlen (VALUE),
+               "Attribute value length do not match (take)");
+
   scew_attribute_free (attribute);
 }
 END_TEST
@@ -0,0 +1,262 @@
+/**
+ * @file     check_binary.c
+ * @brief    Unit testing for SCEW binary documents
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 20:30
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+
+#include "test.h"
+
+#include <scew/binary.h>
+#include <scew/error.h>
+#include <scew/parser.h>
+#include <scew/printer.h>
+#include <scew/reader_buffer.h>
+#include <scew/writer_buffer.h>
+
+#include <check.h>
+
+#include <stdlib.h>
+
+
+/* Unit tests */
+
+static XML_Char const *TEST_XML =
+  _XT("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+      "<lib>"
+      "<shelf id=\"s1\">"
+      "<book id=\"b1\" lang=\"en\"><title>A &amp; B</title></book>"
+      "<book id=\"b2\"><title>&lt;B&gt;</title><note>x</note></book>"
+      "<dvd id=\"d1\"/>"
+      "<book id=\"b3\" lang=\"en\"><title>C</title></book>"
+      "</shelf>"
+      "<shelf id=\"s2\">"
+      "<box id=\"x1\" note=\"&quot;quoted&quot;\">"
+      "<book id=\"b4\" lang=\"fr\"><title>D</title></book>"
+      "</box>"
+      "</shelf>"
+      "</lib>");
+
+enum { MAX_BUFFER_ = 4096 };
+
+static scew_tree*
+load_tree_ (XML_Char const *xml)
+{
+  scew_parser *parser = scew_parser_create ();
+  scew_reader *reader = scew_reader_buffer_create (xml, scew_strlen (xml));
+  scew_tree *tree = scew_parser_load (parser, reader);
+
+  scew_reader_free (reader);
+  scew_parser_free (parser);
+
+  return tree;
+}
+
+/* Prints the given tree as a binary document, returning its size. */
+static size_t
+print_binary_ (scew_tree const *tree, XML_Char *buffer)
+{
+  scew_writer *writer = NULL;
+  size_t size = 0;
+
+  for (size = 0; size < MAX_BUFFER_; ++size)
+    {
+      buffer[size] = _XT('\xff');
+    }
+
+  writer = scew_writer_buffer_create (buffer, MAX_BUFFER_);
+  scew_bool printed = scew_binary_print_tree (writer, tree);
+
+  CHECK_BOOL (printed, SCEW_TRUE, "Unable to print binary document");
+
+  /* Binary documents might contain null characters, so the null
+     character written after the document is looked for from the end
+     of the (pre-filled) buffer. */
+  size = MAX_BUFFER_ - 1;
+  while ((size > 0) && (_XT('\xff') == buffer[size]))
+    {
+      size -= 1;
+    }
+
+  scew_writer_free (writer);
+
+  return size;
+}
+
+static scew_tree*
+load_binary_ (XML_Char const *buffer, size_t size)
+{
+  scew_reader *reader = scew_reader_buffer_create (buffer, size);
+  scew_tree *tree = scew_binary_load (reader);
+
+  scew_reader_free (reader);
+
+  return tree;
+}
+
+
+START_TEST (test_round_trip)
+{
+  XML_Char buffer[MAX_BUFFER_];
+
+  scew_tree *tree = load_tree_ (TEST_XML);
+  CHECK_PTR (tree, "Unable to parse document");
+  scew_tree_set_xml_preamble (tree, _XT("<!DOCTYPE lib>"));
+
+  size_t size = print_binary_ (tree, buffer);
+
+  /* Names are only stored once, and nothing is escaped. */
+  CHECK_BOOL (size < scew_strlen (TEST_XML), SCEW_TRUE,
+              "Binary document is not smaller than XML");
+
+  scew_tree *copy = load_binary_ (buffer, size);
+  CHECK_PTR (copy, "Unable to load binary document");
+  CHECK_BOOL (scew_tree_compare (tree, copy, NULL), SCEW_TRUE,
+              "Loaded tree does not match");
+  CHECK_STR (scew_tree_xml_preamble (copy), _XT("<!DOCTYPE lib>"),
+             "Loaded preamble does not match");
+  CHECK_S_INT (scew_tree_xml_standalone (copy), scew_tree_standalone_yes,
+               "Loaded standalone attribute does not match");
+
+  scew_element *box =
+    scew_element_by_index (scew_element_by_index (scew_tree_root (copy), 1),
+                           0);
+  CHECK_STR (scew_attribute_value (scew_element_attribute_by_name
+                                   (box, _XT("note"))),
+             _XT("\"quoted\""), "Loaded attribute does not match");
+
+  scew_tree_free (copy);
+  scew_tree_free (tree);
+}
+END_TEST
+
+START_TEST (test_empty)
+{
+  XML_Char buffer[MAX_BUFFER_];
+
+  scew_tree *tree = scew_tree_create ();
+
+  size_t size = print_binary_ (tree, buffer);
+
+  scew_tree *copy = load_binary_ (buffer, size);
+  CHECK_PTR (copy, "Unable to load empty binary document");
+  CHECK_NULL_PTR (scew_tree_root (copy), "Empty document has a root");
+  CHECK_STR (scew_tree_xml_version (copy), _XT("1.0"),
+             "Loaded version does not match");
+  CHECK_NULL_PTR (scew_tree_xml_preamble (copy), "Loaded preamble is set");
+
+  scew_tree_free (copy);
+  scew_tree_free (tree);
+}
+END_TEST
+
+START_TEST (test_deep)
+{
+  enum { DEPTH = 10000 };
+
+  XML_Char *buffer = NULL;
+  unsigned int i = 0;
+
+  scew_tree *tree = scew_tree_create ();
+  scew_element *element = scew_tree_set_root (tree, _XT("level"));
+
+  for (i = 1; i < DEPTH; ++i)
+    {
+      element = scew_element_add (element, _XT("level"));
+    }
+  scew_element_set_contents (element, _XT("bottom"));
+
+  /* A rather large document, so the writer and reader buffers are
+     refilled several times. */
+  buffer = calloc (DEPTH * 8, sizeof (XML_Char));
+  scew_writer *writer = scew_writer_buffer_create (buffer, DEPTH * 8);
+  CHECK_BOOL (scew_binary_print_tree (writer, tree), SCEW_TRUE,
+              "Unable to print deep binary document");
+  scew_writer_free (writer);
+
+  /* Anything after the document is not read. */
+  scew_tree *copy = load_binary_ (buffer, DEPTH * 8 - 1);
+  CHECK_PTR (copy, "Unable to load deep binary document");
+  CHECK_BOOL (scew_tree_compare (tree, copy, NULL), SCEW_TRUE,
+              "Loaded deep tree does not match");
+
+  scew_tree_free (copy);
+  scew_tree_free (tree);
+  free (buffer);
+}
+END_TEST
+
+START_TEST (test_invalid)
+{
+  XML_Char buffer[MAX_BUFFER_];
+
+  scew_tree *tree = load_tree_ (TEST_XML);
+  unsigned int i = 0;
+
+  size_t size = print_binary_ (tree, buffer);
+
+  /* Truncated documents */
+  for (i = 1; i < size; i += 7)
+    {
+      CHECK_NULL_PTR (load_binary_ (buffer, i),
+                      "Truncated document should not be loaded");
+      CHECK_S_INT (scew_error_code (), scew_error_binary,
+                   "Truncated document error");
+    }
+
+  /* Not a binary document */
+  CHECK_NULL_PTR (load_binary_ (TEST_XML, scew_strlen (TEST_XML)),
+                  "XML document should not be loaded");
+  CHECK_S_INT (scew_error_code (), scew_error_binary,
+               "XML document error");
+
+  scew_tree_free (tree);
+}
+END_TEST
+
+
+/* Suite */
+
+static Suite*
+binary_suite (void)
+{
+  Suite *s = suite_create ("SCEW binary documents");
+
+  /* Core test case */
+  TCase *tc_core = tcase_create ("Core");
+  tcase_add_test (tc_core, test_round_trip);
+  tcase_add_test (tc_core, test_empty);
+  tcase_add_test (tc_core, test_deep);
+  tcase_add_test (tc_core, test_invalid);
+  suite_add_tcase (s, tc_core);
+
+  return s;
+}
+
+void
+run_tests (SRunner *sr)
+{
+  srunner_add_suite (sr, binary_suite ());
+}
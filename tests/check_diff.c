@@ -0,0 +1,392 @@
+/**
+ * @file     check_diff.c
+ * @brief    Unit testing for SCEW tree differences
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 12:10
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "test.h"
+
+#include <scew/diff.h>
+#include <scew/error.h>
+#include <scew/parser.h>
+#include <scew/reader_buffer.h>
+
+#include <check.h>
+
+#include <stdlib.h>
+
+
+/* Unit tests */
+
+static XML_Char const *TEST_XML_A =
+  _XT("<root>"
+      "<a>1</a><b x=\"1\" y=\"2\"/><c/><d>4</d>"
+      "</root>");
+
+static XML_Char const *TEST_XML_B =
+  _XT("<root>"
+      "<a>one</a><b x=\"1\" z=\"3\"/><d>4</d><c/><e/>"
+      "</root>");
+
+static scew_tree*
+load_tree_ (XML_Char const *xml)
+{
+  scew_parser *parser = scew_parser_create ();
+  scew_reader *reader = scew_reader_buffer_create (xml, scew_strlen (xml));
+  scew_tree *tree = scew_parser_load (parser, reader);
+
+  scew_reader_free (reader);
+  scew_parser_free (parser);
+
+  return tree;
+}
+
+static void
+check_patch_ (scew_tree const *a, scew_tree const *b, scew_diff const *diff)
+{
+  scew_tree *patched = scew_tree_copy (a);
+
+  CHECK_BOOL (scew_tree_patch (patched, diff), SCEW_TRUE,
+              "Unable to patch tree");
+  CHECK_BOOL (scew_element_compare (scew_tree_root (patched),
+                                    scew_tree_root (b),
+                                    NULL),
+              SCEW_TRUE, "Patched tree is not equal to target tree");
+
+  scew_tree_free (patched);
+}
+
+
+/* Identical trees */
+
+START_TEST (test_identical)
+{
+  scew_tree *a = load_tree_ (TEST_XML_A);
+  scew_tree *b = scew_tree_copy (a);
+
+  CHECK_PTR (a, "Unable to load tree");
+
+  scew_diff *diff = scew_tree_diff (a, b);
+
+  CHECK_PTR (diff, "Unable to diff trees");
+  CHECK_U_INT (scew_diff_count (diff), 0, "Identical trees have no edits");
+  CHECK_NULL_PTR (scew_diff_edits (diff), "Identical trees have no edits");
+
+  scew_diff_free (diff);
+  scew_tree_free (a);
+  scew_tree_free (b);
+}
+END_TEST
+
+
+/* Edit operations */
+
+START_TEST (test_edits)
+{
+  static unsigned int const N_EDITS = 5;
+  static scew_diff_operation const OPERATIONS[] =
+    {
+      scew_diff_update_text,
+      scew_diff_update_attribute,
+      scew_diff_update_attribute,
+      scew_diff_move,
+      scew_diff_insert
+    };
+  static XML_Char const *PATHS[] =
+    {
+      _XT("/root/a[1]"),
+      _XT("/root/b[1]"),
+      _XT("/root/b[1]"),
+      _XT("/root/d[1]"),
+      _XT("/root")
+    };
+
+  scew_tree *a = load_tree_ (TEST_XML_A);
+  scew_tree *b = load_tree_ (TEST_XML_B);
+
+  scew_diff *diff = scew_tree_diff (a, b);
+
+  CHECK_PTR (diff, "Unable to diff trees");
+  CHECK_U_INT (scew_diff_count (diff), N_EDITS, "Wrong number of edits");
+
+  unsigned int i = 0;
+  scew_list *list = scew_diff_edits (diff);
+  for (i = 0; (i < N_EDITS) && (list != NULL); ++i)
+    {
+      scew_diff_edit *edit = scew_list_data (list);
+      CHECK_U_INT (scew_diff_edit_operation (edit), OPERATIONS[i],
+                   "Wrong operation for edit %d", i);
+      CHECK_STR (scew_diff_edit_path (edit), PATHS[i],
+                 "Wrong path for edit %d", i);
+      list = scew_list_next (list);
+    }
+
+  scew_diff_edit *edit = scew_list_data (scew_diff_edits (diff));
+  CHECK_STR (scew_diff_edit_value (edit), _XT("one"), "Wrong new contents");
+
+  edit = scew_list_data (scew_list_index (scew_diff_edits (diff), 1));
+  CHECK_STR (scew_diff_edit_name (edit), _XT("y"), "Wrong attribute name");
+  CHECK_NULL_PTR (scew_diff_edit_value (edit), "Attribute should be deleted");
+
+  edit = scew_list_data (scew_list_index (scew_diff_edits (diff), 3));
+  CHECK_U_INT (scew_diff_edit_position (edit), 2, "Wrong move position");
+
+  edit = scew_list_data (scew_list_index (scew_diff_edits (diff), 4));
+  CHECK_U_INT (scew_diff_edit_position (edit), 4, "Wrong insert position");
+  CHECK_STR (scew_element_name (scew_diff_edit_element (edit)), _XT("e"),
+             "Wrong inserted element");
+
+  check_patch_ (a, b, diff);
+
+  /* The inverse script deletes instead of inserting. */
+  scew_diff_free (diff);
+  diff = scew_tree_diff (b, a);
+
+  CHECK_PTR (diff, "Unable to diff trees");
+  check_patch_ (b, a, diff);
+
+  scew_diff_free (diff);
+  scew_tree_free (a);
+  scew_tree_free (b);
+}
+END_TEST
+
+
+/* Root elements */
+
+START_TEST (test_roots)
+{
+  scew_tree *a = load_tree_ (TEST_XML_A);
+  scew_tree *b = scew_tree_create ();
+  scew_tree *empty = scew_tree_create ();
+
+  scew_tree_set_root (b, _XT("other"));
+
+  scew_diff *diff = scew_tree_diff (a, b);
+
+  CHECK_PTR (diff, "Unable to diff trees");
+  CHECK_U_INT (scew_diff_count (diff), 2, "Roots should be replaced");
+  check_patch_ (a, b, diff);
+  scew_diff_free (diff);
+
+  /* Patching a different tree fails. */
+  diff = scew_tree_diff (empty, a);
+
+  CHECK_PTR (diff, "Unable to diff trees");
+  CHECK_U_INT (scew_diff_count (diff), 1, "Root should be inserted");
+  CHECK_BOOL (scew_tree_patch (b, diff), SCEW_FALSE,
+              "Patch should not apply");
+  CHECK_U_INT (scew_error_code (), scew_error_diff, "Wrong error code");
+  check_patch_ (empty, a, diff);
+
+  scew_diff_free (diff);
+  scew_tree_free (a);
+  scew_tree_free (b);
+  scew_tree_free (empty);
+}
+END_TEST
+
+
+/* Serialization */
+
+START_TEST (test_serialization)
+{
+  scew_tree *a = load_tree_ (TEST_XML_A);
+  scew_tree *b = load_tree_ (TEST_XML_B);
+
+  scew_diff *diff = scew_tree_diff (a, b);
+  scew_tree *diff_tree = scew_diff_tree (diff);
+
+  CHECK_PTR (diff_tree, "Unable to create edit script tree");
+  CHECK_STR (scew_element_name (scew_tree_root (diff_tree)), _XT("diff"),
+             "Wrong edit script root element");
+  CHECK_U_INT (scew_element_count (scew_tree_root (diff_tree)),
+               scew_diff_count (diff), "Wrong number of edit elements");
+
+  scew_diff *new_diff = scew_diff_from_tree (diff_tree);
+
+  CHECK_PTR (new_diff, "Unable to create edit script from tree");
+  CHECK_U_INT (scew_diff_count (new_diff), scew_diff_count (diff),
+               "Wrong number of edits");
+  check_patch_ (a, b, new_diff);
+
+  /* Not an edit script */
+  CHECK_NULL_PTR (scew_diff_from_tree (a), "Invalid edit script tree");
+  CHECK_U_INT (scew_error_code (), scew_error_diff, "Wrong error code");
+
+  scew_diff_free (diff);
+  scew_diff_free (new_diff);
+  scew_tree_free (diff_tree);
+  scew_tree_free (a);
+  scew_tree_free (b);
+}
+END_TEST
+
+
+/* Random changes */
+
+static XML_Char const *NAMES_[] = { _XT("a"), _XT("b"), _XT("c") };
+
+static XML_Char const*
+random_name_ (void)
+{
+  return NAMES_[rand () % 3];
+}
+
+static void
+random_element_ (scew_element *element, unsigned int depth)
+{
+  unsigned int i = 0;
+  unsigned int n_children = (depth > 0) ? rand () % 5 : 0;
+
+  if (rand () % 2)
+    {
+      scew_element_set_contents (element, random_name_ ());
+    }
+  if (rand () % 2)
+    {
+      scew_element_add_attribute_pair (element, random_name_ (),
+                                       random_name_ ());
+    }
+  for (i = 0; i < n_children; ++i)
+    {
+      random_element_ (scew_element_add (element, random_name_ ()), depth - 1);
+    }
+}
+
+static scew_element*
+random_descendant_ (scew_element *element)
+{
+  while ((scew_element_count (element) > 0) && (rand () % 3))
+    {
+      element = scew_element_by_index (element,
+                                       rand () % scew_element_count (element));
+    }
+
+  return element;
+}
+
+static void
+random_change_ (scew_element *root)
+{
+  scew_element *element = random_descendant_ (root);
+  scew_element *parent = scew_element_parent (element);
+  scew_element *child = NULL;
+
+  switch (rand () % 6)
+    {
+    case 0:
+      scew_element_set_contents (element, random_name_ ());
+      break;
+    case 1:
+      scew_element_add_attribute_pair (element, random_name_ (),
+                                       random_name_ ());
+      break;
+    case 2:
+      scew_element_delete_attribute_all (element);
+      break;
+    case 3:
+      child = scew_element_create (random_name_ ());
+      random_element_ (child, 2);
+      scew_element_insert_element (element, child,
+                                   rand () % (scew_element_count (element) + 1));
+      break;
+    case 4:
+      if (parent != NULL)
+        {
+          scew_element_free (element);
+        }
+      break;
+    case 5:
+      if (parent != NULL)
+        {
+          scew_element_detach (element);
+          scew_element_insert_element (parent, element,
+                                       rand () % (scew_element_count (parent)
+                                                  + 1));
+        }
+      break;
+    }
+}
+
+START_TEST (test_random)
+{
+  static unsigned int const N_TREES = 200;
+  static unsigned int const N_CHANGES = 8;
+
+  unsigned int i = 0;
+  unsigned int j = 0;
+
+  srand (1);
+
+  for (i = 0; i < N_TREES; ++i)
+    {
+      scew_tree *a = scew_tree_create ();
+      random_element_ (scew_tree_set_root (a, _XT("root")), 4);
+
+      scew_tree *b = scew_tree_copy (a);
+      unsigned int n_changes = rand () % N_CHANGES;
+      for (j = 0; j < n_changes; ++j)
+        {
+          random_change_ (scew_tree_root (b));
+        }
+
+      scew_diff *diff = scew_tree_diff (a, b);
+
+      CHECK_PTR (diff, "Unable to diff trees");
+      check_patch_ (a, b, diff);
+
+      scew_diff_free (diff);
+      scew_tree_free (a);
+      scew_tree_free (b);
+    }
+}
+END_TEST
+
+
+/* Suite */
+
+static Suite*
+diff_suite (void)
+{
+  Suite *s = suite_create ("SCEW tree differences");
+
+  /* Core test case */
+  TCase *tc_core = tcase_create ("Core");
+  tcase_add_test (tc_core, test_identical);
+  tcase_add_test (tc_core, test_edits);
+  tcase_add_test (tc_core, test_roots);
+  tcase_add_test (tc_core, test_serialization);
+  tcase_add_test (tc_core, test_random);
+  suite_add_tcase (s, tc_core);
+
+  return s;
+}
+
+void
+run_tests (SRunner *sr)
+{
+  srunner_add_suite (sr, diff_suite ());
+}
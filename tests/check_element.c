@@ -33,9 +33,24 @@
 
 #include <check.h>
 
+#include <pthread.h>
+
 
 /* Unit tests */
 
+enum { N_THREADS = 8 };
+
+/* Hashes and compares an element from a thread. */
+typedef struct
+{
+  scew_element const *element;
+  scew_element const *copy;
+  unsigned long hash;
+  scew_bool equal;
+} hash_job_;
+
+static void* hash_thread_ (void *data);
+
 /* Allocation */
 
 START_TEST (test_alloc)
@@ -106,23 +121,80 @@ START_TEST (test_accessors)
   /* Name */
   CHECK_STR (scew_element_name (element), NAME,
              "Element name do not match");
+  CHECK_U_INT (scew_element_name_len (element), scew_strlen (NAME),
+               "Element name length do not match");
 
   scew_element_set_name (element, NEW_NAME);
 
   CHECK_STR (scew_element_name (element), NEW_NAME,
              "Element name do not match (NEW_NAME)");
+  CHECK_U_INT (scew_element_name_len (element), scew_strlen (NEW_NAME),
+               "Element name length do not match (NEW_NAME)");
 
   /* Contents */
   CHECK_NULL_PTR (scew_element_contents (element), "Element has no contents");
+  CHECK_U_INT (scew_element_contents_len (element), 0,
+               "Element has no contents length");
 
   scew_element_set_contents (element, CONTENTS);
 
   CHECK_STR (scew_element_contents (element), CONTENTS,
              "Element contents do not match");
+  CHECK_U_INT (scew_element_contents_len (element), scew_strlen (CONTENTS),
+               "Element contents length do not match");
 
   scew_element_free_contents (element);
 
   CHECK_NULL_PTR (scew_element_contents (element), "Element has no contents");
+  CHECK_U_INT (scew_element_contents_len (element), 0,
+               "Element has no contents length");
+
+  /* Length-based setters (not null-terminated spans) */
+  scew_element_set_name_len (element, CONTENTS, 4);
+
+  CHECK_STR (scew_element_name (element), _XT("root"),
+             "Element name do not match (span)");
+  CHECK_U_INT (scew_element_name_len (element), 4,
+               "Element name length do not match (span)");
+
+  scew_element_set_contents_len (element, CONTENTS, 12);
+
+  CHECK_STR (scew_element_contents (element), _XT("root element"),
+             "Element contents do not match (span)");
+  CHECK_U_INT (scew_element_contents_len (element), 12,
+               "Element contents length do not match (span)");
+
+  /* Ownership-transfer setters */
+  XML_Char *name = scew_strdup (NEW_NAME);
+  XML_Char *contents = scew_strdup (CONTENTS);
+
+  scew_element_set_name_take (element, name);
+  scew_element_set_contents_take (element, contents);
+
+  CHECK_STR (scew_element_name (element), NEW_NAME,
+             "Element name do not match (take)");
+  CHECK_U_INT (scew_element_name_len (element), scew_strlen (NEW_NAME),
+               "Element name length do not match (take)");
+  CHECK_STR (scew_element_contents (element), CONTENTS,
+             "Element contents do not match (take)");
+  CHECK_U_INT (scew_element_contents_len (element), scew_strlen (CONTENTS),
+               "Element contents length do not match (take)");
+
+  /* Switch between short (stored inline) and long strings */
+  scew_element_set_contents (element, scew_element_contents (element) + 5);
+
+  CHECK_STR (scew_element_contents (element), CONTENTS + 5,
+             "Element contents do not match (own suffix)");
+
+  scew_element_set_contents (element, scew_element_contents (element) + 8);
+
+  CHECK_STR (scew_element_contents (element), CONTENTS + 13,
+             "Element contents do not match (short own suffix)");
+
+  scew_element_set_contents (element, CONTENTS);
+
+  CHECK_STR (scew_element_contents (element), CONTENTS,
+             "Element contents do not match (long again)");
 
   scew_element_free (element);
 }
@@ -436,6 +508,172 @@ START_TEST (test_search)
 }
 END_TEST
 
+
+/* Search (descendants) */
+
+START_TEST (test_search_descendants)
+{
+  scew_element *root = scew_element_create (_XT("root"));
+
+  CHECK_PTR (root, "Unable to create element");
+
+  scew_element *a = scew_element_add (root, _XT("a"));
+  scew_element *b = scew_element_add (a, _XT("b"));
+  scew_element *c = scew_element_add (root, _XT("c"));
+  scew_element *d = scew_element_add (c, _XT("b"));
+
+  CHECK_PTR (d, "Unable to create children");
+
+  scew_element_add_attribute_pair (b, _XT("id"), _XT("1"));
+
+  CHECK_BOOL (scew_element_descendant_by_name (root, _XT("b")) == b,
+              SCEW_TRUE, "First descendant does not match");
+  CHECK_BOOL (scew_element_descendant_by_name (c, _XT("b")) == d,
+              SCEW_TRUE, "Descendant of second child does not match");
+  CHECK_NULL_PTR (scew_element_descendant_by_name (root, _XT("root")),
+                  "Element itself should not be found");
+  CHECK_NULL_PTR (scew_element_descendant_by_name (root, _XT("none")),
+                  "Unknown descendant should not be found");
+
+  /* There are no false negatives. */
+  CHECK_BOOL (scew_element_may_contain (root, _XT("root")), SCEW_TRUE,
+              "Summary does not contain the element itself");
+  CHECK_BOOL (scew_element_may_contain (a, _XT("b")), SCEW_TRUE,
+              "Summary does not contain a child name");
+  CHECK_BOOL (scew_element_may_contain_attribute (root, _XT("id")),
+              SCEW_TRUE, "Summary does not contain an attribute name");
+
+  /* Summaries are updated after modifications. */
+  scew_element *e = scew_element_add (d, _XT("e"));
+
+  CHECK_BOOL (scew_element_descendant_by_name (root, _XT("e")) == e,
+              SCEW_TRUE, "Added descendant not found");
+  CHECK_BOOL (scew_element_may_contain (c, _XT("e")), SCEW_TRUE,
+              "Summary not updated after adding an element");
+
+  scew_element_set_name (e, _XT("f"));
+  CHECK_BOOL (scew_element_descendant_by_name (root, _XT("f")) == e,
+              SCEW_TRUE, "Renamed descendant not found");
+
+  scew_element_add_attribute_pair (e, _XT("lang"), _XT("en"));
+  CHECK_BOOL (scew_element_may_contain_attribute (root, _XT("lang")),
+              SCEW_TRUE, "Summary not updated after adding an attribute");
+
+  scew_element_free (b);
+  CHECK_BOOL (scew_element_descendant_by_name (root, _XT("b")) == d,
+              SCEW_TRUE, "Deleted descendant found");
+
+  /* Copies keep the summaries. */
+  scew_element *copy = scew_element_copy (root);
+
+  CHECK_PTR (copy, "Unable to copy element");
+  CHECK_BOOL (scew_element_may_contain (copy, _XT("f")), SCEW_TRUE,
+              "Copied summary does not match");
+  CHECK_STR (scew_element_name (scew_element_descendant_by_name
+                                (copy, _XT("f"))),
+             _XT("f"), "Copied descendant not found");
+
+  scew_element_free (copy);
+  scew_element_free (root);
+
+  /* Pruned subtrees do not stop the search. */
+  XML_Char name[CHECK_MAX_BUFFER_];
+  unsigned int i = 0;
+
+  root = scew_element_create (_XT("root"));
+  a = scew_element_add (root, _XT("a"));
+  for (i = 0; i < 200; ++i)
+    {
+      check_sprintf (name, _XT("child%d"), i);
+      scew_element_add (a, name);
+    }
+  c = scew_element_add (root, _XT("c"));
+  e = scew_element_add (c, _XT("target"));
+
+  CHECK_BOOL (scew_element_may_contain (a, _XT("target")), SCEW_TRUE,
+              "Summary should be saturated");
+  CHECK_BOOL (scew_element_descendant_by_name (root, _XT("target")) == e,
+              SCEW_TRUE, "Descendant after a saturated subtree not found");
+
+  scew_element_free (root);
+}
+END_TEST
+
+
+/* Epochs */
+
+START_TEST (test_epochs)
+{
+  scew_element *root = scew_element_create (_XT("root"));
+
+  CHECK_PTR (root, "Unable to create element");
+
+  scew_element *a = scew_element_add (root, _XT("a"));
+  scew_element *b = scew_element_add (a, _XT("b"));
+  scew_element *c = scew_element_add (root, _XT("c"));
+  scew_attribute *id = scew_element_add_attribute_pair (b, _XT("id"), _XT("1"));
+
+  CHECK_PTR (id, "Unable to create attribute");
+
+  unsigned long root_epoch = scew_element_epoch (root);
+  unsigned long a_epoch = scew_element_epoch (a);
+  unsigned long c_epoch = scew_element_epoch (c);
+
+  CHECK_BOOL ((root_epoch != 0) && (a_epoch != 0) && (c_epoch != 0), SCEW_TRUE,
+              "Epoch of an element never read is 0");
+  CHECK_U_INT (scew_element_epoch (root), root_epoch,
+               "Epoch changed without modifications");
+  CHECK_U_INT (scew_element_epoch (c), c_epoch,
+               "Epoch of a child read again changed without modifications");
+
+  /* Contents */
+  scew_element_set_contents (b, _XT("contents"));
+  CHECK_BOOL (scew_element_epoch (a) != a_epoch, SCEW_TRUE,
+              "Parent epoch not changed after setting contents");
+  CHECK_BOOL (scew_element_epoch (root) != root_epoch, SCEW_TRUE,
+              "Root epoch not changed after setting contents");
+  CHECK_U_INT (scew_element_epoch (c), c_epoch,
+               "Sibling epoch changed after setting contents");
+
+  /* Attributes (reading the descendant first) */
+  root_epoch = scew_element_epoch (root);
+  unsigned long b_epoch = scew_element_epoch (b);
+
+  scew_attribute_set_value (id, _XT("2"));
+  CHECK_BOOL (scew_element_epoch (b) != b_epoch, SCEW_TRUE,
+              "Epoch not changed after setting an attribute");
+  CHECK_BOOL (scew_element_epoch (root) != root_epoch, SCEW_TRUE,
+              "Root epoch not changed after setting an attribute");
+
+  /* Names */
+  root_epoch = scew_element_epoch (root);
+  scew_element_set_name (c, _XT("d"));
+  scew_element_set_name (c, _XT("e"));
+  CHECK_BOOL (scew_element_epoch (root) != root_epoch, SCEW_TRUE,
+              "Root epoch not changed after renaming");
+  CHECK_BOOL (scew_element_epoch (c) != c_epoch, SCEW_TRUE,
+              "Epoch not changed after renaming");
+
+  /* Children */
+  root_epoch = scew_element_epoch (root);
+  a_epoch = scew_element_epoch (a);
+  c_epoch = scew_element_epoch (c);
+  scew_element_free (b);
+  CHECK_BOOL (scew_element_epoch (root) != root_epoch, SCEW_TRUE,
+              "Root epoch not changed after deleting an element");
+  CHECK_BOOL (scew_element_epoch (a) != a_epoch, SCEW_TRUE,
+              "Parent epoch not changed after deleting an element");
+  CHECK_U_INT (scew_element_epoch (c), c_epoch,
+               "Sibling epoch changed after deleting an element");
+
+  root_epoch = scew_element_epoch (root);
+  CHECK_U_INT (scew_element_epoch (root), root_epoch,
+               "Epoch changed without modifications");
+
+  scew_element_free (root);
+}
+END_TEST
+
 
 /* Comparison */
 
@@ -484,6 +722,190 @@ START_TEST (test_compare)
 }
 END_TEST
 
+
+/* Hash */
+
+START_TEST (test_hash)
+{
+  static XML_Char const *NAME = _XT("root");
+  static XML_Char const *CHILD_NAME = _XT("element");
+  static XML_Char const *CONTENTS = _XT("contents");
+  static XML_Char const *ATTR_NAME = _XT("id");
+  static XML_Char const *ATTR_VALUE = _XT("first");
+
+  scew_element *root = scew_element_create (NAME);
+  scew_element *child = scew_element_add (root, CHILD_NAME);
+  scew_element *grandchild = scew_element_add_pair (child, CHILD_NAME, CONTENTS);
+  scew_attribute *attribute =
+    scew_element_add_attribute_pair (child, ATTR_NAME, ATTR_VALUE);
+
+  CHECK_PTR (grandchild, "Unable to create grandchild");
+  CHECK_PTR (attribute, "Unable to create attribute");
+
+  /* Copies have the same hash */
+  scew_element *root_copy = scew_element_copy (root);
+  unsigned long hash = scew_element_hash (root);
+
+  CHECK_BOOL (hash == scew_element_hash (root_copy), SCEW_TRUE,
+              "Root and root copy should have the same hash");
+
+  /* Empty and unset contents are different */
+  scew_element_set_contents (root, _XT(""));
+  CHECK_BOOL (hash != scew_element_hash (root), SCEW_TRUE,
+              "Empty contents should change the hash");
+  scew_element_free_contents (root);
+  CHECK_BOOL (hash == scew_element_hash (root), SCEW_TRUE,
+              "Hash should be restored after freeing contents");
+
+  /* Changes in descendants are propagated */
+  scew_element_set_contents (grandchild, _XT("other"));
+  CHECK_BOOL (hash != scew_element_hash (root), SCEW_TRUE,
+              "Grandchild contents should change the root hash");
+  CHECK_BOOL (scew_element_compare (root, root_copy, NULL), SCEW_FALSE,
+              "Root and root copy should be different (grandchild)");
+  scew_element_set_contents (grandchild, CONTENTS);
+  CHECK_BOOL (hash == scew_element_hash (root), SCEW_TRUE,
+              "Hash should be restored after restoring contents");
+
+  scew_attribute_set_value (attribute, _XT("second"));
+  CHECK_BOOL (hash != scew_element_hash (root), SCEW_TRUE,
+              "Attribute value should change the root hash");
+  scew_attribute_set_value (attribute, ATTR_VALUE);
+  CHECK_BOOL (hash == scew_element_hash (root), SCEW_TRUE,
+              "Hash should be restored after restoring attribute");
+
+  scew_element_delete_attribute (child, attribute);
+  CHECK_BOOL (hash != scew_element_hash (root), SCEW_TRUE,
+              "Deleting an attribute should change the root hash");
+  scew_element_add_attribute_pair (child, ATTR_NAME, ATTR_VALUE);
+  CHECK_BOOL (hash == scew_element_hash (root), SCEW_TRUE,
+              "Hash should be restored after adding attribute");
+
+  scew_element_detach (grandchild);
+  CHECK_BOOL (hash != scew_element_hash (root), SCEW_TRUE,
+              "Detaching a child should change the root hash");
+  scew_element_add_element (child, grandchild);
+  CHECK_BOOL (hash == scew_element_hash (root), SCEW_TRUE,
+              "Hash should be restored after adding child");
+
+  CHECK_BOOL (scew_element_compare (root, root_copy, NULL), SCEW_TRUE,
+              "Root and root copy should be equal");
+
+  scew_element_free (root);
+  scew_element_free (root_copy);
+}
+END_TEST
+
+
+/* Parallel copy and comparison */
+
+START_TEST (test_parallel)
+{
+  static XML_Char const *NAME = _XT("root");
+  static XML_Char const *CHILD_NAME = _XT("element");
+  static XML_Char const *CONTENTS = _XT("contents");
+  static unsigned int const N_ELEMENTS = 100;
+
+  scew_element *root = scew_element_create (NAME);
+  scew_element_add_attribute_pair (root, _XT("id"), _XT("root"));
+
+  unsigned int i = 0;
+  for (i = 0; i < N_ELEMENTS; ++i)
+    {
+      scew_element *child = scew_element_add (root, CHILD_NAME);
+      unsigned int j = 0;
+      for (j = 0; j < i % 7; ++j)
+        {
+          scew_element_add_pair (child, CHILD_NAME, CONTENTS);
+        }
+    }
+
+  /* Copies */
+  scew_element *copy = scew_element_copy (root);
+  scew_element *parallel_copy = scew_element_copy_parallel (root);
+
+  CHECK_PTR (parallel_copy, "Unable to copy root element in parallel");
+  CHECK_U_INT (scew_element_count (parallel_copy), N_ELEMENTS,
+               "Wrong number of copied children");
+  CHECK_BOOL (scew_element_compare (root, parallel_copy, NULL), SCEW_TRUE,
+              "Root and parallel copy should be equal");
+  CHECK_BOOL (scew_element_compare_parallel (copy, parallel_copy, NULL),
+              SCEW_TRUE, "Copy and parallel copy should be equal");
+
+  /* Children are in order */
+  for (i = 0; i < N_ELEMENTS; ++i)
+    {
+      CHECK_U_INT (scew_element_count (scew_element_by_index (parallel_copy,
+                                                              i)),
+                   i % 7, "Wrong number of children (child %d)", i);
+    }
+
+  /* Modify a grandchild */
+  scew_element *element = scew_element_by_index (parallel_copy, N_ELEMENTS - 1);
+  scew_element_set_contents (scew_element_by_index (element, 0), NAME);
+
+  CHECK_BOOL (scew_element_compare (copy, parallel_copy, NULL), SCEW_FALSE,
+              "Copy and parallel copy should be different");
+  CHECK_BOOL (scew_element_compare_parallel (copy, parallel_copy, NULL),
+              SCEW_FALSE, "Copy and parallel copy should be different");
+
+  scew_element_free (root);
+  scew_element_free (copy);
+  scew_element_free (parallel_copy);
+}
+END_TEST
+
+START_TEST (test_parallel_hash)
+{
+  static unsigned int const N_ELEMENTS = 200;
+
+  pthread_t threads[N_THREADS];
+  hash_job_ jobs[N_THREADS];
+  unsigned int round = 0;
+  unsigned int i = 0;
+
+  scew_element *root = scew_element_create (_XT("root"));
+  for (i = 0; i < N_ELEMENTS; ++i)
+    {
+      scew_element *child = scew_element_add (root, _XT("element"));
+      scew_element_add_pair (child, _XT("child"), _XT("contents"));
+    }
+  scew_element *copy = scew_element_copy (root);
+  unsigned long hash = scew_element_hash (copy);
+
+  /* Uncached hashes are computed and published by concurrent readers,
+     both before and after a modification. */
+  for (round = 0; round < 2; ++round)
+    {
+      for (i = 0; i < N_THREADS; ++i)
+        {
+          jobs[i].element = root;
+          jobs[i].copy = copy;
+          CHECK_S_INT (pthread_create (&threads[i], NULL, hash_thread_,
+                                       &jobs[i]),
+                       0, "Unable to create thread");
+        }
+      for (i = 0; i < N_THREADS; ++i)
+        {
+          pthread_join (threads[i], NULL);
+          CHECK_BOOL (jobs[i].hash == hash, (0 == round),
+                      "Wrong concurrent hash (round %d)", round);
+          CHECK_BOOL (jobs[i].equal, (0 == round),
+                      "Wrong concurrent comparison (round %d)", round);
+        }
+
+      scew_element_set_contents (scew_element_by_index
+                                 (scew_element_by_index (root, N_ELEMENTS - 1),
+                                  0),
+                                 _XT("modified"));
+    }
+
+  scew_element_free (root);
+  scew_element_free (copy);
+}
+END_TEST
+
+
 
 /* Suite */
 
@@ -500,7 +922,12 @@ element_suite (void)
   tcase_add_test (tc_core, test_hierarchy_basic);
   tcase_add_test (tc_core, test_hierarchy_delete);
   tcase_add_test (tc_core, test_search);
+  tcase_add_test (tc_core, test_search_descendants);
+  tcase_add_test (tc_core, test_epochs);
   tcase_add_test (tc_core, test_compare);
+  tcase_add_test (tc_core, test_hash);
+  tcase_add_test (tc_core, test_parallel);
+  tcase_add_test (tc_core, test_parallel_hash);
   suite_add_tcase (s, tc_core);
 
   return s;
@@ -511,3 +938,18 @@ run_tests (SRunner *sr)
 {
   srunner_add_suite (sr, element_suite ());
 }
+
+
+
+/* Private */
+
+void*
+hash_thread_ (void *data)
+{
+  hash_job_ *job = (hash_job_ *) data;
+
+  job->hash = scew_element_hash (job->element);
+  job->equal = scew_element_compare (job->element, job->copy, NULL);
+
+  return NULL;
+}
@@ -153,6 +153,39 @@ START_TEST (test_prepend)
 }
 END_TEST
 
+
+/* Insert */
+
+START_TEST (test_insert)
+{
+  /* Insert every item before the previous one */
+  scew_list *list = scew_list_create (&data_[0]);
+  unsigned int i = 0;
+  for (i = 1; i < N_ELEMENTS_; ++i)
+    {
+      scew_list *item = scew_list_insert (list, &data_[i]);
+
+      CHECK_PTR (item, "Unable to insert item %d", i);
+      CHECK_BOOL (scew_list_next (item) == list, SCEW_TRUE,
+                  "Invalid next item (item %d)", i);
+      CHECK_BOOL (scew_list_previous (list) == item, SCEW_TRUE,
+                  "Invalid previous item (item %d)", i);
+      list = item;
+    }
+
+  /* Insert in the middle */
+  scew_list *middle = scew_list_index (list, 2);
+  scew_list *item = scew_list_insert (middle, &data_[0]);
+
+  CHECK_BOOL (scew_list_index (list, 2) == item, SCEW_TRUE,
+              "Item should be inserted in the middle");
+  CHECK_U_INT (scew_list_size (list), N_ELEMENTS_ + 1,
+               "Number of items mismatch");
+
+  scew_list_free (list);
+}
+END_TEST
+
 
 /* Delete */
 
@@ -365,6 +398,7 @@ list_suite (void)
   tcase_add_test (tc_core, test_accessors);
   tcase_add_test (tc_core, test_append);
   tcase_add_test (tc_core, test_prepend);
+  tcase_add_test (tc_core, test_insert);
   tcase_add_test (tc_core, test_delete);
   tcase_add_test (tc_core, test_traverse);
   tcase_add_test (tc_core, test_traverse_foreach);
@@ -123,6 +123,7 @@ START_TEST (test_load)
 {
   static unsigned int const N_CHILDREN = 4;
   static XML_Char const *CHILD_NAME = _XT("element");
+  static XML_Char const *CHILD_CONTENTS = _XT("element contents");
 
   scew_parser *parser = scew_parser_create ();
 
@@ -150,6 +151,15 @@ START_TEST (test_load)
                  "Child name do not match");
     }
 
+  /* Trimmed contents must keep their length up to date. */
+  scew_element *first = scew_element_by_index (root, 0);
+  CHECK_STR (scew_element_contents (first), CHILD_CONTENTS,
+             "Child contents do not match");
+  CHECK_U_INT (scew_element_contents_len (first), scew_strlen (CHILD_CONTENTS),
+               "Child contents length do not match");
+  CHECK_NULL_PTR (scew_element_contents (root),
+                  "Root whitespace contents should be trimmed");
+
   scew_tree_free (tree);
   scew_reader_free (reader);
   scew_parser_free (parser);
@@ -337,6 +347,37 @@ START_TEST (test_load_chunked_stream_b)
 }
 END_TEST
 
+
+/* Load contents split in several chunks */
+
+START_TEST (test_load_contents)
+{
+  static XML_Char const *CONTENTS_XML =
+    _XT("<test>  one &amp; two &lt;three&gt;\n four  </test>");
+  static XML_Char const *CONTENTS = _XT("one & two <three>\n four");
+
+  scew_parser *parser = scew_parser_create ();
+
+  scew_reader *reader =
+    scew_reader_buffer_create (CONTENTS_XML, scew_strlen (CONTENTS_XML));
+
+  scew_tree *tree = scew_parser_load (parser, reader);
+
+  CHECK_PTR (tree, "Unable to parse contents XML");
+
+  scew_element *root = scew_tree_root (tree);
+
+  CHECK_STR (scew_element_contents (root), CONTENTS,
+             "Root contents do not match");
+  CHECK_U_INT (scew_element_contents_len (root), scew_strlen (CONTENTS),
+               "Root contents length do not match");
+
+  scew_tree_free (tree);
+  scew_reader_free (reader);
+  scew_parser_free (parser);
+}
+END_TEST
+
 
 /* Load invalid */
 
@@ -384,6 +425,7 @@ parser_suite (void)
   tcase_add_test (tc_core, test_load_stream);
   tcase_add_test (tc_core, test_load_chunked_stream_a);
   tcase_add_test (tc_core, test_load_chunked_stream_b);
+  tcase_add_test (tc_core, test_load_contents);
   tcase_add_test (tc_core, test_load_invalid);
   suite_add_tcase (s, tc_core);
 
@@ -30,9 +30,12 @@
 
 #include <scew/printer.h>
 #include <scew/writer_buffer.h>
+#include <scew/writer_buffered.h>
 
 #include <check.h>
 
+#include <stdlib.h>
+
 
 /* Unit tests */
 
@@ -82,6 +85,10 @@ static XML_Char const *TEST_CHILDREN_CONTENTS =
 static XML_Char const *TEST_ATTRIBUTE_CONTENTS =
   _XT(" attribute1=\"value1\" attribute2=\"value2\"");
 
+static XML_Char const *shared_contents_ = NULL;
+static scew_bool shared_ = SCEW_FALSE;
+static unsigned int writevs_ = 0;
+
 static scew_writer* test_writer_create_ (XML_Char **buffer);
 
 static scew_tree* test_tree_create_ (void);
@@ -198,6 +205,399 @@ START_TEST (test_print_attribute)
 }
 END_TEST
 
+/* Print through a buffered writer */
+
+START_TEST (test_print_buffered)
+{
+#define SPACES_ "                    "
+
+  static XML_Char const *WIDE_CONTENTS =
+    _XT("<element>\n"
+        SPACES_ "<subelement attribute=\"value\"/>\n"
+        SPACES_ "<subelement attribute1=\"value1\" attribute2=\"value2\">\n"
+        SPACES_ SPACES_
+        "<subsubelement>With accents: à é è í ó ú</subsubelement>\n"
+        SPACES_ "</subelement>\n"
+        "</element>\n");
+
+#undef SPACES_
+
+  XML_Char *write_buffer = NULL;
+
+  scew_writer *inner = test_writer_create_ (&write_buffer);
+  scew_writer *writer = scew_writer_buffered_create (inner, 16);
+
+  CHECK_PTR (writer, "Unable to create buffered writer");
+
+  scew_printer *printer = scew_printer_create (writer);
+
+  /* Create XML tree */
+  scew_tree *tree = test_tree_create_ ();
+
+  /* Print tree */
+  CHECK_BOOL (scew_printer_print_tree (printer, tree), SCEW_TRUE,
+              "Unable to print XML tree");
+  CHECK_BOOL (scew_writer_buffered_flush (writer), SCEW_TRUE,
+              "Unable to flush buffered writer");
+
+  CHECK_STR (write_buffer, TEST_TREE_CONTENTS,
+             "Buffered tree does not match");
+
+  scew_writer_free (writer);
+  scew_writer_free (inner);
+
+  /* Indentation wider than a single write */
+  inner = test_writer_create_ (&write_buffer);
+  scew_printer_set_writer (printer, inner);
+  scew_printer_set_indentation (printer, 20);
+
+  scew_element *element = scew_element_by_index (scew_tree_root (tree), 3);
+  CHECK_BOOL (scew_printer_print_element (printer, element), SCEW_TRUE,
+              "Unable to print element");
+
+  CHECK_STR (write_buffer, WIDE_CONTENTS, "Wide indentation does not match");
+
+  scew_writer_free (inner);
+  scew_printer_free (printer);
+  scew_tree_free (tree);
+}
+END_TEST
+
+/* Escaping */
+
+START_TEST (test_print_escaped)
+{
+  enum { MAX_BUFFER = 2048, CHARS_NO = 127 };
+
+  static XML_Char const *CONTENTS = _XT("<<a & 'b' > \"c\">>");
+  static XML_Char const *ESCAPED_CONTENTS =
+    _XT("<element attribute=\"&quot;x&quot; &amp; y\">"
+        "&lt;&lt;a &amp; &apos;b&apos; &gt; &quot;c&quot;&gt;&gt;"
+        "</element>");
+
+  XML_Char write_buffer[MAX_BUFFER];
+  XML_Char expected[MAX_BUFFER];
+
+  scew_writer *writer = scew_writer_buffer_create (write_buffer, MAX_BUFFER);
+  scew_printer *printer = scew_printer_create (writer);
+
+  scew_printer_set_indented (printer, SCEW_FALSE);
+
+  scew_element *element = scew_element_create (_XT("element"));
+  scew_element_add_attribute_pair (element, _XT("attribute"),
+                                   _XT("\"x\" & y"));
+  scew_element_set_contents (element, CONTENTS);
+
+  CHECK_BOOL (scew_printer_print_element (printer, element), SCEW_TRUE,
+              "Unable to print element");
+
+  CHECK_STR (write_buffer, ESCAPED_CONTENTS, "Escaped element does not match");
+
+  scew_writer_free (writer);
+
+  /* All ASCII characters must be escaped as scew_strescape does. */
+  XML_Char chars[CHARS_NO];
+  unsigned int i = 0;
+  for (i = 0; i < CHARS_NO - 1; ++i)
+    {
+      chars[i] = (XML_Char) (i + 1);
+    }
+  chars[CHARS_NO - 1] = _XT('\0');
+
+  scew_element_delete_attribute_all (element);
+  scew_element_set_contents (element, chars);
+
+  XML_Char *escaped = scew_strescape (chars);
+  size_t len = 0;
+  scew_memcpy (expected, _XT("<element>"), 9);
+  len += 9;
+  scew_memcpy (expected + len, escaped, scew_strlen (escaped));
+  len += scew_strlen (escaped);
+  scew_memcpy (expected + len, _XT("</element>"), 11);
+  free (escaped);
+
+  writer = scew_writer_buffer_create (write_buffer, MAX_BUFFER);
+  scew_printer_set_writer (printer, writer);
+
+  CHECK_BOOL (scew_printer_print_element (printer, element), SCEW_TRUE,
+              "Unable to print element");
+
+  CHECK_STR (write_buffer, expected, "Escaped characters do not match");
+
+  scew_writer_free (writer);
+  scew_printer_free (printer);
+  scew_element_free (element);
+}
+END_TEST
+
+/* Measuring */
+
+START_TEST (test_measure)
+{
+  static unsigned int const SPACES[] = { 0, 3, 20, 40 };
+
+  scew_tree *tree = test_tree_create_ ();
+  scew_element *element = scew_element_by_index (scew_tree_root (tree), 3);
+
+  scew_writer *writer = scew_writer_memory_create ();
+  scew_printer *printer = scew_printer_create (writer);
+
+  XML_Char *data = NULL;
+  size_t len = 0;
+  unsigned int i = 0;
+
+  /* Escaped characters are measured as printed. */
+  scew_element_set_contents (scew_element_by_index (scew_tree_root (tree), 1),
+                             _XT("<a & 'b'>"));
+
+  for (i = 0; i < sizeof (SPACES) / sizeof (SPACES[0]); ++i)
+    {
+      scew_printer_set_indented (printer, SPACES[i] > 0);
+      scew_printer_set_indentation (printer, SPACES[i]);
+
+      CHECK_BOOL (scew_printer_print_tree (printer, tree), SCEW_TRUE,
+                  "Unable to print XML tree");
+      data = scew_writer_memory_steal (writer, &len);
+
+      CHECK_U_INT (scew_printer_measure_tree (printer, tree), len,
+                   "Measured tree does not match printed tree");
+
+      free (data);
+
+      CHECK_BOOL (scew_printer_print_element (printer, element), SCEW_TRUE,
+                  "Unable to print element");
+      data = scew_writer_memory_steal (writer, &len);
+
+      CHECK_U_INT (scew_printer_measure_element (printer, element), len,
+                   "Measured element does not match printed element");
+
+      free (data);
+    }
+
+  /* Nothing is written while measuring. */
+  data = scew_writer_memory_steal (writer, &len);
+
+  CHECK_U_INT (len, 0, "Measuring should not write anything");
+
+  free (data);
+
+  scew_writer_free (writer);
+  scew_printer_free (printer);
+  scew_tree_free (tree);
+}
+END_TEST
+
+/* Parallel printing */
+
+START_TEST (test_print_parallel)
+{
+  enum { CHILDREN_NO = 600 };
+
+  static unsigned int const SPACES[] = { 0, 3, 20 };
+
+  scew_tree *tree = test_tree_create_ ();
+  scew_element *root = scew_tree_root (tree);
+
+  scew_writer *writer = scew_writer_memory_create ();
+  scew_printer *printer = scew_printer_create (writer);
+
+  XML_Char *expected = NULL;
+  XML_Char *data = NULL;
+  size_t expected_len = 0;
+  size_t len = 0;
+  unsigned int i = 0;
+
+  /* More children than parallel chunks, and mixed contents. */
+  scew_element_set_contents (root, _XT("Root & contents"));
+  for (i = 0; i < CHILDREN_NO; ++i)
+    {
+      scew_element *child = scew_element_add (root, _XT("child"));
+      scew_element_add_attribute_pair (child, _XT("a"), _XT("<\"value\">"));
+      if (i % 3 == 0)
+        {
+          scew_element_set_contents (scew_element_add (child, _XT("sub")),
+                                     _XT("Some 'contents'"));
+        }
+    }
+
+  for (i = 0; i < sizeof (SPACES) / sizeof (SPACES[0]); ++i)
+    {
+      scew_printer_set_indented (printer, SPACES[i] > 0);
+      scew_printer_set_indentation (printer, SPACES[i]);
+
+      CHECK_BOOL (scew_printer_print_tree (printer, tree), SCEW_TRUE,
+                  "Unable to print XML tree");
+      expected = scew_writer_memory_steal (writer, &expected_len);
+
+      CHECK_BOOL (scew_printer_print_tree_parallel (printer, tree), SCEW_TRUE,
+                  "Unable to print XML tree in parallel");
+      data = scew_writer_memory_steal (writer, &len);
+
+      CHECK_U_INT (len, expected_len, "Parallel tree size does not match");
+      CHECK_STR (data, expected, "Parallel tree does not match");
+
+      free (expected);
+      free (data);
+    }
+
+  /* Elements with less than two children are printed sequentially. */
+  scew_element *element = scew_element_by_index (root, 3);
+
+  CHECK_BOOL (scew_printer_print_element (printer, element), SCEW_TRUE,
+              "Unable to print element");
+  expected = scew_writer_memory_steal (writer, &expected_len);
+
+  CHECK_BOOL (scew_printer_print_element_parallel (printer, element),
+              SCEW_TRUE, "Unable to print element in parallel");
+  data = scew_writer_memory_steal (writer, &len);
+
+  CHECK_STR (data, expected, "Parallel element does not match");
+
+  free (expected);
+  free (data);
+
+  scew_writer_free (writer);
+  scew_printer_free (printer);
+  scew_tree_free (tree);
+}
+END_TEST
+
+/* Vectored printing */
+
+/* Writes spans to a memory writer, looking for the tree's contents. */
+static size_t
+vectored_write_ (scew_writer *writer, XML_Char const *buffer, size_t char_no)
+{
+  return scew_writer_write (scew_writer_data (writer), buffer, char_no);
+}
+
+static size_t
+vectored_writev_ (scew_writer *writer,
+                  scew_writer_span const *spans,
+                  size_t span_no)
+{
+  size_t written = 0;
+  size_t i = 0;
+
+  writevs_ += 1;
+
+  for (i = 0; i < span_no; ++i)
+    {
+      shared_ = shared_ || (spans[i].buffer == shared_contents_);
+      written += vectored_write_ (writer, spans[i].buffer, spans[i].char_no);
+    }
+
+  return written;
+}
+
+static scew_bool
+vectored_end_ (scew_writer *writer)
+{
+  return scew_writer_end (scew_writer_data (writer));
+}
+
+static scew_bool
+vectored_error_ (scew_writer *writer)
+{
+  return scew_writer_error (scew_writer_data (writer));
+}
+
+static scew_bool
+vectored_close_ (scew_writer *writer)
+{
+  return scew_writer_close (scew_writer_data (writer));
+}
+
+static void
+vectored_free_ (scew_writer *writer)
+{
+}
+
+static scew_writer_hooks const vectored_hooks_ =
+  {
+    vectored_write_,
+    vectored_end_,
+    vectored_error_,
+    vectored_close_,
+    vectored_free_
+  };
+
+START_TEST (test_print_vectored)
+{
+  scew_writer *inner = scew_writer_memory_create ();
+  scew_writer *writer = scew_writer_create (&vectored_hooks_, inner);
+
+  CHECK_PTR (writer, "Unable to create vectored writer");
+
+  scew_writer_set_writev (writer, vectored_writev_);
+  CHECK_BOOL (scew_writer_vectored (writer), SCEW_TRUE,
+              "Writer should support vectored output");
+
+  scew_printer *printer = scew_printer_create (writer);
+
+  /* Create XML tree */
+  scew_tree *tree = test_tree_create_ ();
+  scew_element *element = scew_element_by_index (scew_tree_root (tree), 0);
+
+  shared_contents_ = scew_element_contents (element);
+  shared_ = SCEW_FALSE;
+  writevs_ = 0;
+
+  /* Print tree */
+  CHECK_BOOL (scew_printer_print_tree (printer, tree), SCEW_TRUE,
+              "Unable to print XML tree");
+
+  CHECK_U_INT (writevs_, 1, "Spans should be written at once");
+  CHECK_BOOL (shared_, SCEW_TRUE, "Long contents should not be copied");
+
+  size_t len = 0;
+  XML_Char *data = scew_writer_memory_steal (inner, &len);
+
+  CHECK_U_INT (len, scew_strlen (TEST_TREE_CONTENTS), "Invalid tree size");
+  CHECK_STR (data, TEST_TREE_CONTENTS, "Vectored tree does not match");
+
+  free (data);
+
+  /* More spans than collected at once, printed in parallel too */
+  enum { CHILDREN_NO = 300 };
+
+  unsigned int i = 0;
+  for (i = 0; i < CHILDREN_NO; ++i)
+    {
+      scew_element_set_contents (scew_element_add (element, _XT("child")),
+                                 scew_element_contents (element));
+    }
+
+  scew_printer_set_writer (printer, inner);
+  CHECK_BOOL (scew_printer_print_tree (printer, tree), SCEW_TRUE,
+              "Unable to print XML tree");
+  XML_Char *expected = scew_writer_memory_steal (inner, NULL);
+
+  scew_printer_set_writer (printer, writer);
+  CHECK_BOOL (scew_printer_print_tree (printer, tree), SCEW_TRUE,
+              "Unable to print XML tree");
+  data = scew_writer_memory_steal (inner, NULL);
+
+  CHECK_STR (data, expected, "Vectored tree does not match");
+
+  free (data);
+
+  CHECK_BOOL (scew_printer_print_tree_parallel (printer, tree), SCEW_TRUE,
+              "Unable to print XML tree in parallel");
+  data = scew_writer_memory_steal (inner, NULL);
+
+  CHECK_STR (data, expected, "Vectored parallel tree does not match");
+
+  free (data);
+  free (expected);
+
+  scew_writer_free (writer);
+  scew_writer_free (inner);
+  scew_printer_free (printer);
+  scew_tree_free (tree);
+}
+END_TEST
+
 
 /* Suite */
 
@@ -212,6 +612,11 @@ printer_suite (void)
   tcase_add_test (tc_core, test_print_tree);
   tcase_add_test (tc_core, test_print_element);
   tcase_add_test (tc_core, test_print_attribute);
+  tcase_add_test (tc_core, test_print_buffered);
+  tcase_add_test (tc_core, test_print_escaped);
+  tcase_add_test (tc_core, test_measure);
+  tcase_add_test (tc_core, test_print_parallel);
+  tcase_add_test (tc_core, test_print_vectored);
   suite_add_tcase (s, tc_core);
 
   return s;
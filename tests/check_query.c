@@ -0,0 +1,391 @@
+/**
+ * @file     check_query.c
+ * @brief    Unit testing for SCEW queries
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 15:40
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "test.h"
+
+#include <scew/attribute.h>
+#include <scew/error.h>
+#include <scew/parser.h>
+#include <scew/query.h>
+#include <scew/reader_buffer.h>
+
+#include <check.h>
+
+#include <stdlib.h>
+
+
+/* Unit tests */
+
+static XML_Char const *TEST_XML =
+  _XT("<lib>"
+      "<shelf id=\"s1\">"
+      "<book id=\"b1\" lang=\"en\"><title>A</title></book>"
+      "<book id=\"b2\"><title>B</title><note>x</note></book>"
+      "<dvd id=\"d1\"/>"
+      "<book id=\"b3\" lang=\"en\"><title>C</title></book>"
+      "</shelf>"
+      "<shelf id=\"s2\">"
+      "<box id=\"x1\">"
+      "<book id=\"b4\" lang=\"fr\"><title>D</title></book>"
+      "</box>"
+      "</shelf>"
+      "</lib>");
+
+enum { MAX_OUTPUT_ = 256 };
+
+static scew_tree*
+load_tree_ (XML_Char const *xml)
+{
+  scew_parser *parser = scew_parser_create ();
+  scew_reader *reader = scew_reader_buffer_create (xml, scew_strlen (xml));
+  scew_tree *tree = scew_parser_load (parser, reader);
+
+  scew_reader_free (reader);
+  scew_parser_free (parser);
+
+  return tree;
+}
+
+/* Appends the id (or the contents, or the name) of each match. */
+static scew_bool
+collect_hook_ (scew_element *element, void *data)
+{
+  XML_Char *output = data;
+  scew_attribute *id = scew_element_attribute_by_name (element, _XT("id"));
+
+  if (output[0] != _XT('\0'))
+    {
+      scew_strcat (output, _XT(","));
+    }
+  if (id != NULL)
+    {
+      scew_strcat (output, scew_attribute_value (id));
+    }
+  else if (scew_element_contents (element) != NULL)
+    {
+      scew_strcat (output, scew_element_contents (element));
+    }
+  else
+    {
+      scew_strcat (output, scew_element_name (element));
+    }
+
+  return SCEW_TRUE;
+}
+
+static void
+check_query_ (scew_element *element,
+              XML_Char const *expression,
+              XML_Char const *expected)
+{
+  XML_Char output[MAX_OUTPUT_] = _XT("");
+  scew_query *query = scew_query_compile (expression);
+
+  CHECK_PTR (query, "Unable to compile query \"%s\"", expression);
+  CHECK_BOOL (scew_query_run (query, element, collect_hook_, output),
+              SCEW_TRUE, "Query \"%s\" was stopped", expression);
+  CHECK_STR (output, expected, "Query \"%s\" results do not match",
+             expression);
+
+  scew_query_free (query);
+}
+
+static scew_bool
+stop_hook_ (scew_element *element, void *data)
+{
+  unsigned int *calls = data;
+
+  *calls += 1;
+
+  return SCEW_FALSE;
+}
+
+
+/* Expressions */
+
+START_TEST (test_compile)
+{
+  static XML_Char const *INVALID[] =
+    {
+      _XT(""), _XT("/"), _XT("//"), _XT("book/"), _XT("book["),
+      _XT("book[0]"), _XT("book[@]"), _XT("book[@a='x]"),
+      _XT("book[@a=x]"), _XT("book[foo]"), _XT("a b"),
+      _XT("text()/a"), _XT("a[1][2][3][4][5][6][7][8][9]")
+    };
+  static XML_Char const *VALID[] =
+    {
+      _XT("a"), _XT("/a"), _XT("//a"), _XT("*"), _XT("a/*/b//c"),
+      _XT("text()"), _XT("//text()"), _XT("a//text()"),
+      _XT(" a:b[ @x = \"1\" ][ text() ][last()][12] "),
+      _XT("a[1][2][3][4][5][6][7][8]")
+    };
+  unsigned int i = 0;
+
+  for (i = 0; i < sizeof (INVALID) / sizeof (INVALID[0]); ++i)
+    {
+      CHECK_NULL_PTR (scew_query_compile (INVALID[i]),
+                      "Query \"%s\" should not compile", INVALID[i]);
+      CHECK_U_INT (scew_error_code (), scew_error_query,
+                   "Wrong error code for query \"%s\"", INVALID[i]);
+    }
+
+  for (i = 0; i < sizeof (VALID) / sizeof (VALID[0]); ++i)
+    {
+      scew_query *query = scew_query_compile (VALID[i]);
+      CHECK_PTR (query, "Unable to compile query \"%s\"", VALID[i]);
+      scew_query_free (query);
+    }
+}
+END_TEST
+
+
+/* Paths */
+
+START_TEST (test_paths)
+{
+  scew_tree *tree = load_tree_ (TEST_XML);
+  scew_element *root = scew_tree_root (tree);
+
+  CHECK_PTR (tree, "Unable to load tree");
+
+  check_query_ (root, _XT("/lib"), _XT("lib"));
+  check_query_ (root, _XT("/lib/shelf"), _XT("s1,s2"));
+  check_query_ (root, _XT("/shelf"), _XT(""));
+  check_query_ (root, _XT("shelf"), _XT("s1,s2"));
+  check_query_ (root, _XT("/lib/shelf/book"), _XT("b1,b2,b3"));
+  check_query_ (root, _XT("shelf/*"), _XT("b1,b2,d1,b3,x1"));
+  check_query_ (root, _XT("//book"), _XT("b1,b2,b3,b4"));
+  check_query_ (root, _XT("//lib//book"), _XT("b1,b2,b3,b4"));
+  check_query_ (root, _XT("//shelf//book"), _XT("b1,b2,b3,b4"));
+  check_query_ (root, _XT("/lib/*/*//book"), _XT("b4"));
+  check_query_ (root, _XT("/lib/shelf//box//title"), _XT("D"));
+  check_query_ (root, _XT("shelf//book/title/text()"), _XT("A,B,C,D"));
+  check_query_ (root, _XT("//text()"), _XT("A,B,x,C,D"));
+  check_query_ (root, _XT("shelf/book//text()"), _XT("A,B,x,C"));
+  check_query_ (root, _XT("//dvd/text()"), _XT(""));
+  check_query_ (root, _XT("text()"), _XT(""));
+
+  /* Queries on inner elements. */
+  scew_query *query = scew_query_compile (_XT("shelf"));
+  scew_element *shelf = scew_query_first (query, root);
+  scew_query_free (query);
+
+  check_query_ (shelf, _XT("book"), _XT("b1,b2,b3"));
+  check_query_ (shelf, _XT("/shelf/book"), _XT("b1,b2,b3"));
+  check_query_ (shelf, _XT("//title/text()"), _XT("A,B,C"));
+  check_query_ (shelf, _XT("//shelf"), _XT("s1"));
+  check_query_ (shelf, _XT("/shelf[1]"), _XT("s1"));
+  check_query_ (shelf, _XT("/shelf[last()]"), _XT("s1"));
+
+  scew_tree_free (tree);
+}
+END_TEST
+
+
+/* Predicates */
+
+START_TEST (test_predicates)
+{
+  scew_tree *tree = load_tree_ (TEST_XML);
+  scew_element *root = scew_tree_root (tree);
+
+  CHECK_PTR (tree, "Unable to load tree");
+
+  check_query_ (root, _XT("/lib/shelf/book[2]"), _XT("b2"));
+  check_query_ (root, _XT("/lib/shelf/*[3]"), _XT("d1"));
+  check_query_ (root, _XT("/lib/shelf/book[last()]"), _XT("b3"));
+  check_query_ (root, _XT("shelf[2]//book[last()]"), _XT("b4"));
+  check_query_ (root, _XT("//book[1]"), _XT("b1,b4"));
+  check_query_ (root, _XT("//book[last()]"), _XT("b3,b4"));
+  check_query_ (root, _XT("//shelf/book[1]"), _XT("b1"));
+  check_query_ (root, _XT("//book[4]"), _XT(""));
+  check_query_ (root, _XT("//book[@lang]"), _XT("b1,b3,b4"));
+  check_query_ (root, _XT("//book[@lang='en']"), _XT("b1,b3"));
+  check_query_ (root, _XT("//book[ @lang = \"fr\" ]"), _XT("b4"));
+  check_query_ (root, _XT("//book[@lang='en'][2]"), _XT("b3"));
+  check_query_ (root, _XT("shelf/book[@lang='en'][2]"), _XT("b3"));
+  check_query_ (root, _XT("shelf/book[@lang='en'][last()]"), _XT("b3"));
+  check_query_ (root, _XT("//book[2][@lang='en']"), _XT(""));
+  check_query_ (root, _XT("//book[@lang='e']"), _XT(""));
+  check_query_ (root, _XT("//*[@id='x1']/book"), _XT("b4"));
+  check_query_ (root, _XT("//title[text()='C']/text()"), _XT("C"));
+  check_query_ (root, _XT("//*[text()]"), _XT("A,B,x,C,D"));
+
+  scew_tree_free (tree);
+}
+END_TEST
+
+
+/* Hooks */
+
+START_TEST (test_hooks)
+{
+  scew_tree *tree = load_tree_ (TEST_XML);
+  scew_element *root = scew_tree_root (tree);
+  scew_query *query = scew_query_compile (_XT("//book"));
+  unsigned int calls = 0;
+
+  CHECK_PTR (tree, "Unable to load tree");
+  CHECK_PTR (query, "Unable to compile query");
+
+  scew_element *first = scew_query_first (query, root);
+  CHECK_PTR (first, "Query has no first match");
+  CHECK_STR (scew_attribute_value (scew_element_attribute_by_name (first,
+                                                                   _XT("id"))),
+             _XT("b1"), "First match is not the first book");
+
+  CHECK_U_INT (scew_query_count (query, root), 4,
+               "Wrong number of matches");
+
+  CHECK_BOOL (scew_query_run (query, root, stop_hook_, &calls), SCEW_FALSE,
+              "Query was not stopped");
+  CHECK_U_INT (calls, 1, "Query was not stopped on first match");
+
+  scew_query_free (query);
+  scew_tree_free (tree);
+}
+END_TEST
+
+START_TEST (test_summaries)
+{
+  static XML_Char const *QUERIES[] =
+    {
+      _XT("//book"), _XT("//shelf//book[@lang='en']"), _XT("//box//title"),
+      _XT("//*[@lang]"), _XT("//none"), _XT("//note/text()"),
+      _XT("shelf//dvd"), _XT("//title[text()='D']")
+    };
+  scew_tree *tree = load_tree_ (TEST_XML);
+  scew_element *root = scew_tree_root (tree);
+  unsigned int i = 0;
+
+  CHECK_PTR (tree, "Unable to load tree");
+
+  for (i = 0; i < sizeof (QUERIES) / sizeof (QUERIES[0]); ++i)
+    {
+      XML_Char expected[MAX_OUTPUT_] = _XT("");
+      scew_query *query = scew_query_compile (QUERIES[i]);
+
+      CHECK_PTR (query, "Unable to compile query \"%s\"", QUERIES[i]);
+      scew_query_run (query, root, collect_hook_, expected);
+
+      /* Compute all the summaries, so they are used by the query. */
+      scew_element_may_contain (root, _XT("none"));
+      check_query_ (root, QUERIES[i], expected);
+
+      scew_query_free (query);
+    }
+
+  /* Modified subtrees are not pruned. */
+  scew_element *title =
+    scew_element_descendant_by_name (root, _XT("title"));
+
+  CHECK_PTR (title, "Unable to find title");
+  scew_element_add_attribute_pair (title, _XT("mark"), _XT("m1"));
+  check_query_ (root, _XT("//*[@mark]"), _XT("A"));
+
+  scew_element_may_contain (root, _XT("none"));
+  check_query_ (root, _XT("//*[@mark]"), _XT("A"));
+
+  scew_tree_free (tree);
+}
+END_TEST
+
+
+/* Indexes */
+
+START_TEST (test_index)
+{
+  static XML_Char const *QUERIES[] =
+    {
+      _XT("//book"), _XT("//shelf//book[@lang='en']"), _XT("//book[1]"),
+      _XT("//*/title/text()"), _XT("//box/book[last()]"), _XT("//none"),
+      _XT("//lib"), _XT("/lib//title[text()='B']")
+    };
+  scew_tree *tree = load_tree_ (TEST_XML);
+  scew_element *root = scew_tree_root (tree);
+  unsigned int i = 0;
+
+  CHECK_PTR (tree, "Unable to load tree");
+  CHECK_BOOL (scew_tree_index_names (tree), SCEW_TRUE,
+              "Unable to index element names");
+
+  for (i = 0; i < sizeof (QUERIES) / sizeof (QUERIES[0]); ++i)
+    {
+      XML_Char expected[MAX_OUTPUT_] = _XT("");
+      XML_Char output[MAX_OUTPUT_] = _XT("");
+      scew_query *query = scew_query_compile (QUERIES[i]);
+
+      CHECK_PTR (query, "Unable to compile query \"%s\"", QUERIES[i]);
+      scew_query_run (query, root, collect_hook_, expected);
+      scew_query_run_tree (query, tree, collect_hook_, output);
+      CHECK_STR (output, expected, "Indexed query \"%s\" results differ",
+                 QUERIES[i]);
+
+      scew_query_free (query);
+    }
+
+  /* Out of date indexes are not used. */
+  scew_query *query = scew_query_compile (_XT("//book"));
+  XML_Char output[MAX_OUTPUT_] = _XT("");
+
+  scew_element_delete_by_name (scew_element_by_name (root, _XT("shelf")),
+                               _XT("book"));
+  scew_query_run_tree (query, tree, collect_hook_, output);
+  CHECK_STR (output, _XT("b2,b3,b4"), "Out of date index was used");
+
+  scew_query_free (query);
+  scew_tree_free (tree);
+}
+END_TEST
+
+
+/* Suite */
+
+static Suite*
+query_suite (void)
+{
+  Suite *s = suite_create ("SCEW queries");
+
+  /* Core test case */
+  TCase *tc_core = tcase_create ("Core");
+  tcase_add_test (tc_core, test_compile);
+  tcase_add_test (tc_core, test_paths);
+  tcase_add_test (tc_core, test_predicates);
+  tcase_add_test (tc_core, test_hooks);
+  tcase_add_test (tc_core, test_index);
+  tcase_add_test (tc_core, test_summaries);
+  suite_add_tcase (s, tc_core);
+
+  return s;
+}
+
+void
+run_tests (SRunner *sr)
+{
+  srunner_add_suite (sr, query_suite ());
+}
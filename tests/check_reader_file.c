@@ -32,10 +32,16 @@
 
 #include <check.h>
 
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
 
 /* Unit tests */
 
 static char const *TEST_FILE = SCEW_TESTSDIR"/check_reader_file.txt";
+static char const *TEST_BIG_FILE = SCEW_TESTSDIR"/check_reader_file.big";
 
 static XML_Char const *TEST_CONTENTS =
   _XT("This is just a dummy file to test the SCEW reader for "
@@ -134,6 +140,137 @@ START_TEST (test_misc)
 }
 END_TEST
 
+/* File descriptors */
+
+START_TEST (test_fd)
+{
+  enum { MAX_BUFFER_SIZE = 512 };
+
+  XML_Char read_buffer[MAX_BUFFER_SIZE] = _XT("");
+
+  int fd = open (TEST_FILE, O_RDONLY);
+
+  CHECK_BOOL (fd >= 0, SCEW_TRUE, "Unable to open test file");
+
+  scew_reader *reader = scew_reader_fd_create (fd);
+
+  CHECK_PTR (reader, "Unable to create file descriptor reader");
+
+  CHECK_BOOL (scew_reader_end (reader), SCEW_FALSE,
+              "Reader should be at the beginning");
+
+  unsigned int i = 0;
+  while (i < scew_strlen (TEST_CONTENTS))
+    {
+      CHECK_U_INT (scew_reader_read (reader, read_buffer + i, 1), 1,
+                   "Invalid number of read characters");
+      i += 1;
+    }
+  read_buffer[i] = _XT('\0');
+
+  CHECK_STR (read_buffer, TEST_CONTENTS, "Buffers do not match");
+
+  CHECK_U_INT (scew_reader_read (reader, read_buffer + i, 1), 0,
+               "There are no more characters to read");
+
+  CHECK_BOOL (scew_reader_end (reader), SCEW_TRUE,
+              "Reader should be at the end");
+
+  CHECK_BOOL (scew_reader_error (reader), SCEW_FALSE,
+              "Reader should have no error");
+
+  scew_reader_free (reader);
+}
+END_TEST
+
+START_TEST (test_fd_big)
+{
+  enum { BIG_SIZE = 200000, CHUNK_SIZE = 1000 };
+
+  /* Bigger than the internal block, read back in small chunks. */
+  XML_Char *big = malloc ((BIG_SIZE + 1) * sizeof (XML_Char));
+  unsigned int i = 0;
+  for (i = 0; i < BIG_SIZE; ++i)
+    {
+      big[i] = _XT('a') + (i % 26);
+    }
+
+  FILE *file = fopen (TEST_BIG_FILE, "wb");
+  fwrite (big, sizeof (XML_Char), BIG_SIZE, file);
+  fclose (file);
+
+  scew_reader *reader = scew_reader_fd_create (open (TEST_BIG_FILE, O_RDONLY));
+
+  CHECK_PTR (reader, "Unable to create file descriptor reader");
+
+  XML_Char *read_buffer = malloc ((BIG_SIZE + 1) * sizeof (XML_Char));
+  size_t total = 0;
+  size_t read_no = 0;
+  do
+    {
+      read_no = scew_reader_read (reader, read_buffer + total, CHUNK_SIZE);
+      total += read_no;
+    }
+  while (read_no > 0);
+
+  CHECK_U_INT (total, BIG_SIZE, "Invalid number of read characters");
+
+  CHECK_BOOL (memcmp (read_buffer, big, BIG_SIZE * sizeof (XML_Char)) == 0,
+              SCEW_TRUE, "Buffers do not match");
+
+  CHECK_BOOL (scew_reader_end (reader), SCEW_TRUE,
+              "Reader should be at the end");
+
+  scew_reader_free (reader);
+
+  free (read_buffer);
+  free (big);
+
+  /* Remove test file from hard drive */
+  remove (TEST_BIG_FILE);
+}
+END_TEST
+
+START_TEST (test_fd_pipe)
+{
+  enum { MAX_BUFFER_SIZE = 512 };
+
+  XML_Char read_buffer[MAX_BUFFER_SIZE] = _XT("");
+
+  int fds[2];
+
+  CHECK_S_INT (pipe (fds), 0, "Unable to create pipe");
+
+  scew_reader *reader = scew_reader_fd_create (fds[0]);
+
+  CHECK_PTR (reader, "Unable to create file descriptor reader");
+
+  /* Data is returned as soon as it is available. */
+  size_t contents_len = scew_strlen (TEST_CONTENTS);
+  size_t size = contents_len * sizeof (XML_Char);
+  CHECK_S_INT (write (fds[1], TEST_CONTENTS, size), size,
+               "Unable to write to pipe");
+
+  CHECK_U_INT (scew_reader_read (reader, read_buffer, MAX_BUFFER_SIZE - 1),
+               contents_len, "Invalid number of read characters");
+
+  CHECK_STR (read_buffer, TEST_CONTENTS, "Buffers do not match");
+
+  CHECK_BOOL (scew_reader_end (reader), SCEW_FALSE,
+              "Pipe is still open");
+
+  close (fds[1]);
+
+  CHECK_U_INT (scew_reader_read (reader, read_buffer, MAX_BUFFER_SIZE - 1), 0,
+               "There are no more characters to read");
+
+  CHECK_BOOL (scew_reader_end (reader), SCEW_TRUE,
+              "Reader should be at the end");
+
+  scew_reader_free (reader);
+}
+END_TEST
+
 
 /* Suite */
 
@@ -147,6 +284,9 @@ reader_file_suite (void)
   tcase_add_test (tc_core, test_alloc);
   tcase_add_test (tc_core, test_read);
   tcase_add_test (tc_core, test_misc);
+  tcase_add_test (tc_core, test_fd);
+  tcase_add_test (tc_core, test_fd_big);
+  tcase_add_test (tc_core, test_fd_pipe);
   suite_add_tcase (s, tc_core);
 
   return s;
@@ -0,0 +1,288 @@
+/**
+ * @file     check_str.c
+ * @brief    Unit testing for SCEW strings
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 21:30
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+#include "test.h"
+
+#include <scew/xstr.h>
+
+#include <check.h>
+
+#include <stdlib.h>
+
+
+/* Unit tests */
+
+/*
+ * Strings are long enough to be scanned in blocks by vector
+ * instructions, and every interesting character is tried at every
+ * position, so block boundaries and tails are exercised.
+ */
+enum { MAX_LEN = 100 };
+
+static XML_Char const *FILLER = _XT("abcdefghijklmnopqrstuvwxyz0123456789");
+static XML_Char const *ESCAPABLE = _XT("<>&'\"");
+static XML_Char const *SPACES = _XT(" \t\n\v\f\r");
+
+static void test_fill_ (XML_Char *string, size_t len);
+static XML_Char* test_escape_ (XML_Char const *src);
+
+/* Escaping */
+
+START_TEST (test_escape)
+{
+  XML_Char string[MAX_LEN + 1];
+  unsigned int len = 0;
+  unsigned int pos = 0;
+  unsigned int i = 0;
+
+  for (len = 0; len <= MAX_LEN; ++len)
+    {
+      for (pos = 0; pos <= len; ++pos)
+        {
+          for (i = 0; i < scew_strlen (ESCAPABLE); ++i)
+            {
+              test_fill_ (string, len);
+              if (pos < len)
+                {
+                  string[pos] = ESCAPABLE[i];
+                  /* Also one at the end. */
+                  string[len - 1] = ESCAPABLE[(i + 1) % 5];
+                }
+
+              XML_Char *escaped = scew_strescape (string);
+              XML_Char *expected = test_escape_ (string);
+
+              CHECK_STR (escaped, expected, "Escaped strings do not match");
+
+              free (escaped);
+              free (expected);
+            }
+        }
+    }
+}
+END_TEST
+
+/* Empty strings */
+
+START_TEST (test_empty)
+{
+  XML_Char string[MAX_LEN + 1];
+  unsigned int len = 0;
+  unsigned int pos = 0;
+  unsigned int i = 0;
+
+  CHECK_BOOL (scew_isempty (_XT("")), SCEW_TRUE,
+              "Zero-length strings are empty");
+
+  for (len = 1; len <= MAX_LEN; ++len)
+    {
+      for (i = 0; i < len; ++i)
+        {
+          string[i] = SPACES[i % 6];
+        }
+      string[len] = _XT('\0');
+
+      CHECK_BOOL (scew_isempty (string), SCEW_TRUE,
+                  "Whitespace strings are empty");
+
+      for (pos = 0; pos < len; ++pos)
+        {
+          XML_Char old = string[pos];
+
+          string[pos] = FILLER[pos % 36];
+          CHECK_BOOL (scew_isempty (string), SCEW_FALSE,
+                      "Strings with non-space characters are not empty");
+          string[pos] = old;
+        }
+    }
+}
+END_TEST
+
+/* Trimming */
+
+START_TEST (test_trim)
+{
+  enum { MAX_SPACES = 40, BODY_LEN = 5 };
+
+  XML_Char string[2 * MAX_SPACES + BODY_LEN + 1];
+  XML_Char body[BODY_LEN + 1];
+  unsigned int leading = 0;
+  unsigned int trailing = 0;
+  unsigned int len = 0;
+  unsigned int i = 0;
+
+  /* Inner whitespace is kept. */
+  scew_strcpy (body, _XT("a b\tc"));
+
+  for (leading = 0; leading <= MAX_SPACES; ++leading)
+    {
+      for (trailing = 0; trailing <= MAX_SPACES; ++trailing)
+        {
+          len = 0;
+          for (i = 0; i < leading; ++i)
+            {
+              string[len++] = SPACES[i % 6];
+            }
+          for (i = 0; i < BODY_LEN; ++i)
+            {
+              string[len++] = body[i];
+            }
+          for (i = 0; i < trailing; ++i)
+            {
+              string[len++] = SPACES[i % 6];
+            }
+          string[len] = _XT('\0');
+
+          scew_strtrim (string);
+
+          CHECK_STR (string, body, "Trimmed string does not match");
+        }
+
+      /* Only whitespace. */
+      for (i = 0; i < leading; ++i)
+        {
+          string[i] = SPACES[i % 6];
+        }
+      string[leading] = _XT('\0');
+
+      scew_strtrim (string);
+
+      CHECK_STR (string, _XT(""), "Whitespace should be trimmed off");
+    }
+}
+END_TEST
+
+/* Element and attribute strings */
+
+START_TEST (test_xstr_append)
+{
+  static XML_Char const *LONG = _XT("  xy                            ");
+
+  scew_xstr str = { NULL, 0, { 0 } };
+
+  /* Inline strings stay inline while they fit... */
+  scew_xstr_append_ (&str, _XT("ab"), 2);
+  scew_xstr_append_ (&str, _XT("cd"), 2);
+  CHECK_STR (str.data, _XT("abcd"), "Appended inline string does not match");
+  CHECK_BOOL (str.data == str.buf, SCEW_TRUE, "Short string is not inline");
+
+  /* ... and move to the heap when they grow. */
+  scew_xstr_append_ (&str, FILLER, 20);
+  CHECK_U_INT (str.len, 24, "Appended string length does not match");
+  CHECK_BOOL (scew_memcmp (str.data + 4, FILLER, 20) == 0, SCEW_TRUE,
+              "Appended heap string does not match");
+
+  /* Heap strings can be short after trimming, and must be kept. */
+  scew_xstr_set_ (&str, LONG, scew_strlen (LONG));
+  scew_xstr_trim_ (&str);
+  CHECK_STR (str.data, _XT("xy"), "Trimmed string does not match");
+  scew_xstr_append_ (&str, _XT("cd"), 2);
+  CHECK_STR (str.data, _XT("xycd"), "Appended trimmed string does not match");
+  CHECK_U_INT (str.len, 4, "Appended trimmed string length does not match");
+
+  scew_xstr_free_ (&str);
+}
+END_TEST
+
+
+/* Suite */
+
+static Suite*
+str_suite (void)
+{
+  Suite *s = suite_create ("SCEW strings");
+
+  /* Core test case */
+  TCase *tc_core = tcase_create ("Core");
+  tcase_add_test (tc_core, test_escape);
+  tcase_add_test (tc_core, test_empty);
+  tcase_add_test (tc_core, test_trim);
+  tcase_add_test (tc_core, test_xstr_append);
+  suite_add_tcase (s, tc_core);
+
+  return s;
+}
+
+void
+run_tests (SRunner *sr)
+{
+  srunner_add_suite (sr, str_suite ());
+}
+
+
+/* Private */
+
+void
+test_fill_ (XML_Char *string, size_t len)
+{
+  size_t i = 0;
+
+  for (i = 0; i < len; ++i)
+    {
+      string[i] = FILLER[i % 36];
+    }
+  string[len] = _XT('\0');
+}
+
+XML_Char*
+test_escape_ (XML_Char const *src)
+{
+  /* The longest entity has six characters. */
+  XML_Char *escaped = malloc ((6 * scew_strlen (src) + 1) * sizeof (XML_Char));
+  XML_Char *p = escaped;
+
+  *p = _XT('\0');
+  for (; *src != _XT('\0'); ++src)
+    {
+      switch (*src)
+        {
+        case _XT('<'):
+          scew_strcat (p, _XT("&lt;"));
+          break;
+        case _XT('>'):
+          scew_strcat (p, _XT("&gt;"));
+          break;
+        case _XT('&'):
+          scew_strcat (p, _XT("&amp;"));
+          break;
+        case _XT('\''):
+          scew_strcat (p, _XT("&apos;"));
+          break;
+        case _XT('"'):
+          scew_strcat (p, _XT("&quot;"));
+          break;
+        default:
+          p[0] = *src;
+          p[1] = _XT('\0');
+          break;
+        }
+      p += scew_strlen (p);
+    }
+
+  return escaped;
+}
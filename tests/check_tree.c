@@ -28,10 +28,15 @@
 
 #include "test.h"
 
+#include <scew/attribute.h>
+#include <scew/error.h>
 #include <scew/tree.h>
 
 #include <check.h>
 
+#include <stdio.h>
+#include <string.h>
+
 
 /* Unit tests */
 
@@ -172,6 +177,672 @@ START_TEST (test_compare)
 }
 END_TEST
 
+/* Indexes */
+
+START_TEST (test_index)
+{
+  static XML_Char const *NAME = _XT("root");
+  static XML_Char const *ITEM_NAME = _XT("item");
+  static XML_Char const *OTHER_NAME = _XT("other");
+  static unsigned int const N_ELEMENTS = 10;
+
+  scew_element * const *elements = NULL;
+  unsigned int count = 0;
+
+  scew_tree *tree = scew_tree_create ();
+  scew_element *root = scew_tree_set_root (tree, NAME);
+
+  CHECK_PTR (root, "Unable to create root element");
+
+  /* Items at different depths, in document order */
+  scew_element *items[N_ELEMENTS];
+  scew_element *parent = root;
+  unsigned int i = 0;
+  for (i = 0; i < N_ELEMENTS; ++i)
+    {
+      items[i] = scew_element_add (parent, ITEM_NAME);
+      scew_element_add (parent, OTHER_NAME);
+      if (i % 3 == 0)
+        {
+          parent = items[i];
+        }
+    }
+
+  CHECK_NULL_PTR (scew_tree_elements_by_name (tree, ITEM_NAME, &count),
+                  "Names index is not enabled yet");
+
+  CHECK_BOOL (scew_tree_index_names (tree), SCEW_TRUE,
+              "Unable to index element names");
+
+  elements = scew_tree_elements_by_name (tree, ITEM_NAME, &count);
+  CHECK_U_INT (count, N_ELEMENTS, "Wrong number of indexed items");
+  for (i = 0; i < N_ELEMENTS; ++i)
+    {
+      CHECK_PTR (elements[i] == items[i] ? elements[i] : NULL,
+                 "Item %d is not in document order", i);
+    }
+
+  elements = scew_tree_elements_by_name (tree, NAME, &count);
+  CHECK_U_INT (count, 1, "Root element is not indexed");
+  CHECK_NULL_PTR (scew_tree_elements_by_name (tree, _XT("none"), &count),
+                  "Unknown names should not be found");
+
+  /* Modifications are noticed */
+  scew_element_set_name (items[N_ELEMENTS - 1], OTHER_NAME);
+  scew_tree_elements_by_name (tree, ITEM_NAME, &count);
+  CHECK_U_INT (count, N_ELEMENTS - 1, "Renamed item is still indexed");
+
+  scew_element_add (items[0], ITEM_NAME);
+  elements = scew_tree_elements_by_name (tree, ITEM_NAME, &count);
+  CHECK_U_INT (count, N_ELEMENTS, "New item is not indexed");
+  CHECK_PTR (elements[0] == items[0] ? elements[0] : NULL,
+             "Items are not in document order");
+
+  scew_element_free (items[3]);
+  scew_tree_elements_by_name (tree, ITEM_NAME, &count);
+  CHECK_U_INT (count, 4, "Deleted items are still indexed");
+
+  scew_tree_unindex_names (tree);
+  CHECK_NULL_PTR (scew_tree_elements_by_name (tree, ITEM_NAME, &count),
+                  "Names index is not enabled any more");
+
+  scew_tree_free (tree);
+}
+END_TEST
+
+START_TEST (test_index_attribute)
+{
+  static XML_Char const *NAME = _XT("root");
+  static XML_Char const *ITEM_NAME = _XT("item");
+  static XML_Char const *ID = _XT("id");
+  static unsigned int const N_ELEMENTS = 100;
+  static unsigned int const N_CHANGES = 1000;
+
+  XML_Char value[CHECK_MAX_BUFFER_];
+  unsigned int count = 0;
+
+  scew_tree *tree = scew_tree_create ();
+  scew_element *root = scew_tree_set_root (tree, NAME);
+
+  CHECK_PTR (root, "Unable to create root element");
+
+  scew_element *items[N_ELEMENTS];
+  unsigned int i = 0;
+  for (i = 0; i < N_ELEMENTS; ++i)
+    {
+      items[i] = scew_element_add (root, ITEM_NAME);
+      check_sprintf (value, _XT("i%d"), i);
+      scew_element_add_attribute_pair (items[i], ID, value);
+      scew_element_add_attribute_pair (items[i], _XT("key"), value);
+    }
+
+  CHECK_NULL_PTR (scew_tree_element_by_attribute (tree, ID, _XT("i0")),
+                  "Attribute is not indexed yet");
+
+  CHECK_BOOL (scew_tree_index_attribute (tree, ID), SCEW_TRUE,
+              "Unable to index attribute");
+  CHECK_BOOL (scew_tree_index_names (tree), SCEW_TRUE,
+              "Unable to index element names");
+
+  for (i = 0; i < N_ELEMENTS; ++i)
+    {
+      check_sprintf (value, _XT("i%d"), i);
+      CHECK_PTR (scew_tree_element_by_attribute (tree, ID, value) == items[i]
+                 ? items[i] : NULL, "Item %d not found by attribute", i);
+    }
+  CHECK_NULL_PTR (scew_tree_element_by_attribute (tree, ID, _XT("none")),
+                  "Unknown value should not be found");
+  CHECK_NULL_PTR (scew_tree_element_by_attribute (tree, _XT("key"),
+                                                  _XT("i0")),
+                  "Attribute key is not indexed");
+
+  /* Attribute values are updated in place */
+  for (i = 0; i < N_CHANGES; ++i)
+    {
+      scew_attribute *id =
+        scew_element_attribute_by_name (items[i % N_ELEMENTS], ID);
+      check_sprintf (value, _XT("c%d"), i);
+      scew_attribute_set_value (id, value);
+    }
+  for (i = N_CHANGES - N_ELEMENTS; i < N_CHANGES; ++i)
+    {
+      check_sprintf (value, _XT("c%d"), i);
+      CHECK_PTR (scew_tree_element_by_attribute (tree, ID, value)
+                 == items[i % N_ELEMENTS] ? value : NULL,
+                 "Changed value %d not found", i);
+    }
+  CHECK_NULL_PTR (scew_tree_element_by_attribute (tree, ID, _XT("i0")),
+                  "Old value should not be found");
+
+  scew_element_delete_attribute_by_name (items[0], ID);
+  check_sprintf (value, _XT("c%d"), N_CHANGES - N_ELEMENTS);
+  CHECK_NULL_PTR (scew_tree_element_by_attribute (tree, ID, value),
+                  "Deleted attribute should not be found");
+
+  scew_element_add_attribute_pair (items[0], ID, _XT("new"));
+  CHECK_PTR (scew_tree_element_by_attribute (tree, ID, _XT("new")),
+             "Added attribute not found");
+
+  scew_attribute_set_name (scew_element_attribute_by_name (items[0], ID),
+                           _XT("renamed"));
+  CHECK_NULL_PTR (scew_tree_element_by_attribute (tree, ID, _XT("new")),
+                  "Renamed attribute should not be found");
+
+  /* Structural changes rebuild the indexes */
+  scew_element *other = scew_element_add (items[1], ITEM_NAME);
+  scew_element_add_attribute_pair (other, ID, _XT("other"));
+  CHECK_PTR (scew_tree_element_by_attribute (tree, ID, _XT("other")) == other
+             ? other : NULL, "New element not found by attribute");
+  scew_tree_elements_by_name (tree, ITEM_NAME, &count);
+  CHECK_U_INT (count, N_ELEMENTS + 1, "New element is not indexed by name");
+
+  scew_element_free (other);
+  CHECK_NULL_PTR (scew_tree_element_by_attribute (tree, ID, _XT("other")),
+                  "Deleted element should not be found");
+
+  scew_tree_unindex_attribute (tree, ID);
+  CHECK_NULL_PTR (scew_tree_element_by_attribute (tree, ID, _XT("c999")),
+                  "Attribute is not indexed any more");
+
+  scew_tree_free (tree);
+}
+END_TEST
+
+START_TEST (test_index_text)
+{
+  static unsigned int const N_ELEMENTS = 100;
+
+  XML_Char contents[CHECK_MAX_BUFFER_];
+  scew_element * const *found = NULL;
+  unsigned int count = 0;
+
+  scew_tree *tree = scew_tree_create ();
+  scew_element *root = scew_tree_set_root (tree, _XT("root"));
+
+  CHECK_PTR (root, "Unable to create root element");
+
+  scew_element *items[N_ELEMENTS];
+  unsigned int i = 0;
+  for (i = 0; i < N_ELEMENTS; ++i)
+    {
+      items[i] = scew_element_add (root, _XT("item"));
+      check_sprintf (contents, _XT("Item t%d, %s item.\n(t%d)"),
+                     i, ((i % 2) == 0) ? _XT("even") : _XT("odd"), i);
+      scew_element_set_contents (items[i], contents);
+    }
+
+  CHECK_NULL_PTR (scew_tree_elements_by_token (tree, _XT("item"), &count),
+                  "Contents are not indexed yet");
+
+  CHECK_BOOL (scew_tree_index_text (tree), SCEW_TRUE,
+              "Unable to index contents");
+
+  found = scew_tree_elements_by_token (tree, _XT("even"), &count);
+  CHECK_U_INT (count, N_ELEMENTS / 2, "Number of elements with token");
+  for (i = 0; i < count; ++i)
+    {
+      CHECK_PTR (found[i] == items[2 * i] ? found[i] : NULL,
+                 "Element %d with token is not in document order", i);
+    }
+
+  /* Repeated tokens only count once per element */
+  found = scew_tree_elements_by_token (tree, _XT("t7"), &count);
+  CHECK_U_INT (count, 1, "Repeated token found several times");
+  CHECK_PTR (found[0] == items[7] ? found[0] : NULL,
+             "Element not found by token");
+
+  /* Tokens are case-sensitive and split by punctuation */
+  scew_tree_elements_by_token (tree, _XT("item"), &count);
+  CHECK_U_INT (count, N_ELEMENTS, "Number of elements with lower case token");
+  scew_tree_elements_by_token (tree, _XT("Item"), &count);
+  CHECK_U_INT (count, N_ELEMENTS, "Number of elements with upper case token");
+  CHECK_NULL_PTR (scew_tree_elements_by_token (tree, _XT("item."), &count),
+                  "Tokens should not have punctuation");
+
+  /* Contents are updated in place */
+  scew_element_set_contents (items[0], _XT("changed even"));
+  CHECK_NULL_PTR (scew_tree_elements_by_token (tree, _XT("t0"), &count),
+                  "Old token should not be found");
+  scew_tree_elements_by_token (tree, _XT("changed"), &count);
+  CHECK_U_INT (count, 1, "Number of elements with new token");
+  found = scew_tree_elements_by_token (tree, _XT("even"), &count);
+  CHECK_U_INT (count, N_ELEMENTS / 2, "Number of elements with kept token");
+  CHECK_PTR (found[count - 1] == items[0] ? found[0] : NULL,
+             "Changed element should be the last one");
+
+  scew_element_free_contents (items[1]);
+  scew_tree_elements_by_token (tree, _XT("odd"), &count);
+  CHECK_U_INT (count, N_ELEMENTS / 2 - 1, "Freed contents are still found");
+
+  /* Many updates of a common token, in update order */
+  for (i = 2; i < N_ELEMENTS; i += 2)
+    {
+      scew_element_set_contents (items[i], _XT("odd again"));
+      scew_element_set_contents (items[i], _XT("even again"));
+    }
+  found = scew_tree_elements_by_token (tree, _XT("even"), &count);
+  CHECK_U_INT (count, N_ELEMENTS / 2, "Number of elements with updated token");
+  for (i = 0; i < count; ++i)
+    {
+      CHECK_PTR (found[i] == items[2 * i] ? found[i] : NULL,
+                 "Updated element %d is not in update order", i);
+    }
+  scew_tree_elements_by_token (tree, _XT("odd"), &count);
+  CHECK_U_INT (count, N_ELEMENTS / 2 - 1, "Replaced contents are still found");
+
+  /* Structural changes rebuild the index */
+  scew_element *other = scew_element_add (root, _XT("other"));
+  scew_element_set_contents (other, _XT("odd one"));
+  scew_tree_elements_by_token (tree, _XT("odd"), &count);
+  CHECK_U_INT (count, N_ELEMENTS / 2, "New element is not indexed");
+
+  scew_element_free (items[3]);
+  scew_tree_elements_by_token (tree, _XT("odd"), &count);
+  CHECK_U_INT (count, N_ELEMENTS / 2 - 1, "Deleted element is still indexed");
+
+  scew_tree_unindex_text (tree);
+  CHECK_NULL_PTR (scew_tree_elements_by_token (tree, _XT("odd"), &count),
+                  "Contents are not indexed any more");
+
+  scew_tree_free (tree);
+}
+END_TEST
+
+START_TEST (test_index_order)
+{
+  static XML_Char const *NAMES[] =
+    {
+      _XT("a"), _XT("b"), _XT("c"), _XT("d"), _XT("e"), _XT("f"), _XT("g")
+    };
+
+  scew_element * const *subtree = NULL;
+  unsigned int count = 0;
+
+  scew_tree *tree = scew_tree_create ();
+  scew_element *root = scew_tree_set_root (tree, NAMES[0]);
+
+  CHECK_PTR (root, "Unable to create root element");
+
+  /* a(b(c, d), e(f), g) */
+  scew_element *b = scew_element_add (root, NAMES[1]);
+  scew_element *c = scew_element_add (b, NAMES[2]);
+  scew_element *d = scew_element_add (b, NAMES[3]);
+  scew_element *e = scew_element_add (root, NAMES[4]);
+  scew_element *f = scew_element_add (e, NAMES[5]);
+  scew_element *g = scew_element_add (root, NAMES[6]);
+  scew_element *shuffled[] = { g, d, root, f, b, e, c };
+  scew_element *elements[] = { root, b, c, d, e, f, g };
+  unsigned int n = sizeof (elements) / sizeof (elements[0]);
+
+  CHECK_NULL_PTR (scew_tree_subtree_elements (tree, b, &count),
+                  "Document order is not indexed yet");
+
+  /* The same answers are given with and without index. */
+  unsigned int pass = 0;
+  for (pass = 0; pass < 2; ++pass)
+    {
+      CHECK_BOOL (scew_tree_is_ancestor (tree, root, f), SCEW_TRUE,
+                  "Root is an ancestor (pass %d)", pass);
+      CHECK_BOOL (scew_tree_is_ancestor (tree, b, d), SCEW_TRUE,
+                  "Parent is an ancestor (pass %d)", pass);
+      CHECK_BOOL (scew_tree_is_ancestor (tree, b, f), SCEW_FALSE,
+                  "Element of another subtree is not an ancestor (pass %d)",
+                  pass);
+      CHECK_BOOL (scew_tree_is_ancestor (tree, b, b), SCEW_FALSE,
+                  "Element is not its own ancestor (pass %d)", pass);
+      CHECK_BOOL (scew_tree_is_ancestor (tree, d, b), SCEW_FALSE,
+                  "Child is not an ancestor (pass %d)", pass);
+
+      unsigned int i = 0;
+      unsigned int j = 0;
+      for (i = 0; i < n; ++i)
+        {
+          for (j = 0; j < n; ++j)
+            {
+              int order = scew_tree_compare_order (tree, elements[i],
+                                                   elements[j]);
+              CHECK_S_INT ((order > 0) - (order < 0), (i > j) - (i < j),
+                           "Order of %d and %d (pass %d)", i, j, pass);
+            }
+        }
+
+      scew_element *sorted[sizeof (shuffled) / sizeof (shuffled[0])];
+      memcpy (sorted, shuffled, sizeof (shuffled));
+      scew_tree_sort_elements (tree, sorted, n);
+      for (i = 0; i < n; ++i)
+        {
+          CHECK_STR (scew_element_name (sorted[i]), NAMES[i],
+                     "Sorted element %d (pass %d)", i, pass);
+        }
+
+      CHECK_BOOL (scew_tree_index_order (tree), SCEW_TRUE,
+                  "Unable to index document order");
+    }
+
+  subtree = scew_tree_subtree_elements (tree, b, &count);
+  CHECK_U_INT (count, 3, "Number of elements in subtree");
+  CHECK_STR (scew_element_name (subtree[0]), _XT("b"), "Subtree root");
+  CHECK_STR (scew_element_name (subtree[2]), _XT("d"), "Subtree last");
+
+  scew_tree_subtree_elements (tree, root, &count);
+  CHECK_U_INT (count, n, "Number of elements in tree");
+
+  /* Structural changes rebuild the index */
+  scew_element *h = scew_element_add (c, _XT("h"));
+  CHECK_BOOL (scew_tree_is_ancestor (tree, b, h), SCEW_TRUE,
+              "New element is not indexed");
+  CHECK_S_INT (scew_tree_compare_order (tree, h, d) < 0, 1,
+               "New element is not in document order");
+  scew_tree_subtree_elements (tree, b, &count);
+  CHECK_U_INT (count, 4, "Number of elements in modified subtree");
+
+  scew_tree_unindex_order (tree);
+  CHECK_NULL_PTR (scew_tree_subtree_elements (tree, b, &count),
+                  "Document order is not indexed any more");
+
+  scew_tree_free (tree);
+}
+END_TEST
+
+
+
+/* Frozen trees */
+
+START_TEST (test_freeze)
+{
+  static unsigned int const N_ELEMENTS = 50;
+
+  XML_Char value[CHECK_MAX_BUFFER_];
+  unsigned int count = 0;
+
+  scew_tree *tree = scew_tree_create ();
+  scew_element *root = scew_tree_set_root (tree, _XT("root"));
+
+  CHECK_PTR (root, "Unable to create root element");
+
+  unsigned int i = 0;
+  for (i = 0; i < N_ELEMENTS; ++i)
+    {
+      scew_element *item = scew_element_add (root, _XT("item"));
+      scew_element *child =
+        scew_element_add (item, _XT("a child with a rather long name"));
+      check_sprintf (value, _XT("i%d"), i);
+      scew_element_add_attribute_pair (item, _XT("id"), value);
+      check_sprintf (value, _XT("the contents of child number %d"), i);
+      scew_element_set_contents (child, value);
+    }
+
+  CHECK_BOOL (scew_tree_index_names (tree), SCEW_TRUE,
+              "Unable to index element names");
+  CHECK_BOOL (scew_tree_index_attribute (tree, _XT("id")), SCEW_TRUE,
+              "Unable to index attribute");
+
+  scew_tree *copy = scew_tree_copy (tree);
+  unsigned long hash = scew_element_hash (root);
+
+  CHECK_PTR (copy, "Unable to copy tree");
+  CHECK_BOOL (scew_tree_is_frozen (tree), SCEW_FALSE,
+              "Tree should not be frozen yet");
+
+  CHECK_BOOL (scew_tree_freeze (tree), SCEW_TRUE, "Unable to freeze tree");
+  CHECK_BOOL (scew_tree_is_frozen (tree), SCEW_TRUE, "Tree is not frozen");
+  CHECK_BOOL (scew_tree_freeze (tree), SCEW_TRUE, "Unable to refreeze tree");
+
+  /* Frozen trees are read as any other tree */
+  root = scew_tree_root (tree);
+  CHECK_BOOL (scew_tree_compare (tree, copy, NULL), SCEW_TRUE,
+              "Frozen tree does not match its copy");
+  CHECK_U_INT (scew_element_hash (root), hash, "Frozen hash does not match");
+  CHECK_U_INT (scew_element_count (root), N_ELEMENTS,
+               "Number of frozen children");
+
+  scew_element *item = scew_element_by_index (root, N_ELEMENTS - 1);
+  CHECK_PTR (item, "Unable to find frozen child");
+  CHECK_BOOL (scew_element_parent (item) == root, SCEW_TRUE,
+              "Frozen parent does not match");
+  CHECK_STR (scew_attribute_value (scew_element_attribute_by_name
+                                   (item, _XT("id"))),
+             _XT("i49"), "Frozen attribute does not match");
+  CHECK_STR (scew_element_contents (scew_element_by_index (item, 0)),
+             _XT("the contents of child number 49"),
+             "Frozen contents do not match");
+  CHECK_PTR (scew_element_descendant_by_name
+             (root, _XT("a child with a rather long name")),
+             "Frozen descendant not found");
+
+  /* Indexes are rebuilt while freezing */
+  scew_element * const *items =
+    scew_tree_elements_by_name (tree, _XT("item"), &count);
+  CHECK_U_INT (count, N_ELEMENTS, "Number of frozen elements by name");
+  CHECK_BOOL (items[N_ELEMENTS - 1] == item, SCEW_TRUE,
+              "Frozen element by name does not match");
+  CHECK_BOOL (scew_tree_element_by_attribute (tree, _XT("id"), _XT("i49"))
+              == item, SCEW_TRUE, "Frozen element by attribute not found");
+
+  /* Frozen trees can not be modified */
+  scew_attribute *attribute =
+    scew_element_attribute_by_name (item, _XT("id"));
+  CHECK_NULL_PTR (scew_element_set_name (root, _XT("modified")),
+                  "Frozen element name should not be set");
+  CHECK_S_INT (scew_error_code (), scew_error_frozen, "Frozen tree error");
+  CHECK_NULL_PTR (scew_element_set_contents (item, _XT("modified")),
+                  "Frozen element contents should not be set");
+  CHECK_NULL_PTR (scew_element_add (root, _XT("added")),
+                  "Frozen element should not get children");
+  CHECK_NULL_PTR (scew_element_add_attribute_pair (item, _XT("a"), _XT("b")),
+                  "Frozen element should not get attributes");
+  CHECK_NULL_PTR (scew_attribute_set_value (attribute, _XT("modified")),
+                  "Frozen attribute value should not be set");
+  CHECK_NULL_PTR (scew_tree_set_root (tree, _XT("modified")),
+                  "Frozen tree root should not be set");
+  scew_element_delete_attribute_all (item);
+  scew_element_delete_all_by_name (root, _XT("item"));
+  scew_element_detach (item);
+  scew_element_free (item);
+  scew_attribute_free (attribute);
+  CHECK_S_INT (scew_error_code (), scew_error_frozen, "Frozen tree error");
+  CHECK_BOOL (scew_tree_root (tree) == root, SCEW_TRUE,
+              "Frozen tree root has changed");
+  CHECK_BOOL (scew_tree_compare (tree, copy, NULL), SCEW_TRUE,
+              "Frozen tree has been modified");
+
+  /* Copies of frozen trees can be modified */
+  scew_tree_free (copy);
+  copy = scew_tree_copy (tree);
+  CHECK_PTR (copy, "Unable to copy frozen tree");
+  CHECK_BOOL (scew_tree_is_frozen (copy), SCEW_FALSE,
+              "Copy of frozen tree should not be frozen");
+  scew_element_set_name (scew_tree_root (copy), _XT("modified"));
+  CHECK_BOOL (scew_tree_compare (tree, copy, NULL), SCEW_FALSE,
+              "Modified copy should not match");
+
+  scew_tree_free (copy);
+  scew_tree_free (tree);
+}
+END_TEST
+
+START_TEST (test_snapshot)
+{
+  static char const *SNAPSHOT_FILE = SCEW_TESTSDIR"/check_tree.snapshot";
+  static char const *SOURCE_FILE = SCEW_TESTSDIR"/check_tree_source.xml";
+
+  XML_Char value[CHECK_MAX_BUFFER_];
+  unsigned int count = 0;
+
+  scew_tree *tree = scew_tree_create ();
+  scew_element *root = scew_tree_set_root (tree, _XT("root"));
+
+  CHECK_PTR (root, "Unable to create root element");
+
+  scew_tree_set_xml_encoding (tree, _XT("ISO-8859-1"));
+  scew_tree_set_xml_preamble (tree, _XT("<!-- snapshot -->"));
+  scew_tree_set_xml_standalone (tree, scew_tree_standalone_yes);
+
+  unsigned int i = 0;
+  for (i = 0; i < 10; ++i)
+    {
+      scew_element *item = scew_element_add (root, _XT("item"));
+      check_sprintf (value, _XT("i%d"), i);
+      scew_element_add_attribute_pair (item, _XT("id"), value);
+      check_sprintf (value, _XT("the contents of item number %d"), i);
+      scew_element_set_contents (item, value);
+    }
+
+  FILE *source = fopen (SOURCE_FILE, "wb");
+  CHECK_PTR (source, "Unable to create source file");
+  fputs ("<root/>", source);
+  fclose (source);
+
+  CHECK_BOOL (scew_tree_save_snapshot (tree, SNAPSHOT_FILE, SOURCE_FILE),
+              SCEW_TRUE, "Unable to save snapshot");
+
+  /* Snapshots are opened as frozen trees */
+  scew_tree *snapshot = scew_tree_open_snapshot (SNAPSHOT_FILE, SOURCE_FILE);
+  CHECK_PTR (snapshot, "Unable to open snapshot");
+  CHECK_BOOL (scew_tree_is_frozen (snapshot), SCEW_TRUE,
+              "Snapshot is not frozen");
+  CHECK_BOOL (scew_tree_compare (tree, snapshot, NULL), SCEW_TRUE,
+              "Snapshot does not match its tree");
+  CHECK_STR (scew_tree_xml_preamble (snapshot), _XT("<!-- snapshot -->"),
+             "Snapshot preamble does not match");
+  CHECK_U_INT (scew_element_hash (scew_tree_root (snapshot)),
+               scew_element_hash (root), "Snapshot hash does not match");
+
+  scew_element *item = scew_element_by_index (scew_tree_root (snapshot), 9);
+  CHECK_STR (scew_element_contents (item),
+             _XT("the contents of item number 9"),
+             "Snapshot contents do not match");
+  CHECK_BOOL (scew_element_parent (item) == scew_tree_root (snapshot),
+              SCEW_TRUE, "Snapshot parent does not match");
+
+  /* Snapshots can be indexed */
+  CHECK_BOOL (scew_tree_index_attribute (snapshot, _XT("id")), SCEW_TRUE,
+              "Unable to index snapshot attribute");
+  CHECK_BOOL (scew_tree_element_by_attribute (snapshot, _XT("id"), _XT("i9"))
+              == item, SCEW_TRUE, "Snapshot element by attribute not found");
+  CHECK_BOOL (scew_tree_index_names (snapshot), SCEW_TRUE,
+              "Unable to index snapshot element names");
+  scew_tree_elements_by_name (snapshot, _XT("item"), &count);
+  CHECK_U_INT (count, 10, "Number of snapshot elements by name");
+
+  scew_tree_free (snapshot);
+
+  /* Snapshots are out of date once the source changes */
+  source = fopen (SOURCE_FILE, "ab");
+  CHECK_PTR (source, "Unable to modify source file");
+  fputs ("\n", source);
+  fclose (source);
+
+  CHECK_NULL_PTR (scew_tree_open_snapshot (SNAPSHOT_FILE, SOURCE_FILE),
+                  "Out of date snapshot should not be opened");
+  CHECK_S_INT (scew_error_code (), scew_error_snapshot,
+               "Out of date snapshot error");
+
+  snapshot = scew_tree_open_snapshot (SNAPSHOT_FILE, NULL);
+  CHECK_PTR (snapshot, "Unable to open snapshot without source");
+  scew_tree_free (snapshot);
+
+  /* Empty trees and frozen trees can be saved too */
+  scew_tree *empty = scew_tree_create ();
+  CHECK_BOOL (scew_tree_save_snapshot (empty, SNAPSHOT_FILE, NULL),
+              SCEW_TRUE, "Unable to save empty snapshot");
+  snapshot = scew_tree_open_snapshot (SNAPSHOT_FILE, NULL);
+  CHECK_PTR (snapshot, "Unable to open empty snapshot");
+  CHECK_NULL_PTR (scew_tree_root (snapshot), "Empty snapshot has a root");
+  CHECK_NULL_PTR (scew_tree_open_snapshot (SNAPSHOT_FILE, SOURCE_FILE),
+                  "Snapshot without source should not be opened");
+  scew_tree_free (snapshot);
+  scew_tree_free (empty);
+
+  CHECK_BOOL (scew_tree_freeze (tree), SCEW_TRUE, "Unable to freeze tree");
+  CHECK_BOOL (scew_tree_save_snapshot (tree, SNAPSHOT_FILE, NULL),
+              SCEW_TRUE, "Unable to save frozen snapshot");
+  snapshot = scew_tree_open_snapshot (SNAPSHOT_FILE, NULL);
+  CHECK_BOOL (scew_tree_compare (tree, snapshot, NULL), SCEW_TRUE,
+              "Frozen snapshot does not match its tree");
+  scew_tree_free (snapshot);
+
+  /* Anything else is not a snapshot */
+  CHECK_NULL_PTR (scew_tree_open_snapshot (SOURCE_FILE, NULL),
+                  "Invalid snapshot should not be opened");
+  CHECK_S_INT (scew_error_code (), scew_error_snapshot,
+               "Invalid snapshot error");
+
+  remove (SNAPSHOT_FILE);
+  remove (SOURCE_FILE);
+
+  scew_tree_free (tree);
+}
+END_TEST
+
+START_TEST (test_snapshot_corrupted)
+{
+  static char const *SNAPSHOT_FILE =
+    SCEW_TESTSDIR"/check_tree_corrupted.snapshot";
+  static unsigned char const FLIPS[] = { 0x01, 0x10, 0x80 };
+
+  XML_Char value[CHECK_MAX_BUFFER_];
+  unsigned char data[8192];
+  size_t size = 0;
+  size_t i = 0;
+  unsigned int f = 0;
+
+  scew_tree *tree = scew_tree_create ();
+  scew_element *root = scew_tree_set_root (tree, _XT("root"));
+  for (i = 0; i < 5; ++i)
+    {
+      scew_element *item = scew_element_add (root, _XT("item"));
+      check_sprintf (value, _XT("i%d"), (int) i);
+      scew_element_add_attribute_pair (item, _XT("id"), value);
+      check_sprintf (value, _XT("the contents of item number %d"), (int) i);
+      scew_element_set_contents (item, value);
+      scew_element_add (item, _XT("a child with a rather long name"));
+    }
+
+  CHECK_BOOL (scew_tree_save_snapshot (tree, SNAPSHOT_FILE, NULL),
+              SCEW_TRUE, "Unable to save snapshot");
+
+  FILE *file = fopen (SNAPSHOT_FILE, "rb");
+  CHECK_PTR (file, "Unable to read snapshot");
+  size = fread (data, 1, sizeof (data), file);
+  fclose (file);
+  CHECK_BOOL ((size > 0) && (size < sizeof (data)), SCEW_TRUE,
+              "Unexpected snapshot size");
+
+  /* Corrupted snapshots are either rejected or valid trees */
+  for (i = 0; i < size; ++i)
+    {
+      for (f = 0; f < sizeof (FLIPS); ++f)
+        {
+          data[i] ^= FLIPS[f];
+          file = fopen (SNAPSHOT_FILE, "wb");
+          fwrite (data, 1, size, file);
+          fclose (file);
+          data[i] ^= FLIPS[f];
+
+          scew_tree *snapshot = scew_tree_open_snapshot (SNAPSHOT_FILE, NULL);
+          if (NULL == snapshot)
+            {
+              CHECK_S_INT (scew_error_code (), scew_error_snapshot,
+                           "Corrupted snapshot error");
+            }
+          else
+            {
+              scew_tree *copy = scew_tree_copy (snapshot);
+              CHECK_PTR (copy, "Unable to copy corrupted snapshot");
+              scew_tree_compare (tree, snapshot, NULL);
+              scew_tree_free (copy);
+              scew_tree_free (snapshot);
+            }
+        }
+    }
+
+  remove (SNAPSHOT_FILE);
+
+  scew_tree_free (tree);
+}
+END_TEST
+
 
 
 /* Suite */
@@ -187,6 +858,13 @@ tree_suite (void)
   tcase_add_test (tc_core, test_properties);
   tcase_add_test (tc_core, test_contents);
   tcase_add_test (tc_core, test_compare);
+  tcase_add_test (tc_core, test_index);
+  tcase_add_test (tc_core, test_index_attribute);
+  tcase_add_test (tc_core, test_index_text);
+  tcase_add_test (tc_core, test_index_order);
+  tcase_add_test (tc_core, test_freeze);
+  tcase_add_test (tc_core, test_snapshot);
+  tcase_add_test (tc_core, test_snapshot_corrupted);
   suite_add_tcase (s, tc_core);
 
   return s;
@@ -32,6 +32,8 @@
 
 #include <check.h>
 
+#include <stdlib.h>
+
 
 /* Unit tests */
 
@@ -123,6 +125,98 @@ START_TEST (test_misc)
 }
 END_TEST
 
+/* Growing memory */
+
+START_TEST (test_memory)
+{
+  enum { WRITES_NO = 1000 };
+
+  static XML_Char const *BUFFER = _XT("This is a buffer for the writer");
+
+  size_t buffer_len = scew_strlen (BUFFER);
+  size_t len = 0;
+  unsigned int i = 0;
+
+  scew_writer *writer = scew_writer_memory_create ();
+
+  CHECK_PTR (writer, "Unable to create memory writer");
+
+  /* Nothing written yet */
+  XML_Char *data = scew_writer_memory_steal (writer, &len);
+
+  CHECK_PTR (data, "Unable to steal empty buffer");
+  CHECK_U_INT (len, 0, "Nothing should be written yet");
+  CHECK_STR (data, _XT(""), "Buffer should be empty");
+
+  free (data);
+
+  /* Write much more than initially allocated */
+  for (i = 0; i < WRITES_NO; ++i)
+    {
+      CHECK_U_INT (scew_writer_write (writer, BUFFER, buffer_len), buffer_len,
+                   "Invalid number of written characters");
+    }
+
+  CHECK_BOOL (scew_writer_error (writer), SCEW_FALSE,
+              "Writer should have no error");
+
+  data = scew_writer_memory_steal (writer, &len);
+
+  CHECK_PTR (data, "Unable to steal buffer");
+  CHECK_U_INT (len, WRITES_NO * buffer_len, "Invalid number of characters");
+  CHECK_U_INT (scew_strlen (data), len, "Buffer should be null-terminated");
+
+  for (i = 0; i < WRITES_NO; ++i)
+    {
+      CHECK_BOOL (scew_memcmp (data + i * buffer_len, BUFFER, buffer_len) == 0,
+                  SCEW_TRUE, "Buffers do not match");
+    }
+
+  free (data);
+
+  /* Writers without vectored output write span by span */
+  scew_writer_span const spans[] =
+    {
+      { BUFFER, buffer_len },
+      { BUFFER, 0 },
+      { BUFFER, 4 }
+    };
+
+  CHECK_BOOL (scew_writer_vectored (writer), SCEW_FALSE,
+              "Memory writers do not support vectored output");
+  CHECK_U_INT (scew_writer_writev (writer, spans, 3), buffer_len + 4,
+               "Invalid number of written characters");
+
+  data = scew_writer_memory_steal (writer, &len);
+
+  CHECK_U_INT (len, buffer_len + 4, "Invalid size of written spans");
+  CHECK_BOOL (scew_memcmp (data + buffer_len, BUFFER, 4) == 0, SCEW_TRUE,
+              "Spans do not match");
+
+  free (data);
+
+  /* The writer can still be used after stealing its data */
+  scew_writer_write (writer, BUFFER, buffer_len);
+  scew_writer_close (writer);
+
+  CHECK_BOOL (scew_writer_end (writer), SCEW_TRUE,
+              "Writer is closed, thus at the end");
+  CHECK_U_INT (scew_writer_write (writer, BUFFER, buffer_len), 0,
+               "Closed writers do not write");
+
+  data = scew_writer_memory_steal (writer, NULL);
+
+  CHECK_STR (data, BUFFER, "Buffers do not match");
+
+  free (data);
+
+  /* Data not stolen is freed with the writer */
+  scew_writer_write (writer, BUFFER, buffer_len);
+
+  scew_writer_free (writer);
+}
+END_TEST
+
 
 /* Suite */
 
@@ -136,6 +230,7 @@ writer_buffer_suite (void)
   tcase_add_test (tc_core, test_alloc);
   tcase_add_test (tc_core, test_write);
   tcase_add_test (tc_core, test_misc);
+  tcase_add_test (tc_core, test_memory);
   suite_add_tcase (s, tc_core);
 
   return s;
@@ -0,0 +1,214 @@
+/**
+ * @file     check_writer_buffered.c
+ * @brief    Unit testing for SCEW buffered writers
+ * @author   Aleix Conchillo Flaque <aleix@member.fsf.org>
+ * @date     Sun Oct 18, 2026 20:50
+ *
+ * @if copyright
+ *
+ * Copyright (C) 2026 Aleix Conchillo Flaque
+ *
+ * SCEW is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * SCEW is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ *
+ * @endif
+ */
+
+
+#include "test.h"
+
+#include <scew/writer_buffer.h>
+#include <scew/writer_buffered.h>
+
+#include <check.h>
+
+
+/* Unit tests */
+
+enum { MAX_BUFFER_SIZE = 512 };
+
+static unsigned int writes_ = 0;
+
+/* Counts the writes to a buffer writer. */
+static size_t
+counted_write_ (scew_writer *writer, XML_Char const *buffer, size_t char_no)
+{
+  writes_ += 1;
+
+  return scew_writer_write (scew_writer_data (writer), buffer, char_no);
+}
+
+static scew_bool
+counted_end_ (scew_writer *writer)
+{
+  return scew_writer_end (scew_writer_data (writer));
+}
+
+static scew_bool
+counted_error_ (scew_writer *writer)
+{
+  return scew_writer_error (scew_writer_data (writer));
+}
+
+static scew_bool
+counted_close_ (scew_writer *writer)
+{
+  return scew_writer_close (scew_writer_data (writer));
+}
+
+static void
+counted_free_ (scew_writer *writer)
+{
+  scew_writer_free (scew_writer_data (writer));
+}
+
+static scew_writer_hooks const counted_hooks_ =
+  {
+    counted_write_,
+    counted_end_,
+    counted_error_,
+    counted_close_,
+    counted_free_
+  };
+
+/* Allocation */
+
+START_TEST (test_alloc)
+{
+  XML_Char buffer[MAX_BUFFER_SIZE] = _XT("");
+
+  scew_writer *inner = scew_writer_buffer_create (buffer, MAX_BUFFER_SIZE);
+  scew_writer *writer = scew_writer_buffered_create (inner, 64);
+
+  CHECK_PTR (writer, "Unable to create buffered writer");
+
+  scew_writer_free (writer);
+  scew_writer_free (inner);
+}
+END_TEST
+
+/* Write */
+
+START_TEST (test_write)
+{
+  static XML_Char const *BUFFER = _XT("This is a buffer for the writer");
+
+  XML_Char write_buffer[MAX_BUFFER_SIZE] = _XT("");
+
+  scew_writer *inner =
+    scew_writer_create (&counted_hooks_,
+                        scew_writer_buffer_create (write_buffer,
+                                                   MAX_BUFFER_SIZE));
+  scew_writer *writer = scew_writer_buffered_create (inner, 8);
+
+  CHECK_PTR (writer, "Unable to create buffered writer");
+
+  writes_ = 0;
+
+  /* Small writes are collected */
+  unsigned int i = 0;
+  for (i = 0; i < 7; ++i)
+    {
+      CHECK_U_INT (scew_writer_write (writer, BUFFER + i, 1), 1,
+                   "Invalid number of written characters");
+    }
+  CHECK_U_INT (writes_, 0, "Collected characters were written");
+  CHECK_STR (write_buffer, _XT(""), "Collected characters were written");
+
+  CHECK_BOOL (scew_writer_buffered_flush (writer), SCEW_TRUE,
+              "Unable to flush buffered writer");
+  CHECK_U_INT (writes_, 1, "Number of writes after flush");
+  CHECK_STR (write_buffer, _XT("This is"), "Flushed buffers do not match");
+
+  /* Small writes are written once the buffer is full */
+  for (i = 7; i < 16; ++i)
+    {
+      scew_writer_write (writer, BUFFER + i, 1);
+    }
+  CHECK_U_INT (writes_, 2, "Number of writes after filling the buffer");
+  CHECK_STR (write_buffer, _XT("This is a buffe"),
+             "Full buffers do not match");
+
+  /* Large writes are not collected (pending ones are written first) */
+  i = scew_strlen (BUFFER) - 16;
+  CHECK_U_INT (scew_writer_write (writer, BUFFER + 16, i), i,
+               "Invalid number of written characters");
+  CHECK_U_INT (writes_, 4, "Number of writes after large write");
+  CHECK_STR (write_buffer, BUFFER, "Buffers do not match");
+
+  CHECK_BOOL (scew_writer_error (writer), SCEW_FALSE,
+              "Buffered writer should have no error");
+
+  scew_writer_free (writer);
+  scew_writer_free (inner);
+}
+END_TEST
+
+/* Close */
+
+START_TEST (test_close)
+{
+  XML_Char write_buffer[MAX_BUFFER_SIZE] = _XT("");
+
+  scew_writer *inner = scew_writer_buffer_create (write_buffer,
+                                                  MAX_BUFFER_SIZE);
+  scew_writer *writer = scew_writer_buffered_create (inner, 64);
+
+  scew_writer_write (writer, _XT("pending"), 7);
+  CHECK_STR (write_buffer, _XT(""), "Collected characters were written");
+
+  /* Closing writes pending characters and closes the inner writer */
+  CHECK_BOOL (scew_writer_close (writer), SCEW_TRUE,
+              "Unable to close buffered writer");
+  CHECK_STR (write_buffer, _XT("pending"), "Pending characters were lost");
+  CHECK_BOOL (scew_writer_end (writer), SCEW_TRUE,
+              "Buffered writer is closed, thus at the end");
+
+  scew_writer_free (writer);
+  scew_writer_free (inner);
+
+  /* Freeing also writes pending characters */
+  inner = scew_writer_buffer_create (write_buffer, MAX_BUFFER_SIZE);
+  writer = scew_writer_buffered_create (inner, 64);
+  scew_writer_write (writer, _XT("freed"), 5);
+  scew_writer_free (writer);
+  CHECK_STR (write_buffer, _XT("freed"), "Pending characters were lost");
+  scew_writer_free (inner);
+}
+END_TEST
+
+
+/* Suite */
+
+static Suite*
+writer_buffered_suite (void)
+{
+  Suite *s = suite_create ("SCEW buffered writer");
+
+  /* Core test case */
+  TCase *tc_core = tcase_create ("Core");
+  tcase_add_test (tc_core, test_alloc);
+  tcase_add_test (tc_core, test_write);
+  tcase_add_test (tc_core, test_close);
+  suite_add_tcase (s, tc_core);
+
+  return s;
+}
+
+void
+run_tests (SRunner *sr)
+{
+  srunner_add_suite (sr, writer_buffered_suite ());
+}
@@ -33,6 +33,11 @@
 
 #include <check.h>
 
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
 
 /* Unit tests */
 
@@ -154,6 +159,175 @@ START_TEST (test_misc)
 }
 END_TEST
 
+/* File descriptors */
+
+START_TEST (test_fd)
+{
+  enum { BIG_SIZE = 200000 };
+
+  int fd = open (TEST_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  CHECK_BOOL (fd >= 0, SCEW_TRUE, "Unable to open test file");
+
+  scew_writer *writer = scew_writer_fd_create (fd);
+
+  CHECK_PTR (writer, "Unable to create file descriptor writer");
+
+  /* Reserving space is only a hint, it might not be supported. */
+  scew_writer_fd_preallocate (writer, BIG_SIZE);
+
+  /* Small writes are collected, big ones go straight to the file. */
+  XML_Char *big = malloc (BIG_SIZE * sizeof (XML_Char));
+  unsigned int i = 0;
+  for (i = 0; i < BIG_SIZE; ++i)
+    {
+      big[i] = _XT('a') + (i % 26);
+    }
+
+  size_t contents_len = scew_strlen (TEST_CONTENTS);
+  for (i = 0; i < contents_len; ++i)
+    {
+      CHECK_U_INT (scew_writer_write (writer, TEST_CONTENTS + i, 1), 1,
+                   "Invalid number of written characters");
+    }
+  CHECK_U_INT (scew_writer_write (writer, big, BIG_SIZE), BIG_SIZE,
+               "Invalid number of written characters (big)");
+  CHECK_U_INT (scew_writer_write (writer, TEST_CONTENTS, contents_len),
+               contents_len, "Invalid number of written characters");
+
+  CHECK_BOOL (scew_writer_error (writer), SCEW_FALSE,
+              "Writer should have no error");
+
+  scew_writer_close (writer);
+
+  CHECK_BOOL (scew_writer_end (writer), SCEW_TRUE,
+              "Writer is closed, thus at the end");
+
+  scew_writer_free (writer);
+
+  /* Read everything back (characters are written as in memory). */
+  size_t total = 2 * contents_len + BIG_SIZE;
+  XML_Char *read_buffer = malloc ((total + 1) * sizeof (XML_Char));
+
+  FILE *file = fopen (TEST_FILE, "rb");
+  CHECK_U_INT (fread (read_buffer, sizeof (XML_Char), total + 1, file), total,
+               "Invalid file size");
+  fclose (file);
+
+  CHECK_BOOL (memcmp (read_buffer, TEST_CONTENTS,
+                      contents_len * sizeof (XML_Char)) == 0, SCEW_TRUE,
+              "Buffers do not match (start)");
+  CHECK_BOOL (memcmp (read_buffer + contents_len, big,
+                      BIG_SIZE * sizeof (XML_Char)) == 0, SCEW_TRUE,
+              "Buffers do not match (big)");
+  CHECK_BOOL (memcmp (read_buffer + contents_len + BIG_SIZE, TEST_CONTENTS,
+                      contents_len * sizeof (XML_Char)) == 0, SCEW_TRUE,
+              "Buffers do not match (end)");
+
+  free (read_buffer);
+  free (big);
+
+  /* Remove test file from hard drive */
+  remove (TEST_FILE);
+}
+END_TEST
+
+START_TEST (test_fd_pipe)
+{
+  int fds[2];
+
+  CHECK_S_INT (pipe (fds), 0, "Unable to create pipe");
+
+  scew_writer *writer = scew_writer_fd_create (fds[1]);
+
+  CHECK_PTR (writer, "Unable to create file descriptor writer");
+
+  CHECK_BOOL (scew_writer_fd_preallocate (writer, 1024), SCEW_FALSE,
+              "Pipes can not reserve space");
+
+  size_t contents_len = scew_strlen (TEST_CONTENTS);
+  CHECK_U_INT (scew_writer_write (writer, TEST_CONTENTS, contents_len),
+               contents_len, "Invalid number of written characters");
+
+  /* Closing flushes the data and the write end of the pipe. */
+  scew_writer_free (writer);
+
+  enum { MAX_BUFFER_SIZE = 512 };
+
+  XML_Char read_buffer[MAX_BUFFER_SIZE];
+  size_t bytes = 0;
+  ssize_t result = 0;
+  do
+    {
+      result = read (fds[0], (char *) read_buffer + bytes,
+                     sizeof (read_buffer) - sizeof (XML_Char) - bytes);
+      bytes += (result > 0) ? result : 0;
+    }
+  while (result > 0);
+  close (fds[0]);
+
+  CHECK_U_INT (bytes, contents_len * sizeof (XML_Char), "Invalid size read");
+
+  read_buffer[bytes / sizeof (XML_Char)] = _XT('\0');
+  CHECK_STR (read_buffer, TEST_CONTENTS, "Buffers do not match");
+}
+END_TEST
+
+START_TEST (test_fd_writev)
+{
+  enum { SPANS_NO = 100 };
+
+  int fds[2];
+
+  CHECK_S_INT (pipe (fds), 0, "Unable to create pipe");
+
+  scew_writer *writer = scew_writer_fd_create (fds[1]);
+
+  CHECK_PTR (writer, "Unable to create file descriptor writer");
+
+  /* Collected data is written before the spans */
+  size_t contents_len = scew_strlen (TEST_CONTENTS);
+  CHECK_U_INT (scew_writer_write (writer, TEST_CONTENTS, 5), 5,
+               "Invalid number of written characters");
+
+  /* More spans than a single writev call sends, some empty */
+  scew_writer_span spans[SPANS_NO];
+  size_t char_no = 0;
+  unsigned int i = 0;
+  for (i = 0; i < SPANS_NO; ++i)
+    {
+      spans[i].buffer = TEST_CONTENTS + 5 + char_no;
+      spans[i].char_no = (i % 10 == 0) ? 0 : 1;
+      char_no += spans[i].char_no;
+    }
+  spans[SPANS_NO - 1].char_no = contents_len - 5 - (char_no - 1);
+
+  CHECK_U_INT (scew_writer_writev (writer, spans, SPANS_NO), contents_len - 5,
+               "Invalid number of written characters");
+
+  scew_writer_free (writer);
+
+  enum { MAX_BUFFER_SIZE = 512 };
+
+  XML_Char read_buffer[MAX_BUFFER_SIZE];
+  size_t bytes = 0;
+  ssize_t result = 0;
+  do
+    {
+      result = read (fds[0], (char *) read_buffer + bytes,
+                     sizeof (read_buffer) - sizeof (XML_Char) - bytes);
+      bytes += (result > 0) ? result : 0;
+    }
+  while (result > 0);
+  close (fds[0]);
+
+  CHECK_U_INT (bytes, contents_len * sizeof (XML_Char), "Invalid size read");
+
+  read_buffer[bytes / sizeof (XML_Char)] = _XT('\0');
+  CHECK_STR (read_buffer, TEST_CONTENTS, "Buffers do not match");
+}
+END_TEST
+
 
 /* Suite */
 
@@ -167,6 +341,9 @@ writer_file_suite (void)
   tcase_add_test (tc_core, test_alloc);
   tcase_add_test (tc_core, test_write);
   tcase_add_test (tc_core, test_misc);
+  tcase_add_test (tc_core, test_fd);
+  tcase_add_test (tc_core, test_fd_pipe);
+  tcase_add_test (tc_core, test_fd_writev);
   suite_add_tcase (s, tc_core);
 
   return s;